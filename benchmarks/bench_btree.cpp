@@ -0,0 +1,76 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include <phoenix/bench.hpp>
+#include <phoenix/btree.hpp>
+#include <phoenix/utility.hpp>
+
+// Usage: bench_btree [entries]
+// Random insertions, lookups and a full range scan in phoenix::btree_map and std::map,
+// plus bulk loading the btree from sorted pairs.
+using key = std::uint64_t;
+
+template <typename Map, typename Insert, typename Contains, typename Scan>
+void run(const std::string& name, const std::vector<key>& keys, Insert insert, Contains contains, Scan scan,
+         const phoenix::bench_options& options) {
+  Map map;
+  phoenix::bench(name + "/insert", options).items(keys.size()).run([&]() { map = Map(); }, [&]() {
+    for (auto k : keys) insert(map, k);
+  });
+  std::size_t found = 0;
+  phoenix::bench(name + "/find", options).items(keys.size()).run([&]() {
+    found = 0;
+    for (auto k : keys) found += contains(map, k) ? 1 : 0;
+    phoenix::do_not_optimize(found);
+  });
+  key sum = 0;
+  phoenix::bench(name + "/scan", options).items(keys.size()).run([&]() {
+    sum = scan(map);
+    phoenix::do_not_optimize(sum);
+  });
+  if (found != keys.size()) std::cout << name << " [OUTPUT INVALID]" << std::endl;
+}
+
+int main(int argc, char** argv) {
+  std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+  std::mt19937_64 gen(7);
+  std::vector<key> keys(count);
+  for (auto& k : keys) k = gen();
+  std::cout << count << " random 64-bit keys" << std::endl;
+  // Every call handles all keys, a few samples are enough
+  phoenix::bench_options options;
+  options.samples = 5;
+
+  using btree = phoenix::btree_map<key, key>;
+  run<btree>("phoenix::btree_map", keys, [](btree& map, key k) { map.insert(k, k); },
+             [](const btree& map, key k) { return map.contains(k); },
+             [](const btree& map) {
+               key sum = 0;
+               for (auto it = map.begin(); it != map.end(); ++it) sum += it.value();
+               return sum;
+             },
+             options);
+  using std_map = std::map<key, key>;
+  run<std_map>("std::map", keys, [](std_map& map, key k) { map.emplace(k, k); },
+               [](const std_map& map, key k) { return map.count(k) != 0; },
+               [](const std_map& map) {
+                 key sum = 0;
+                 for (const auto& element : map) sum += element.second;
+                 return sum;
+               },
+               options);
+
+  std::vector<phoenix::pair<key, key>> sorted(count);
+  std::sort(keys.begin(), keys.end());
+  for (std::size_t i = 0; i < count; i++) sorted[i] = {keys[i], keys[i]};
+  btree loaded;
+  phoenix::bench("phoenix::btree_map/bulk load", options).items(count).run([&]() { loaded = btree(); }, [&]() {
+    loaded.assign_sorted(sorted.begin(), sorted.end());
+  });
+  std::cout << "bulk loaded height " << loaded.height() << std::endl;
+}
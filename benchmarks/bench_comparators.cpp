@@ -0,0 +1,57 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <phoenix/bench.hpp>
+#include <phoenix/sort.hpp>
+#include <phoenix/utility.hpp>
+#include <phoenix/vector.hpp>
+
+// Usage: bench_comparators [elements]
+// Same algorithms called with a function pointer comparator and with the equivalent functor.
+// std::int64_t isn't a vectorized sort key, so sorting goes through the generic introsort.
+using key = std::int64_t;
+
+phoenix::vector<key> random_keys(std::size_t count) {
+  std::mt19937_64 gen(42);
+  phoenix::vector<key> keys(count);
+  for (std::size_t i = 0; i < count; i++) keys[i] = static_cast<key>(gen());
+  return keys;
+}
+
+// is_greater<key> itself would be passed on as greater_fn
+bool key_greater(const key& first, const key& second) {
+  return first > second;
+}
+
+template <typename Compare>
+void run(const std::string& name, std::size_t count, Compare compare, const phoenix::bench_options& options) {
+  auto source = random_keys(count);
+  phoenix::vector<key> keys;
+  phoenix::bench(name + "/sort", options).items(count).run([&]() { keys = source; }, [&]() {
+    phoenix::sort(keys.begin(), keys.end(), compare);
+  });
+
+  bool sorted = false;
+  phoenix::bench(name + "/is_sorted", options).items(count).run([&]() {
+    sorted = phoenix::is_sorted(keys.cbegin(), keys.cend(), compare);
+    phoenix::do_not_optimize(sorted);
+  });
+
+  phoenix::bench(name + "/heap_sort", options).items(count).run([&]() { keys = source; }, [&]() {
+    phoenix::heap_sort(keys.begin(), keys.end(), compare);
+  });
+  if (!sorted || !phoenix::is_sorted(keys.cbegin(), keys.cend(), compare))
+    std::cout << name << " [OUTPUT INVALID]" << std::endl;
+}
+
+int main(int argc, char** argv) {
+  std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+  std::cout << count << " random 64-bit integers" << std::endl;
+  // Sorts of the default size take most of a second, a few samples are enough
+  phoenix::bench_options options;
+  options.samples = 5;
+  run("function pointer", count, &key_greater, options);
+  run("greater_fn", count, phoenix::greater_fn{}, options);
+}
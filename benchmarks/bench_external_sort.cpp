@@ -0,0 +1,75 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <phoenix/external_sort.hpp>
+#include <phoenix/vector.hpp>
+
+// Usage: bench_external_sort [data MiB] [memory budget MiB] [fan-in] [temp directory]
+struct record {
+  std::uint64_t key;
+  std::uint64_t payload;
+
+  bool operator>(const record& other) const { return key > other.key; }
+};
+
+void generate(const std::string& path, std::size_t count) {
+  std::mt19937_64 gen(42);
+  std::FILE* file = std::fopen(path.c_str(), "wb");
+  phoenix::vector<record> block(1 << 16);
+  for (std::size_t written = 0; written < count;) {
+    std::size_t n = count - written < block.size() ? count - written : block.size();
+    for (std::size_t i = 0; i < n; i++) block[i] = record{gen(), written + i};
+    std::fwrite(&block[0], sizeof(record), n, file);
+    written += n;
+  }
+  std::fclose(file);
+}
+
+bool verify(const std::string& path, std::size_t count) {
+  std::FILE* file = std::fopen(path.c_str(), "rb");
+  phoenix::vector<record> block(1 << 16);
+  std::size_t total = 0;
+  std::uint64_t previous = 0;
+  bool sorted = true;
+  for (std::size_t n; (n = std::fread(&block[0], sizeof(record), block.size(), file)) > 0;) {
+    for (std::size_t i = 0; i < n; i++) {
+      if (block[i].key < previous) sorted = false;
+      previous = block[i].key;
+    }
+    total += n;
+  }
+  std::fclose(file);
+  return sorted && total == count;
+}
+
+int main(int argc, char** argv) {
+  std::size_t data_mib = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 256;
+  phoenix::external_sort_config config;
+  config.memory_budget = (argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 32) << 20;
+  config.fan_in = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 64;
+  config.temp_directory = argc > 4 ? argv[4] : "";
+
+  std::string directory = config.temp_directory.empty() ? "." : config.temp_directory;
+  std::string input = directory + "/bench_external_sort_input.bin";
+  std::string output = directory + "/bench_external_sort_output.bin";
+  std::size_t count = (data_mib << 20) / sizeof(record);
+
+  generate(input, count);
+
+  auto start = std::chrono::steady_clock::now();
+  phoenix::external_sort<record>(input, output, config);
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  bool valid = verify(output, count);
+  std::remove(input.c_str());
+  std::remove(output.c_str());
+
+  std::cout << "external_sort: " << data_mib << " MiB, budget " << (config.memory_budget >> 20)
+            << " MiB, fan-in " << config.fan_in << ": " << elapsed.count() << " s, "
+            << data_mib / elapsed.count() << " MiB/s" << (valid ? "" : " [OUTPUT INVALID]") << std::endl;
+  return valid ? 0 : 1;
+}
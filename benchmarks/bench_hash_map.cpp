@@ -0,0 +1,58 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <phoenix/bench.hpp>
+#include <phoenix/hash_map.hpp>
+
+// Usage: bench_hash_map [max entries]
+// Insertion, successful and failed lookups of random 64-bit keys in phoenix::hash_map and
+// std::unordered_map, for 10^3 entries up to max entries (10^7 by default, 10^8 needs a few GB).
+using key = std::uint64_t;
+
+template <typename Map, typename Insert, typename Contains>
+void run(const std::string& name, const std::vector<key>& keys, const std::vector<key>& missing, Insert insert,
+         Contains contains, const phoenix::bench_options& options) {
+  std::string suffix = "/" + std::to_string(keys.size());
+  Map map;
+  phoenix::bench(name + "/insert" + suffix, options).items(keys.size()).run([&]() { map = Map(); }, [&]() {
+    for (auto k : keys) insert(map, k);
+  });
+  std::size_t hits = 0, misses = 0;
+  phoenix::bench(name + "/hit" + suffix, options).items(keys.size()).run([&]() {
+    hits = 0;
+    for (auto k : keys) hits += contains(map, k) ? 1 : 0;
+    phoenix::do_not_optimize(hits);
+  });
+  phoenix::bench(name + "/miss" + suffix, options).items(missing.size()).run([&]() {
+    misses = 0;
+    for (auto k : missing) misses += contains(map, k) ? 1 : 0;
+    phoenix::do_not_optimize(misses);
+  });
+  if (hits != keys.size() || misses != 0) std::cout << name << suffix << " [OUTPUT INVALID]" << std::endl;
+}
+
+int main(int argc, char** argv) {
+  std::size_t max_count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+  // Calls on the largest maps take a good part of a second, a few samples are enough
+  phoenix::bench_options options;
+  options.samples = 5;
+  for (std::size_t count = 1000; count <= max_count; count *= 10) {
+    // Odd keys are inserted, even keys are missing
+    std::mt19937_64 gen(count);
+    std::vector<key> keys(count), missing(count);
+    for (std::size_t i = 0; i < count; i++) {
+      keys[i] = gen() | 1;
+      missing[i] = gen() & ~key(1);
+    }
+    run<phoenix::hash_map<key, key>>("phoenix::hash_map", keys, missing,
+        [](phoenix::hash_map<key, key>& map, key k) { map.insert(k, k); },
+        [](const phoenix::hash_map<key, key>& map, key k) { return map.contains(k); }, options);
+    run<std::unordered_map<key, key>>("std::unordered_map", keys, missing,
+        [](std::unordered_map<key, key>& map, key k) { map.emplace(k, k); },
+        [](const std::unordered_map<key, key>& map, key k) { return map.count(k) != 0; }, options);
+  }
+}
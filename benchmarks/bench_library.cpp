@@ -0,0 +1,335 @@
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <phoenix/algorithm.hpp>
+#include <phoenix/array.hpp>
+#include <phoenix/bench.hpp>
+#include <phoenix/btree.hpp>
+#include <phoenix/flat_map.hpp>
+#include <phoenix/flat_set.hpp>
+#include <phoenix/hash_map.hpp>
+#include <phoenix/merge.hpp>
+#include <phoenix/mpmc_queue.hpp>
+#include <phoenix/numa.hpp>
+#include <phoenix/numeric.hpp>
+#include <phoenix/object_pool.hpp>
+#include <phoenix/priority_queue.hpp>
+#include <phoenix/ranges.hpp>
+#include <phoenix/search.hpp>
+#include <phoenix/sort.hpp>
+#include <phoenix/span.hpp>
+#include <phoenix/spsc_queue.hpp>
+#include <phoenix/string.hpp>
+#include <phoenix/thread_pool.hpp>
+#include <phoenix/vector.hpp>
+
+// Usage: bench_library [--counters] [filter]
+// Every container and algorithm of the library measured with phoenix::bench, at a few input sizes.
+// With a filter, only benchmarks whose names contain it are run, e.g. "bench_library sort".
+// --counters adds hardware counters (cycles, IPC, cache, branch and TLB misses, page faults) per iteration.
+// external_sort isn't included, as its time is dominated by the disk.
+struct suite {
+  std::string filter;
+  phoenix::bench_options options;
+
+  template <typename Benchmark>
+  void run(const std::string& name, std::initializer_list<std::size_t> sizes, Benchmark benchmark) const {
+    if (name.find(filter) != std::string::npos) phoenix::run_bench(name, sizes, benchmark, options);
+  }
+};
+
+phoenix::vector<std::uint32_t> random_keys(std::size_t size, std::uint32_t seed = 7) {
+  std::mt19937 generator(seed);
+  phoenix::vector<std::uint32_t> keys(size, phoenix::uninitialized);
+  for (auto& key : keys) key = generator();
+  return keys;
+}
+
+phoenix::vector<std::uint32_t> sorted_keys(std::size_t size, std::uint32_t seed = 7) {
+  auto keys = random_keys(size, seed);
+  phoenix::sort(keys.begin(), keys.end());
+  return keys;
+}
+
+void containers(const suite& s) {
+  s.run("vector/push", {1 << 10, 1 << 14}, [](phoenix::bench& b, std::size_t n) {
+    return b.items(n).run([n]() {
+      phoenix::vector<std::uint32_t> values;
+      for (std::size_t i = 0; i < n; i++) values.push(static_cast<std::uint32_t>(i));
+      phoenix::do_not_optimize(values);
+    });
+  });
+  s.run("vector/copy", {1 << 10, 1 << 16, 1 << 20}, [](phoenix::bench& b, std::size_t n) {
+    auto source = random_keys(n);
+    return b.bytes(n * sizeof(std::uint32_t)).run([&source]() {
+      phoenix::vector<std::uint32_t> copy(source);
+      phoenix::do_not_optimize(copy);
+    });
+  });
+  s.run("array/copy", {4096}, [](phoenix::bench& b, std::size_t n) {
+    phoenix::array<std::uint32_t, 4096> source(3), copy;
+    return b.bytes(n * sizeof(std::uint32_t)).run([&source, &copy]() {
+      copy = source;
+      phoenix::do_not_optimize(copy);
+    });
+  });
+  s.run("string/find", {1 << 10, 1 << 16, 1 << 20}, [](phoenix::bench& b, std::size_t n) {
+    phoenix::string text(n, 'a');
+    return b.bytes(n).run([&text]() {
+      auto position = text.find("needle");
+      phoenix::do_not_optimize(position);
+    });
+  });
+  s.run("hash_map/insert", {1 << 10, 1 << 16, 1 << 20}, [](phoenix::bench& b, std::size_t n) {
+    auto keys = random_keys(n);
+    return b.items(n).run([&keys]() {
+      phoenix::hash_map<std::uint32_t, std::uint32_t> map;
+      for (auto key : keys) map.insert(key, key);
+      phoenix::do_not_optimize(map);
+    });
+  });
+  s.run("hash_map/find", {1 << 10, 1 << 16, 1 << 20}, [](phoenix::bench& b, std::size_t n) {
+    auto keys = random_keys(n);
+    phoenix::hash_map<std::uint32_t, std::uint32_t> map(n);
+    for (auto key : keys) map.insert(key, key);
+    return b.items(n).run([&keys, &map]() {
+      std::size_t found = 0;
+      for (auto key : keys) found += map.contains(key);
+      phoenix::do_not_optimize(found);
+    });
+  });
+  s.run("flat_map/find", {1 << 10, 1 << 16, 1 << 20}, [](phoenix::bench& b, std::size_t n) {
+    auto keys = random_keys(n);
+    phoenix::flat_map<std::uint32_t, std::uint32_t> map(keys, keys);
+    return b.items(n).run([&keys, &map]() {
+      std::size_t found = 0;
+      for (auto key : keys) found += map.contains(key);
+      phoenix::do_not_optimize(found);
+    });
+  });
+  s.run("flat_set/insert", {1 << 10, 1 << 14}, [](phoenix::bench& b, std::size_t n) {
+    auto keys = random_keys(n);
+    return b.items(n).run([&keys]() {
+      phoenix::flat_set<std::uint32_t> set;
+      for (auto key : keys) set.insert(key);
+      phoenix::do_not_optimize(set);
+    });
+  });
+  s.run("btree_map/insert", {1 << 10, 1 << 16, 1 << 20}, [](phoenix::bench& b, std::size_t n) {
+    auto keys = random_keys(n);
+    return b.items(n).run([&keys]() {
+      phoenix::btree_map<std::uint32_t, std::uint32_t> map;
+      for (auto key : keys) map.insert(key, key);
+      phoenix::do_not_optimize(map);
+    });
+  });
+  s.run("btree_map/find", {1 << 10, 1 << 16, 1 << 20}, [](phoenix::bench& b, std::size_t n) {
+    auto keys = random_keys(n);
+    phoenix::btree_map<std::uint32_t, std::uint32_t> map;
+    for (auto key : keys) map.insert(key, key);
+    return b.items(n).run([&keys, &map]() {
+      std::size_t found = 0;
+      for (auto key : keys) found += map.find(key) != map.end();
+      phoenix::do_not_optimize(found);
+    });
+  });
+  s.run("priority_queue/push_pop", {1 << 10, 1 << 16, 1 << 20}, [](phoenix::bench& b, std::size_t n) {
+    auto keys = random_keys(n);
+    return b.items(n).run([&keys]() {
+      phoenix::priority_queue<std::uint32_t> queue;
+      for (auto key : keys) queue.push(key);
+      std::uint32_t last = 0;
+      while (!queue.empty()) last = queue.pop();
+      phoenix::do_not_optimize(last);
+    });
+  });
+  s.run("spsc_queue/push_pop", {1 << 10, 1 << 16}, [](phoenix::bench& b, std::size_t n) {
+    auto queue = std::make_shared<phoenix::spsc_queue<std::uint32_t, 1024>>();
+    return b.items(n).run([n, &queue]() {
+      std::uint32_t value = 0;
+      for (std::size_t i = 0; i < n; i++) {
+        queue->try_push(static_cast<std::uint32_t>(i));
+        queue->try_pop(value);
+      }
+      phoenix::do_not_optimize(value);
+    });
+  });
+  s.run("mpmc_queue/push_pop", {1 << 10, 1 << 16}, [](phoenix::bench& b, std::size_t n) {
+    phoenix::mpmc_queue<std::uint32_t> queue(1024);
+    return b.items(n).run([n, &queue]() {
+      std::uint32_t value = 0;
+      for (std::size_t i = 0; i < n; i++) {
+        queue.try_push(static_cast<std::uint32_t>(i));
+        queue.try_pop(value);
+      }
+      phoenix::do_not_optimize(value);
+    });
+  });
+  s.run("object_pool/create_destroy", {1 << 10, 1 << 16}, [](phoenix::bench& b, std::size_t n) {
+    phoenix::object_pool<std::uint64_t> pool;
+    phoenix::vector<std::uint64_t*> objects(n);
+    return b.items(n).run([n, &pool, &objects]() {
+      for (std::size_t i = 0; i < n; i++) objects[i] = pool.create(i);
+      for (std::size_t i = 0; i < n; i++) pool.destroy(objects[i]);
+    });
+  });
+}
+
+void algorithms(const suite& s) {
+  s.run("sort/uint32", {1 << 10, 1 << 16, 1 << 20}, [](phoenix::bench& b, std::size_t n) {
+    auto source = random_keys(n), keys = source;
+    return b.items(n).run([&]() { keys = source; }, [&keys]() { phoenix::sort(keys.begin(), keys.end()); });
+  });
+  s.run("sort/string", {1 << 10, 1 << 16}, [](phoenix::bench& b, std::size_t n) {
+    auto numbers = random_keys(n);
+    phoenix::vector<phoenix::string> source(n), strings;
+    for (std::size_t i = 0; i < n; i++) source[i] = phoenix::string(std::to_string(numbers[i]));
+    return b.items(n).run([&]() { strings = source; }, [&strings]() { phoenix::sort(strings.begin(), strings.end()); });
+  });
+  s.run("heap_sort/uint32", {1 << 10, 1 << 16}, [](phoenix::bench& b, std::size_t n) {
+    auto source = random_keys(n), keys = source;
+    return b.items(n).run([&]() { keys = source; }, [&keys]() { phoenix::heap_sort(keys.begin(), keys.end()); });
+  });
+  s.run("sort_by_key/uint64", {1 << 10, 1 << 16, 1 << 20}, [](phoenix::bench& b, std::size_t n) {
+    auto keys = random_keys(n);
+    phoenix::vector<std::uint64_t> source(n), records;
+    for (std::size_t i = 0; i < n; i++) source[i] = (std::uint64_t{keys[i]} << 32) | i;
+    auto high = [](std::uint64_t record) { return static_cast<std::uint32_t>(record >> 32); };
+    return b.items(n).run([&]() { records = source; },
+                          [&]() { phoenix::sort_by_key(records.begin(), records.end(), high); });
+  });
+  s.run("argsort/uint32", {1 << 10, 1 << 16, 1 << 20}, [](phoenix::bench& b, std::size_t n) {
+    auto keys = random_keys(n);
+    return b.items(n).run([&keys]() {
+      auto permutation = phoenix::argsort(keys.begin(), keys.end());
+      phoenix::do_not_optimize(permutation);
+    });
+  });
+  s.run("column_sort/strided_span", {1 << 10, 1 << 16}, [](phoenix::bench& b, std::size_t n) {
+    auto source = random_keys(n * 8), matrix = source;
+    return b.items(n).run([&]() { matrix = source; }, [&matrix]() {
+      auto column = phoenix::column(phoenix::span<std::uint32_t>(matrix), 8, 3);
+      phoenix::sort(column.begin(), column.end());
+    });
+  });
+  s.run("binary_search", {1 << 10, 1 << 16, 1 << 20}, [](phoenix::bench& b, std::size_t n) {
+    auto keys = sorted_keys(n), queries = random_keys(1024, 11);
+    return b.items(queries.size()).run([&keys, &queries]() {
+      std::size_t found = 0;
+      for (auto query : queries) found += phoenix::binary_search(keys.begin(), keys.end(), query);
+      phoenix::do_not_optimize(found);
+    });
+  });
+  s.run("sorted_index/lower_bound", {1 << 10, 1 << 16, 1 << 20}, [](phoenix::bench& b, std::size_t n) {
+    phoenix::sorted_index<std::uint32_t> index(sorted_keys(n));
+    auto queries = random_keys(1024, 11);
+    return b.items(queries.size()).run([&index, &queries]() {
+      std::size_t ranks = 0;
+      for (auto query : queries) ranks += index.lower_bound(query);
+      phoenix::do_not_optimize(ranks);
+    });
+  });
+  s.run("count", {1 << 10, 1 << 16, 1 << 20}, [](phoenix::bench& b, std::size_t n) {
+    auto keys = random_keys(n);
+    return b.bytes(n * sizeof(std::uint32_t)).run([&keys]() {
+      auto count = phoenix::count(keys.begin(), keys.end(), keys[0]);
+      phoenix::do_not_optimize(count);
+    });
+  });
+  s.run("minmax_element", {1 << 10, 1 << 16, 1 << 20}, [](phoenix::bench& b, std::size_t n) {
+    auto keys = random_keys(n);
+    return b.bytes(n * sizeof(std::uint32_t)).run([&keys]() {
+      auto bounds = phoenix::minmax_element(keys.begin(), keys.end());
+      phoenix::do_not_optimize(bounds);
+    });
+  });
+  s.run("equal", {1 << 10, 1 << 16, 1 << 20}, [](phoenix::bench& b, std::size_t n) {
+    auto first = random_keys(n), second = first;
+    return b.bytes(2 * n * sizeof(std::uint32_t)).run([&first, &second]() {
+      bool same = phoenix::equal(first.begin(), first.end(), second.begin());
+      phoenix::do_not_optimize(same);
+    });
+  });
+  s.run("merge", {1 << 10, 1 << 16, 1 << 20}, [](phoenix::bench& b, std::size_t n) {
+    auto first = sorted_keys(n, 1), second = sorted_keys(n, 2);
+    phoenix::vector<std::uint32_t> output(2 * n);
+    return b.items(2 * n).run([&]() {
+      phoenix::merge(first.begin(), first.end(), second.begin(), second.end(), output.begin());
+      phoenix::do_not_optimize(output);
+    });
+  });
+  s.run("set_intersection", {1 << 10, 1 << 16, 1 << 20}, [](phoenix::bench& b, std::size_t n) {
+    auto first = sorted_keys(n, 1), second = sorted_keys(n, 2);
+    phoenix::vector<std::uint32_t> output(n);
+    return b.items(2 * n).run([&]() {
+      auto end = phoenix::set_intersection(first.begin(), first.end(), second.begin(), second.end(), output.begin());
+      phoenix::do_not_optimize(end);
+    });
+  });
+  s.run("reduce/unseq", {1 << 10, 1 << 16, 1 << 20}, [](phoenix::bench& b, std::size_t n) {
+    auto keys = random_keys(n);
+    return b.bytes(n * sizeof(std::uint32_t)).run([&keys]() {
+      auto sum = phoenix::reduce(phoenix::execution::unseq, keys.begin(), keys.end(), std::uint64_t{0});
+      phoenix::do_not_optimize(sum);
+    });
+  });
+  s.run("reduce/par", {1 << 16, 1 << 20}, [](phoenix::bench& b, std::size_t n) {
+    auto keys = random_keys(n);
+    return b.bytes(n * sizeof(std::uint32_t)).run([&keys]() {
+      auto sum = phoenix::reduce(phoenix::execution::par, keys.begin(), keys.end(), std::uint64_t{0});
+      phoenix::do_not_optimize(sum);
+    });
+  });
+  s.run("inclusive_scan/unseq", {1 << 10, 1 << 16, 1 << 20}, [](phoenix::bench& b, std::size_t n) {
+    auto keys = random_keys(n);
+    phoenix::vector<std::uint32_t> sums(n);
+    return b.bytes(n * sizeof(std::uint32_t)).run([&keys, &sums]() {
+      phoenix::inclusive_scan(phoenix::execution::unseq, keys.begin(), keys.end(), sums.begin());
+      phoenix::do_not_optimize(sums);
+    });
+  });
+  s.run("parallel_for", {1 << 16, 1 << 20}, [](phoenix::bench& b, std::size_t n) {
+    auto keys = random_keys(n);
+    return b.items(n).run([&keys]() {
+      phoenix::parallel_for(keys.begin(), keys.end(), 4096, [](phoenix::vector<std::uint32_t>::iterator first,
+                                                               phoenix::vector<std::uint32_t>::iterator last) {
+        for (; first != last; ++first) *first = *first * 3 + 1;
+      });
+    });
+  });
+  s.run("numa/make_vector", {1 << 16, 1 << 20}, [](phoenix::bench& b, std::size_t n) {
+    return b.bytes(n * sizeof(std::uint32_t)).run([n]() {
+      auto values = phoenix::numa::make_vector<std::uint32_t>(n, 1);
+      phoenix::do_not_optimize(values);
+    });
+  });
+  s.run("ranges/map_filter_to_vector", {1 << 10, 1 << 16, 1 << 20}, [](phoenix::bench& b, std::size_t n) {
+    auto keys = random_keys(n);
+    return b.items(n).run([&keys]() {
+      auto odd = keys | phoenix::views::map([](std::uint32_t x) { return x * 3; }) |
+                 phoenix::views::filter([](std::uint32_t x) { return x % 2 == 1; }) | phoenix::to_vector();
+      phoenix::do_not_optimize(odd);
+    });
+  });
+}
+
+int main(int argc, char** argv) {
+  suite s;
+  for (int i = 1; i < argc; i++) {
+    std::string argument = argv[i];
+    if (argument == "--counters") {
+      s.options.counters = true;
+    } else {
+      s.filter = argument;
+    }
+  }
+  if (s.options.counters) {
+    phoenix::perf_counters events;
+    if (!events.error().empty()) std::cout << "Some counters are unavailable - " << events.error() << std::endl;
+  }
+  s.options.samples = 10;
+  s.options.sample_seconds = 0.002;
+  containers(s);
+  algorithms(s);
+}
@@ -0,0 +1,169 @@
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <phoenix/bench.hpp>
+#include <phoenix/mpmc_queue.hpp>
+
+// Usage: bench_mpmc_queue [messages]
+// Contention with 1 to 64 threads, half of them producers and half consumers (a single thread
+// alternates). Blocking and batched operations of mpmc_queue are compared with a mutex and
+// condition variable guarded std::deque of the same capacity.
+using message = std::uint64_t;
+constexpr std::size_t capacity = 1024;
+constexpr std::size_t batch = 32;
+
+class locked_queue {
+ public:
+  void push(message value) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _not_full.wait(lock, [&]() { return _values.size() < capacity; });
+    _values.push_back(value);
+    lock.unlock();
+    _not_empty.notify_one();
+  }
+
+  message pop() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _not_empty.wait(lock, [&]() { return !_values.empty(); });
+    message value = _values.front();
+    _values.pop_front();
+    lock.unlock();
+    _not_full.notify_one();
+    return value;
+  }
+
+ private:
+  std::mutex _mutex;
+  std::condition_variable _not_empty, _not_full;
+  std::deque<message> _values;
+};
+
+// Producer p sends messages p, p + producers, ..., consumers sum what they get.
+// Returns whether all messages arrived.
+template <typename Producer, typename Consumer>
+bool exchange(unsigned threads, message count, Producer producer, Consumer consumer) {
+  unsigned producers = threads / 2;
+  unsigned consumers = threads - producers;
+  std::vector<message> sums(consumers, 0);
+  std::vector<std::thread> pool;
+  for (unsigned p = 0; p < producers; p++) {
+    message share = count / producers + (p < count % producers ? 1 : 0);
+    pool.emplace_back([&, p, share]() { producer(p, producers, share); });
+  }
+  for (unsigned c = 0; c < consumers; c++) {
+    message share = count / consumers + (c < count % consumers ? 1 : 0);
+    pool.emplace_back([&, c, share]() { sums[c] = consumer(share); });
+  }
+  for (auto& t : pool) t.join();
+  message sum = 0;
+  for (auto s : sums) sum += s;
+  return sum == count * (count - 1) / 2;
+}
+
+int main(int argc, char** argv) {
+  message count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+  std::cout << count << " messages, capacity " << capacity << ", batches of " << batch << std::endl;
+  // Calls with many threads take a while, a few samples are enough
+  phoenix::bench_options options;
+  options.samples = 5;
+
+  for (unsigned threads = 1; threads <= 64; threads *= 2) {
+    std::string suffix = "/" + std::to_string(threads) + (threads == 1 ? " thread" : " threads");
+    bool valid = true;
+    // One thread can't block on itself, so it pushes and pops alternately
+    phoenix::mpmc_queue<message> queue(capacity);
+    phoenix::bench("mpmc_queue" + suffix, options).items(count).run([&]() {
+      if (threads > 1) {
+        valid &= exchange(
+            threads, count,
+            [&](unsigned p, unsigned producers, message share) {
+              for (message i = 0; i < share; i++) queue.push(p + i * producers);
+            },
+            [&](message share) {
+              message sum = 0;
+              for (message i = 0; i < share; i++) sum += queue.pop();
+              return sum;
+            });
+        return;
+      }
+      message sum = 0;
+      for (message i = 0; i < count; i++) {
+        queue.push(i);
+        sum += queue.pop();
+      }
+      valid &= sum == count * (count - 1) / 2;
+    });
+
+    // Consumers of the batched run may get more than their share, so they count together
+    std::atomic<message> received{0};
+    phoenix::bench("mpmc_queue batched" + suffix, options).items(count).run([&]() {
+      if (threads > 1) {
+        received = 0;
+        valid &= exchange(
+            threads, count,
+            [&](unsigned p, unsigned producers, message share) {
+              message values[batch];
+              for (message i = 0; i < share;) {
+                std::size_t length = 0;
+                for (; length < batch && i + length < share; length++) values[length] = p + (i + length) * producers;
+                std::size_t pushed = queue.push_n(values, length);
+                if (pushed == 0) std::this_thread::yield();
+                i += pushed;
+              }
+            },
+            [&](message) {
+              message values[batch], sum = 0;
+              while (received.load(std::memory_order_relaxed) < count) {
+                std::size_t popped = queue.pop_n(values, batch);
+                if (popped == 0) std::this_thread::yield();
+                for (std::size_t j = 0; j < popped; j++) sum += values[j];
+                received += popped;
+              }
+              return sum;
+            });
+        return;
+      }
+      message values[batch], sum = 0;
+      for (message i = 0; i < count; i += batch) {
+        std::size_t length = 0;
+        for (; length < batch && i + length < count; length++) values[length] = i + length;
+        queue.push_n(values, length);
+        queue.pop_n(values, length);
+        for (std::size_t j = 0; j < length; j++) sum += values[j];
+      }
+      valid &= sum == count * (count - 1) / 2;
+    });
+
+    locked_queue locked;
+    phoenix::bench("mutex + deque" + suffix, options).items(count).run([&]() {
+      if (threads > 1) {
+        valid &= exchange(
+            threads, count,
+            [&](unsigned p, unsigned producers, message share) {
+              for (message i = 0; i < share; i++) locked.push(p + i * producers);
+            },
+            [&](message share) {
+              message sum = 0;
+              for (message i = 0; i < share; i++) sum += locked.pop();
+              return sum;
+            });
+        return;
+      }
+      message sum = 0;
+      for (message i = 0; i < count; i++) {
+        locked.push(i);
+        sum += locked.pop();
+      }
+      valid &= sum == count * (count - 1) / 2;
+    });
+
+    if (!valid) std::cout << threads << " threads [OUTPUT INVALID]" << std::endl;
+  }
+}
@@ -0,0 +1,60 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <phoenix/bench.hpp>
+#include <phoenix/cpu.hpp>
+#include <phoenix/execution.hpp>
+#include <phoenix/numa.hpp>
+#include <phoenix/numeric.hpp>
+#include <phoenix/thread_pool.hpp>
+#include <phoenix/vector.hpp>
+
+// Usage: bench_numa [threads] [megabytes]
+// Builds a large vector serially and with each placement of numa::make_vector, then measures the
+// bandwidth of parallel reads (reduce) and read-writes (transform in place) over it with pinned
+// workers. On a multi-socket machine the serially built vector is limited by one node's memory.
+template <typename Build>
+void run(const std::string& name, std::size_t length, Build build, phoenix::thread_pool& pool,
+         const phoenix::bench_options& options) {
+  auto policy = phoenix::execution::par.on(pool);
+  std::size_t bytes = length * sizeof(double);
+  // The old vector is freed untimed, so every build pays for page faults of a new one
+  phoenix::vector<double> values;
+  phoenix::bench(name + "/build", options).bytes(bytes).run([&]() { values = phoenix::vector<double>(); }, [&]() {
+    build().swap(values);
+  });
+
+  double sum = 0;
+  phoenix::bench(name + "/read", options).bytes(bytes).run([&]() {
+    sum = phoenix::reduce(policy, values.begin(), values.end(), 0.0);
+    phoenix::do_not_optimize(sum);
+  });
+  phoenix::bench(name + "/read+write", options).bytes(2 * bytes).run([&]() {
+    phoenix::transform(policy, values.begin(), values.end(), values.begin(), [](double x) { return x * 1.0; });
+  });
+  if (sum != static_cast<double>(length)) std::cout << name << " [OUTPUT INVALID]" << std::endl;
+}
+
+int main(int argc, char** argv) {
+  unsigned threads = argc > 1 ? static_cast<unsigned>(std::strtoul(argv[1], nullptr, 10))
+                              : phoenix::cpu::available_cores();
+  std::size_t megabytes = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 256;
+  std::size_t length = megabytes * (std::size_t{1} << 20) / sizeof(double);
+  phoenix::thread_pool pool(threads, true);
+  auto policy = phoenix::execution::par.on(pool);
+  std::cout << phoenix::numa::node_count() << " nodes, " << pool.size() << " pinned workers, " << megabytes
+            << " MB" << std::endl;
+  // Every call goes over the whole vector, a few samples are enough
+  phoenix::bench_options options;
+  options.samples = 5;
+
+  run("serial construction", length, [&]() { return phoenix::vector<double>(length, 1.0); }, pool, options);
+  struct mode {
+    const char* name;
+    phoenix::numa::placement where;
+  };
+  for (auto m : {mode{"parallel first touch", phoenix::numa::first_touch},
+                 mode{"interleaved", phoenix::numa::interleave}, mode{"bound to node 0", phoenix::numa::bind(0)}}) {
+    run(m.name, length, [&]() { return phoenix::numa::make_vector(length, 1.0, policy, m.where); }, pool, options);
+  }
+}
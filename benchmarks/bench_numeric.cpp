@@ -0,0 +1,72 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <phoenix/bench.hpp>
+#include <phoenix/cpu.hpp>
+#include <phoenix/execution.hpp>
+#include <phoenix/numeric.hpp>
+#include <phoenix/thread_pool.hpp>
+#include <phoenix/vector.hpp>
+
+// Usage: bench_numeric [threads]
+// reduce, inclusive_scan and transform_reduce over 2^24 elements with each execution policy,
+// compared with a plain loop
+template <typename T>
+void run(const std::string& type, phoenix::thread_pool& pool) {
+  constexpr std::size_t length = std::size_t{1} << 24;
+  phoenix::vector<T> values(length), scanned(length);
+  // All sums stay below 2^24, so float results are exact in any order
+  for (std::size_t i = 0; i < length; i++) values[i] = static_cast<T>(i % 2);
+  auto par = phoenix::execution::par.on(pool);
+  // Measures work, then checks its last result
+  auto report = [&](const char* name, auto work, auto check) {
+    phoenix::bench(type + "/" + name).bytes(length * sizeof(T)).run(work);
+    if (!check()) std::cout << type << "/" << name << " [OUTPUT INVALID]" << std::endl;
+  };
+
+  T loop = 0, seq = 0, unseq = 0, parallel = 0;
+  report("sum, loop", [&]() {
+    loop = 0;
+    for (std::size_t i = 0; i < length; i++) loop += values[i];
+    phoenix::do_not_optimize(loop);
+  }, [&]() { return true; });
+  report("reduce seq", [&]() {
+    seq = phoenix::reduce(phoenix::execution::seq, values.begin(), values.end(), T{});
+  }, [&]() { return seq == loop; });
+  report("reduce unseq", [&]() {
+    unseq = phoenix::reduce(phoenix::execution::unseq, values.begin(), values.end(), T{});
+  }, [&]() { return unseq == loop; });
+  report("reduce par", [&]() {
+    parallel = phoenix::reduce(par, values.begin(), values.end(), T{});
+  }, [&]() { return parallel == loop; });
+  report("dot product par", [&]() {
+    parallel = phoenix::transform_reduce(par, values.begin(), values.end(), values.begin(), T{});
+  }, [&]() { return parallel == loop; });
+
+  report("scan, loop", [&]() {
+    T sum = 0;
+    for (std::size_t i = 0; i < length; i++) scanned[i] = sum += values[i];
+  }, [&]() { return scanned[length - 1] == loop; });
+  auto scan = [&](const char* name, auto policy) {
+    scanned[length - 1] = 0;
+    report(name, [&]() {
+      phoenix::inclusive_scan(policy, values.begin(), values.end(), scanned.begin());
+    }, [&]() { return scanned[length - 1] == loop; });
+  };
+  scan("inclusive_scan seq", phoenix::execution::seq);
+  scan("inclusive_scan unseq", phoenix::execution::unseq);
+  scan("inclusive_scan par", par);
+}
+
+int main(int argc, char** argv) {
+  unsigned threads = argc > 1 ? static_cast<unsigned>(std::strtoul(argv[1], nullptr, 10))
+                              : phoenix::cpu::available_cores();
+  phoenix::thread_pool pool(threads);
+  std::cout << pool.size() << " workers, chunks of " << phoenix::execution::par.chunk_size << " elements"
+            << std::endl;
+  run<std::int32_t>("int32", pool);
+  run<std::int64_t>("int64", pool);
+  run<float>("float", pool);
+  run<double>("double", pool);
+}
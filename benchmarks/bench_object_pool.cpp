@@ -0,0 +1,100 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <string>
+#include <thread>
+#include <phoenix/bench.hpp>
+#include <phoenix/cpu.hpp>
+#include <phoenix/object_pool.hpp>
+#include <phoenix/vector.hpp>
+
+// Usage: bench_object_pool [threads]
+// Nanoseconds per allocation and deallocation of 48-byte nodes with new/delete and object_pool,
+// on one thread and on many threads at once, and std::list push/pop with both allocators.
+struct node {
+  std::uint64_t key;
+  node* left;
+  node* right;
+  std::uint64_t payload[3];
+};
+
+constexpr std::size_t live = 1000;
+constexpr int rounds = 2000;
+
+// Allocates live nodes, frees them in a different order, repeats; returns a checksum
+template <typename Allocate, typename Free>
+std::uint64_t churn(Allocate allocate, Free free) {
+  node* nodes[live];
+  std::uint64_t checksum = 0;
+  for (int round = 0; round < rounds; round++) {
+    for (std::size_t i = 0; i < live; i++) {
+      nodes[i] = allocate();
+      nodes[i]->key = i;
+    }
+    for (std::size_t i = 0; i < live; i++) {
+      node* n = nodes[(i * 7) % live];
+      checksum += n->key;
+      free(n);
+    }
+  }
+  return checksum;
+}
+
+template <typename Allocate, typename Free>
+void run(const std::string& name, unsigned threads, Allocate allocate, Free free) {
+  constexpr std::uint64_t expected = rounds * (live * (live - 1) / 2);
+  phoenix::vector<std::uint64_t> checksums(threads);
+  std::string full_name = name + "/" + std::to_string(threads) + " threads";
+  phoenix::bench(full_name).items(2 * rounds * live * threads).run([&]() {
+    std::thread* workers = new std::thread[threads];
+    for (unsigned t = 0; t < threads; t++) {
+      workers[t] = std::thread([&, t]() { checksums[t] = churn(allocate, free); });
+    }
+    for (unsigned t = 0; t < threads; t++) workers[t].join();
+    delete[] workers;
+  });
+  for (auto checksum : checksums) {
+    if (checksum != expected) {
+      std::cout << full_name << " [OUTPUT INVALID]" << std::endl;
+      break;
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  unsigned threads = argc > 1 ? static_cast<unsigned>(std::strtoul(argv[1], nullptr, 10))
+                              : phoenix::cpu::available_cores();
+  phoenix::object_pool<node> pool;
+  for (unsigned count : {1u, threads}) {
+    run("new/delete", count, []() { return new node; }, [](node* n) { delete n; });
+    run("object_pool", count, [&]() { return pool.allocate(); }, [&](node* n) { pool.deallocate(n); });
+  }
+  auto stats = pool.stats();
+  std::cout << "object_pool: " << stats.slabs << " slabs, " << stats.capacity << " objects, " << stats.in_use
+            << " in use, " << stats.cached << " cached" << std::endl;
+
+  constexpr int operations = 2000000;
+  auto list_churn = [](auto& list) {
+    long sum = 0;
+    for (int i = 0; i < operations; i++) {
+      list.push_back(i);
+      if (list.size() > live) {
+        sum += list.front();
+        list.pop_front();
+      }
+    }
+    return sum;
+  };
+  // Lists start empty in every call, so that both see the same sequence of operations
+  long standard_sum = 0, pooled_sum = 0;
+  phoenix::bench("std::list push/pop/std::allocator").items(operations).run([&]() {
+    std::list<int> standard;
+    standard_sum = list_churn(standard);
+  });
+  phoenix::bench("std::list push/pop/pool_allocator").items(operations).run([&]() {
+    std::list<int, phoenix::pool_allocator<int>> pooled;
+    pooled_sum = list_churn(pooled);
+  });
+  if (standard_sum != pooled_sum) std::cout << "std::list push/pop [OUTPUT INVALID]" << std::endl;
+}
@@ -0,0 +1,81 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+#include <phoenix/bench.hpp>
+#include <phoenix/priority_queue.hpp>
+#include <phoenix/utility.hpp>
+#include <phoenix/vector.hpp>
+
+// Usage: bench_priority_queue [elements]
+// Pushing and popping random 64-bit integers with 2-, 4- and 8-ary heaps and std::priority_queue,
+// heap construction, and a Dijkstra-like mix of decrease_key and pop on the indexed queue.
+using key = std::uint64_t;
+
+template <std::size_t Arity>
+void run(const std::vector<key>& values, const phoenix::bench_options& options) {
+  std::string name = std::to_string(Arity) + "-ary heap";
+  std::size_t count = values.size();
+  phoenix::priority_queue<key, phoenix::greater_fn, Arity> queue;
+  phoenix::bench(name + "/push", options).items(count).run([&]() { queue.clear(); }, [&]() {
+    for (auto v : values) queue.push(v);
+  });
+  key checksum = 0;
+  phoenix::bench(name + "/pop", options).items(count).run([&]() {
+    queue.clear();
+    for (auto v : values) queue.push(v);
+    checksum = 0;
+  }, [&]() {
+    while (!queue.empty()) checksum += queue.pop() >> 32;
+  });
+
+  phoenix::vector<key> copy;
+  phoenix::bench(name + "/heapify", options).items(count).run([&]() { copy = phoenix::vector<key>(values); }, [&]() {
+    phoenix::priority_queue<key, phoenix::greater_fn, Arity> built(std::move(copy));
+    phoenix::do_not_optimize(built);
+  });
+
+  // Every element gets its priority raised once, then everything is popped
+  phoenix::indexed_priority_queue<key, phoenix::less_fn, Arity> indexed;
+  phoenix::vector<std::size_t> handles(count);
+  phoenix::bench(name + "/decrease_key + pop", options).items(count).run([&]() {
+    indexed.clear();
+    for (std::size_t i = 0; i < count; i++) handles[i] = indexed.push(values[i]);
+  }, [&]() {
+    for (std::size_t i = 0; i < count; i++) indexed.decrease_key(handles[i], indexed.value(handles[i]) / 2);
+    while (!indexed.empty()) indexed.pop();
+  });
+  std::cout << name << " checksum " << checksum << std::endl;
+}
+
+int main(int argc, char** argv) {
+  std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+  std::mt19937_64 gen(42);
+  std::vector<key> values(count);
+  for (auto& v : values) v = gen();
+  std::cout << count << " random 64-bit integers" << std::endl;
+  // Every call handles all elements, a few samples are enough
+  phoenix::bench_options options;
+  options.samples = 5;
+
+  run<2>(values, options);
+  run<4>(values, options);
+  run<8>(values, options);
+
+  std::priority_queue<key> queue;
+  auto reset = [&]() { queue = std::priority_queue<key>(); };
+  phoenix::bench("std::priority_queue/push", options).items(count).run(reset, [&]() {
+    for (auto v : values) queue.push(v);
+  });
+  key checksum = 0;
+  phoenix::bench("std::priority_queue/pop", options).items(count).run([&]() {
+    queue = std::priority_queue<key>(values.begin(), values.end());
+    checksum = 0;
+  }, [&]() {
+    for (; !queue.empty(); queue.pop()) checksum += queue.top() >> 32;
+  });
+  std::cout << "std::priority_queue checksum " << checksum << std::endl;
+}
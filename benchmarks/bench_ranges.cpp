@@ -0,0 +1,62 @@
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <phoenix/algorithm.hpp>
+#include <phoenix/bench.hpp>
+#include <phoenix/ranges.hpp>
+#include <phoenix/vector.hpp>
+
+// Usage: bench_ranges
+// A four-stage pipeline (map, filter, map, take) over 16M integers, run as a chain of views
+// consumed by to_vector and as separate passes that each build a temporary vector with push().
+// The temporaries grow geometrically, plain push() grows by 16 elements and would be quadratic.
+int main() {
+  std::mt19937 generator(7);
+  const std::size_t size = std::size_t{1} << 24, limit = size / 4;
+  phoenix::vector<std::uint32_t> values(size);
+  for (auto& value : values) value = generator();
+
+  auto scale = [](std::uint32_t x) { return static_cast<std::uint64_t>(x) * 3; };
+  auto even = [](std::uint64_t x) { return x % 2 == 0; };
+  auto offset = [](std::uint64_t x) { return x + 17; };
+
+  phoenix::vector<std::uint64_t> fused, passes;
+  phoenix::bench("pipeline/views").items(size).run([&]() {
+    fused = values | phoenix::views::map(scale) | phoenix::views::filter(even) | phoenix::views::map(offset) |
+            phoenix::views::take(limit) | phoenix::to_vector();
+  });
+  auto append = [](phoenix::vector<std::uint64_t>& vector, std::uint64_t x) {
+    phoenix::detail::grow(vector, vector.size() + 1);
+    vector.push(x);
+  };
+  phoenix::bench("pipeline/separate passes").items(size).run([&]() {
+    phoenix::vector<std::uint64_t> scaled, filtered, shifted, result;
+    for (auto x : values) append(scaled, scale(x));
+    for (auto x : scaled) {
+      if (even(x)) append(filtered, x);
+    }
+    for (auto x : filtered) append(shifted, offset(x));
+    for (std::size_t i = 0; i < limit && i < shifted.size(); i++) append(result, shifted[i]);
+    passes.swap(result);
+  });
+  if (fused.size() != passes.size() || !phoenix::equal(fused.begin(), fused.end(), passes.begin()))
+    std::cout << "pipeline [OUTPUT INVALID]" << std::endl;
+
+  std::uint64_t iterated = 0, pushed = 0, expected = 0;
+  auto view = values | phoenix::views::map(scale) | phoenix::views::filter(even);
+  phoenix::bench("view sum/range-for").items(size).run([&]() {
+    iterated = 0;
+    for (auto x : view) iterated += x;
+  });
+  phoenix::bench("view sum/for_each").items(size).run([&]() {
+    pushed = 0;
+    phoenix::for_each(view, [&pushed](std::uint64_t x) { pushed += x; });
+  });
+  phoenix::bench("view sum/hand-written loop").items(size).run([&]() {
+    expected = 0;
+    for (auto x : values) {
+      if (even(scale(x))) expected += scale(x);
+    }
+  });
+  if (iterated != expected || pushed != expected) std::cout << "view sum [OUTPUT INVALID]" << std::endl;
+}
@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <phoenix/bench.hpp>
+#include <phoenix/search.hpp>
+
+// Usage: bench_sorted_index [max keys] [queries]
+// Random lookups of 32-bit keys in std::lower_bound, phoenix::lower_bound and sorted_index,
+// for 10^6 keys up to max keys (10^8 by default, 10^9 needs about 8 GB of memory).
+using key = std::uint32_t;
+
+void check(const std::string& name, std::uint64_t checksum, std::uint64_t expected) {
+  if (checksum != expected) std::cout << name << " [OUTPUT INVALID]" << std::endl;
+}
+
+void run(std::size_t count, std::size_t query_count) {
+  std::mt19937 gen(42);
+  std::vector<key> keys(count);
+  for (auto& k : keys) k = static_cast<key>(gen());
+  std::sort(keys.begin(), keys.end());
+  std::vector<key> queries(query_count);
+  for (auto& q : queries) q = static_cast<key>(gen());
+
+  std::string suffix = "/" + std::to_string(count);
+  std::uint64_t expected = 0;
+  phoenix::bench("std::lower_bound" + suffix).items(query_count).run([&]() {
+    expected = 0;
+    for (auto q : queries) expected += static_cast<std::uint64_t>(std::lower_bound(keys.begin(), keys.end(), q) - keys.begin());
+  });
+
+  std::uint64_t checksum = 0;
+  phoenix::bench("phoenix::lower_bound" + suffix).items(query_count).run([&]() {
+    checksum = 0;
+    for (auto q : queries) checksum += static_cast<std::uint64_t>(phoenix::lower_bound(keys.data(), keys.data() + count, q) - keys.data());
+  });
+  check("phoenix::lower_bound" + suffix, checksum, expected);
+
+  phoenix::sorted_index<key> index(keys.begin(), keys.end());
+  keys = std::vector<key>();
+
+  phoenix::bench("sorted_index::lower_bound" + suffix).items(query_count).run([&]() {
+    checksum = 0;
+    for (auto q : queries) checksum += index.lower_bound(q);
+  });
+  check("sorted_index::lower_bound" + suffix, checksum, expected);
+
+  std::vector<std::size_t> ranks(query_count);
+  phoenix::bench("sorted_index::lower_bounds" + suffix).items(query_count).run([&]() {
+    index.lower_bounds(queries.begin(), queries.end(), ranks.begin());
+  });
+  checksum = 0;
+  for (auto r : ranks) checksum += r;
+  check("sorted_index::lower_bounds" + suffix, checksum, expected);
+}
+
+int main(int argc, char** argv) {
+  std::size_t max_count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000000;
+  std::size_t query_count = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+  for (std::size_t count = 1000000; count <= max_count; count *= 10) run(count, query_count);
+}
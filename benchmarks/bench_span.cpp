@@ -0,0 +1,70 @@
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <phoenix/algorithm.hpp>
+#include <phoenix/bench.hpp>
+#include <phoenix/sort.hpp>
+#include <phoenix/span.hpp>
+#include <phoenix/utility.hpp>
+#include <phoenix/vector.hpp>
+
+// Usage: bench_span
+// Summing 4096-element windows of a 16M element vector through span slices compared with copying
+// each window into its own vector, and sorting a column of a 4096x64 row-major matrix in place
+// through strided_span compared with copying it out, sorting and copying it back.
+std::uint64_t window_sum(phoenix::span<const std::uint32_t> window) {
+  std::uint64_t total = 0;
+  for (auto value : window) total += value;
+  return total;
+}
+
+int main() {
+  std::mt19937 generator(7);
+  const std::size_t size = std::size_t{1} << 24, window = 4096;
+  phoenix::vector<std::uint32_t> values(size);
+  for (auto& value : values) value = generator() % 1000;
+
+  std::uint64_t sliced = 0, copied = 0;
+  phoenix::bench("window sums/span").items(size).run([&]() {
+    sliced = 0;
+    phoenix::span<const std::uint32_t> all(values);
+    for (std::size_t offset = 0; offset < size; offset += window) sliced += window_sum(all.subspan(offset, window));
+  });
+  phoenix::bench("window sums/copy").items(size).run([&]() {
+    copied = 0;
+    for (std::size_t offset = 0; offset < size; offset += window) {
+      phoenix::vector<std::uint32_t> part(window);
+      for (std::size_t i = 0; i < window; i++) part[i] = values[offset + i];
+      copied += window_sum(part);
+    }
+  });
+  if (sliced != copied) std::cout << "window sums [OUTPUT INVALID]" << std::endl;
+
+  // Both matrices are restored from the same unsorted cells before every call
+  const std::size_t rows = 4096, columns = 64;
+  phoenix::vector<std::uint32_t> original(rows * columns), first, second;
+  for (auto& cell : original) cell = generator();
+
+  phoenix::bench("column sort/strided_span").items(rows * columns).run([&]() { first = original; }, [&]() {
+    phoenix::span<std::uint32_t> cells(first);
+    for (std::size_t c = 0; c < columns; c++) {
+      auto column = phoenix::column(cells, columns, c);
+      phoenix::sort(column.begin(), column.end());
+    }
+  });
+  phoenix::vector<std::uint32_t> buffer(rows);
+  phoenix::bench("column sort/copy out and back").items(rows * columns).run([&]() { second = original; }, [&]() {
+    for (std::size_t c = 0; c < columns; c++) {
+      for (std::size_t r = 0; r < rows; r++) buffer[r] = second[r * columns + c];
+      phoenix::sort(buffer.begin(), buffer.end());
+      for (std::size_t r = 0; r < rows; r++) second[r * columns + c] = buffer[r];
+    }
+  });
+  bool valid = phoenix::equal(first.begin(), first.end(), second.begin());
+  phoenix::span<std::uint32_t> second_cells(second);
+  for (std::size_t c = 0; c < columns; c++) {
+    auto column = phoenix::column(second_cells, columns, c);
+    valid &= phoenix::is_sorted(column.begin(), column.end());
+  }
+  if (!valid) std::cout << "column sort [OUTPUT INVALID]" << std::endl;
+}
@@ -0,0 +1,116 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <phoenix/bench.hpp>
+#include <phoenix/cpu.hpp>
+#include <phoenix/spsc_queue.hpp>
+
+// Usage: bench_spsc_queue [messages]
+// Throughput of single and batched transfers of 64-bit messages from a producer to a consumer,
+// and round-trip latency of a ping-pong between two queues. The threads are pinned to cores 0
+// and 1, with one available core both run on it and yield instead of spinning.
+using message = std::uint64_t;
+constexpr std::size_t capacity = 4096;
+
+phoenix::spsc_queue<message, capacity> forward_queue;
+phoenix::spsc_queue<message, capacity> backward_queue;
+
+unsigned consumer_core() { return phoenix::cpu::available_cores() > 1 ? 1 : 0; }
+
+// Waiting without yielding would only burn the time slice of the other thread on a single core
+void wait() {
+  static const bool spin = phoenix::cpu::available_cores() > 1;
+  if (spin) {
+  #ifdef PHOSTDLIB_X86_SIMD
+    _mm_pause();
+  #endif
+  } else {
+    std::this_thread::yield();
+  }
+}
+
+// Runs producer on the current thread and consumer on a second one
+template <typename Producer, typename Consumer>
+void run_pair(Producer producer, Consumer consumer) {
+  std::thread other([&]() {
+    phoenix::cpu::pin_current_thread(consumer_core());
+    consumer();
+  });
+  producer();
+  other.join();
+}
+
+void throughput(message count, std::size_t batch, const phoenix::bench_options& options) {
+  message sum = 0;
+  std::string name = "spsc_queue/batch " + std::to_string(batch);
+  phoenix::bench(name, options).items(count).run([&]() {
+    sum = 0;
+    run_pair(
+        [&]() {
+          message values[capacity];
+          for (message next = 0; next < count;) {
+            if (batch == 1) {
+              if (forward_queue.try_push(next)) next++;
+              else wait();
+              continue;
+            }
+            std::size_t length = 0;
+            for (; length < batch && next + length < count; length++) values[length] = next + length;
+            std::size_t pushed = forward_queue.push_n(values, length);
+            if (pushed == 0) wait();
+            next += pushed;
+          }
+        },
+        [&]() {
+          message values[capacity];
+          for (message received = 0; received < count;) {
+            std::size_t popped = batch == 1 ? forward_queue.try_pop(values[0]) : forward_queue.pop_n(values, batch);
+            if (popped == 0) wait();
+            for (std::size_t i = 0; i < popped; i++) sum += values[i];
+            received += popped;
+          }
+        });
+  });
+  if (sum != count * (count - 1) / 2) std::cout << name << " [OUTPUT INVALID]" << std::endl;
+}
+
+// Every message goes there and back before the next one is sent
+void latency(message count, const phoenix::bench_options& options) {
+  bool valid = true;
+  phoenix::bench("spsc_queue/round trip", options).items(count).run([&]() {
+    run_pair(
+        [&]() {
+          message reply;
+          for (message i = 0; i < count; i++) {
+            while (!forward_queue.try_push(i)) wait();
+            while (!backward_queue.try_pop(reply)) wait();
+            valid &= reply == i;
+          }
+        },
+        [&]() {
+          message value;
+          for (message i = 0; i < count; i++) {
+            while (!forward_queue.try_pop(value)) wait();
+            while (!backward_queue.try_push(value)) wait();
+          }
+        });
+  });
+  if (!valid) std::cout << "spsc_queue/round trip [OUTPUT INVALID]" << std::endl;
+}
+
+int main(int argc, char** argv) {
+  message count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+  bool pinned = phoenix::cpu::pin_current_thread(0);
+  std::cout << count << " messages, queue capacity " << capacity << ", "
+            << (pinned ? "producer pinned to core 0, consumer to core " + std::to_string(consumer_core())
+                       : std::string("threads not pinned"))
+            << std::endl;
+  // Every call sends all messages, a few samples are enough
+  phoenix::bench_options options;
+  options.samples = 5;
+
+  for (std::size_t batch : {1, 16, 256}) throughput(count, batch, options);
+  latency(count / 100 > 0 ? count / 100 : 1, options);
+}
@@ -0,0 +1,76 @@
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <phoenix/bench.hpp>
+#include <phoenix/hash.hpp>
+#include <phoenix/hash_map.hpp>
+#include <phoenix/sort.hpp>
+#include <phoenix/string.hpp>
+#include <phoenix/vector.hpp>
+
+// Usage: bench_string
+// One million short identifiers stored as phoenix::string, std::string and phoenix::vector<char>,
+// sorted and inserted into a hash_map, and substring search in 16 MB of text compared with
+// std::string::find.
+template <typename String>
+void identifiers(const std::string& name, const phoenix::vector<std::string>& sources,
+                 const phoenix::bench_options& options) {
+  std::size_t count = sources.size();
+  phoenix::vector<String> built(count), strings;
+  phoenix::bench(name + "/build", options).items(count).run([&]() {
+    for (std::size_t i = 0; i < count; i++) built[i] = String(sources[i].c_str());
+  });
+  phoenix::bench(name + "/sort", options).items(count).run([&]() { strings = built; }, [&]() {
+    phoenix::sort(strings.begin(), strings.end(), phoenix::less_fn{});
+  });
+  phoenix::hash_map<String, int> map;
+  auto reset = [&]() { map = phoenix::hash_map<String, int>(); };
+  phoenix::bench(name + "/hash_map insert", options).items(count).run(reset, [&]() {
+    for (std::size_t i = 0; i < count; i++) map.insert(strings[i], static_cast<int>(i));
+  });
+  bool valid = map.size() <= count;
+  for (std::size_t i = 1; i < count; i++) valid &= !(strings[i - 1] < strings[i]);
+  if (!valid) std::cout << name << " [OUTPUT INVALID]" << std::endl;
+}
+
+int main() {
+  std::mt19937_64 generator(7);
+  phoenix::vector<std::string> sources(1000000);
+  for (auto& source : sources) {
+    std::size_t length = 4 + generator() % 16;
+    source = "id_";
+    for (std::size_t i = 0; i < length; i++) source += static_cast<char>('a' + generator() % 26);
+  }
+  std::cout << sources.size() << " identifiers of 7 to 22 characters" << std::endl;
+  // Every call handles all identifiers, a few samples are enough
+  phoenix::bench_options options;
+  options.samples = 5;
+  identifiers<phoenix::string>("phoenix::string", sources, options);
+  identifiers<std::string>("std::string", sources, options);
+  phoenix::bench("phoenix::vector<char>/build", options).items(sources.size()).run([&]() {
+    phoenix::vector<phoenix::vector<char>> chars(sources.size());
+    for (std::size_t i = 0; i < sources.size(); i++) {
+      for (char c : sources[i]) chars[i].push(c);
+    }
+    phoenix::do_not_optimize(chars);
+  });
+
+  std::string text;
+  while (text.size() < (std::size_t{1} << 24)) text += sources[text.size() % sources.size()] + " ";
+  phoenix::string phoenix_text(text);
+  for (std::string needle : {std::string("zq"), std::string("id_zzzz"), std::string("not present in the text")}) {
+    std::size_t expected = 0, found = 0;
+    phoenix::bench("std::string/find \"" + needle + "\"").bytes(text.size()).run([&]() {
+      expected = 0;
+      for (std::size_t at = text.find(needle); at != std::string::npos; at = text.find(needle, at + 1)) expected++;
+    });
+    phoenix::bench("phoenix::string/find \"" + needle + "\"").bytes(text.size()).run([&]() {
+      found = 0;
+      for (std::size_t at = phoenix_text.find(needle); at != phoenix::npos; at = phoenix_text.find(needle, at + 1)) {
+        found++;
+      }
+    });
+    if (found != expected) std::cout << "find \"" << needle << "\" [OUTPUT INVALID]" << std::endl;
+  }
+}
@@ -0,0 +1,92 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <phoenix/bench.hpp>
+#include <phoenix/cpu.hpp>
+#include <phoenix/thread_pool.hpp>
+#include <phoenix/vector.hpp>
+
+// Usage: bench_thread_pool [threads]
+// Scheduling overhead of the work-stealing pool: empty tasks spawned from outside and inside the
+// pool, recursive fork/join, 10 us tasks compared with running them on one thread, and
+// parallel_for over 10^7 elements with different grain sizes.
+void spin(double seconds) {
+  auto end = std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds);
+  while (std::chrono::steady_clock::now() < end) {}
+}
+
+long fibonacci(phoenix::thread_pool& pool, int n) {
+  if (n < 2) return n;
+  long a = 0;
+  phoenix::task_group group(pool);
+  group.run([&]() { a = fibonacci(pool, n - 1); });
+  long b = fibonacci(pool, n - 2);
+  group.wait();
+  return a + b;
+}
+
+long serial_fibonacci(int n) { return n < 2 ? n : serial_fibonacci(n - 1) + serial_fibonacci(n - 2); }
+
+int main(int argc, char** argv) {
+  unsigned cores = phoenix::cpu::available_cores();
+  unsigned threads = argc > 1 ? static_cast<unsigned>(std::strtoul(argv[1], nullptr, 10)) : cores;
+  phoenix::thread_pool pool(threads);
+  std::cout << pool.size() << " workers, " << cores << " cores" << std::endl;
+
+  constexpr int empty_tasks = 200000;
+  std::atomic<int> counter{0};
+  bool valid = true;
+  phoenix::bench("empty tasks/spawned from outside").items(empty_tasks).run([&]() {
+    counter = 0;
+    phoenix::task_group group(pool);
+    for (int i = 0; i < empty_tasks; i++) group.run([&counter]() { counter++; });
+    group.wait();
+    valid &= counter.load() == empty_tasks;
+  });
+  phoenix::bench("empty tasks/spawned from a worker").items(empty_tasks).run([&]() {
+    counter = 0;
+    phoenix::task_group outer(pool);
+    outer.run([&]() {
+      phoenix::task_group group(pool);
+      for (int i = 0; i < empty_tasks; i++) group.run([&counter]() { counter++; });
+      group.wait();
+    });
+    outer.wait();
+    valid &= counter.load() == empty_tasks;
+  });
+  if (!valid) std::cout << "empty tasks [OUTPUT INVALID]" << std::endl;
+
+  // fibonacci(25) makes 242785 calls, every one but the leaves forks a task
+  long result = 0, expected = 0;
+  phoenix::bench("fibonacci(25)/fork-join").items(242785).run([&]() { result = fibonacci(pool, 25); });
+  phoenix::bench("fibonacci(25)/serial").items(242785).run([&]() { expected = serial_fibonacci(25); });
+  if (result != expected) std::cout << "fibonacci(25) [OUTPUT INVALID]" << std::endl;
+
+  // Ideal time is tasks * 10 us / parallelism
+  constexpr int tasks = 4000;
+  constexpr double task_length = 10e-6;
+  phoenix::bench("10 us tasks").items(tasks).run([&]() {
+    phoenix::task_group group(pool);
+    for (int i = 0; i < tasks; i++) group.run([]() { spin(task_length); });
+    group.wait();
+  });
+  double ideal = tasks * task_length / static_cast<double>(pool.size() < cores ? pool.size() : cores);
+  std::cout << "10 us tasks: ideal " << ideal * 1e3 << " ms" << std::endl;
+
+  phoenix::vector<std::uint64_t> values(10000000);
+  using iterator = phoenix::vector<std::uint64_t>::iterator;
+  for (std::size_t grain : {1000, 10000, 100000, 1000000}) {
+    phoenix::bench("parallel_for/grain " + std::to_string(grain)).items(values.size()).run([&]() {
+      phoenix::parallel_for(pool, values.begin(), values.end(), grain, [](iterator first, iterator last) {
+        for (; first != last; ++first) *first += 3;
+      });
+    });
+  }
+  // Every call adds 3 to every element
+  valid = values[0] > 0 && values[0] % 3 == 0;
+  for (auto v : values) valid &= v == values[0];
+  if (!valid) std::cout << "parallel_for [OUTPUT INVALID]" << std::endl;
+}
@@ -0,0 +1,176 @@
+#ifndef PHOSTDLIB_ALGORITHM_HPP
+#define PHOSTDLIB_ALGORITHM_HPP
+#include <phoenix/iterator_flag.hpp>
+#include <phoenix/utility.hpp>
+#include <phoenix/detail/simd_search.hpp>
+#include <cstddef>
+#include <type_traits>
+
+// Searches and reductions. Contiguous ranges of integers, float and double (phoenix::vector,
+// phoenix::array, raw pointers) are processed with SSE2 or AVX2 when the CPU supports them,
+// everything else goes through the generic iterator loops.
+namespace phoenix {
+  namespace detail {
+    template <typename Iterator>
+    using value_type_of = typename std::remove_cv<
+        typename std::remove_reference<decltype(*std::declval<Iterator&>())>::type>::type;
+
+    // Searched value has to be of the element type, so that comparisons mean the same in vectors
+    template <typename Iterator, typename T>
+    struct use_simd_value : std::integral_constant<bool, is_contiguous<Iterator>::value &&
+        simd_search::is_key<value_type_of<Iterator>>::value && std::is_same<value_type_of<Iterator>, T>::value> {};
+
+    template <typename InputIterator, typename T>
+    InputIterator find(InputIterator begin, InputIterator end, const T& value, std::false_type) {
+      for (; begin != end; ++begin) {
+        if (*begin == value) break;
+      }
+      return begin;
+    }
+
+    template <typename InputIterator, typename T>
+    InputIterator find(InputIterator begin, InputIterator end, const T& value, std::true_type) {
+      std::size_t index;
+      if (simd_search::find(to_pointer(begin), detail::distance(begin, end), value, index)) return begin + index;
+      return detail::find(begin, end, value, std::false_type{});
+    }
+
+    template <typename InputIterator, typename T>
+    std::size_t count(InputIterator begin, InputIterator end, const T& value, std::false_type) {
+      std::size_t total = 0;
+      for (; begin != end; ++begin) {
+        if (*begin == value) total++;
+      }
+      return total;
+    }
+
+    template <typename InputIterator, typename T>
+    std::size_t count(InputIterator begin, InputIterator end, const T& value, std::true_type) {
+      std::size_t total;
+      if (simd_search::count(to_pointer(begin), detail::distance(begin, end), value, total)) return total;
+      return detail::count(begin, end, value, std::false_type{});
+    }
+
+    template <typename InputIterator, typename T>
+    T accumulate(InputIterator begin, InputIterator end, T init, std::false_type) {
+      for (; begin != end; ++begin) init = init + *begin;
+      return init;
+    }
+
+    template <typename InputIterator, typename T>
+    T accumulate(InputIterator begin, InputIterator end, T init, std::true_type) {
+      T sum;
+      if (simd_search::accumulate(to_pointer(begin), detail::distance(begin, end), init, sum)) return sum;
+      return detail::accumulate(begin, end, init, std::false_type{});
+    }
+
+    template <typename InputIterator1, typename InputIterator2, typename BinaryPredicate>
+    bool equal(InputIterator1 begin1, InputIterator1 end1, InputIterator2 begin2, BinaryPredicate predicate,
+               std::false_type) {
+      for (; begin1 != end1; ++begin1, ++begin2) {
+        if (!predicate(*begin1, *begin2)) return false;
+      }
+      return true;
+    }
+
+    template <typename InputIterator1, typename InputIterator2, typename BinaryPredicate>
+    bool equal(InputIterator1 begin1, InputIterator1 end1, InputIterator2 begin2, BinaryPredicate predicate,
+               std::true_type) {
+      bool result;
+      if (simd_search::equal(to_pointer(begin1), to_pointer(begin2), detail::distance(begin1, end1), result))
+        return result;
+      return detail::equal(begin1, end1, begin2, predicate, std::false_type{});
+    }
+
+    template <typename Iterator1, typename Iterator2, typename BinaryPredicate>
+    struct use_simd_equal : std::integral_constant<bool, is_contiguous<Iterator1>::value &&
+        is_contiguous<Iterator2>::value && simd_search::is_key<value_type_of<Iterator1>>::value &&
+        std::is_same<value_type_of<Iterator1>, value_type_of<Iterator2>>::value &&
+        std::is_same<typename std::decay<BinaryPredicate>::type, equal_fn>::value> {};
+
+    // First smallest and first biggest element, either of them can be skipped
+    template <bool Min, bool Max, typename ForwardIterator, typename Compare>
+    pair<ForwardIterator, ForwardIterator> extremes(ForwardIterator begin, ForwardIterator end, Compare compare,
+                                                    std::false_type) {
+      pair<ForwardIterator, ForwardIterator> result{begin, begin};
+      if (begin == end) return result;
+      for (auto it = begin; ++it != end;) {
+        if (Min && compare(*result.first, *it)) result.first = it;
+        if (Max && compare(*it, *result.second)) result.second = it;
+      }
+      return result;
+    }
+
+    template <bool Min, bool Max, typename ForwardIterator, typename Compare>
+    pair<ForwardIterator, ForwardIterator> extremes(ForwardIterator begin, ForwardIterator end, Compare compare,
+                                                    std::true_type) {
+      // Under descending order the smallest element is the biggest number
+      constexpr bool descending = natural_order<Compare>::value < 0;
+      std::size_t low = 0, high = 0;
+      bool handled = simd_search::extreme_indices<descending ? Max : Min, descending ? Min : Max>(
+          to_pointer(begin), detail::distance(begin, end), low, high);
+      if (!handled) return extremes<Min, Max>(begin, end, compare, std::false_type{});
+      if (descending) return pair<ForwardIterator, ForwardIterator>{begin + high, begin + low};
+      return pair<ForwardIterator, ForwardIterator>{begin + low, begin + high};
+    }
+  }
+
+  template <typename InputIterator, typename T>
+  InputIterator find(InputIterator begin, InputIterator end, const T& value) {
+    return detail::find(begin, end, value,
+                        std::integral_constant<bool, detail::use_simd_value<InputIterator, T>::value>{});
+  }
+
+  template <typename InputIterator, typename T>
+  std::size_t count(InputIterator begin, InputIterator end, const T& value) {
+    return detail::count(begin, end, value,
+                         std::integral_constant<bool, detail::use_simd_value<InputIterator, T>::value>{});
+  }
+
+  // Integer sums wrap around in the element type. Floating-point sums of contiguous ranges add up
+  // fixed partial sums separately, so they can differ from a sequential sum by rounding, but
+  // they are the same on every instruction set.
+  template <typename InputIterator, typename T>
+  T accumulate(InputIterator begin, InputIterator end, T init) {
+    return detail::accumulate(begin, end, init,
+                              std::integral_constant<bool, detail::use_simd_value<InputIterator, T>::value>{});
+  }
+
+  template <typename InputIterator, typename T, typename BinaryOperation>
+  T accumulate(InputIterator begin, InputIterator end, T init, BinaryOperation operation) {
+    for (; begin != end; ++begin) init = operation(init, *begin);
+    return init;
+  }
+
+  // The second range must be at least as long as the first one
+  template <typename InputIterator1, typename InputIterator2, typename BinaryPredicate = equal_fn>
+  bool equal(InputIterator1 begin1, InputIterator1 end1, InputIterator2 begin2,
+             BinaryPredicate predicate = BinaryPredicate{}) {
+    return detail::equal(begin1, end1, begin2, predicate,
+        std::integral_constant<bool, detail::use_simd_equal<InputIterator1, InputIterator2, BinaryPredicate>::value>{});
+  }
+
+  // First smallest element, end for empty ranges
+  template <typename ForwardIterator, typename Compare = greater_fn>
+  ForwardIterator min_element(ForwardIterator begin, ForwardIterator end, Compare compare = Compare{}) {
+    return detail::extremes<true, false>(begin, end, compare,
+        std::integral_constant<bool, detail::use_simd_search<ForwardIterator, Compare>::value>{}).first;
+  }
+
+  // First biggest element, end for empty ranges
+  template <typename ForwardIterator, typename Compare = greater_fn>
+  ForwardIterator max_element(ForwardIterator begin, ForwardIterator end, Compare compare = Compare{}) {
+    return detail::extremes<false, true>(begin, end, compare,
+        std::integral_constant<bool, detail::use_simd_search<ForwardIterator, Compare>::value>{}).second;
+  }
+
+  // First smallest and first biggest element in a single pass
+  template <typename ForwardIterator, typename Compare = greater_fn>
+  pair<ForwardIterator, ForwardIterator> minmax_element(ForwardIterator begin, ForwardIterator end,
+                                                        Compare compare = Compare{}) {
+    return detail::extremes<true, true>(begin, end, compare,
+        std::integral_constant<bool, detail::use_simd_search<ForwardIterator, Compare>::value>{});
+  }
+}
+
+#endif //PHOSTDLIB_ALGORITHM_HPP
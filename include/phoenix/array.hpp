@@ -24,16 +24,18 @@ namespace phoenix {
     class iterator {
     public:
       using self = iterator;
-      static constexpr auto iterator_type = iterator_flag::random_access;
-
-      using value_type = value_type;
-      using reference = reference;
-      using pointer = pointer;
-      using const_reference = const_reference;
-      using const_pointer = const_pointer;
-      using difference_type = difference_type;
-      using size_type = size_type;
-
+      static constexpr auto iterator_type = iterator_flag::contiguous;
+
+      using iterator_category = detail::std_category<iterator_type>;
+      using value_type = T;
+      using reference = T&;
+      using const_reference = const T&;
+      using pointer = T*;
+      using const_pointer = const T*;
+      using difference_type = std::ptrdiff_t;
+      using size_type = std::size_t;
+
+      iterator() : _ptr{nullptr} {}
       explicit iterator(pointer e) : _ptr{e} {}
 
       self& operator++() {
@@ -58,14 +60,18 @@ namespace phoenix {
         return t;
       }
 
-      reference operator*() {
+      reference operator*() const {
         return *_ptr;
       }
 
-      pointer operator->() {
+      pointer operator->() const {
         return _ptr;
       }
 
+      reference operator[](difference_type x) const {
+        return _ptr[x];
+      }
+
       bool operator==(const self& other) const {
         return _ptr == other._ptr;
       }
@@ -74,14 +80,27 @@ namespace phoenix {
         return _ptr != other._ptr;
       }
 
-      self operator+(difference_type x) {
+      bool operator<(const self& other) const { return _ptr < other._ptr; }
+      bool operator>(const self& other) const { return _ptr > other._ptr; }
+      bool operator<=(const self& other) const { return _ptr <= other._ptr; }
+      bool operator>=(const self& other) const { return _ptr >= other._ptr; }
+
+      self operator+(difference_type x) const {
         return self(_ptr + x);
       }
 
-      self operator-(difference_type x) {
+      self operator-(difference_type x) const {
         return self(_ptr - x);
       }
 
+      difference_type operator-(const self& other) const {
+        return _ptr - other._ptr;
+      }
+
+      friend self operator+(difference_type x, const self& it) {
+        return it + x;
+      }
+
       self& operator+=(difference_type x) {
         _ptr += x;
         return *this;
@@ -103,15 +122,22 @@ namespace phoenix {
     class const_iterator {
     public:
       using self = const_iterator;
-      static constexpr auto iterator_type = iterator_flag::random_access;
+      static constexpr auto iterator_type = iterator_flag::contiguous;
+
+      using iterator_category = detail::std_category<iterator_type>;
+      using value_type = T;
+      using reference = const T&;
+      using const_reference = const T&;
+      using pointer = const T*;
+      using const_pointer = const T*;
+      using difference_type = std::ptrdiff_t;
+      using size_type = std::size_t;
 
-      using value_type = value_type;
-      using const_reference = const_reference;
-      using const_pointer = const_pointer;
-      using difference_type = difference_type;
-      using size_type = size_type;
+      const_iterator() : _ptr{nullptr} {}
+      explicit const_iterator(pointer e) : _ptr{e} {}
 
-      explicit const_iterator(const_pointer e) : _ptr{e} {}
+      // Iterators can be used where const iterators are expected
+      const_iterator(const iterator& it) : _ptr{detail::to_pointer(it)} {}
 
       self& operator++() {
         _ptr++;
@@ -135,14 +161,18 @@ namespace phoenix {
         return t;
       }
 
-      const_reference operator*() const {
+      reference operator*() const {
         return *_ptr;
       }
 
-      const_pointer operator->() const {
+      pointer operator->() const {
         return _ptr;
       }
 
+      reference operator[](difference_type x) const {
+        return _ptr[x];
+      }
+
       bool operator==(const self& other) const {
         return _ptr == other._ptr;
       }
@@ -151,14 +181,27 @@ namespace phoenix {
         return _ptr != other._ptr;
       }
 
-      self operator+(difference_type x) {
+      bool operator<(const self& other) const { return _ptr < other._ptr; }
+      bool operator>(const self& other) const { return _ptr > other._ptr; }
+      bool operator<=(const self& other) const { return _ptr <= other._ptr; }
+      bool operator>=(const self& other) const { return _ptr >= other._ptr; }
+
+      self operator+(difference_type x) const {
         return self(_ptr + x);
       }
 
-      self operator-(difference_type x) {
+      self operator-(difference_type x) const {
         return self(_ptr - x);
       }
 
+      difference_type operator-(const self& other) const {
+        return _ptr - other._ptr;
+      }
+
+      friend self operator+(difference_type x, const self& it) {
+        return it + x;
+      }
+
       self& operator+=(difference_type x) {
         _ptr += x;
         return *this;
@@ -214,18 +257,15 @@ namespace phoenix {
     #endif
 
     array(const array<value_type, N>& other) : _data{} {
-      auto* i = _data;
-      for (const auto& x : other) *(i++) = x;
+      detail::copy(other._data, other._data + N, _data);
     }
 
     explicit array(const std::array<value_type, N>& other) : _data{} {
-      auto* i = _data;
-      for (const auto& x : other) *(i++) = x;
+      detail::copy(other.data(), other.data() + N, _data);
     }
 
     array<value_type, N>& operator=(const array<value_type, N>& other) {
-      auto* i = _data;
-      for (const auto& x : other) *(i++) = x;
+      detail::copy(other._data, other._data + N, _data);
       return *this;
     }
 
@@ -0,0 +1,416 @@
+#ifndef PHOSTDLIB_BENCH_HPP
+#define PHOSTDLIB_BENCH_HPP
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <initializer_list>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+#ifdef __linux__
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Microbenchmark harness. Kept apart from test.hpp, so that tests don't get the system headers
+// of perf_counters (and names like access() or read() along with them).
+namespace phoenix {
+  // Compiler barriers of benchmarks: do_not_optimize makes the value (and the memory it points to)
+  // observable, so computations of it aren't removed, clobber_memory forces pending writes to memory.
+  template <typename T>
+  inline void do_not_optimize(const T& value) {
+    #if defined(__GNUC__)
+    __asm__ __volatile__("" : : "r,m"(value) : "memory");
+    #else
+    static const volatile void* sink;
+    sink = &value;
+    #endif
+  }
+
+  // Integers and pointers may stay in a general-purpose register, other values are kept in memory.
+  // GCC doesn't write a floating-point value back when it is given a general-purpose register.
+  namespace detail {
+    template <typename T>
+    using register_value = std::integral_constant<bool, std::is_trivially_copyable<T>::value &&
+        sizeof(T) <= sizeof(void*) && !std::is_floating_point<T>::value>;
+  }
+
+  template <typename T>
+  inline typename std::enable_if<detail::register_value<T>::value>::type
+  do_not_optimize(T& value) {
+    #if defined(__GNUC__)
+    __asm__ __volatile__("" : "+m,r"(value) : : "memory");
+    #else
+    static volatile void* sink;
+    sink = &value;
+    #endif
+  }
+
+  template <typename T>
+  inline typename std::enable_if<!detail::register_value<T>::value>::type
+  do_not_optimize(T& value) {
+    #if defined(__GNUC__)
+    __asm__ __volatile__("" : "+m"(value) : : "memory");
+    #else
+    static volatile void* sink;
+    sink = &value;
+    #endif
+  }
+
+  inline void clobber_memory() {
+    #if defined(__GNUC__)
+    __asm__ __volatile__("" : : : "memory");
+    #else
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    #endif
+  }
+
+  // Hardware and software event counters of the calling thread, read with perf_event_open on Linux.
+  // Only user space is counted, which perf_event_paranoid up to 2 allows to unprivileged processes.
+  // Events that can't be opened (other systems, containers without perf access, CPUs or VMs
+  // without the event) are reported as unavailable, and error() says why.
+  class perf_counters {
+   public:
+    enum event : std::size_t {
+      cycles,
+      instructions,
+      cache_misses,
+      llc_misses,
+      branch_misses,
+      tlb_misses,
+      page_faults,
+      event_count
+    };
+
+    static const char* name(event e) {
+      const char* names[] = {"cycles",        "instructions", "cache misses", "LLC misses",
+                             "branch misses", "TLB misses",   "page faults"};
+      return names[e];
+    }
+
+    // Counters start stopped and at zero
+    perf_counters() : _error{} {
+      _descriptors.fill(-1);
+      #ifdef __linux__
+      for (std::size_t e = 0; e < event_count; e++) open(static_cast<event>(e));
+      #else
+      _error = "hardware counters are only supported on Linux";
+      #endif
+    }
+
+    perf_counters(const perf_counters&) = delete;
+    perf_counters& operator=(const perf_counters&) = delete;
+
+    ~perf_counters() {
+      #ifdef __linux__
+      for (int descriptor : _descriptors) {
+        if (descriptor >= 0) close(descriptor);
+      }
+      #endif
+    }
+
+    bool available(event e) const { return _descriptors[e] >= 0; }
+
+    bool available() const {
+      for (std::size_t e = 0; e < event_count; e++) {
+        if (available(static_cast<event>(e))) return true;
+      }
+      return false;
+    }
+
+    // Why the first unavailable event couldn't be opened, empty if all are available
+    const std::string& error() const { return _error; }
+
+    void start() { control(enable_events); }
+    void stop() { control(disable_events); }
+    void reset() { control(reset_events); }
+
+    // Count since the last reset, negative if the event is unavailable. When there are more events
+    // than hardware counters the kernel multiplexes them, and counts are scaled up to the whole time.
+    double value(event e) const {
+      #ifdef __linux__
+      std::uint64_t values[3];
+      if (!available(e) || read(_descriptors[e], values, sizeof(values)) != sizeof(values)) return -1;
+      if (values[2] == 0) return values[1] == 0 ? 0 : -1;
+      return static_cast<double>(values[0]) * static_cast<double>(values[1]) / static_cast<double>(values[2]);
+      #else
+      (void)e;
+      return -1;
+      #endif
+    }
+
+   private:
+    #ifdef __linux__
+    void open(event e) {
+      perf_event_attr attributes;
+      std::memset(&attributes, 0, sizeof(attributes));
+      attributes.size = sizeof(attributes);
+      attributes.type = PERF_TYPE_HARDWARE;
+      switch (e) {
+        case cycles: attributes.config = PERF_COUNT_HW_CPU_CYCLES; break;
+        case instructions: attributes.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+        case cache_misses: attributes.config = PERF_COUNT_HW_CACHE_MISSES; break;
+        case llc_misses: attributes.config = cache_event(PERF_COUNT_HW_CACHE_LL); break;
+        case branch_misses: attributes.config = PERF_COUNT_HW_BRANCH_MISSES; break;
+        case tlb_misses: attributes.config = cache_event(PERF_COUNT_HW_CACHE_DTLB); break;
+        default: attributes.type = PERF_TYPE_SOFTWARE; attributes.config = PERF_COUNT_SW_PAGE_FAULTS; break;
+      }
+      if (e == llc_misses || e == tlb_misses) attributes.type = PERF_TYPE_HW_CACHE;
+      attributes.disabled = 1;
+      attributes.exclude_kernel = 1;
+      attributes.exclude_hv = 1;
+      attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+      long descriptor = syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+      if (descriptor >= 0) {
+        _descriptors[e] = static_cast<int>(descriptor);
+      } else if (_error.empty()) {
+        _error = std::string(name(e)) + ": perf_event_open failed: " + std::strerror(errno);
+        if (errno == EACCES || errno == EPERM) _error += " (see /proc/sys/kernel/perf_event_paranoid)";
+        if (errno == ENOENT || errno == EOPNOTSUPP) _error += " (the CPU or VM doesn't provide it)";
+      }
+    }
+
+    static std::uint64_t cache_event(std::uint64_t cache) {
+      return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+
+    #endif
+
+    enum command { enable_events, disable_events, reset_events };
+
+    void control(command c) {
+      #ifdef __linux__
+      const unsigned long requests[] = {PERF_EVENT_IOC_ENABLE, PERF_EVENT_IOC_DISABLE, PERF_EVENT_IOC_RESET};
+      for (int descriptor : _descriptors) {
+        if (descriptor >= 0) ioctl(descriptor, requests[c], 0);
+      }
+      #else
+      (void)c;
+      #endif
+    }
+
+    std::array<int, event_count> _descriptors;
+    std::string _error;
+  };
+
+  struct bench_options {
+    // Timed samples, each repeating the function for at least sample_seconds
+    std::size_t samples = 20;
+    double sample_seconds = 0.005;
+    // Untimed runs before the samples, after the iteration count is calibrated
+    double warmup_seconds = 0.01;
+    // Where results are printed, nowhere if null
+    std::ostream* output = &std::cout;
+    // Collect perf_counters events during the timed samples
+    bool counters = false;
+  };
+
+  // Seconds per iteration over the samples
+  struct bench_result {
+    std::string name;
+    std::size_t iterations;
+    std::size_t samples;
+    double min, median, p99, mean, stddev;
+    // Zero unless items() or bytes() were given
+    double items_per_second, bytes_per_second;
+    // Events per iteration, indexed by perf_counters::event, negative when not counted
+    std::array<double, perf_counters::event_count> counters;
+
+    double counter(perf_counters::event e) const { return counters[e]; }
+
+    // Instructions per cycle, negative when either isn't counted
+    double ipc() const {
+      double cycles = counter(perf_counters::cycles), instructions = counter(perf_counters::instructions);
+      return cycles > 0 && instructions >= 0 ? instructions / cycles : -1;
+    }
+
+    std::ostream& print(std::ostream& os) const {
+      os << name << ": " << time(median) << " median (min " << time(min) << ", p99 " << time(p99) << ", stddev "
+         << time(stddev) << "), " << samples << " x " << iterations << " iterations";
+      if (items_per_second > 0) os << ", " << rate(items_per_second) << " items/s";
+      if (bytes_per_second > 0) os << ", " << rate(bytes_per_second) << "B/s";
+      const char* separator = "; per iteration: ";
+      for (std::size_t e = 0; e < perf_counters::event_count; e++) {
+        if (counters[e] < 0) continue;
+        os << separator << count(counters[e]) << perf_counters::name(static_cast<perf_counters::event>(e));
+        if (e == perf_counters::instructions && ipc() >= 0) os << " (" << count(ipc()) << "IPC)";
+        separator = ", ";
+      }
+      return os;
+    }
+
+   private:
+    static std::string time(double seconds) {
+      const char* units[] = {"ns", "us", "ms", "s"};
+      double value = seconds * 1e9;
+      std::size_t unit = 0;
+      for (; unit < 3 && value >= 1000; unit++) value /= 1000;
+      std::stringstream stream;
+      stream.precision(value < 10 ? 3 : 4);
+      stream << value << ' ' << units[unit];
+      return stream.str();
+    }
+
+    static std::string rate(double per_second) {
+      const char* prefixes[] = {"", "k", "M", "G", "T"};
+      std::size_t prefix = 0;
+      for (; prefix < 4 && per_second >= 1000; prefix++) per_second /= 1000;
+      std::stringstream stream;
+      stream.precision(4);
+      stream << per_second << ' ' << prefixes[prefix];
+      return stream.str();
+    }
+
+    // Averages of events may be fractions of one per iteration
+    static std::string count(double value) {
+      if (value >= 100) return rate(value);
+      std::stringstream stream;
+      stream.setf(std::ios::fixed);
+      stream.precision(2);
+      stream << value << ' ';
+      return stream.str();
+    }
+  };
+
+  // Measures a function, calling it as many times as needed for stable timings:
+  //   bench("vector push").items(n).run([&]() { ... });
+  // With a setup function, setup() runs untimed before each call, and calls are timed one by one,
+  // so functions much shorter than a microsecond should be measured without one.
+  class bench {
+   public:
+    explicit bench(std::string name, bench_options options = bench_options{})
+        : _name{std::move(name)}, _options{options}, _items{0}, _bytes{0}, _counters{nullptr} {}
+
+    // Work done by a single call, for throughput
+    bench& items(std::size_t count) {
+      _items = count;
+      return *this;
+    }
+
+    bench& bytes(std::size_t count) {
+      _bytes = count;
+      return *this;
+    }
+
+    template <typename Function>
+    bench_result run(Function function) {
+      return measure([this, &function](std::size_t iterations) {
+        resume_counters();
+        auto start = clock::now();
+        for (std::size_t i = 0; i < iterations; i++) {
+          function();
+          clobber_memory();
+        }
+        double elapsed = seconds(start);
+        pause_counters();
+        return elapsed;
+      });
+    }
+
+    template <typename Setup, typename Function>
+    bench_result run(Setup setup, Function function) {
+      return measure([this, &setup, &function](std::size_t iterations) {
+        double total = 0;
+        for (std::size_t i = 0; i < iterations; i++) {
+          setup();
+          clobber_memory();
+          resume_counters();
+          auto start = clock::now();
+          function();
+          clobber_memory();
+          total += seconds(start);
+          pause_counters();
+        }
+        return total;
+      });
+    }
+
+   private:
+    using clock = std::chrono::steady_clock;
+
+    static double seconds(clock::time_point start) {
+      return std::chrono::duration<double>(clock::now() - start).count();
+    }
+
+    void resume_counters() {
+      if (_counters != nullptr) _counters->start();
+    }
+
+    void pause_counters() {
+      if (_counters != nullptr) _counters->stop();
+    }
+
+    template <typename Sample>
+    bench_result measure(Sample sample) {
+      // Iterations grow until a sample lasts long enough, which also warms caches and branch predictors
+      std::size_t iterations = 1;
+      double elapsed = sample(iterations);
+      while (elapsed < _options.sample_seconds) {
+        double scale = elapsed > 0 ? 1.2 * _options.sample_seconds / elapsed : 10;
+        iterations = static_cast<std::size_t>(std::ceil(static_cast<double>(iterations) * std::min(scale, 10.0)));
+        elapsed = sample(iterations);
+      }
+      for (double warmup = 0; warmup < _options.warmup_seconds;) warmup += sample(iterations);
+
+      // Counters are only running during the timed parts of the samples
+      std::unique_ptr<perf_counters> counters;
+      if (_options.counters) counters.reset(new perf_counters());
+      _counters = counters.get();
+      std::vector<double> times;
+      std::size_t samples = _options.samples > 0 ? _options.samples : 1;
+      for (std::size_t i = 0; i < samples; i++) times.push_back(sample(iterations) / static_cast<double>(iterations));
+      _counters = nullptr;
+      std::sort(times.begin(), times.end());
+
+      bench_result result{_name, iterations, samples, times.front(), 0, 0, 0, 0, 0, 0, {}};
+      result.counters.fill(-1);
+      for (std::size_t e = 0; counters && e < perf_counters::event_count; e++) {
+        double count = counters->value(static_cast<perf_counters::event>(e));
+        if (count >= 0) result.counters[e] = count / static_cast<double>(samples * iterations);
+      }
+      std::size_t middle = samples / 2;
+      result.median = samples % 2 == 1 ? times[middle] : (times[middle - 1] + times[middle]) / 2;
+      result.p99 = times[static_cast<std::size_t>(std::ceil(0.99 * static_cast<double>(samples))) - 1];
+      for (double time : times) result.mean += time / static_cast<double>(samples);
+      for (double time : times) result.stddev += (time - result.mean) * (time - result.mean);
+      result.stddev = samples > 1 ? std::sqrt(result.stddev / static_cast<double>(samples - 1)) : 0;
+      if (result.median > 0) {
+        result.items_per_second = static_cast<double>(_items) / result.median;
+        result.bytes_per_second = static_cast<double>(_bytes) / result.median;
+      }
+      if (_options.output != nullptr) result.print(*_options.output) << std::endl;
+      return result;
+    }
+
+    std::string _name;
+    bench_options _options;
+    std::size_t _items, _bytes;
+    perf_counters* _counters;
+  };
+
+  // Runs benchmark(bench&, size) -> bench_result for every input size, named "name/size"
+  template <typename Benchmark>
+  std::vector<bench_result> run_bench(const std::string& name, std::initializer_list<std::size_t> sizes,
+                                      Benchmark benchmark, bench_options options = bench_options{}) {
+    std::vector<bench_result> results;
+    for (std::size_t size : sizes) {
+      bench b(name + "/" + std::to_string(size), options);
+      results.push_back(benchmark(b, size));
+    }
+    return results;
+  }
+}
+
+#endif //PHOSTDLIB_BENCH_HPP
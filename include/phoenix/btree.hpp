@@ -0,0 +1,759 @@
+#ifndef PHOSTDLIB_BTREE_HPP
+#define PHOSTDLIB_BTREE_HPP
+#include <phoenix/iterator_flag.hpp>
+#include <phoenix/search.hpp>
+#include <phoenix/utility.hpp>
+#include <phoenix/vector.hpp>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#ifndef PHOSTDLIB_DONT_SUPPORT_PRINT
+#include <iostream>
+#endif
+
+// Ordered containers stored as B+ trees. All elements live in leaves, which are linked into
+// a list for range scans; inner nodes only hold separator keys. Nodes take NodeSize bytes
+// (a multiple of the cache line), and keys inside a node are searched with the branchless
+// binary search. Nodes are allocated with Allocator, rebound to the node types, so they can
+// come from a pool or an arena.
+namespace phoenix {
+  namespace detail {
+    template <typename V>
+    struct btree_value_size : std::integral_constant<std::size_t, sizeof(V)> {};
+
+    template <>
+    struct btree_value_size<void> : std::integral_constant<std::size_t, 0> {};
+
+    // Values of a leaf, sets have none
+    template <typename V, std::size_t N>
+    struct btree_values {
+      V values[N];
+
+      void set_value(std::size_t i, const V& value) { values[i] = value; }
+      void copy_value(std::size_t to, const btree_values& from, std::size_t i) { values[to] = from.values[i]; }
+      void move_value(std::size_t to, btree_values& from, std::size_t i) { values[to] = std::move(from.values[i]); }
+    };
+
+    template <std::size_t N>
+    struct btree_values<void, N> {
+      void set_value(std::size_t) {}
+      void copy_value(std::size_t, const btree_values&, std::size_t) {}
+      void move_value(std::size_t, btree_values&, std::size_t) {}
+    };
+
+    template <typename K, typename V, typename Compare, typename Allocator, std::size_t NodeSize>
+    class btree {
+     public:
+      using key_type = K;
+      using size_type = std::size_t;
+
+      static_assert(NodeSize % 64 == 0, "B+ tree nodes have to fill whole cache lines");
+
+      static constexpr std::size_t leaf_keys =
+          (NodeSize - 3 * sizeof(void*)) / (sizeof(K) + btree_value_size<V>::value) > 3
+              ? (NodeSize - 3 * sizeof(void*)) / (sizeof(K) + btree_value_size<V>::value) : 3;
+      static constexpr std::size_t inner_keys =
+          (NodeSize - 2 * sizeof(void*)) / (sizeof(K) + sizeof(void*)) > 3
+              ? (NodeSize - 2 * sizeof(void*)) / (sizeof(K) + sizeof(void*)) : 3;
+
+     protected:
+      struct node {
+        std::size_t count;
+      };
+
+      struct leaf : node, btree_values<V, leaf_keys> {
+        K keys[leaf_keys];
+        leaf* prev;
+        leaf* next;
+      };
+
+      struct inner : node {
+        K keys[inner_keys];
+        node* children[inner_keys + 1];
+      };
+
+      // Height of a tree with fanout of at least 4 never gets close to this
+      static constexpr std::size_t max_height = 48;
+
+      using leaf_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<leaf>;
+      using inner_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<inner>;
+      using leaf_traits = std::allocator_traits<leaf_allocator>;
+      using inner_traits = std::allocator_traits<inner_allocator>;
+
+     public:
+      // Reference is V& or const V& for maps and void for sets, which dereference to keys
+      template <typename Reference>
+      class basic_iterator {
+       public:
+        using self = basic_iterator;
+        static constexpr auto iterator_type = iterator_flag::bidirectional;
+
+        using iterator_category = detail::std_category<iterator_type>;
+        using value_type = typename std::conditional<std::is_void<Reference>::value, const K&,
+                                                     pair<const K&, Reference>>::type;
+        using reference = value_type;
+        using pointer = void;
+        using difference_type = std::ptrdiff_t;
+
+        basic_iterator(const btree* tree, leaf* position, std::size_t index)
+            : _tree{tree}, _leaf{position}, _index{index} {}
+
+        // Iterators to values can be used where iterators to const values are expected
+        template <typename OtherReference>
+        basic_iterator(const basic_iterator<OtherReference>& other)
+            : _tree{other._tree}, _leaf{other._leaf}, _index{other._index} {}
+
+        const K& key() const { return _leaf->keys[_index]; }
+        Reference value() const { return _leaf->values[_index]; }
+        reference operator*() const { return dereference(std::is_void<Reference>{}); }
+
+        self& operator++() {
+          if (++_index == _leaf->count) {
+            _leaf = _leaf->next;
+            _index = 0;
+          }
+          return *this;
+        }
+
+        self operator++(int) {
+          auto t = *this;
+          this->operator++();
+          return t;
+        }
+
+        self& operator--() {
+          if (_leaf == nullptr) {
+            _leaf = _tree->_last;
+            _index = _leaf->count;
+          } else if (_index == 0) {
+            _leaf = _leaf->prev;
+            _index = _leaf->count;
+          }
+          _index--;
+          return *this;
+        }
+
+        self operator--(int) {
+          auto t = *this;
+          this->operator--();
+          return t;
+        }
+
+        bool operator==(const self& other) const { return _leaf == other._leaf && _index == other._index; }
+        bool operator!=(const self& other) const { return !(*this == other); }
+
+       private:
+        template <typename>
+        friend class basic_iterator;
+
+        const K& dereference(std::true_type) const { return key(); }
+        reference dereference(std::false_type) const { return reference{key(), value()}; }
+
+        const btree* _tree;
+        leaf* _leaf;
+        std::size_t _index;
+      };
+
+      explicit btree(Compare compare = Compare{}, const Allocator& allocator = Allocator{})
+          : _root{nullptr}, _first{nullptr}, _last{nullptr}, _size{0}, _height{0}, _compare(compare),
+            _leaves(allocator), _inners(allocator) {}
+
+      btree(const btree& other)
+          : btree(other._compare, leaf_traits::select_on_container_copy_construction(other._leaves)) {
+        copy_from(other);
+      }
+
+      btree(btree&& other) noexcept
+          : _root{other._root}, _first{other._first}, _last{other._last}, _size{other._size},
+            _height{other._height}, _compare(std::move(other._compare)), _leaves(std::move(other._leaves)),
+            _inners(std::move(other._inners)) {
+        other.release();
+      }
+
+      btree& operator=(const btree& other) {
+        if (this == &other) return *this;
+        clear();
+        _compare = other._compare;
+        copy_from(other);
+        return *this;
+      }
+
+      btree& operator=(btree&& other) noexcept {
+        if (this == &other) return *this;
+        clear();
+        _root = other._root;
+        _first = other._first;
+        _last = other._last;
+        _size = other._size;
+        _height = other._height;
+        _compare = std::move(other._compare);
+        _leaves = std::move(other._leaves);
+        _inners = std::move(other._inners);
+        other.release();
+        return *this;
+      }
+
+      ~btree() { clear(); }
+
+      size_type size() const { return _size; }
+      bool empty() const { return _size == 0; }
+      // Number of inner node levels above the leaves
+      size_type height() const { return _height; }
+
+      void clear() {
+        if (_root != nullptr) destroy(_root, _height);
+        release();
+      }
+
+      template <typename Key>
+      bool contains(const Key& key) const {
+        leaf* position;
+        std::size_t index;
+        return find_position(key, position, index);
+      }
+
+      template <typename Key>
+      size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+      template <typename Key>
+      size_type erase(const Key& key) {
+        if (_root == nullptr) return 0;
+        inner* path[max_height];
+        std::size_t slots[max_height];
+        leaf* position = descend(key, path, slots);
+        std::size_t index = leaf_lower(position, key);
+        if (index == position->count || _compare(position->keys[index], key)) return 0;
+
+        for (std::size_t i = index + 1; i < position->count; i++) {
+          position->keys[i - 1] = std::move(position->keys[i]);
+          position->move_value(i - 1, *position, i);
+        }
+        position->count--;
+        _size--;
+        if (position->count == 0) remove_leaf(position, path, slots);
+        return 1;
+      }
+
+     protected:
+      template <typename Key>
+      std::size_t leaf_lower(const leaf* position, const Key& key) const {
+        return detail::partition_point(position->keys, position->count,
+                                       [&](const K& element) { return _compare(key, element); });
+      }
+
+      template <typename Key>
+      std::size_t leaf_upper(const leaf* position, const Key& key) const {
+        return detail::partition_point(position->keys, position->count,
+                                       [&](const K& element) { return !_compare(element, key); });
+      }
+
+      // Child holding key: the number of separators not after key
+      template <typename Key>
+      std::size_t child_of(const inner* parent, const Key& key) const {
+        return detail::partition_point(parent->keys, parent->count,
+                                       [&](const K& element) { return !_compare(element, key); });
+      }
+
+      // Leaf which would hold key, with inner nodes and child indices on the way if path is given
+      template <typename Key>
+      leaf* descend(const Key& key, inner** path = nullptr, std::size_t* slots = nullptr) const {
+        node* current = _root;
+        for (std::size_t level = 0; level < _height; level++) {
+          auto parent = static_cast<inner*>(current);
+          std::size_t slot = child_of(parent, key);
+          if (path != nullptr) {
+            path[level] = parent;
+            slots[level] = slot;
+          }
+          current = parent->children[slot];
+        }
+        return static_cast<leaf*>(current);
+      }
+
+      template <typename Key>
+      bool find_position(const Key& key, leaf*& position, std::size_t& index) const {
+        if (_root == nullptr) return false;
+        position = descend(key);
+        index = leaf_lower(position, key);
+        return index < position->count && !_compare(position->keys[index], key);
+      }
+
+      // Moves positions past the end of a leaf to the start of the next one
+      template <typename Iterator>
+      Iterator normalized(leaf* position, std::size_t index) const {
+        if (position != nullptr && index == position->count) return Iterator(this, position->next, 0);
+        return Iterator(this, position, index);
+      }
+
+      template <typename Iterator>
+      Iterator first() const { return Iterator(this, _first, 0); }
+
+      template <typename Iterator, typename Key>
+      Iterator find_iterator(const Key& key) const {
+        leaf* position;
+        std::size_t index;
+        if (!find_position(key, position, index)) return Iterator(this, nullptr, 0);
+        return Iterator(this, position, index);
+      }
+
+      template <typename Iterator, typename Key>
+      Iterator lower_iterator(const Key& key) const {
+        if (_root == nullptr) return Iterator(this, nullptr, 0);
+        leaf* position = descend(key);
+        return normalized<Iterator>(position, leaf_lower(position, key));
+      }
+
+      template <typename Iterator, typename Key>
+      Iterator upper_iterator(const Key& key) const {
+        if (_root == nullptr) return Iterator(this, nullptr, 0);
+        leaf* position = descend(key);
+        return normalized<Iterator>(position, leaf_upper(position, key));
+      }
+
+      // Inserts key if it's missing, splitting full nodes on the way back up.
+      // Returns the leaf and index of key and whether it was inserted.
+      template <typename... Value>
+      bool insert_unique(const K& key, leaf*& position, std::size_t& index, const Value&... value) {
+        if (_root == nullptr) {
+          _root = _first = _last = new_leaf();
+          _height = 0;
+        }
+        inner* path[max_height];
+        std::size_t slots[max_height];
+        position = descend(key, path, slots);
+        index = leaf_lower(position, key);
+        if (index < position->count && !_compare(position->keys[index], key)) return false;
+
+        if (position->count == leaf_keys) {
+          leaf* right = split_leaf(position);
+          if (index > position->count) {
+            index -= position->count;
+            position = right;
+          }
+          insert_separator(right->keys[0], right, path, slots);
+        }
+        for (std::size_t i = position->count; i > index; i--) {
+          position->keys[i] = std::move(position->keys[i - 1]);
+          position->move_value(i, *position, i - 1);
+        }
+        position->keys[index] = key;
+        position->set_value(index, value...);
+        position->count++;
+        _size++;
+        return true;
+      }
+
+      // Builds the tree bottom-up from sorted elements in O(N): leaves are filled completely, then
+      // inner levels are built over them. Elements equal to the previous one are skipped,
+      // unsorted ones throw std::invalid_argument.
+      template <typename InputIterator, typename KeyOf, typename Store>
+      void bulk_load(InputIterator begin, InputIterator end, KeyOf key_of, Store store) {
+        clear();
+        vector<node*> level;
+        vector<K> lows;
+        leaf* current = nullptr;
+        for (; begin != end; ++begin) {
+          auto&& element = *begin;
+          const K& key = key_of(element);
+          if (current != nullptr) {
+            const K& previous = current->keys[current->count - 1];
+            if (_compare(previous, key)) {
+              for (std::size_t i = 0; i < level.size(); i++) free_leaf(static_cast<leaf*>(level[i]));
+              release();
+              throw std::invalid_argument("Elements loaded into a B+ tree must be sorted!");
+            }
+            if (!_compare(key, previous)) continue;
+          }
+          if (current == nullptr || current->count == leaf_keys) {
+            current = append_leaf(level, lows, key);
+          }
+          current->keys[current->count] = key;
+          store(*current, current->count, element);
+          current->count++;
+          _size++;
+        }
+        build_levels(level, lows);
+      }
+
+      node* _root;
+      leaf* _first;
+      leaf* _last;
+      std::size_t _size, _height;
+      Compare _compare;
+
+     private:
+      leaf* new_leaf() {
+        leaf* result = leaf_traits::allocate(_leaves, 1);
+        leaf_traits::construct(_leaves, result);
+        result->count = 0;
+        result->prev = result->next = nullptr;
+        return result;
+      }
+
+      inner* new_inner() {
+        inner* result = inner_traits::allocate(_inners, 1);
+        inner_traits::construct(_inners, result);
+        result->count = 0;
+        return result;
+      }
+
+      void free_leaf(leaf* position) {
+        leaf_traits::destroy(_leaves, position);
+        leaf_traits::deallocate(_leaves, position, 1);
+      }
+
+      void free_inner(inner* parent) {
+        inner_traits::destroy(_inners, parent);
+        inner_traits::deallocate(_inners, parent, 1);
+      }
+
+      void destroy(node* current, std::size_t height) {
+        if (height == 0) {
+          free_leaf(static_cast<leaf*>(current));
+          return;
+        }
+        auto parent = static_cast<inner*>(current);
+        for (std::size_t i = 0; i <= parent->count; i++) destroy(parent->children[i], height - 1);
+        free_inner(parent);
+      }
+
+      void release() {
+        _root = nullptr;
+        _first = _last = nullptr;
+        _size = _height = 0;
+      }
+
+      // New leaf linked after the last one, lows collect the first key of every leaf
+      leaf* append_leaf(vector<node*>& level, vector<K>& lows, const K& low) {
+        leaf* result = new_leaf();
+        result->prev = _last;
+        if (_last != nullptr) _last->next = result;
+        else _first = result;
+        _last = result;
+        detail::grow(level, level.size() + 1);
+        level.push(static_cast<node*>(result));
+        detail::grow(lows, lows.size() + 1);
+        lows.push(low);
+        return result;
+      }
+
+      // Groups every level into parents with an even share of children, up to a single root
+      void build_levels(vector<node*>& level, vector<K>& lows) {
+        if (level.size() == 0) return;
+        while (level.size() > 1) {
+          std::size_t parents = (level.size() + inner_keys) / (inner_keys + 1);
+          vector<node*> next_level(parents);
+          vector<K> next_lows(parents);
+          for (std::size_t p = 0, child = 0; p < parents; p++) {
+            // The first level.size() % parents parents get one child more
+            std::size_t children = level.size() / parents + (p < level.size() % parents ? 1 : 0);
+            inner* parent = new_inner();
+            next_lows[p] = lows[child];
+            for (std::size_t c = 0; c < children; c++, child++) {
+              parent->children[c] = level[child];
+              if (c > 0) parent->keys[c - 1] = lows[child];
+            }
+            parent->count = children - 1;
+            next_level[p] = parent;
+          }
+          level = std::move(next_level);
+          lows = std::move(next_lows);
+          _height++;
+        }
+        _root = level[0];
+      }
+
+      // Copies leaves as they are and builds inner levels over them
+      void copy_from(const btree& other) {
+        vector<node*> level;
+        vector<K> lows;
+        for (const leaf* source = other._first; source != nullptr; source = source->next) {
+          leaf* target = append_leaf(level, lows, source->keys[0]);
+          for (std::size_t i = 0; i < source->count; i++) {
+            target->keys[i] = source->keys[i];
+            target->copy_value(i, *source, i);
+          }
+          target->count = source->count;
+        }
+        _size = other._size;
+        build_levels(level, lows);
+      }
+
+      // Upper half of a full leaf goes to a new leaf linked after it
+      leaf* split_leaf(leaf* position) {
+        leaf* right = new_leaf();
+        std::size_t half = position->count / 2;
+        for (std::size_t i = half; i < position->count; i++) {
+          right->keys[i - half] = std::move(position->keys[i]);
+          right->move_value(i - half, *position, i);
+        }
+        right->count = position->count - half;
+        position->count = half;
+
+        right->prev = position;
+        right->next = position->next;
+        if (position->next != nullptr) position->next->prev = right;
+        else _last = right;
+        position->next = right;
+        return right;
+      }
+
+      // Adds child right of the node descended into at every level, splitting full inner nodes
+      void insert_separator(K separator, node* child, inner** path, std::size_t* slots) {
+        for (std::size_t level = _height; level-- > 0;) {
+          inner* parent = path[level];
+          std::size_t slot = slots[level];
+          if (parent->count < inner_keys) {
+            for (std::size_t i = parent->count; i > slot; i--) {
+              parent->keys[i] = std::move(parent->keys[i - 1]);
+              parent->children[i + 1] = parent->children[i];
+            }
+            parent->keys[slot] = std::move(separator);
+            parent->children[slot + 1] = child;
+            parent->count++;
+            return;
+          }
+
+          K keys[inner_keys + 1];
+          node* children[inner_keys + 2];
+          for (std::size_t i = 0, j = 0; i <= inner_keys; i++) {
+            keys[i] = i == slot ? std::move(separator) : std::move(parent->keys[j++]);
+          }
+          for (std::size_t i = 0, j = 0; i <= inner_keys + 1; i++) {
+            children[i] = i == slot + 1 ? child : parent->children[j++];
+          }
+
+          // The middle separator moves up, nodes on both sides keep the rest
+          std::size_t middle = (inner_keys + 1) / 2;
+          inner* right = new_inner();
+          for (std::size_t i = 0; i < middle; i++) parent->keys[i] = std::move(keys[i]);
+          for (std::size_t i = 0; i <= middle; i++) parent->children[i] = children[i];
+          parent->count = middle;
+          for (std::size_t i = middle + 1; i <= inner_keys; i++) right->keys[i - middle - 1] = std::move(keys[i]);
+          for (std::size_t i = middle + 1; i <= inner_keys + 1; i++) right->children[i - middle - 1] = children[i];
+          right->count = inner_keys - middle;
+
+          separator = std::move(keys[middle]);
+          child = right;
+        }
+
+        inner* root = new_inner();
+        root->keys[0] = std::move(separator);
+        root->children[0] = _root;
+        root->children[1] = child;
+        root->count = 1;
+        _root = root;
+        _height++;
+      }
+
+      // Empty leaves are unlinked and removed from their parents, and so are inner nodes left
+      // without children. Nodes which are not empty are never merged, so erasing keeps the
+      // lookup cost bounded by the height reached by insertions.
+      void remove_leaf(leaf* position, inner** path, std::size_t* slots) {
+        if (_height == 0) {
+          free_leaf(position);
+          release();
+          return;
+        }
+        if (position->prev != nullptr) position->prev->next = position->next;
+        else _first = position->next;
+        if (position->next != nullptr) position->next->prev = position->prev;
+        else _last = position->prev;
+        free_leaf(position);
+
+        for (std::size_t level = _height; level-- > 0;) {
+          inner* parent = path[level];
+          std::size_t slot = slots[level];
+          if (parent->count == 0) {
+            free_inner(parent);
+            // The whole tree was a chain of single children above this leaf
+            if (level == 0) {
+              release();
+              return;
+            }
+            continue;
+          }
+          std::size_t removed_key = slot == 0 ? 0 : slot - 1;
+          for (std::size_t i = removed_key + 1; i < parent->count; i++) parent->keys[i - 1] = std::move(parent->keys[i]);
+          for (std::size_t i = slot + 1; i <= parent->count; i++) parent->children[i - 1] = parent->children[i];
+          parent->count--;
+          break;
+        }
+
+        while (_height > 0 && static_cast<inner*>(_root)->count == 0) {
+          auto root = static_cast<inner*>(_root);
+          _root = root->children[0];
+          free_inner(root);
+          _height--;
+        }
+      }
+
+      leaf_allocator _leaves;
+      inner_allocator _inners;
+    };
+  }
+
+  template <typename K, typename V, typename Compare = greater_fn, typename Allocator = std::allocator<K>,
+            std::size_t NodeSize = 512>
+  class btree_map : public detail::btree<K, V, Compare, Allocator, NodeSize> {
+    using base = detail::btree<K, V, Compare, Allocator, NodeSize>;
+    using leaf = typename base::leaf;
+
+   public:
+    using mapped_type = V;
+    using iterator = typename base::template basic_iterator<V&>;
+    using const_iterator = typename base::template basic_iterator<const V&>;
+
+    explicit btree_map(Compare compare = Compare{}, const Allocator& allocator = Allocator{})
+        : base(compare, allocator) {}
+
+    // Elements of the range have to provide .first (key) and .second (value)
+    template <typename InputIterator>
+    btree_map(InputIterator begin, InputIterator end, Compare compare = Compare{},
+              const Allocator& allocator = Allocator{})
+        : base(compare, allocator) {
+      for (; begin != end; ++begin) insert((*begin).first, (*begin).second);
+    }
+
+    btree_map(std::initializer_list<pair<K, V>> elements, Compare compare = Compare{},
+              const Allocator& allocator = Allocator{})
+        : btree_map(elements.begin(), elements.end(), compare, allocator) {}
+
+    // Replaces the contents with pairs sorted by key in O(N)
+    template <typename InputIterator>
+    void assign_sorted(InputIterator begin, InputIterator end) {
+      this->bulk_load(begin, end, [](const auto& element) -> const K& { return element.first; },
+                      [](leaf& target, std::size_t index, const auto& element) {
+                        target.values[index] = element.second;
+                      });
+    }
+
+    iterator begin() { return this->template first<iterator>(); }
+    iterator end() { return iterator(this, nullptr, 0); }
+    const_iterator begin() const { return this->template first<const_iterator>(); }
+    const_iterator end() const { return const_iterator(this, nullptr, 0); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    template <typename Key>
+    iterator find(const Key& key) { return this->template find_iterator<iterator>(key); }
+    template <typename Key>
+    const_iterator find(const Key& key) const { return this->template find_iterator<const_iterator>(key); }
+
+    template <typename Key>
+    iterator lower_bound(const Key& key) { return this->template lower_iterator<iterator>(key); }
+    template <typename Key>
+    const_iterator lower_bound(const Key& key) const { return this->template lower_iterator<const_iterator>(key); }
+
+    template <typename Key>
+    iterator upper_bound(const Key& key) { return this->template upper_iterator<iterator>(key); }
+    template <typename Key>
+    const_iterator upper_bound(const Key& key) const { return this->template upper_iterator<const_iterator>(key); }
+
+    template <typename Key>
+    V& at(const Key& key) {
+      auto it = find(key);
+      if (it == end()) throw std::out_of_range("Key not found in btree_map!");
+      return it.value();
+    }
+
+    template <typename Key>
+    const V& at(const Key& key) const {
+      auto it = find(key);
+      if (it == end()) throw std::out_of_range("Key not found in btree_map!");
+      return it.value();
+    }
+
+    // Inserts a default value if key is missing
+    V& operator[](const K& key) { return insert(key, V{}).first.value(); }
+
+    // Returns the position of key and whether it was inserted, an existing value is left unchanged
+    pair<iterator, bool> insert(const K& key, const V& value) {
+      leaf* position;
+      std::size_t index;
+      bool inserted = this->insert_unique(key, position, index, value);
+      return {iterator(this, position, index), inserted};
+    }
+
+    pair<iterator, bool> insert_or_assign(const K& key, const V& value) {
+      auto result = insert(key, value);
+      if (!result.second) result.first.value() = value;
+      return result;
+    }
+
+    #ifndef PHOSTDLIB_DONT_SUPPORT_PRINT
+    friend std::ostream& operator<<(std::ostream& os, const btree_map& map) {
+      os << '{';
+      for (auto it = map.begin(); it != map.end(); ++it) os << (it == map.begin() ? "" : ", ") << it.key() << ": " << it.value();
+      return os << '}';
+    }
+    #endif
+  };
+
+  template <typename K, typename Compare = greater_fn, typename Allocator = std::allocator<K>,
+            std::size_t NodeSize = 512>
+  class btree_set : public detail::btree<K, void, Compare, Allocator, NodeSize> {
+    using base = detail::btree<K, void, Compare, Allocator, NodeSize>;
+    using leaf = typename base::leaf;
+
+   public:
+    using value_type = K;
+    using const_iterator = typename base::template basic_iterator<void>;
+    using iterator = const_iterator;
+
+    explicit btree_set(Compare compare = Compare{}, const Allocator& allocator = Allocator{})
+        : base(compare, allocator) {}
+
+    template <typename InputIterator>
+    btree_set(InputIterator begin, InputIterator end, Compare compare = Compare{},
+              const Allocator& allocator = Allocator{})
+        : base(compare, allocator) {
+      for (; begin != end; ++begin) insert(*begin);
+    }
+
+    btree_set(std::initializer_list<K> keys, Compare compare = Compare{}, const Allocator& allocator = Allocator{})
+        : btree_set(keys.begin(), keys.end(), compare, allocator) {}
+
+    // Replaces the contents with sorted keys in O(N)
+    template <typename InputIterator>
+    void assign_sorted(InputIterator begin, InputIterator end) {
+      this->bulk_load(begin, end, [](const K& key) -> const K& { return key; },
+                      [](leaf&, std::size_t, const K&) {});
+    }
+
+    const_iterator begin() const { return this->template first<const_iterator>(); }
+    const_iterator end() const { return const_iterator(this, nullptr, 0); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    template <typename Key>
+    const_iterator find(const Key& key) const { return this->template find_iterator<const_iterator>(key); }
+
+    template <typename Key>
+    const_iterator lower_bound(const Key& key) const { return this->template lower_iterator<const_iterator>(key); }
+
+    template <typename Key>
+    const_iterator upper_bound(const Key& key) const { return this->template upper_iterator<const_iterator>(key); }
+
+    // Returns the position of key and whether it was inserted
+    pair<const_iterator, bool> insert(const K& key) {
+      leaf* position;
+      std::size_t index;
+      bool inserted = this->insert_unique(key, position, index);
+      return {const_iterator(this, position, index), inserted};
+    }
+
+    #ifndef PHOSTDLIB_DONT_SUPPORT_PRINT
+    friend std::ostream& operator<<(std::ostream& os, const btree_set& set) {
+      os << '{';
+      for (auto it = set.begin(); it != set.end(); ++it) os << (it == set.begin() ? "" : ", ") << *it;
+      return os << '}';
+    }
+    #endif
+  };
+}
+
+#endif //PHOSTDLIB_BTREE_HPP
@@ -0,0 +1,103 @@
+#ifndef PHOSTDLIB_CPU_HPP
+#define PHOSTDLIB_CPU_HPP
+
+// Define PHOSTDLIB_DONT_USE_SIMD to compile every algorithm with its generic (scalar) path only
+#if !defined(PHOSTDLIB_DONT_USE_SIMD) && (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define PHOSTDLIB_X86_SIMD 1
+#include <immintrin.h>
+
+// Code between BEGIN and END is compiled for given instruction set, and must be called only
+// after checking cpu::active_level()
+#if defined(__clang__)
+#define PHOSTDLIB_TARGET_AVX2_BEGIN \
+  _Pragma("clang attribute push(__attribute__((target(\"avx2,bmi,bmi2,popcnt\"))), apply_to = function)")
+#define PHOSTDLIB_TARGET_AVX512_BEGIN \
+  _Pragma("clang attribute push(__attribute__((target(\"avx512f,avx2,bmi,bmi2,popcnt\"))), apply_to = function)")
+#define PHOSTDLIB_TARGET_END _Pragma("clang attribute pop")
+#else
+// GCC 12 reports false -Wmaybe-uninitialized in AVX-512 intrinsic headers (GCC bug 105593)
+#define PHOSTDLIB_TARGET_AVX2_BEGIN \
+  _Pragma("GCC push_options") _Pragma("GCC target(\"avx2,bmi,bmi2,popcnt\")") \
+  _Pragma("GCC diagnostic push") _Pragma("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+#define PHOSTDLIB_TARGET_AVX512_BEGIN \
+  _Pragma("GCC push_options") _Pragma("GCC target(\"avx512f,avx2,bmi,bmi2,popcnt\")") \
+  _Pragma("GCC diagnostic push") _Pragma("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+#define PHOSTDLIB_TARGET_END _Pragma("GCC diagnostic pop") _Pragma("GCC pop_options")
+#endif
+#endif
+
+#include <cstddef>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace phoenix {
+  enum class simd_level : unsigned {
+    scalar = 0,
+    sse2 = 1,
+    avx2 = 2,
+    avx512 = 3
+  };
+
+  namespace cpu {
+    inline simd_level detected_level() {
+    #ifdef PHOSTDLIB_X86_SIMD
+      static const simd_level level = []() {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return simd_level::avx512;
+        if (__builtin_cpu_supports("avx2")) return simd_level::avx2;
+        if (__builtin_cpu_supports("sse2")) return simd_level::sse2;
+        return simd_level::scalar;
+      }();
+      return level;
+    #else
+      return simd_level::scalar;
+    #endif
+    }
+
+    inline simd_level& level_limit() {
+      static simd_level limit = simd_level::avx512;
+      return limit;
+    }
+
+    // Caps the instruction set used by the dispatched algorithms (useful for testing and benchmarking)
+    inline void set_level_limit(simd_level limit) {
+      level_limit() = limit;
+    }
+
+    inline simd_level active_level() {
+      auto detected = detected_level();
+      auto limit = level_limit();
+      return static_cast<unsigned>(detected) < static_cast<unsigned>(limit) ? detected : limit;
+    }
+
+    // Data written by different threads should be at least this far apart to avoid false sharing
+    constexpr std::size_t cache_line_size = 64;
+
+    inline unsigned available_cores() {
+    #ifdef __linux__
+      cpu_set_t set;
+      if (sched_getaffinity(0, sizeof(set), &set) == 0) return static_cast<unsigned>(CPU_COUNT(&set));
+    #endif
+      return 1;
+    }
+
+    // Binds the calling thread to one core, returns false if that's not supported or core doesn't exist
+    inline bool pin_current_thread(unsigned core) {
+    #ifdef __linux__
+      if (core >= CPU_SETSIZE) return false;
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(core, &set);
+      return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    #else
+      (void)core;
+      return false;
+    #endif
+    }
+  }
+}
+
+#endif //PHOSTDLIB_CPU_HPP
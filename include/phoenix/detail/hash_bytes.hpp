@@ -0,0 +1,39 @@
+#ifndef PHOSTDLIB_DETAIL_HASH_BYTES_HPP
+#define PHOSTDLIB_DETAIL_HASH_BYTES_HPP
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace phoenix {
+  namespace detail {
+    // Finalizer spreading every input bit over the whole result, so that both the low and the
+    // high bits of a hash can be used by hash tables
+    inline std::uint64_t mix(std::uint64_t x) {
+      x ^= x >> 32;
+      x *= 0xd6e8feb86659fd93ull;
+      x ^= x >> 32;
+      x *= 0xd6e8feb86659fd93ull;
+      x ^= x >> 32;
+      return x;
+    }
+
+    inline std::uint64_t hash_bytes(const void* data, std::size_t length) {
+      constexpr std::uint64_t multiplier = 0x9e3779b97f4a7c15ull;
+      auto bytes = static_cast<const unsigned char*>(data);
+      std::uint64_t h = length * multiplier;
+      for (; length >= 8; length -= 8, bytes += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, bytes, 8);
+        h = (h ^ mix(word)) * multiplier;
+      }
+      if (length > 0) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, bytes, length);
+        h = (h ^ mix(word)) * multiplier;
+      }
+      return mix(h);
+    }
+  }
+}
+
+#endif //PHOSTDLIB_DETAIL_HASH_BYTES_HPP
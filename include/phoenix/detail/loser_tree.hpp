@@ -0,0 +1,62 @@
+#ifndef PHOSTDLIB_DETAIL_LOSER_TREE_HPP
+#define PHOSTDLIB_DETAIL_LOSER_TREE_HPP
+#include <phoenix/vector.hpp>
+#include <cstddef>
+
+namespace phoenix {
+  namespace detail {
+    // Tournament tree of losers for k-way merging. Before(a, b) tells whether the current head of
+    // source a goes out before the head of source b (exhausted sources must never go before).
+    // Equal heads are taken from the lower source first, so merging is stable.
+    template <typename Before>
+    class loser_tree {
+     public:
+      loser_tree(std::size_t sources, Before before)
+          : _losers(sources > 0 ? sources : 1, 0), _sources{sources}, _before(before) {
+        if (_sources < 2) return;
+
+        vector<std::size_t> winners(2 * _sources, 0);
+        for (std::size_t i = 0; i < _sources; i++) winners[_sources + i] = i;
+        for (std::size_t node = _sources - 1; node > 0; node--) {
+          std::size_t a = winners[2 * node], b = winners[2 * node + 1];
+          std::size_t winner = play(a, b);
+          _losers[node] = winner == a ? b : a;
+          winners[node] = winner;
+        }
+        _losers[0] = winners[1];
+      }
+
+      std::size_t top() const { return _losers[0]; }
+
+      // Call after the head of top() source has changed
+      void replay() {
+        std::size_t winner = _losers[0];
+        for (std::size_t node = (winner + _sources) / 2; node > 0; node /= 2) {
+          if (play(winner, _losers[node]) != winner) {
+            std::size_t t = _losers[node];
+            _losers[node] = winner;
+            winner = t;
+          }
+        }
+        _losers[0] = winner;
+      }
+
+     private:
+      std::size_t play(std::size_t a, std::size_t b) {
+        bool b_wins = a < b ? _before(b, a) : !_before(a, b);
+        return b_wins ? b : a;
+      }
+
+      vector<std::size_t> _losers;
+      std::size_t _sources;
+      Before _before;
+    };
+
+    template <typename Before>
+    loser_tree<Before> make_loser_tree(std::size_t sources, Before before) {
+      return loser_tree<Before>(sources, before);
+    }
+  }
+}
+
+#endif //PHOSTDLIB_DETAIL_LOSER_TREE_HPP
@@ -0,0 +1,143 @@
+#ifndef PHOSTDLIB_DETAIL_SIMD_SCAN_HPP
+#define PHOSTDLIB_DETAIL_SIMD_SCAN_HPP
+#include <phoenix/cpu.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace phoenix {
+  namespace detail {
+    namespace simd_scan {
+      // Element types of the prefix sum kernels
+      template <typename T>
+      struct is_key : std::integral_constant<bool,
+          (std::is_integral<T>::value && !std::is_same<T, bool>::value && (sizeof(T) == 4 || sizeof(T) == 8)) ||
+          std::is_same<T, float>::value || std::is_same<T, double>::value> {};
+    }
+  }
+}
+
+#if defined(PHOSTDLIB_X86_SIMD) && defined(__SSE2__)
+namespace phoenix {
+  namespace detail {
+    namespace simd_scan {
+      // SSE2 is enough here: scans are bound by memory bandwidth, and prefix sums don't cross the
+      // 128-bit lanes of wider registers cheaply
+      template <typename T, std::size_t Size = sizeof(T)>
+      struct vec;
+
+      template <typename T>
+      struct vec<T, 4> {
+        using reg = __m128i;
+        static constexpr std::size_t lanes = 4;
+        static reg loadu(const T* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+        static void storeu(T* p, reg v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+        static reg set1(T x) { return _mm_set1_epi32(static_cast<int>(x)); }
+        static reg add(reg a, reg b) { return _mm_add_epi32(a, b); }
+        static reg shift_lane(reg v) { return _mm_slli_si128(v, 4); }
+        static reg prefix(reg v) {
+          v = add(v, _mm_slli_si128(v, 4));
+          return add(v, _mm_slli_si128(v, 8));
+        }
+        static reg broadcast_last(reg v) { return _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 3, 3, 3)); }
+        static T first(reg v) { return static_cast<T>(_mm_cvtsi128_si32(v)); }
+      };
+
+      template <typename T>
+      struct vec<T, 8> {
+        using reg = __m128i;
+        static constexpr std::size_t lanes = 2;
+        static reg loadu(const T* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+        static void storeu(T* p, reg v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+        static reg set1(T x) { return _mm_set1_epi64x(static_cast<long long>(x)); }
+        static reg add(reg a, reg b) { return _mm_add_epi64(a, b); }
+        static reg shift_lane(reg v) { return _mm_slli_si128(v, 8); }
+        static reg prefix(reg v) { return add(v, _mm_slli_si128(v, 8)); }
+        static reg broadcast_last(reg v) { return _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 2, 3, 2)); }
+        static T first(reg v) { return static_cast<T>(_mm_cvtsi128_si64(v)); }
+      };
+
+      template <>
+      struct vec<float, 4> {
+        using reg = __m128;
+        static constexpr std::size_t lanes = 4;
+        static reg loadu(const float* p) { return _mm_loadu_ps(p); }
+        static void storeu(float* p, reg v) { _mm_storeu_ps(p, v); }
+        static reg set1(float x) { return _mm_set1_ps(x); }
+        static reg add(reg a, reg b) { return _mm_add_ps(a, b); }
+        static reg shift(reg v, std::integral_constant<int, 4>) {
+          return _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v), 4));
+        }
+        static reg shift(reg v, std::integral_constant<int, 8>) {
+          return _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v), 8));
+        }
+        static reg shift_lane(reg v) { return shift(v, std::integral_constant<int, 4>{}); }
+        static reg prefix(reg v) {
+          v = add(v, shift(v, std::integral_constant<int, 4>{}));
+          return add(v, shift(v, std::integral_constant<int, 8>{}));
+        }
+        static reg broadcast_last(reg v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)); }
+        static float first(reg v) { return _mm_cvtss_f32(v); }
+      };
+
+      template <>
+      struct vec<double, 8> {
+        using reg = __m128d;
+        static constexpr std::size_t lanes = 2;
+        static reg loadu(const double* p) { return _mm_loadu_pd(p); }
+        static void storeu(double* p, reg v) { _mm_storeu_pd(p, v); }
+        static reg set1(double x) { return _mm_set1_pd(x); }
+        static reg add(reg a, reg b) { return _mm_add_pd(a, b); }
+        static reg shift_lane(reg v) { return _mm_castsi128_pd(_mm_slli_si128(_mm_castpd_si128(v), 8)); }
+        static reg prefix(reg v) { return add(v, shift_lane(v)); }
+        static reg broadcast_last(reg v) { return _mm_unpackhi_pd(v, v); }
+        static double first(reg v) { return _mm_cvtsd_f64(v); }
+      };
+
+      // Prefix sums of a register are computed with log2(lanes) shifted additions, then the sum of
+      // everything before the register is added. Input and output may be the same array.
+      // Returns carry + the sum of all elements.
+      template <typename T>
+      T sum(const T* in, std::size_t length, T* out, T carry, bool exclusive) {
+        using V = vec<T>;
+        auto total = V::set1(carry);
+        std::size_t i = 0;
+        for (; i + V::lanes <= length; i += V::lanes) {
+          auto prefix = V::prefix(V::loadu(in + i));
+          V::storeu(out + i, V::add(total, exclusive ? V::shift_lane(prefix) : prefix));
+          total = V::add(total, V::broadcast_last(prefix));
+        }
+        T rest = V::first(total);
+        for (; i < length; i++) {
+          T value = in[i];
+          if (exclusive) out[i] = rest;
+          rest = static_cast<T>(rest + value);
+          if (!exclusive) out[i] = rest;
+        }
+        return rest;
+      }
+    }
+  }
+}
+#define PHOSTDLIB_SIMD_SCAN 1
+#endif
+
+namespace phoenix {
+  namespace detail {
+    namespace simd_scan {
+      // Runs the kernel and returns true, or returns false when generic code has to run
+      template <typename T>
+      bool prefix_sum(const T* in, std::size_t length, T* out, T carry, bool exclusive, T& total) {
+      #ifdef PHOSTDLIB_SIMD_SCAN
+        total = sum(in, length, out, carry, exclusive);
+        return true;
+      #else
+        (void)in, (void)length, (void)out, (void)carry, (void)exclusive, (void)total;
+        return false;
+      #endif
+      }
+    }
+  }
+}
+
+#endif //PHOSTDLIB_DETAIL_SIMD_SCAN_HPP
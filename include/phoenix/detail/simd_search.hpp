@@ -0,0 +1,427 @@
+#ifndef PHOSTDLIB_DETAIL_SIMD_SEARCH_HPP
+#define PHOSTDLIB_DETAIL_SIMD_SEARCH_HPP
+#include <phoenix/cpu.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace phoenix {
+  namespace detail {
+    namespace simd_search {
+      // Element types the kernels handle: integers (except bool), float and double
+      template <typename T>
+      struct is_key : std::integral_constant<bool,
+          (std::is_integral<T>::value && !std::is_same<T, bool>::value && sizeof(T) <= 8) ||
+          std::is_same<T, float>::value || std::is_same<T, double>::value> {};
+
+      template <std::size_t Size>
+      using size_tag = std::integral_constant<std::size_t, Size>;
+
+      // Number of partial sums used by accumulate - lanes of a 256-bit register, on every level
+      template <typename T>
+      using accumulate_width = std::integral_constant<std::size_t, 32 / sizeof(T)>;
+
+      // accumulate without vector instructions, in the same order as the kernels
+      template <typename T>
+      T accumulate_portable(const T* data, std::size_t length, T init) {
+        constexpr std::size_t width = accumulate_width<T>::value;
+        T s[4][width] = {};
+        std::size_t i = 0;
+        for (; i + 4 * width <= length; i += 4 * width) {
+          for (std::size_t k = 0; k < 4; k++) {
+            for (std::size_t lane = 0; lane < width; lane++) {
+              s[k][lane] = static_cast<T>(s[k][lane] + data[i + k * width + lane]);
+            }
+          }
+        }
+        for (; i + width <= length; i += width) {
+          for (std::size_t lane = 0; lane < width; lane++) s[0][lane] = static_cast<T>(s[0][lane] + data[i + lane]);
+        }
+        T sum = init;
+        for (std::size_t lane = 0; lane < width; lane++) {
+          T low = static_cast<T>(s[0][lane] + s[1][lane]), high = static_cast<T>(s[2][lane] + s[3][lane]);
+          sum = static_cast<T>(sum + static_cast<T>(low + high));
+        }
+        for (; i < length; i++) sum = static_cast<T>(sum + data[i]);
+        return sum;
+      }
+
+      // Sign bit of T, flipping it makes unsigned values comparable with signed instructions
+      template <typename T>
+      T sign_bit() {
+        using unsigned_type = typename std::make_unsigned<T>::type;
+        return static_cast<T>(static_cast<unsigned_type>(static_cast<unsigned_type>(1) << (sizeof(T) * 8 - 1)));
+      }
+    }
+  }
+}
+
+#if defined(PHOSTDLIB_X86_SIMD) && defined(__SSE2__)
+namespace phoenix {
+  namespace detail {
+    namespace simd_search {
+      namespace sse2 {
+        inline __m128i set1(std::uint64_t x, size_tag<1>) { return _mm_set1_epi8(static_cast<char>(x)); }
+        inline __m128i set1(std::uint64_t x, size_tag<2>) { return _mm_set1_epi16(static_cast<short>(x)); }
+        inline __m128i set1(std::uint64_t x, size_tag<4>) { return _mm_set1_epi32(static_cast<int>(x)); }
+        inline __m128i set1(std::uint64_t x, size_tag<8>) { return _mm_set1_epi64x(static_cast<long long>(x)); }
+
+        inline __m128i cmpeq(__m128i a, __m128i b, size_tag<1>) { return _mm_cmpeq_epi8(a, b); }
+        inline __m128i cmpeq(__m128i a, __m128i b, size_tag<2>) { return _mm_cmpeq_epi16(a, b); }
+        inline __m128i cmpeq(__m128i a, __m128i b, size_tag<4>) { return _mm_cmpeq_epi32(a, b); }
+        // SSE2 has no 64-bit comparisons, both halves have to match
+        inline __m128i cmpeq(__m128i a, __m128i b, size_tag<8>) {
+          __m128i halves = _mm_cmpeq_epi32(a, b);
+          return _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+        }
+
+        inline __m128i cmpgt(__m128i a, __m128i b, size_tag<1>) { return _mm_cmpgt_epi8(a, b); }
+        inline __m128i cmpgt(__m128i a, __m128i b, size_tag<2>) { return _mm_cmpgt_epi16(a, b); }
+        inline __m128i cmpgt(__m128i a, __m128i b, size_tag<4>) { return _mm_cmpgt_epi32(a, b); }
+        // High halves decide unless they are equal, then unsigned comparison of low halves does
+        inline __m128i cmpgt(__m128i a, __m128i b, size_tag<8>) {
+          const __m128i sign = _mm_set1_epi32(static_cast<int>(0x80000000u));
+          __m128i greater = _mm_cmpgt_epi32(a, b);
+          __m128i equal = _mm_cmpeq_epi32(a, b);
+          __m128i low_greater = _mm_cmpgt_epi32(_mm_xor_si128(a, sign), _mm_xor_si128(b, sign));
+          __m128i result = _mm_or_si128(greater, _mm_and_si128(equal, _mm_shuffle_epi32(low_greater, _MM_SHUFFLE(2, 2, 0, 0))));
+          return _mm_shuffle_epi32(result, _MM_SHUFFLE(3, 3, 1, 1));
+        }
+
+        inline __m128i add(__m128i a, __m128i b, size_tag<1>) { return _mm_add_epi8(a, b); }
+        inline __m128i add(__m128i a, __m128i b, size_tag<2>) { return _mm_add_epi16(a, b); }
+        inline __m128i add(__m128i a, __m128i b, size_tag<4>) { return _mm_add_epi32(a, b); }
+        inline __m128i add(__m128i a, __m128i b, size_tag<8>) { return _mm_add_epi64(a, b); }
+
+        // Per-byte counters, used to count matches without extracting bit masks
+        inline __m128i zero_bytes() { return _mm_setzero_si128(); }
+        inline __m128i subtract_bytes(__m128i a, __m128i b) { return _mm_sub_epi8(a, b); }
+        inline std::size_t sum_bytes(__m128i v) {
+          __m128i sums = _mm_sad_epu8(v, _mm_setzero_si128());
+          return static_cast<std::size_t>(_mm_cvtsi128_si32(sums) + _mm_cvtsi128_si32(_mm_srli_si128(sums, 8)));
+        }
+
+        inline __m128i select(__m128i mask, __m128i a, __m128i b) {
+          return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+        }
+
+        template <typename T>
+        struct vec {
+          using value_type = T;
+          using reg = __m128i;
+          using size = size_tag<sizeof(T)>;
+          static constexpr std::size_t lanes = 16 / sizeof(T);
+
+          static reg loadu(const T* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+          static void storeu(T* p, reg v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+          static reg set1(T x) { return sse2::set1(static_cast<std::uint64_t>(x), size{}); }
+          static reg zero() { return _mm_setzero_si128(); }
+          static reg signed_order(reg v) {
+            return std::is_signed<T>::value ? v : _mm_xor_si128(v, set1(sign_bit<T>()));
+          }
+          static reg gt_mask(reg a, reg b) { return cmpgt(signed_order(a), signed_order(b), size{}); }
+          static __m128i eq_bytes(reg a, reg b) { return cmpeq(a, b, size{}); }
+          static unsigned eq(reg a, reg b) { return static_cast<unsigned>(_mm_movemask_epi8(eq_bytes(a, b))); }
+          static unsigned gt(reg a, reg b) { return static_cast<unsigned>(_mm_movemask_epi8(gt_mask(a, b))); }
+          static reg min(reg a, reg b) { return select(gt_mask(a, b), b, a); }
+          static reg max(reg a, reg b) { return select(gt_mask(a, b), a, b); }
+          static reg add(reg a, reg b) { return sse2::add(a, b, size{}); }
+          static reg nan_mask(reg) { return _mm_setzero_si128(); }
+          static reg bit_or(reg a, reg b) { return _mm_or_si128(a, b); }
+          static bool any(reg mask) { return _mm_movemask_epi8(mask) != 0; }
+        };
+
+        template <>
+        struct vec<float> {
+          using value_type = float;
+          using reg = __m128;
+          static constexpr std::size_t lanes = 4;
+
+          static reg loadu(const float* p) { return _mm_loadu_ps(p); }
+          static void storeu(float* p, reg v) { _mm_storeu_ps(p, v); }
+          static reg set1(float x) { return _mm_set1_ps(x); }
+          static reg zero() { return _mm_setzero_ps(); }
+          static __m128i eq_bytes(reg a, reg b) { return _mm_castps_si128(_mm_cmpeq_ps(a, b)); }
+          static unsigned eq(reg a, reg b) { return static_cast<unsigned>(_mm_movemask_epi8(eq_bytes(a, b))); }
+          static unsigned gt(reg a, reg b) {
+            return static_cast<unsigned>(_mm_movemask_epi8(_mm_castps_si128(_mm_cmpgt_ps(a, b))));
+          }
+          static reg min(reg a, reg b) { return _mm_min_ps(a, b); }
+          static reg max(reg a, reg b) { return _mm_max_ps(a, b); }
+          static reg add(reg a, reg b) { return _mm_add_ps(a, b); }
+          static reg nan_mask(reg v) { return _mm_cmpunord_ps(v, v); }
+          static reg bit_or(reg a, reg b) { return _mm_or_ps(a, b); }
+          static bool any(reg mask) { return _mm_movemask_ps(mask) != 0; }
+        };
+
+        template <>
+        struct vec<double> {
+          using value_type = double;
+          using reg = __m128d;
+          static constexpr std::size_t lanes = 2;
+
+          static reg loadu(const double* p) { return _mm_loadu_pd(p); }
+          static void storeu(double* p, reg v) { _mm_storeu_pd(p, v); }
+          static reg set1(double x) { return _mm_set1_pd(x); }
+          static reg zero() { return _mm_setzero_pd(); }
+          static __m128i eq_bytes(reg a, reg b) { return _mm_castpd_si128(_mm_cmpeq_pd(a, b)); }
+          static unsigned eq(reg a, reg b) { return static_cast<unsigned>(_mm_movemask_epi8(eq_bytes(a, b))); }
+          static unsigned gt(reg a, reg b) {
+            return static_cast<unsigned>(_mm_movemask_epi8(_mm_castpd_si128(_mm_cmpgt_pd(a, b))));
+          }
+          static reg min(reg a, reg b) { return _mm_min_pd(a, b); }
+          static reg max(reg a, reg b) { return _mm_max_pd(a, b); }
+          static reg add(reg a, reg b) { return _mm_add_pd(a, b); }
+          static reg nan_mask(reg v) { return _mm_cmpunord_pd(v, v); }
+          static reg bit_or(reg a, reg b) { return _mm_or_pd(a, b); }
+          static bool any(reg mask) { return _mm_movemask_pd(mask) != 0; }
+        };
+
+        #include "simd_search_kernels.hpp"
+      }
+
+      PHOSTDLIB_TARGET_AVX2_BEGIN
+      namespace avx2 {
+        inline __m256i set1(std::uint64_t x, size_tag<1>) { return _mm256_set1_epi8(static_cast<char>(x)); }
+        inline __m256i set1(std::uint64_t x, size_tag<2>) { return _mm256_set1_epi16(static_cast<short>(x)); }
+        inline __m256i set1(std::uint64_t x, size_tag<4>) { return _mm256_set1_epi32(static_cast<int>(x)); }
+        inline __m256i set1(std::uint64_t x, size_tag<8>) { return _mm256_set1_epi64x(static_cast<long long>(x)); }
+
+        inline __m256i cmpeq(__m256i a, __m256i b, size_tag<1>) { return _mm256_cmpeq_epi8(a, b); }
+        inline __m256i cmpeq(__m256i a, __m256i b, size_tag<2>) { return _mm256_cmpeq_epi16(a, b); }
+        inline __m256i cmpeq(__m256i a, __m256i b, size_tag<4>) { return _mm256_cmpeq_epi32(a, b); }
+        inline __m256i cmpeq(__m256i a, __m256i b, size_tag<8>) { return _mm256_cmpeq_epi64(a, b); }
+
+        inline __m256i cmpgt(__m256i a, __m256i b, size_tag<1>) { return _mm256_cmpgt_epi8(a, b); }
+        inline __m256i cmpgt(__m256i a, __m256i b, size_tag<2>) { return _mm256_cmpgt_epi16(a, b); }
+        inline __m256i cmpgt(__m256i a, __m256i b, size_tag<4>) { return _mm256_cmpgt_epi32(a, b); }
+        inline __m256i cmpgt(__m256i a, __m256i b, size_tag<8>) { return _mm256_cmpgt_epi64(a, b); }
+
+        inline __m256i add(__m256i a, __m256i b, size_tag<1>) { return _mm256_add_epi8(a, b); }
+        inline __m256i add(__m256i a, __m256i b, size_tag<2>) { return _mm256_add_epi16(a, b); }
+        inline __m256i add(__m256i a, __m256i b, size_tag<4>) { return _mm256_add_epi32(a, b); }
+        inline __m256i add(__m256i a, __m256i b, size_tag<8>) { return _mm256_add_epi64(a, b); }
+
+        inline __m256i zero_bytes() { return _mm256_setzero_si256(); }
+        inline __m256i subtract_bytes(__m256i a, __m256i b) { return _mm256_sub_epi8(a, b); }
+        inline std::size_t sum_bytes(__m256i v) {
+          __m256i sums = _mm256_sad_epu8(v, _mm256_setzero_si256());
+          __m128i halves = _mm_add_epi64(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+          return static_cast<std::size_t>(_mm_cvtsi128_si32(halves) + _mm_cvtsi128_si32(_mm_srli_si128(halves, 8)));
+        }
+
+        template <typename T>
+        struct vec {
+          using value_type = T;
+          using reg = __m256i;
+          using size = size_tag<sizeof(T)>;
+          static constexpr std::size_t lanes = 32 / sizeof(T);
+
+          static reg loadu(const T* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+          static void storeu(T* p, reg v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+          static reg set1(T x) { return avx2::set1(static_cast<std::uint64_t>(x), size{}); }
+          static reg zero() { return _mm256_setzero_si256(); }
+          static reg signed_order(reg v) {
+            return std::is_signed<T>::value ? v : _mm256_xor_si256(v, set1(sign_bit<T>()));
+          }
+          static reg gt_mask(reg a, reg b) { return cmpgt(signed_order(a), signed_order(b), size{}); }
+          static __m256i eq_bytes(reg a, reg b) { return cmpeq(a, b, size{}); }
+          static unsigned eq(reg a, reg b) { return static_cast<unsigned>(_mm256_movemask_epi8(eq_bytes(a, b))); }
+          static unsigned gt(reg a, reg b) { return static_cast<unsigned>(_mm256_movemask_epi8(gt_mask(a, b))); }
+          static reg min(reg a, reg b) { return _mm256_blendv_epi8(a, b, gt_mask(a, b)); }
+          static reg max(reg a, reg b) { return _mm256_blendv_epi8(b, a, gt_mask(a, b)); }
+          static reg add(reg a, reg b) { return avx2::add(a, b, size{}); }
+          static reg nan_mask(reg) { return _mm256_setzero_si256(); }
+          static reg bit_or(reg a, reg b) { return _mm256_or_si256(a, b); }
+          static bool any(reg mask) { return _mm256_movemask_epi8(mask) != 0; }
+        };
+
+        template <>
+        struct vec<float> {
+          using value_type = float;
+          using reg = __m256;
+          static constexpr std::size_t lanes = 8;
+
+          static reg loadu(const float* p) { return _mm256_loadu_ps(p); }
+          static void storeu(float* p, reg v) { _mm256_storeu_ps(p, v); }
+          static reg set1(float x) { return _mm256_set1_ps(x); }
+          static reg zero() { return _mm256_setzero_ps(); }
+          static __m256i eq_bytes(reg a, reg b) { return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)); }
+          static unsigned eq(reg a, reg b) { return static_cast<unsigned>(_mm256_movemask_epi8(eq_bytes(a, b))); }
+          static unsigned gt(reg a, reg b) {
+            return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_GT_OQ))));
+          }
+          static reg min(reg a, reg b) { return _mm256_min_ps(a, b); }
+          static reg max(reg a, reg b) { return _mm256_max_ps(a, b); }
+          static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+          static reg nan_mask(reg v) { return _mm256_cmp_ps(v, v, _CMP_UNORD_Q); }
+          static reg bit_or(reg a, reg b) { return _mm256_or_ps(a, b); }
+          static bool any(reg mask) { return _mm256_movemask_ps(mask) != 0; }
+        };
+
+        template <>
+        struct vec<double> {
+          using value_type = double;
+          using reg = __m256d;
+          static constexpr std::size_t lanes = 4;
+
+          static reg loadu(const double* p) { return _mm256_loadu_pd(p); }
+          static void storeu(double* p, reg v) { _mm256_storeu_pd(p, v); }
+          static reg set1(double x) { return _mm256_set1_pd(x); }
+          static reg zero() { return _mm256_setzero_pd(); }
+          static __m256i eq_bytes(reg a, reg b) { return _mm256_castpd_si256(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)); }
+          static unsigned eq(reg a, reg b) { return static_cast<unsigned>(_mm256_movemask_epi8(eq_bytes(a, b))); }
+          static unsigned gt(reg a, reg b) {
+            return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_castpd_si256(_mm256_cmp_pd(a, b, _CMP_GT_OQ))));
+          }
+          static reg min(reg a, reg b) { return _mm256_min_pd(a, b); }
+          static reg max(reg a, reg b) { return _mm256_max_pd(a, b); }
+          static reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+          static reg nan_mask(reg v) { return _mm256_cmp_pd(v, v, _CMP_UNORD_Q); }
+          static reg bit_or(reg a, reg b) { return _mm256_or_pd(a, b); }
+          static bool any(reg mask) { return _mm256_movemask_pd(mask) != 0; }
+        };
+
+        #include "simd_search_kernels.hpp"
+      }
+      PHOSTDLIB_TARGET_END
+    }
+  }
+}
+#define PHOSTDLIB_SIMD_SEARCH 1
+#endif
+
+namespace phoenix {
+  namespace detail {
+    namespace simd_search {
+      // Every function below runs the kernel for the best instruction set available and returns
+      // true, or returns false when no instruction set is enabled and generic code has to run
+
+      template <typename T>
+      bool is_sorted_until(const T* data, std::size_t length, bool descending, std::size_t& result) {
+      #ifdef PHOSTDLIB_SIMD_SEARCH
+        auto level = cpu::active_level();
+        if (level >= simd_level::avx2) {
+          result = avx2::is_sorted_until<avx2::vec<T>>(data, length, descending);
+          return true;
+        }
+        if (level >= simd_level::sse2) {
+          result = sse2::is_sorted_until<sse2::vec<T>>(data, length, descending);
+          return true;
+        }
+      #endif
+        (void)data, (void)length, (void)descending, (void)result;
+        return false;
+      }
+
+      template <typename T>
+      bool find(const T* data, std::size_t length, T value, std::size_t& result) {
+      #ifdef PHOSTDLIB_SIMD_SEARCH
+        auto level = cpu::active_level();
+        if (level >= simd_level::avx2) {
+          result = avx2::find<avx2::vec<T>>(data, length, value);
+          return true;
+        }
+        if (level >= simd_level::sse2) {
+          result = sse2::find<sse2::vec<T>>(data, length, value);
+          return true;
+        }
+      #endif
+        (void)data, (void)length, (void)value, (void)result;
+        return false;
+      }
+
+      template <typename T>
+      bool count(const T* data, std::size_t length, T value, std::size_t& result) {
+      #ifdef PHOSTDLIB_SIMD_SEARCH
+        auto level = cpu::active_level();
+        if (level >= simd_level::avx2) {
+          result = avx2::count<avx2::vec<T>>(data, length, value);
+          return true;
+        }
+        if (level >= simd_level::sse2) {
+          result = sse2::count<sse2::vec<T>>(data, length, value);
+          return true;
+        }
+      #endif
+        (void)data, (void)length, (void)value, (void)result;
+        return false;
+      }
+
+      template <typename T>
+      bool equal(const T* first, const T* second, std::size_t length, bool& result) {
+      #ifdef PHOSTDLIB_SIMD_SEARCH
+        auto level = cpu::active_level();
+        if (level >= simd_level::avx2) {
+          result = avx2::equal<avx2::vec<T>>(first, second, length);
+          return true;
+        }
+        if (level >= simd_level::sse2) {
+          result = sse2::equal<sse2::vec<T>>(first, second, length);
+          return true;
+        }
+      #endif
+        (void)first, (void)second, (void)length, (void)result;
+        return false;
+      }
+
+      template <typename T>
+      bool find_substring(const T* data, std::size_t length, const T* needle, std::size_t needle_length,
+                          std::size_t& result) {
+      #ifdef PHOSTDLIB_SIMD_SEARCH
+        auto level = cpu::active_level();
+        if (level >= simd_level::avx2) {
+          result = avx2::find_substring<avx2::vec<T>>(data, length, needle, needle_length);
+          return true;
+        }
+        if (level >= simd_level::sse2) {
+          result = sse2::find_substring<sse2::vec<T>>(data, length, needle, needle_length);
+          return true;
+        }
+      #endif
+        (void)data, (void)length, (void)needle, (void)needle_length, (void)result;
+        return false;
+      }
+
+      template <bool Min, bool Max, typename T>
+      bool extreme_indices(const T* data, std::size_t length, std::size_t& min_index, std::size_t& max_index) {
+      #ifdef PHOSTDLIB_SIMD_SEARCH
+        auto level = cpu::active_level();
+        if (level >= simd_level::avx2) {
+          return avx2::extreme_indices<avx2::vec<T>, Min, Max>(data, length, min_index, max_index);
+        }
+        if (level >= simd_level::sse2) {
+          return sse2::extreme_indices<sse2::vec<T>, Min, Max>(data, length, min_index, max_index);
+        }
+      #endif
+        (void)data, (void)length, (void)min_index, (void)max_index;
+        return false;
+      }
+
+      template <typename T>
+      bool accumulate(const T* data, std::size_t length, T init, T& result) {
+      #ifdef PHOSTDLIB_SIMD_SEARCH
+        auto level = cpu::active_level();
+        if (level >= simd_level::avx2) {
+          result = avx2::accumulate<avx2::vec<T>>(data, length, init);
+          return true;
+        }
+        if (level >= simd_level::sse2) {
+          result = sse2::accumulate<sse2::vec<T>>(data, length, init);
+          return true;
+        }
+      #endif
+        // Floating-point sums have to come out the same as on the vector paths
+        if (std::is_floating_point<T>::value) {
+          result = accumulate_portable(data, length, init);
+          return true;
+        }
+        (void)data, (void)length, (void)init, (void)result;
+        return false;
+      }
+    }
+  }
+}
+
+#endif //PHOSTDLIB_DETAIL_SIMD_SEARCH_HPP
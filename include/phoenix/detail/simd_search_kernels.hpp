@@ -0,0 +1,168 @@
+// Search and reduction kernels shared by all instruction sets. This file is included inside the
+// namespace of every instruction set, after its vec<T> traits and byte counters, so it has no include guard.
+// Masks returned by the traits have one bit per byte, so lane = bit / sizeof(value_type).
+
+template <typename V>
+std::size_t lane_of(unsigned bits) {
+  return static_cast<std::size_t>(__builtin_ctz(bits)) / sizeof(typename V::value_type);
+}
+
+template <typename V>
+constexpr unsigned all_bits() {
+  return V::lanes * sizeof(typename V::value_type) == 32 ? ~0u
+                                                         : (1u << (V::lanes * sizeof(typename V::value_type))) - 1;
+}
+
+// Index of the first element out of order, or length
+template <typename V>
+std::size_t is_sorted_until(const typename V::value_type* data, std::size_t length, bool descending) {
+  std::size_t i = 0;
+  for (; i + V::lanes < length; i += V::lanes) {
+    auto current = V::loadu(data + i), next = V::loadu(data + i + 1);
+    unsigned bits = descending ? V::gt(next, current) : V::gt(current, next);
+    if (bits != 0) return i + lane_of<V>(bits) + 1;
+  }
+  for (; i + 1 < length; i++) {
+    if (descending ? data[i + 1] > data[i] : data[i] > data[i + 1]) return i + 1;
+  }
+  return length;
+}
+
+template <typename V>
+std::size_t find(const typename V::value_type* data, std::size_t length, typename V::value_type value) {
+  auto needle = V::set1(value);
+  std::size_t i = 0;
+  for (; i + 2 * V::lanes <= length; i += 2 * V::lanes) {
+    unsigned first = V::eq(V::loadu(data + i), needle);
+    unsigned second = V::eq(V::loadu(data + i + V::lanes), needle);
+    if ((first | second) != 0) return first != 0 ? i + lane_of<V>(first) : i + V::lanes + lane_of<V>(second);
+  }
+  for (; i < length; i++) {
+    if (data[i] == value) return i;
+  }
+  return length;
+}
+
+template <typename V>
+std::size_t count(const typename V::value_type* data, std::size_t length, typename V::value_type value) {
+  auto needle = V::set1(value);
+  std::size_t bytes = 0, i = 0;
+  // Every matching element adds one to each of its bytes, a byte counter is full after 255 registers
+  while (i + V::lanes <= length) {
+    std::size_t blocks = (length - i) / V::lanes;
+    if (blocks > 255) blocks = 255;
+    auto counter = zero_bytes();
+    for (std::size_t block = 0; block < blocks; block++, i += V::lanes) {
+      counter = subtract_bytes(counter, V::eq_bytes(V::loadu(data + i), needle));
+    }
+    bytes += sum_bytes(counter);
+  }
+  std::size_t total = bytes / sizeof(typename V::value_type);
+  for (; i < length; i++) {
+    if (data[i] == value) total++;
+  }
+  return total;
+}
+
+template <typename V>
+bool equal(const typename V::value_type* first, const typename V::value_type* second, std::size_t length) {
+  std::size_t i = 0;
+  for (; i + V::lanes <= length; i += V::lanes) {
+    if (V::eq(V::loadu(first + i), V::loadu(second + i)) != all_bits<V>()) return false;
+  }
+  for (; i < length; i++) {
+    if (!(first[i] == second[i])) return false;
+  }
+  return true;
+}
+
+// First occurrence of a needle of at least 2 elements, or length. Positions where both the first
+// and the last element of the needle match are compared in full (Mula's SIMD-friendly search).
+template <typename V>
+std::size_t find_substring(const typename V::value_type* data, std::size_t length,
+                           const typename V::value_type* needle, std::size_t needle_length) {
+  if (needle_length > length) return length;
+  auto first = V::set1(needle[0]), last = V::set1(needle[needle_length - 1]);
+  std::size_t end = length - needle_length + 1, i = 0;
+  std::size_t middle = (needle_length - 2) * sizeof(typename V::value_type);
+  for (; i + V::lanes <= end; i += V::lanes) {
+    unsigned bits = V::eq(V::loadu(data + i), first) & V::eq(V::loadu(data + i + needle_length - 1), last);
+    while (bits != 0) {
+      std::size_t lane = lane_of<V>(bits);
+      if (std::memcmp(data + i + lane + 1, needle + 1, middle) == 0) return i + lane;
+      bits &= static_cast<unsigned>(~((std::uint64_t{1} << ((lane + 1) * sizeof(typename V::value_type))) - 1));
+    }
+  }
+  for (; i < end; i++) {
+    if (data[i] == needle[0] && std::memcmp(data + i + 1, needle + 1, middle + sizeof(*data)) == 0) return i;
+  }
+  return length;
+}
+
+// Finds the smallest and/or the biggest value with vector min/max, then the first element equal
+// to it. Returns false for ranges shorter than one register and ranges containing NaN, where
+// min/max instructions don't agree with comparisons.
+template <typename V, bool Min, bool Max>
+bool extreme_indices(const typename V::value_type* data, std::size_t length,
+                     std::size_t& min_index, std::size_t& max_index) {
+  using T = typename V::value_type;
+  if (length < V::lanes) return false;
+
+  auto low = V::loadu(data), high = low;
+  auto nan = V::nan_mask(low);
+  // The last register overlaps the previous one, which doesn't change a minimum or maximum
+  for (std::size_t i = V::lanes; i < length; i += V::lanes) {
+    auto v = V::loadu(data + (i + V::lanes <= length ? i : length - V::lanes));
+    if (Min) low = V::min(low, v);
+    if (Max) high = V::max(high, v);
+    nan = V::bit_or(nan, V::nan_mask(v));
+  }
+  if (V::any(nan)) return false;
+
+  T low_lanes[V::lanes], high_lanes[V::lanes];
+  V::storeu(low_lanes, low);
+  V::storeu(high_lanes, high);
+  T low_value = low_lanes[0], high_value = high_lanes[0];
+  for (std::size_t lane = 1; lane < V::lanes; lane++) {
+    if (low_value > low_lanes[lane]) low_value = low_lanes[lane];
+    if (high_lanes[lane] > high_value) high_value = high_lanes[lane];
+  }
+  if (Min) min_index = find<V>(data, length, low_value);
+  if (Max) max_index = find<V>(data, length, high_value);
+  return true;
+}
+
+// Sums into accumulator_width<T> partial sums, four times over - the same for every instruction
+// set, so floating-point results don't depend on the active level (they can still differ from
+// a sequential sum by rounding). Narrower registers keep one partial sum in several of them.
+template <typename V>
+typename V::value_type accumulate(const typename V::value_type* data, std::size_t length,
+                                  typename V::value_type init) {
+  using T = typename V::value_type;
+  constexpr std::size_t width = accumulate_width<T>::value;
+  constexpr std::size_t parts = width / V::lanes;
+  typename V::reg s0[parts], s1[parts], s2[parts], s3[parts];
+  for (std::size_t p = 0; p < parts; p++) s0[p] = s1[p] = s2[p] = s3[p] = V::zero();
+
+  std::size_t i = 0;
+  for (; i + 4 * width <= length; i += 4 * width) {
+    for (std::size_t p = 0; p < parts; p++) {
+      s0[p] = V::add(s0[p], V::loadu(data + i + p * V::lanes));
+      s1[p] = V::add(s1[p], V::loadu(data + i + width + p * V::lanes));
+      s2[p] = V::add(s2[p], V::loadu(data + i + 2 * width + p * V::lanes));
+      s3[p] = V::add(s3[p], V::loadu(data + i + 3 * width + p * V::lanes));
+    }
+  }
+  for (; i + width <= length; i += width) {
+    for (std::size_t p = 0; p < parts; p++) s0[p] = V::add(s0[p], V::loadu(data + i + p * V::lanes));
+  }
+
+  T lanes[width];
+  for (std::size_t p = 0; p < parts; p++) {
+    V::storeu(lanes + p * V::lanes, V::add(V::add(s0[p], s1[p]), V::add(s2[p], s3[p])));
+  }
+  T sum = init;
+  for (std::size_t lane = 0; lane < width; lane++) sum = static_cast<T>(sum + lanes[lane]);
+  for (; i < length; i++) sum = static_cast<T>(sum + data[i]);
+  return sum;
+}
@@ -0,0 +1,163 @@
+// Vectorized quicksort kernels, generic over vec<T> register traits.
+// No include guard on purpose - sort.hpp includes this file once per instruction set,
+// inside a namespace compiled for that instruction set.
+
+template <typename V>
+typename V::reg bitonic_step(typename V::reg v, const std::int32_t* index, unsigned min_bits) {
+  auto partner = V::permute(v, index);
+  return V::blend(V::max(v, partner), V::min(v, partner), min_bits);
+}
+
+template <typename V>
+typename V::reg sort_register(typename V::reg v) {
+  const auto& network = bitonic_network<V::lanes, V::lanes32>::get();
+  for (std::size_t s = 0; s < network.sort_steps; s++) {
+    v = bitonic_step<V>(v, network.sort_index[s], network.sort_min_bits[s]);
+  }
+  return v;
+}
+
+// Sorts a register holding a bitonic sequence
+template <typename V>
+typename V::reg merge_register(typename V::reg v) {
+  const auto& network = bitonic_network<V::lanes, V::lanes32>::get();
+  for (std::size_t s = 0; s < network.log_lanes; s++) {
+    v = bitonic_step<V>(v, network.merge_index[s], network.merge_min_bits[s]);
+  }
+  return v;
+}
+
+constexpr std::size_t small_registers = 8;
+
+// Sorts up to small_registers * lanes elements, padding the tail with the greatest key
+template <typename V>
+void sort_small(typename V::value_type* data, std::size_t length) {
+  using reg = typename V::reg;
+  constexpr std::size_t lanes = V::lanes;
+  const auto& network = bitonic_network<V::lanes, V::lanes32>::get();
+
+  std::size_t count = 1;
+  while (count * lanes < length) count *= 2;
+
+  typename V::value_type buffer[small_registers * lanes];
+  for (std::size_t i = 0; i < length; i++) buffer[i] = data[i];
+  for (std::size_t i = length; i < count * lanes; i++) buffer[i] = V::max_value();
+
+  reg r[small_registers];
+  for (std::size_t i = 0; i < count; i++) r[i] = sort_register<V>(V::loadu(buffer + i * lanes));
+
+  for (std::size_t width = 1; width < count; width *= 2) {
+    for (std::size_t block = 0; block < count; block += 2 * width) {
+      // Reversing the second run makes the pair of runs a bitonic sequence
+      reg* second = r + block + width;
+      for (std::size_t i = 0; i < width / 2; i++) {
+        reg t = second[i];
+        second[i] = second[width - 1 - i];
+        second[width - 1 - i] = t;
+      }
+      for (std::size_t i = 0; i < width; i++) second[i] = V::permute(second[i], network.reverse_index);
+
+      for (std::size_t distance = width; distance > 0; distance /= 2) {
+        for (std::size_t i = block; i < block + 2 * width; i++) {
+          if (((i - block) & distance) != 0) continue;
+          // Compare and blend instead of min/max - min/max return one operand for both
+          // outputs on equal keys (-0.0 and +0.0) or NaN, which would duplicate an element
+          unsigned swap_bits = V::gt(r[i], r[i + distance]);
+          reg low = V::blend(r[i], r[i + distance], swap_bits);
+          r[i + distance] = V::blend(r[i + distance], r[i], swap_bits);
+          r[i] = low;
+        }
+      }
+      for (std::size_t i = block; i < block + 2 * width; i++) r[i] = merge_register<V>(r[i]);
+    }
+  }
+
+  for (std::size_t i = 0; i < count; i++) V::storeu(buffer + i * lanes, r[i]);
+  for (std::size_t i = 0; i < length; i++) data[i] = buffer[i];
+}
+
+template <typename V, bool GreaterOrEqual>
+void partition_register(typename V::value_type* data, typename V::reg v, typename V::reg pivot,
+                        std::size_t& left, std::size_t& right) {
+  unsigned right_bits = GreaterOrEqual ? V::ge(v, pivot) : V::gt(v, pivot);
+  std::size_t right_count = static_cast<std::size_t>(__builtin_popcount(right_bits));
+  partition_store<V>(data + left, data + right, v, right_bits, right_count);
+  left += V::lanes - right_count;
+  right -= right_count;
+}
+
+// In-place partition, needs length >= 2 * lanes. Elements greater than pivot (or greater
+// or equal, when GreaterOrEqual is set) are moved to the right side, returns the split point.
+// First and last register are kept aside, which leaves a free register on both sides of the
+// unread part - every loaded register is partitioned into that free space.
+template <typename V, bool GreaterOrEqual>
+std::size_t partition(typename V::value_type* data, std::size_t length, typename V::value_type pivot_value) {
+  using value_type = typename V::value_type;
+  constexpr std::size_t lanes = V::lanes;
+  auto pivot = V::set1(pivot_value);
+
+  auto first = V::loadu(data);
+  auto last = V::loadu(data + length - lanes);
+  std::size_t read_left = lanes, read_right = length - lanes;
+  std::size_t left = 0, right = length;
+
+  while (read_right - read_left >= lanes) {
+    typename V::reg v;
+    // Read from the side with less free space, so the stores never overwrite unread data
+    if (read_left - left <= right - read_right) {
+      v = V::loadu(data + read_left);
+      read_left += lanes;
+    } else {
+      read_right -= lanes;
+      v = V::loadu(data + read_right);
+    }
+    partition_register<V, GreaterOrEqual>(data, v, pivot, left, right);
+  }
+
+  value_type rest[lanes];
+  std::size_t rest_length = read_right - read_left;
+  for (std::size_t i = 0; i < rest_length; i++) rest[i] = data[read_left + i];
+  for (std::size_t i = 0; i < rest_length; i++) {
+    bool goes_right = GreaterOrEqual ? !(rest[i] < pivot_value) : pivot_value < rest[i];
+    if (goes_right) data[--right] = rest[i];
+    else data[left++] = rest[i];
+  }
+
+  partition_register<V, GreaterOrEqual>(data, first, pivot, left, right);
+  partition_register<V, GreaterOrEqual>(data, last, pivot, left, right);
+  return left;
+}
+
+template <typename V>
+void sort_loop(typename V::value_type* data, std::size_t length, std::size_t depth) {
+  while (length > small_registers * V::lanes) {
+    if (depth == 0) {
+      heap_sort_n(data, length, greater_fn{});
+      return;
+    }
+    depth--;
+
+    auto pivot = *pick_pivot(data, length);
+    std::size_t split = partition<V, false>(data, length, pivot);
+    if (split == length) {
+      // Pivot is the greatest key - separate its duplicates, they are already in place
+      length = partition<V, true>(data, length, pivot);
+      continue;
+    }
+
+    if (split < length - split) {
+      sort_loop<V>(data, split, depth);
+      data += split;
+      length -= split;
+    } else {
+      sort_loop<V>(data + split, length - split, depth);
+      length = split;
+    }
+  }
+  sort_small<V>(data, length);
+}
+
+template <typename T>
+void sort(T* data, std::size_t length) {
+  sort_loop<vec<T>>(data, length, introsort_depth(length));
+}
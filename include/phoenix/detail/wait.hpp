@@ -0,0 +1,122 @@
+#ifndef PHOSTDLIB_DETAIL_WAIT_HPP
+#define PHOSTDLIB_DETAIL_WAIT_HPP
+#include <phoenix/cpu.hpp>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <thread>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace phoenix {
+  namespace detail {
+    static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "Futex word has to be a plain integer");
+
+    // Sleeps while word == expected (or until woken), may return spuriously.
+    // Without futexes both calls degrade to yielding.
+    inline void futex_wait(std::atomic<std::uint32_t>& word, std::uint32_t expected) {
+    #ifdef __linux__
+      syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+    #else
+      if (word.load(std::memory_order_relaxed) == expected) std::this_thread::yield();
+    #endif
+    }
+
+    inline void futex_wake(std::atomic<std::uint32_t>& word, int threads) {
+    #ifdef __linux__
+      syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE_PRIVATE, threads, nullptr, nullptr, 0);
+    #else
+      (void)word;
+      (void)threads;
+    #endif
+    }
+
+    // Exponentially longer busy waits, then yielding
+    class backoff {
+     public:
+      void pause() {
+        if (_step < spin_steps) {
+          for (unsigned i = 0; i < (1u << _step); i++) {
+          #ifdef PHOSTDLIB_X86_SIMD
+            _mm_pause();
+          #else
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+          #endif
+          }
+        } else {
+          std::this_thread::yield();
+        }
+        _step++;
+      }
+
+      // Time to go to sleep instead
+      bool exhausted() const { return _step >= spin_steps + yield_steps; }
+      void reset() { _step = 0; }
+
+     private:
+      static constexpr unsigned spin_steps = 7;
+      static constexpr unsigned yield_steps = 4;
+      unsigned _step = 0;
+    };
+
+    // Lets threads sleep until a condition (stored elsewhere) may have become true.
+    // Notifications cost a fence and a load while nobody sleeps.
+    class event {
+     public:
+      // Call after making the condition true
+      void notify_one() { notify(1); }
+      void notify_all() { notify(INT_MAX); }
+
+      // A waiter registers itself and then checks the condition once more, so it either sees the
+      // condition or the notifier sees the waiter and bumps the epoch, which fails or ends
+      // futex_wait. After prepare_wait, call either cancel_wait or wait with the returned key.
+      std::uint32_t prepare_wait() {
+        _waiters.fetch_add(1, std::memory_order_seq_cst);
+        std::uint32_t key = _epoch.load(std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return key;
+      }
+
+      void cancel_wait() { _waiters.fetch_sub(1, std::memory_order_relaxed); }
+
+      void wait(std::uint32_t key) {
+        futex_wait(_epoch, key);
+        _waiters.fetch_sub(1, std::memory_order_relaxed);
+      }
+
+      // Calls attempt until it returns true, backing off and then sleeping between failures
+      template <typename Attempt>
+      void wait_until(Attempt attempt) {
+        backoff delay;
+        while (!attempt()) {
+          if (!delay.exhausted()) {
+            delay.pause();
+            continue;
+          }
+          std::uint32_t key = prepare_wait();
+          if (attempt()) {
+            cancel_wait();
+            return;
+          }
+          wait(key);
+        }
+      }
+
+     private:
+      void notify(int threads) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_waiters.load(std::memory_order_relaxed) == 0) return;
+        _epoch.fetch_add(1, std::memory_order_seq_cst);
+        futex_wake(_epoch, threads);
+      }
+
+      std::atomic<std::uint32_t> _epoch{0};
+      std::atomic<std::uint32_t> _waiters{0};
+    };
+  }
+}
+
+#endif //PHOSTDLIB_DETAIL_WAIT_HPP
@@ -0,0 +1,60 @@
+#ifndef PHOSTDLIB_EXECUTION_HPP
+#define PHOSTDLIB_EXECUTION_HPP
+#include <phoenix/thread_pool.hpp>
+#include <cstddef>
+
+// Execution policies of the numeric algorithms:
+// - seq runs a plain loop, in order,
+// - unseq may reorder operations so that they run on SIMD registers,
+// - par splits the range into chunks of a fixed size, processed by a thread pool with the unseq
+//   kernels. Chunk boundaries don't depend on the number of threads and vectorized sums keep
+//   the same partial sums on every instruction set, so results (floating-point ones too) are the
+//   same for any pool size and CPU.
+namespace phoenix {
+  namespace execution {
+    struct sequenced_policy {};
+
+    struct unsequenced_policy {};
+
+    struct parallel_policy {
+      thread_pool* pool;
+      std::size_t chunk_size;
+
+      // Same policy, running on given pool instead of default_thread_pool()
+      parallel_policy on(thread_pool& other) const { return parallel_policy{&other, chunk_size}; }
+      parallel_policy chunk(std::size_t size) const { return parallel_policy{pool, size > 0 ? size : 1}; }
+
+      thread_pool& executor() const { return pool != nullptr ? *pool : default_thread_pool(); }
+    };
+
+    constexpr sequenced_policy seq{};
+    constexpr unsequenced_policy unseq{};
+    constexpr parallel_policy par{nullptr, std::size_t{1} << 16};
+  }
+
+  namespace detail {
+    // Calls function(offset, length) for every chunk of the range, the first one on the calling thread
+    template <typename Function>
+    void for_each_chunk(const execution::parallel_policy& policy, std::size_t length, Function function) {
+      std::size_t size = policy.chunk_size > 0 ? policy.chunk_size : 1;
+      if (length <= size) {
+        if (length > 0) function(std::size_t{0}, length);
+        return;
+      }
+      task_group group(policy.executor());
+      for (std::size_t offset = size; offset < length; offset += size) {
+        std::size_t chunk = length - offset < size ? length - offset : size;
+        group.run([&function, offset, chunk]() { function(offset, chunk); });
+      }
+      function(std::size_t{0}, size);
+      group.wait();
+    }
+
+    inline std::size_t chunk_count(const execution::parallel_policy& policy, std::size_t length) {
+      std::size_t size = policy.chunk_size > 0 ? policy.chunk_size : 1;
+      return (length + size - 1) / size;
+    }
+  }
+}
+
+#endif //PHOSTDLIB_EXECUTION_HPP
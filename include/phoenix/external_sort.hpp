@@ -0,0 +1,355 @@
+#ifndef PHOSTDLIB_EXTERNAL_SORT_HPP
+#define PHOSTDLIB_EXTERNAL_SORT_HPP
+#include <phoenix/sort.hpp>
+#include <phoenix/vector.hpp>
+#include <phoenix/detail/loser_tree.hpp>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <future>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unistd.h>
+
+namespace phoenix {
+  struct external_sort_config {
+    // Memory used for sorting runs and, during merging, for all stream buffers together
+    std::size_t memory_budget = std::size_t(256) << 20;
+    // Maximal number of runs merged at once, more runs are merged in several passes
+    std::size_t fan_in = 64;
+    // Upper limit of a single I/O request
+    std::size_t io_buffer_size = std::size_t(8) << 20;
+    // Directory for temporary run files, TMPDIR (or /tmp) when empty
+    std::string temp_directory;
+    // Keep records with equal keys in input order. Merging is always stable, this makes
+    // the sort of every run stable as well, at the cost of a 32-bit index per record of the run.
+    bool stable = false;
+  };
+
+  namespace detail {
+    inline std::FILE* open_file(const std::string& path, const char* mode) {
+      std::FILE* file = std::fopen(path.c_str(), mode);
+      if (file == nullptr) throw std::runtime_error("Cannot open file " + path);
+      return file;
+    }
+
+    // Sequential reader, the next block is read in the background while the current one is consumed
+    template <typename Record>
+    class record_reader {
+     public:
+      record_reader(const std::string& path, std::size_t buffer_records)
+          : _file{open_file(path, "rb")}, _capacity{buffer_records}, _first(buffer_records),
+            _second(buffer_records), _current{&_first[0]}, _next{&_second[0]}, _position{0}, _count{0} {
+        std::setvbuf(_file, nullptr, _IONBF, 0);
+        prefetch();
+        refill();
+      }
+
+      record_reader(const record_reader&) = delete;
+      record_reader& operator=(const record_reader&) = delete;
+
+      ~record_reader() {
+        if (_pending.valid()) _pending.wait();
+        std::fclose(_file);
+      }
+
+      bool empty() const { return _position == _count; }
+      const Record& front() const { return _current[_position]; }
+
+      void pop() {
+        if (++_position == _count) refill();
+      }
+
+     private:
+      void prefetch() {
+        Record* data = _next;
+        std::FILE* file = _file;
+        std::size_t capacity = _capacity;
+        _pending = std::async(std::launch::async, [=]() {
+          std::size_t count = std::fread(data, sizeof(Record), capacity, file);
+          if (count < capacity && std::ferror(file)) throw std::runtime_error("Reading records failed");
+          return count;
+        });
+      }
+
+      void refill() {
+        _position = 0;
+        _count = _pending.valid() ? _pending.get() : 0;
+        Record* t = _current;
+        _current = _next;
+        _next = t;
+        if (_count == _capacity) prefetch();
+      }
+
+      std::FILE* _file;
+      std::size_t _capacity;
+      vector<Record> _first, _second;
+      Record* _current;
+      Record* _next;
+      std::size_t _position, _count;
+      std::future<std::size_t> _pending;
+    };
+
+    // Sequential writer, full blocks are written in the background while the next one is filled
+    template <typename Record>
+    class record_writer {
+     public:
+      record_writer(const std::string& path, std::size_t buffer_records)
+          : _file{open_file(path, "wb")}, _capacity{buffer_records}, _first(buffer_records),
+            _second(buffer_records), _current{&_first[0]}, _next{&_second[0]}, _count{0} {
+        std::setvbuf(_file, nullptr, _IONBF, 0);
+      }
+
+      record_writer(const record_writer&) = delete;
+      record_writer& operator=(const record_writer&) = delete;
+
+      ~record_writer() {
+        if (_file == nullptr) return;
+        if (_pending.valid()) _pending.wait();
+        std::fclose(_file);
+      }
+
+      void push(const Record& record) {
+        _current[_count++] = record;
+        if (_count == _capacity) flush();
+      }
+
+      // Writes directly from caller's memory, used for whole sorted runs
+      void write(const Record* records, std::size_t count) {
+        flush();
+        if (_pending.valid()) _pending.get();
+        if (std::fwrite(records, sizeof(Record), count, _file) != count)
+          throw std::runtime_error("Writing records failed");
+      }
+
+      void close() {
+        flush();
+        if (_pending.valid()) _pending.get();
+        bool failed = std::fclose(_file) != 0;
+        _file = nullptr;
+        if (failed) throw std::runtime_error("Closing output file failed");
+      }
+
+     private:
+      void flush() {
+        if (_count == 0) return;
+        if (_pending.valid()) _pending.get();
+        Record* t = _current;
+        _current = _next;
+        _next = t;
+        const Record* data = _next;
+        std::FILE* file = _file;
+        std::size_t count = _count;
+        _pending = std::async(std::launch::async, [=]() {
+          if (std::fwrite(data, sizeof(Record), count, file) != count)
+            throw std::runtime_error("Writing records failed");
+        });
+        _count = 0;
+      }
+
+      std::FILE* _file;
+      std::size_t _capacity;
+      vector<Record> _first, _second;
+      Record* _current;
+      Record* _next;
+      std::size_t _count;
+      std::future<void> _pending;
+    };
+
+    // Removes the files it owns on destruction
+    class temp_files {
+     public:
+      explicit temp_files(const std::string& directory) : _directory{directory} {
+        if (_directory.empty()) {
+          const char* env = std::getenv("TMPDIR");
+          _directory = env != nullptr && *env != '\0' ? env : "/tmp";
+        }
+      }
+
+      temp_files(const temp_files&) = delete;
+      temp_files& operator=(const temp_files&) = delete;
+
+      ~temp_files() {
+        for (std::size_t i = 0; i < _paths.size(); i++) {
+          if (!_paths[i].empty()) std::remove(_paths[i].c_str());
+        }
+      }
+
+      std::size_t create() {
+        std::string path = _directory + "/phoenix_run_XXXXXX";
+        int fd = mkstemp(&path[0]);
+        if (fd < 0) throw std::runtime_error("Cannot create temporary file in " + _directory);
+        ::close(fd);
+        _paths.push(path);
+        return _paths.size() - 1;
+      }
+
+      const std::string& path(std::size_t id) const { return _paths[id]; }
+
+      void remove(std::size_t id) {
+        std::remove(_paths[id].c_str());
+        _paths[id].clear();
+      }
+
+     private:
+      std::string _directory;
+      vector<std::string> _paths;
+    };
+  }
+
+  // Sorts binary files of fixed-size records which don't fit in memory. Runs of memory_budget
+  // bytes are sorted with phoenix::sort and written to temporary files, which are then merged
+  // fan_in at a time with a loser tree.
+  template <typename Record, typename Compare = greater_fn>
+  class external_sorter {
+    static_assert(std::is_trivially_copyable<Record>::value, "Records are stored as raw bytes");
+
+   public:
+    explicit external_sorter(const external_sort_config& config = external_sort_config{},
+                             Compare compare = Compare{})
+        : _config(config), _compare(compare) {
+      if (_config.fan_in < 2) throw std::invalid_argument("External sort fan-in must be at least 2");
+      if (run_records() == 0) throw std::invalid_argument("Memory budget is too small");
+    }
+
+    void sort(const std::string& input_path, const std::string& output_path) {
+      detail::temp_files temp(_config.temp_directory);
+      vector<std::size_t> runs;
+      if (make_runs(input_path, output_path, temp, runs)) return;
+
+      // Intermediate passes, until the last merge can write the output directly
+      while (runs.size() > _config.fan_in) {
+        vector<std::size_t> merged;
+        for (std::size_t first = 0; first < runs.size(); first += _config.fan_in) {
+          std::size_t last = first + _config.fan_in < runs.size() ? first + _config.fan_in : runs.size();
+          std::size_t output = temp.create();
+          merge(temp, runs, first, last, temp.path(output));
+          for (std::size_t i = first; i < last; i++) temp.remove(runs[i]);
+          merged.push(output);
+        }
+        runs = std::move(merged);
+      }
+      merge(temp, runs, 0, runs.size(), output_path);
+    }
+
+   private:
+    std::size_t io_records(std::size_t streams) const {
+      // Every stream is double-buffered
+      std::size_t bytes = _config.memory_budget / (2 * streams);
+      if (bytes > _config.io_buffer_size) bytes = _config.io_buffer_size;
+      std::size_t records = bytes / sizeof(Record);
+      return records > 0 ? records : 1;
+    }
+
+    // Stable runs are sorted through 32-bit indices of their records, which take a part of the budget
+    std::size_t run_records() const {
+      if (!_config.stable) return _config.memory_budget / sizeof(Record);
+      std::size_t records = _config.memory_budget / (sizeof(Record) + sizeof(std::uint32_t));
+      std::size_t limit = std::numeric_limits<std::uint32_t>::max();
+      return records < limit ? records : limit;
+    }
+
+    // Sorts indices with ties broken by position, then moves records along the permutation cycles
+    void stable_sort(vector<Record>& run, std::size_t count) const {
+      vector<std::uint32_t> order(count, uninitialized);
+      for (std::size_t i = 0; i < count; i++) order[i] = static_cast<std::uint32_t>(i);
+      detail::introsort(order.begin(), count, [&](std::uint32_t a, std::uint32_t b) {
+        return _compare(run[a], run[b]) || (!_compare(run[b], run[a]) && a > b);
+      });
+      detail::apply_permutation_n(run.begin(), count, [&](std::size_t i) -> std::uint32_t& { return order[i]; });
+    }
+
+    // Returns true when the input fit in a single run, which is then already written to the output
+    bool make_runs(const std::string& input_path, const std::string& output_path,
+                   detail::temp_files& temp, vector<std::size_t>& runs) {
+      std::FILE* input = detail::open_file(input_path, "rb");
+      std::size_t capacity = run_records();
+      // Don't allocate more than the whole input needs
+      if (std::fseek(input, 0, SEEK_END) == 0) {
+        long size = std::ftell(input);
+        std::size_t input_records = size > 0 ? static_cast<std::size_t>(size) / sizeof(Record) : 0;
+        if (input_records < capacity) capacity = input_records + 1;
+        std::rewind(input);
+      }
+      vector<Record> run(capacity);
+
+      try {
+        for (;;) {
+          std::size_t count = std::fread(&run[0], sizeof(Record), capacity, input);
+          if (count < capacity && std::ferror(input)) throw std::runtime_error("Reading " + input_path + " failed");
+          if (count == 0 && runs.size() > 0) break;
+
+          auto run_end = run.begin() + static_cast<std::ptrdiff_t>(count);
+          if (_config.stable) {
+            stable_sort(run, count);
+          } else {
+            phoenix::sort(run.begin(), run_end, _compare);
+          }
+          bool single = runs.size() == 0 && count < capacity;
+
+          std::size_t id = single ? 0 : temp.create();
+          detail::record_writer<Record> writer(single ? output_path : temp.path(id), 1);
+          writer.write(&run[0], count);
+          writer.close();
+          if (single) {
+            std::fclose(input);
+            return true;
+          }
+          runs.push(id);
+          if (count < capacity) break;
+        }
+      } catch (...) {
+        std::fclose(input);
+        throw;
+      }
+      std::fclose(input);
+      return false;
+    }
+
+    void merge(const detail::temp_files& temp, const vector<std::size_t>& runs,
+               std::size_t first, std::size_t last, const std::string& output_path) {
+      std::size_t sources = last - first;
+      std::size_t buffer = io_records(sources + 1);
+
+      vector<detail::record_reader<Record>*> readers(sources, nullptr);
+      try {
+        for (std::size_t i = 0; i < sources; i++)
+          readers[i] = new detail::record_reader<Record>(temp.path(runs[first + i]), buffer);
+
+        detail::record_writer<Record> writer(output_path, buffer);
+        auto tree = detail::make_loser_tree(sources, [&](std::size_t a, std::size_t b) {
+          if (readers[a]->empty()) return false;
+          if (readers[b]->empty()) return true;
+          return _compare(readers[b]->front(), readers[a]->front());
+        });
+
+        for (;;) {
+          auto* reader = readers[tree.top()];
+          if (reader->empty()) break;
+          writer.push(reader->front());
+          reader->pop();
+          tree.replay();
+        }
+        writer.close();
+      } catch (...) {
+        for (std::size_t i = 0; i < sources; i++) delete readers[i];
+        throw;
+      }
+      for (std::size_t i = 0; i < sources; i++) delete readers[i];
+    }
+
+    external_sort_config _config;
+    typename std::decay<Compare>::type _compare;
+  };
+
+  template <typename Record, typename Compare = greater_fn>
+  void external_sort(const std::string& input_path, const std::string& output_path,
+                     const external_sort_config& config = external_sort_config{},
+                     Compare compare = Compare{}) {
+    external_sorter<Record, Compare>(config, compare).sort(input_path, output_path);
+  }
+}
+
+#endif //PHOSTDLIB_EXTERNAL_SORT_HPP
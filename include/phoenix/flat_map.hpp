@@ -0,0 +1,321 @@
+#ifndef PHOSTDLIB_FLAT_MAP_HPP
+#define PHOSTDLIB_FLAT_MAP_HPP
+#include <phoenix/flat_set.hpp>
+#include <phoenix/search.hpp>
+#include <phoenix/sort.hpp>
+#include <phoenix/utility.hpp>
+#include <phoenix/vector.hpp>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace phoenix {
+  // Keys and values are kept in separate vectors, so that searches only touch keys.
+  // Iterators dereference to pair<const K&, V&>, keys() and values() give both columns in order.
+  // That pair is a proxy built on every dereference, so to std algorithms the iterators are only
+  // input ones. Phoenix algorithms still see the random access flag.
+  template <typename K, typename V, typename Compare = greater_fn>
+  class flat_map {
+   public:
+    using key_type = K;
+    using mapped_type = V;
+    using size_type = std::size_t;
+
+    template <typename Map, typename Reference>
+    class basic_iterator {
+     public:
+      using self = basic_iterator;
+      static constexpr auto iterator_type = iterator_flag::random_access;
+
+      // Forward iterators must return a real reference, the proxy pair isn't one
+      using iterator_category = std::input_iterator_tag;
+      using value_type = pair<const K&, Reference>;
+      using reference = value_type;
+      using pointer = void;
+      using difference_type = std::ptrdiff_t;
+
+      basic_iterator(Map* map, std::size_t index) : _map{map}, _index{index} {}
+
+      // Iterators to values can be used where iterators to const values are expected
+      template <typename OtherMap, typename OtherReference>
+      basic_iterator(const basic_iterator<OtherMap, OtherReference>& other)
+          : _map{other._map}, _index{other._index} {}
+
+      const K& key() const { return _map->_keys[_index]; }
+      Reference value() const { return _map->_values[_index]; }
+      reference operator*() const { return reference{key(), value()}; }
+      std::size_t index() const { return _index; }
+
+      self& operator++() {
+        _index++;
+        return *this;
+      }
+
+      self operator++(int) {
+        auto t = *this;
+        _index++;
+        return t;
+      }
+
+      self& operator--() {
+        _index--;
+        return *this;
+      }
+
+      self operator--(int) {
+        auto t = *this;
+        _index--;
+        return t;
+      }
+
+      reference operator[](difference_type x) const { return *(*this + x); }
+
+      self operator+(difference_type x) const { return self(_map, _index + x); }
+      self operator-(difference_type x) const { return self(_map, _index - x); }
+      friend self operator+(difference_type x, const self& it) { return it + x; }
+
+      difference_type operator-(const self& other) const {
+        return static_cast<difference_type>(_index) - static_cast<difference_type>(other._index);
+      }
+
+      self& operator+=(difference_type x) {
+        _index += x;
+        return *this;
+      }
+
+      self& operator-=(difference_type x) {
+        _index -= x;
+        return *this;
+      }
+
+      bool operator==(const self& other) const { return _index == other._index; }
+      bool operator!=(const self& other) const { return _index != other._index; }
+      bool operator<(const self& other) const { return _index < other._index; }
+      bool operator>(const self& other) const { return _index > other._index; }
+      bool operator<=(const self& other) const { return _index <= other._index; }
+      bool operator>=(const self& other) const { return _index >= other._index; }
+
+     private:
+      template <typename, typename>
+      friend class basic_iterator;
+
+      Map* _map;
+      std::size_t _index;
+    };
+
+    using iterator = basic_iterator<flat_map, V&>;
+    using const_iterator = basic_iterator<const flat_map, const V&>;
+
+    explicit flat_map(Compare compare = Compare{}) : _keys(), _values(), _compare(compare) {}
+
+    // Sorts both columns by key. Of the pairs with equal keys the first one is kept.
+    flat_map(vector<K> keys, vector<V> values, Compare compare = Compare{})
+        : _keys(std::move(keys)), _values(std::move(values)), _compare(compare) {
+      if (_keys.size() != _values.size())
+        throw std::invalid_argument("Keys and values of flat_map differ in size!");
+      sort_columns(_keys, _values);
+    }
+
+    // Elements of the range have to provide .first (key) and .second (value)
+    template <typename InputIterator>
+    flat_map(InputIterator begin, InputIterator end, Compare compare = Compare{}) : flat_map(compare) {
+      split(begin, end, _keys, _values);
+      sort_columns(_keys, _values);
+    }
+
+    flat_map(std::initializer_list<pair<K, V>> elements, Compare compare = Compare{})
+        : flat_map(elements.begin(), elements.end(), compare) {}
+
+    size_type size() const { return _keys.size(); }
+    bool empty() const { return _keys.size() == 0; }
+
+    void clear() {
+      _keys = vector<K>();
+      _values = vector<V>();
+    }
+
+    void reserve(size_type capacity) {
+      detail::grow(_keys, capacity);
+      detail::grow(_values, capacity);
+    }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    const vector<K>& keys() const { return _keys; }
+    const vector<V>& values() const { return _values; }
+    // Values can be modified in place, keys can't as that would break the order
+    vector<V>& values() { return _values; }
+
+    template <typename Key>
+    iterator lower_bound(const Key& key) { return iterator(this, lower_index(key)); }
+    template <typename Key>
+    const_iterator lower_bound(const Key& key) const { return const_iterator(this, lower_index(key)); }
+
+    template <typename Key>
+    iterator upper_bound(const Key& key) { return iterator(this, upper_index(key)); }
+    template <typename Key>
+    const_iterator upper_bound(const Key& key) const { return const_iterator(this, upper_index(key)); }
+
+    template <typename Key>
+    iterator find(const Key& key) { return iterator(this, find_index(key)); }
+    template <typename Key>
+    const_iterator find(const Key& key) const { return const_iterator(this, find_index(key)); }
+
+    template <typename Key>
+    bool contains(const Key& key) const { return find_index(key) != size(); }
+
+    template <typename Key>
+    size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+    template <typename Key>
+    V& at(const Key& key) {
+      std::size_t index = find_index(key);
+      if (index == size()) throw std::out_of_range("Key not found in flat_map!");
+      return _values[index];
+    }
+
+    template <typename Key>
+    const V& at(const Key& key) const {
+      std::size_t index = find_index(key);
+      if (index == size()) throw std::out_of_range("Key not found in flat_map!");
+      return _values[index];
+    }
+
+    // Inserts a default value if key is missing, the value is only built then
+    V& operator[](const K& key) {
+      std::size_t index = lower_index(key);
+      if (index < size() && !_compare(_keys[index], key)) return _values[index];
+      detail::insert_at(_keys, index, key);
+      detail::insert_at(_values, index, V{});
+      return _values[index];
+    }
+
+    // Returns the position of key and whether it was inserted, an existing value is left unchanged
+    pair<iterator, bool> insert(const K& key, const V& value) { return try_insert(key, value); }
+
+    pair<iterator, bool> insert_or_assign(const K& key, const V& value) {
+      auto result = try_insert(key, value);
+      if (!result.second) result.first.value() = value;
+      return result;
+    }
+
+    // Sorts the batch, then merges it into both columns from the back, so that every element
+    // moves once. Keys already in the map and repeated keys of the batch keep their first value.
+    template <typename InputIterator>
+    void insert(InputIterator first, InputIterator last) {
+      vector<K> batch_keys;
+      vector<V> batch_values;
+      split(first, last, batch_keys, batch_values);
+      sort_columns(batch_keys, batch_values);
+      auto missing = detail::missing_keys(_keys, batch_keys, batch_keys.size(), _compare);
+
+      std::size_t i = _keys.size(), j = missing.size();
+      detail::extend(_keys, missing.size());
+      detail::extend(_values, missing.size());
+      for (std::size_t k = _keys.size(); j > 0;) {
+        if (i > 0 && _compare(_keys[i - 1], batch_keys[missing[j - 1]])) {
+          --i, --k;
+          _keys[k] = std::move(_keys[i]);
+          _values[k] = std::move(_values[i]);
+        } else {
+          --j, --k;
+          _keys[k] = std::move(batch_keys[missing[j]]);
+          _values[k] = std::move(batch_values[missing[j]]);
+        }
+      }
+    }
+
+    void insert(std::initializer_list<pair<K, V>> elements) { insert(elements.begin(), elements.end()); }
+
+    template <typename Key>
+    size_type erase(const Key& key) {
+      std::size_t index = find_index(key);
+      if (index == size()) return 0;
+      detail::erase_at(_keys, index);
+      detail::erase_at(_values, index);
+      return 1;
+    }
+
+    #ifndef PHOSTDLIB_DONT_SUPPORT_PRINT
+    friend std::ostream& operator<<(std::ostream& os, const flat_map& map) {
+      os << '{';
+      for (std::size_t i = 0; i < map.size(); i++)
+        os << (i > 0 ? ", " : "") << map._keys[i] << ": " << map._values[i];
+      return os << '}';
+    }
+    #endif
+
+   private:
+    template <typename Key>
+    std::size_t lower_index(const Key& key) const {
+      return static_cast<std::size_t>(phoenix::lower_bound(_keys.data(), _keys.data() + size(), key, _compare) -
+                                      _keys.data());
+    }
+
+    template <typename Key>
+    std::size_t upper_index(const Key& key) const {
+      return static_cast<std::size_t>(phoenix::upper_bound(_keys.data(), _keys.data() + size(), key, _compare) -
+                                      _keys.data());
+    }
+
+    template <typename Key>
+    std::size_t find_index(const Key& key) const {
+      std::size_t index = lower_index(key);
+      return index < size() && !_compare(_keys[index], key) ? index : size();
+    }
+
+    pair<iterator, bool> try_insert(const K& key, const V& value) {
+      std::size_t index = lower_index(key);
+      if (index < size() && !_compare(_keys[index], key)) return {iterator(this, index), false};
+      detail::insert_at(_keys, index, key);
+      detail::insert_at(_values, index, value);
+      return {iterator(this, index), true};
+    }
+
+    template <typename InputIterator>
+    static void split(InputIterator begin, InputIterator end, vector<K>& keys, vector<V>& values) {
+      for (; begin != end; ++begin) {
+        detail::grow(keys, keys.size() + 1);
+        detail::grow(values, values.size() + 1);
+        keys.push((*begin).first);
+        values.push((*begin).second);
+      }
+    }
+
+    // Sorts both columns by key and keeps only the first occurrence of every key. argsort order
+    // is applied to both columns, then every run of equal keys is reduced to the pair which had
+    // the lowest position.
+    void sort_columns(vector<K>& keys, vector<V>& values) const {
+      auto order = phoenix::argsort(keys.cbegin(), keys.cend(), _compare);
+      phoenix::apply_permutation(order, keys, values);
+
+      std::size_t length = 0;
+      for (std::size_t i = 0; i < keys.size();) {
+        std::size_t run = i, first = i;
+        for (i++; i < keys.size() && !_compare(keys[i], keys[run]); i++) {
+          if (order[i] < order[first]) first = i;
+        }
+        if (first != length) {
+          keys[length] = std::move(keys[first]);
+          values[length] = std::move(values[first]);
+        }
+        length++;
+      }
+      keys.resize(length);
+      values.resize(length);
+    }
+
+    vector<K> _keys;
+    vector<V> _values;
+    Compare _compare;
+  };
+}
+
+#endif //PHOSTDLIB_FLAT_MAP_HPP
@@ -0,0 +1,192 @@
+#ifndef PHOSTDLIB_FLAT_SET_HPP
+#define PHOSTDLIB_FLAT_SET_HPP
+#include <phoenix/search.hpp>
+#include <phoenix/sort.hpp>
+#include <phoenix/utility.hpp>
+#include <phoenix/vector.hpp>
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
+
+// Sorted containers stored in phoenix::vector. Lookups are branchless binary searches, bulk
+// construction sorts once with phoenix::sort, and batches of insertions are merged into the
+// existing elements in one pass instead of shifting the tail for every element.
+namespace phoenix {
+  namespace detail {
+    template <typename T, std::size_t AllocSize, typename U>
+    void insert_at(vector<T, AllocSize>& v, std::size_t position, U&& value) {
+      grow(v, v.size() + 1);
+      v.resize(v.size() + 1);
+      for (std::size_t i = v.size() - 1; i > position; i--) v[i] = std::move(v[i - 1]);
+      v[position] = std::forward<U>(value);
+    }
+
+    template <typename T, std::size_t AllocSize>
+    void erase_at(vector<T, AllocSize>& v, std::size_t position) {
+      for (std::size_t i = position + 1; i < v.size(); i++) v[i - 1] = std::move(v[i]);
+      v.resize(v.size() - 1);
+    }
+
+    // Adds count elements to the end, their values are overwritten by the caller
+    template <typename T, std::size_t AllocSize>
+    void extend(vector<T, AllocSize>& v, std::size_t count) {
+      grow(v, v.size() + count);
+      v.resize(v.size() + count);
+    }
+
+    template <typename T, typename InputIterator>
+    vector<T> collect(InputIterator begin, InputIterator end) {
+      vector<T> result;
+      for (; begin != end; ++begin) {
+        grow(result, result.size() + 1);
+        result.push(*begin);
+      }
+      return result;
+    }
+
+    // Removes elements equal to their predecessor from a sorted range, returns the new length
+    template <typename T, std::size_t AllocSize, typename Compare>
+    std::size_t unique(vector<T, AllocSize>& v, std::size_t length, Compare compare) {
+      if (length == 0) return 0;
+      std::size_t last = 0;
+      for (std::size_t i = 1; i < length; i++) {
+        if (compare(v[i], v[last])) {
+          if (++last != i) v[last] = std::move(v[i]);
+        }
+      }
+      return last + 1;
+    }
+
+    // Positions of the keys from a sorted, unique batch which are missing in sorted keys.
+    // The search for every next key starts where the previous one ended.
+    template <typename T, std::size_t AllocSize, typename Compare>
+    vector<std::size_t> missing_keys(const vector<T, AllocSize>& keys, const vector<T, AllocSize>& batch,
+                                     std::size_t batch_length, Compare compare) {
+      vector<std::size_t> missing;
+      grow(missing, batch_length);
+      const T* begin = keys.data();
+      const T* end = begin + keys.size();
+      for (std::size_t i = 0; i < batch_length; i++) {
+        begin = phoenix::lower_bound(begin, end, batch[i], compare);
+        if (begin == end || compare(*begin, batch[i])) missing.push(i);
+      }
+      return missing;
+    }
+  }
+
+  template <typename K, typename Compare = greater_fn>
+  class flat_set {
+   public:
+    using key_type = K;
+    using value_type = K;
+    using size_type = std::size_t;
+    using const_iterator = typename vector<K>::const_iterator;
+    using iterator = const_iterator;
+
+    explicit flat_set(Compare compare = Compare{}) : _keys(), _compare(compare) {}
+
+    // Sorts the keys and drops duplicates
+    explicit flat_set(vector<K> keys, Compare compare = Compare{}) : _keys(std::move(keys)), _compare(compare) {
+      phoenix::sort(_keys.begin(), _keys.end(), _compare);
+      _keys.resize(detail::unique(_keys, _keys.size(), _compare));
+    }
+
+    template <typename InputIterator>
+    flat_set(InputIterator begin, InputIterator end, Compare compare = Compare{})
+        : flat_set(detail::collect<K>(begin, end), compare) {}
+
+    flat_set(std::initializer_list<K> keys, Compare compare = Compare{})
+        : flat_set(keys.begin(), keys.end(), compare) {}
+
+    size_type size() const { return _keys.size(); }
+    bool empty() const { return _keys.size() == 0; }
+    void clear() { _keys = vector<K>(); }
+    void reserve(size_type capacity) { detail::grow(_keys, capacity); }
+
+    const_iterator begin() const { return _keys.cbegin(); }
+    const_iterator end() const { return _keys.cend(); }
+    const_iterator cbegin() const { return _keys.cbegin(); }
+    const_iterator cend() const { return _keys.cend(); }
+
+    // Keys in sorted order
+    const vector<K>& keys() const { return _keys; }
+    const K& operator[](size_type i) const { return _keys[i]; }
+
+    template <typename Key>
+    const_iterator lower_bound(const Key& key) const {
+      return phoenix::lower_bound(_keys.cbegin(), _keys.cend(), key, _compare);
+    }
+
+    template <typename Key>
+    const_iterator upper_bound(const Key& key) const {
+      return phoenix::upper_bound(_keys.cbegin(), _keys.cend(), key, _compare);
+    }
+
+    template <typename Key>
+    const_iterator find(const Key& key) const {
+      auto it = lower_bound(key);
+      return it != end() && !_compare(*it, key) ? it : end();
+    }
+
+    template <typename Key>
+    bool contains(const Key& key) const { return find(key) != end(); }
+
+    template <typename Key>
+    size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+    // Returns the position of key and whether it was inserted
+    pair<const_iterator, bool> insert(const K& key) {
+      std::size_t position = index_of(lower_bound(key));
+      if (position < _keys.size() && !_compare(_keys[position], key)) return {begin() + position, false};
+      detail::insert_at(_keys, position, key);
+      return {begin() + position, true};
+    }
+
+    // Sorts the batch, then merges it into the keys from the back, so that every key moves once
+    template <typename InputIterator>
+    void insert(InputIterator first, InputIterator last) {
+      auto batch = detail::collect<K>(first, last);
+      phoenix::sort(batch.begin(), batch.end(), _compare);
+      std::size_t length = detail::unique(batch, batch.size(), _compare);
+      auto missing = detail::missing_keys(_keys, batch, length, _compare);
+
+      std::size_t i = _keys.size(), j = missing.size();
+      detail::extend(_keys, missing.size());
+      for (std::size_t k = _keys.size(); j > 0;) {
+        if (i > 0 && _compare(_keys[i - 1], batch[missing[j - 1]])) {
+          _keys[--k] = std::move(_keys[--i]);
+        } else {
+          _keys[--k] = std::move(batch[missing[--j]]);
+        }
+      }
+    }
+
+    void insert(std::initializer_list<K> keys) { insert(keys.begin(), keys.end()); }
+
+    template <typename Key>
+    size_type erase(const Key& key) {
+      auto it = find(key);
+      if (it == end()) return 0;
+      detail::erase_at(_keys, index_of(it));
+      return 1;
+    }
+
+    #ifndef PHOSTDLIB_DONT_SUPPORT_PRINT
+    friend std::ostream& operator<<(std::ostream& os, const flat_set& set) {
+      os << '{';
+      for (std::size_t i = 0; i < set.size(); i++) os << (i > 0 ? ", " : "") << set[i];
+      return os << '}';
+    }
+    #endif
+
+   private:
+    std::size_t index_of(const_iterator it) const {
+      return static_cast<std::size_t>(it.operator->() - _keys.data());
+    }
+
+    vector<K> _keys;
+    Compare _compare;
+  };
+}
+
+#endif //PHOSTDLIB_FLAT_SET_HPP
@@ -0,0 +1,60 @@
+#ifndef PHOSTDLIB_HASH_HPP
+#define PHOSTDLIB_HASH_HPP
+#include <phoenix/string.hpp>
+#include <phoenix/detail/hash_bytes.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+namespace phoenix {
+  namespace detail {
+    template <typename T>
+    std::size_t hash(const T& value, std::true_type) {
+      return static_cast<std::size_t>(mix(static_cast<std::uint64_t>(value)));
+    }
+
+    template <typename T>
+    std::size_t hash(const T& value, std::false_type) {
+      return static_cast<std::size_t>(mix(std::hash<T>{}(value)));
+    }
+  }
+
+  // Transparent hash: strings hash the same whether passed as std::string, phoenix::string,
+  // string_view or a C string, so hash tables with string keys can be searched with any of them.
+  struct hash_fn {
+    using is_transparent = void;
+
+    template <typename T>
+    std::size_t operator()(const T& value) const {
+      return detail::hash(value, std::integral_constant<bool, std::is_integral<T>::value || std::is_enum<T>::value>{});
+    }
+
+    template <typename T>
+    std::size_t operator()(T* pointer) const {
+      return static_cast<std::size_t>(detail::mix(reinterpret_cast<std::uintptr_t>(pointer)));
+    }
+
+    std::size_t operator()(const std::string& string) const {
+      return static_cast<std::size_t>(detail::hash_bytes(string.data(), string.size()));
+    }
+
+    std::size_t operator()(const char* string) const {
+      return static_cast<std::size_t>(detail::hash_bytes(string, std::strlen(string)));
+    }
+
+    std::size_t operator()(char* string) const { return (*this)(static_cast<const char*>(string)); }
+
+    std::size_t operator()(string_view string) const {
+      return static_cast<std::size_t>(detail::hash_bytes(string.data(), string.size()));
+    }
+
+    std::size_t operator()(const phoenix::string& string) const {
+      return static_cast<std::size_t>(detail::hash_bytes(string.data(), string.size()));
+    }
+  };
+}
+
+#endif //PHOSTDLIB_HASH_HPP
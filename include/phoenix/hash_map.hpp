@@ -0,0 +1,385 @@
+#ifndef PHOSTDLIB_HASH_MAP_HPP
+#define PHOSTDLIB_HASH_MAP_HPP
+#include <phoenix/cpu.hpp>
+#include <phoenix/hash.hpp>
+#include <phoenix/iterator_flag.hpp>
+#include <phoenix/utility.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#ifndef PHOSTDLIB_DONT_SUPPORT_PRINT
+#include <iostream>
+#endif
+
+// Open addressing hash map in the style of Swiss tables. Every slot has a control byte holding
+// either its state (empty or deleted) or 7 bits of the hash of its key. Slots are probed in
+// aligned groups of 16: one comparison of 16 control bytes finds the candidate slots, so keys
+// are compared only when 7 bits of their hashes match.
+namespace phoenix {
+  namespace detail {
+    namespace swiss {
+      constexpr std::int8_t empty = -128;
+      constexpr std::int8_t deleted = -2;
+      constexpr std::size_t group_size = 16;
+
+      // Bit i is set for the control bytes of the group equal to h2
+      inline unsigned match(const std::int8_t* group, std::int8_t h2) {
+      #if defined(PHOSTDLIB_X86_SIMD) && defined(__SSE2__)
+        auto control = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+        return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8(h2))));
+      #else
+        unsigned bits = 0;
+        for (std::size_t i = 0; i < group_size; i++) bits |= (group[i] == h2 ? 1u : 0u) << i;
+        return bits;
+      #endif
+      }
+
+      // Empty and deleted control bytes are the only negative ones
+      inline unsigned match_free(const std::int8_t* group) {
+      #if defined(PHOSTDLIB_X86_SIMD) && defined(__SSE2__)
+        return static_cast<unsigned>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(group))));
+      #else
+        unsigned bits = 0;
+        for (std::size_t i = 0; i < group_size; i++) bits |= (group[i] < 0 ? 1u : 0u) << i;
+        return bits;
+      #endif
+      }
+
+      inline unsigned lowest_bit(unsigned bits) { return static_cast<unsigned>(__builtin_ctz(bits)); }
+    }
+  }
+
+  template <typename K, typename V, typename Hash = hash_fn, typename Eq = equal_fn>
+  class hash_map {
+   public:
+    using key_type = K;
+    using mapped_type = V;
+    using size_type = std::size_t;
+
+    template <typename Map, typename Reference>
+    class basic_iterator {
+     public:
+      using self = basic_iterator;
+      static constexpr auto iterator_type = iterator_flag::forward;
+
+      using iterator_category = detail::std_category<iterator_type>;
+      using value_type = pair<const K&, Reference>;
+      using reference = value_type;
+      using pointer = void;
+      using difference_type = std::ptrdiff_t;
+
+      basic_iterator(Map* map, std::size_t index) : _map{map}, _index{index} { skip_free(); }
+
+      // Iterators to values can be used where iterators to const values are expected
+      template <typename OtherMap, typename OtherReference>
+      basic_iterator(const basic_iterator<OtherMap, OtherReference>& other)
+          : _map{other._map}, _index{other._index} {}
+
+      const K& key() const { return _map->_slots[_index].key; }
+      Reference value() const { return _map->_slots[_index].value; }
+      reference operator*() const { return reference{key(), value()}; }
+
+      self& operator++() {
+        _index++;
+        skip_free();
+        return *this;
+      }
+
+      self operator++(int) {
+        auto t = *this;
+        this->operator++();
+        return t;
+      }
+
+      bool operator==(const self& other) const { return _index == other._index; }
+      bool operator!=(const self& other) const { return _index != other._index; }
+
+     private:
+      template <typename, typename>
+      friend class basic_iterator;
+
+      void skip_free() {
+        while (_index < _map->_capacity && _map->_control[_index] < 0) _index++;
+      }
+
+      Map* _map;
+      std::size_t _index;
+    };
+
+    using iterator = basic_iterator<hash_map, V&>;
+    using const_iterator = basic_iterator<const hash_map, const V&>;
+
+    explicit hash_map(Hash hash = Hash{}, Eq eq = Eq{})
+        : _control{nullptr}, _slots{nullptr}, _capacity{0}, _size{0}, _growth_left{0}, _hash(hash), _eq(eq) {}
+
+    explicit hash_map(size_type capacity, Hash hash = Hash{}, Eq eq = Eq{}) : hash_map(hash, eq) {
+      reserve(capacity);
+    }
+
+    hash_map(std::initializer_list<pair<K, V>> elements, Hash hash = Hash{}, Eq eq = Eq{}) : hash_map(hash, eq) {
+      reserve(elements.size());
+      for (const auto& element : elements) insert(element.first, element.second);
+    }
+
+    hash_map(const hash_map& other) : hash_map(other._hash, other._eq) {
+      reserve(other._size);
+      for (auto it = other.begin(); it != other.end(); ++it) insert(it.key(), it.value());
+    }
+
+    hash_map(hash_map&& other) noexcept
+        : _control{other._control}, _slots{other._slots}, _capacity{other._capacity}, _size{other._size},
+          _growth_left{other._growth_left}, _hash(std::move(other._hash)), _eq(std::move(other._eq)) {
+      other.release();
+    }
+
+    hash_map& operator=(const hash_map& other) {
+      if (this != &other) *this = hash_map(other);
+      return *this;
+    }
+
+    hash_map& operator=(hash_map&& other) noexcept {
+      if (this == &other) return *this;
+      destroy();
+      _control = other._control;
+      _slots = other._slots;
+      _capacity = other._capacity;
+      _size = other._size;
+      _growth_left = other._growth_left;
+      _hash = std::move(other._hash);
+      _eq = std::move(other._eq);
+      other.release();
+      return *this;
+    }
+
+    ~hash_map() { destroy(); }
+
+    size_type size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    size_type capacity() const { return _capacity; }
+    double load_factor() const { return _capacity == 0 ? 0.0 : static_cast<double>(_size) / _capacity; }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, _capacity); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, _capacity); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    // Makes room for count elements without rehashing
+    void reserve(size_type count) {
+      if (count <= _size + _growth_left) return;
+      rehash(count);
+    }
+
+    // Rebuilds the table with room for at least count elements, dropping tombstones.
+    // Elements are moved into the new table, nothing is allocated per element.
+    void rehash(size_type count) {
+      if (count < _size) count = _size;
+      std::size_t capacity = detail::swiss::group_size;
+      while (max_load(capacity) < count) capacity *= 2;
+
+      hash_map table(_hash, _eq);
+      table.allocate(capacity);
+      for (std::size_t i = 0; i < _capacity; i++) {
+        if (_control[i] < 0) continue;
+        std::size_t h = _hash(_slots[i].key);
+        table.emplace_at(table.free_slot(h), h, std::move(_slots[i].key), std::move(_slots[i].value));
+      }
+      swap(table);
+    }
+
+    void clear() {
+      for (std::size_t i = 0; i < _capacity; i++) {
+        if (_control[i] >= 0) _slots[i].~slot();
+        _control[i] = detail::swiss::empty;
+      }
+      _size = 0;
+      _growth_left = max_load(_capacity);
+    }
+
+    template <typename Key>
+    iterator find(const Key& key) { return iterator(this, find_index(key)); }
+    template <typename Key>
+    const_iterator find(const Key& key) const { return const_iterator(this, find_index(key)); }
+
+    template <typename Key>
+    bool contains(const Key& key) const { return find_index(key) != _capacity; }
+
+    template <typename Key>
+    size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+    template <typename Key>
+    V& at(const Key& key) {
+      std::size_t index = find_index(key);
+      if (index == _capacity) throw std::out_of_range("Key not found in hash_map!");
+      return _slots[index].value;
+    }
+
+    template <typename Key>
+    const V& at(const Key& key) const {
+      std::size_t index = find_index(key);
+      if (index == _capacity) throw std::out_of_range("Key not found in hash_map!");
+      return _slots[index].value;
+    }
+
+    // Inserts a default value if key is missing
+    V& operator[](const K& key) {
+      // Inserting may reallocate the slots, so they are read after it
+      std::size_t index = try_insert(key, V{}).first;
+      return _slots[index].value;
+    }
+
+    // Returns the position of key and whether it was inserted, an existing value is left unchanged
+    pair<iterator, bool> insert(const K& key, const V& value) {
+      auto result = try_insert(key, value);
+      return {iterator(this, result.first), result.second};
+    }
+
+    pair<iterator, bool> insert_or_assign(const K& key, const V& value) {
+      auto result = try_insert(key, value);
+      if (!result.second) _slots[result.first].value = value;
+      return {iterator(this, result.first), result.second};
+    }
+
+    template <typename Key>
+    size_type erase(const Key& key) {
+      std::size_t index = find_index(key);
+      if (index == _capacity) return 0;
+      _slots[index].~slot();
+      _size--;
+      // A probe passes a group only when it has no empty slot. If this group has one, no probe
+      // continues past it, so the slot can become empty, otherwise it has to stay a tombstone.
+      const std::int8_t* group = _control + (index & ~(detail::swiss::group_size - 1));
+      if (detail::swiss::match(group, detail::swiss::empty) != 0) {
+        _control[index] = detail::swiss::empty;
+        _growth_left++;
+      } else {
+        _control[index] = detail::swiss::deleted;
+      }
+      return 1;
+    }
+
+    void swap(hash_map& other) noexcept {
+      phoenix::swap(_control, other._control);
+      phoenix::swap(_slots, other._slots);
+      phoenix::swap(_capacity, other._capacity);
+      phoenix::swap(_size, other._size);
+      phoenix::swap(_growth_left, other._growth_left);
+      phoenix::swap(_hash, other._hash);
+      phoenix::swap(_eq, other._eq);
+    }
+
+    #ifndef PHOSTDLIB_DONT_SUPPORT_PRINT
+    friend std::ostream& operator<<(std::ostream& os, const hash_map& map) {
+      os << '{';
+      bool first = true;
+      for (auto it = map.begin(); it != map.end(); ++it, first = false)
+        os << (first ? "" : ", ") << it.key() << ": " << it.value();
+      return os << '}';
+    }
+    #endif
+
+   private:
+    struct slot {
+      K key;
+      V value;
+    };
+
+    // Tables are filled up to 7/8 of their capacity
+    static std::size_t max_load(std::size_t capacity) { return capacity - capacity / 8; }
+
+    // Low 7 bits of a hash are stored in control bytes, the rest picks the first group
+    static std::int8_t h2(std::size_t h) { return static_cast<std::int8_t>(h & 0x7f); }
+    std::size_t first_group(std::size_t h) const { return (h >> 7) & (_capacity / detail::swiss::group_size - 1); }
+
+    // Groups are visited at triangular offsets, which covers all of them for a power of two count
+    template <typename Key>
+    std::size_t find_index(const Key& key) const {
+      if (_size == 0) return _capacity;
+      std::size_t h = _hash(key);
+      std::size_t groups = _capacity / detail::swiss::group_size;
+      std::size_t group = first_group(h);
+      for (std::size_t step = 1; step <= groups; step++) {
+        const std::int8_t* control = _control + group * detail::swiss::group_size;
+        for (unsigned bits = detail::swiss::match(control, h2(h)); bits != 0; bits &= bits - 1) {
+          std::size_t index = group * detail::swiss::group_size + detail::swiss::lowest_bit(bits);
+          if (_eq(_slots[index].key, key)) return index;
+        }
+        if (detail::swiss::match(control, detail::swiss::empty) != 0) break;
+        group = (group + step) & (groups - 1);
+      }
+      return _capacity;
+    }
+
+    // First empty or deleted slot on the probe sequence of h
+    std::size_t free_slot(std::size_t h) const {
+      std::size_t groups = _capacity / detail::swiss::group_size;
+      std::size_t group = first_group(h);
+      for (std::size_t step = 1;; step++) {
+        unsigned bits = detail::swiss::match_free(_control + group * detail::swiss::group_size);
+        if (bits != 0) return group * detail::swiss::group_size + detail::swiss::lowest_bit(bits);
+        group = (group + step) & (groups - 1);
+      }
+    }
+
+    template <typename Key, typename Value>
+    void emplace_at(std::size_t index, std::size_t h, Key&& key, Value&& value) {
+      if (_control[index] == detail::swiss::empty) _growth_left--;
+      new (&_slots[index]) slot{std::forward<Key>(key), std::forward<Value>(value)};
+      _control[index] = h2(h);
+      _size++;
+    }
+
+    pair<std::size_t, bool> try_insert(const K& key, const V& value) {
+      std::size_t index = find_index(key);
+      if (index != _capacity) return {index, false};
+      std::size_t h = _hash(key);
+      index = _capacity == 0 ? 0 : free_slot(h);
+      // Reusing a tombstone doesn't take any room, an empty slot needs room left
+      if (_capacity == 0 || (_control[index] == detail::swiss::empty && _growth_left == 0)) {
+        // Tables mostly filled with tombstones are rebuilt at the same size
+        if (_capacity == 0) rehash(1);
+        else rehash(_size < max_load(_capacity) / 2 ? max_load(_capacity) : max_load(2 * _capacity));
+        index = free_slot(h);
+      }
+      emplace_at(index, h, key, value);
+      return {index, true};
+    }
+
+    void allocate(std::size_t capacity) {
+      _control = new std::int8_t[capacity];
+      std::memset(_control, detail::swiss::empty, capacity);
+      _slots = static_cast<slot*>(::operator new(capacity * sizeof(slot)));
+      _capacity = capacity;
+      _growth_left = max_load(capacity);
+    }
+
+    void destroy() {
+      if (_control == nullptr) return;
+      for (std::size_t i = 0; i < _capacity; i++) {
+        if (_control[i] >= 0) _slots[i].~slot();
+      }
+      delete[] _control;
+      ::operator delete(_slots);
+      release();
+    }
+
+    void release() {
+      _control = nullptr;
+      _slots = nullptr;
+      _capacity = _size = _growth_left = 0;
+    }
+
+    std::int8_t* _control;
+    slot* _slots;
+    std::size_t _capacity, _size, _growth_left;
+    Hash _hash;
+    Eq _eq;
+  };
+}
+
+#endif //PHOSTDLIB_HASH_MAP_HPP
@@ -1,5 +1,8 @@
 #ifndef PHOSTDLIB_ITERATOR_HPP
 #define PHOSTDLIB_ITERATOR_HPP
+#include <cstddef>
+#include <cstring>
+#include <iterator>
 #include <type_traits>
 
 namespace phoenix {
@@ -8,36 +11,177 @@ namespace phoenix {
     output = 0x02,
     forward = 0x04 | input,
     bidirectional = 0x08 | forward,
-    random_access = 0x16 | bidirectional
+    random_access = 0x10 | bidirectional,
+    contiguous = 0x20 | random_access
   };
 
-  iterator_flag operator|(const iterator_flag& first, const iterator_flag& second) {
+  constexpr iterator_flag operator|(const iterator_flag& first, const iterator_flag& second) {
     return static_cast<iterator_flag>(static_cast<unsigned>(first) | static_cast<unsigned>(second));
   }
 
-  iterator_flag operator&(const iterator_flag& first, const iterator_flag& second) {
+  constexpr iterator_flag operator&(const iterator_flag& first, const iterator_flag& second) {
     return static_cast<iterator_flag>(static_cast<unsigned>(first) & static_cast<unsigned>(second));
   }
 
-  iterator_flag operator^(const iterator_flag& first, const iterator_flag& second) {
+  constexpr iterator_flag operator^(const iterator_flag& first, const iterator_flag& second) {
     return static_cast<iterator_flag>(static_cast<unsigned>(first) ^ static_cast<unsigned>(second));
   }
 
-  iterator_flag operator~(const iterator_flag& it) {
+  constexpr iterator_flag operator~(const iterator_flag& it) {
     return static_cast<iterator_flag>(~static_cast<unsigned>(it));
   }
 
-  iterator_flag& operator|=(iterator_flag& first, const iterator_flag& second) {
+  inline iterator_flag& operator|=(iterator_flag& first, const iterator_flag& second) {
     return first = first | second;
   }
 
-  iterator_flag& operator&=(iterator_flag& first, const iterator_flag& second) {
+  inline iterator_flag& operator&=(iterator_flag& first, const iterator_flag& second) {
     return first = first & second;
   }
 
-  iterator_flag& operator^=(iterator_flag& first, const iterator_flag& second) {
+  inline iterator_flag& operator^=(iterator_flag& first, const iterator_flag& second) {
     return first = first ^ second;
   }
+
+  // Every flag of required is set in flag
+  constexpr bool has_flag(iterator_flag flag, iterator_flag required) {
+    return (flag & required) == required;
+  }
+
+  namespace detail {
+    template <typename...>
+    struct make_void {
+      using type = void;
+    };
+
+    template <typename... Ts>
+    using void_t = typename make_void<Ts...>::type;
+
+    // Standard category of the iterators with given flag. There's no contiguous tag before C++20,
+    // contiguous iterators are random access ones to std algorithms.
+    template <iterator_flag Flag>
+    using std_category = typename std::conditional<has_flag(Flag, iterator_flag::random_access),
+        std::random_access_iterator_tag, typename std::conditional<has_flag(Flag, iterator_flag::bidirectional),
+        std::bidirectional_iterator_tag, typename std::conditional<has_flag(Flag, iterator_flag::forward),
+        std::forward_iterator_tag, typename std::conditional<has_flag(Flag, iterator_flag::input),
+        std::input_iterator_tag, std::output_iterator_tag>::type>::type>::type>::type;
+
+    template <typename Category>
+    struct category_flag : std::integral_constant<iterator_flag,
+        std::is_base_of<std::random_access_iterator_tag, Category>::value ? iterator_flag::random_access
+        : std::is_base_of<std::bidirectional_iterator_tag, Category>::value ? iterator_flag::bidirectional
+        : std::is_base_of<std::forward_iterator_tag, Category>::value ? iterator_flag::forward
+        : std::is_base_of<std::input_iterator_tag, Category>::value ? iterator_flag::input
+        : iterator_flag::output> {};
+
+    // Flag of any iterator: declared by phoenix iterators, taken from the standard category of
+    // the others. Iterators without either are treated as input ones.
+    template <typename Iterator, typename = void>
+    struct standard_flag : std::integral_constant<iterator_flag, iterator_flag::input> {};
+
+    template <typename Iterator>
+    struct standard_flag<Iterator, void_t<typename Iterator::iterator_category>>
+        : category_flag<typename Iterator::iterator_category> {};
+
+    template <typename Iterator, typename = void>
+    struct iterator_flag_of : standard_flag<Iterator> {};
+
+    template <typename T>
+    struct iterator_flag_of<T*, void> : std::integral_constant<iterator_flag, iterator_flag::contiguous> {};
+
+    template <typename Iterator>
+    struct iterator_flag_of<Iterator, void_t<decltype(Iterator::iterator_type)>>
+        : std::integral_constant<iterator_flag, Iterator::iterator_type> {};
+
+    template <typename Iterator, iterator_flag Flag>
+    struct is_iterator : std::integral_constant<bool, has_flag(iterator_flag_of<Iterator>::value, Flag)> {};
+
+    template <typename Iterator>
+    struct is_contiguous : is_iterator<Iterator, iterator_flag::contiguous> {};
+
+    template <typename Iterator>
+    struct is_random_access : is_iterator<Iterator, iterator_flag::random_access> {};
+
+    // Raw pointer behind a contiguous iterator
+    template <typename T>
+    T* to_pointer(T* it) { return it; }
+
+    template <typename Iterator>
+    auto to_pointer(Iterator it) -> decltype(it.operator->()) { return it.operator->(); }
+
+    // Tag of the fastest way to walk a range: pointers, random access or one step at a time
+    template <typename Iterator>
+    using walk_tag = std::integral_constant<int, is_contiguous<Iterator>::value ? 2
+                                                 : static_cast<int>(is_random_access<Iterator>::value)>;
+
+    template <typename Iterator>
+    std::size_t distance(Iterator begin, Iterator end, std::integral_constant<int, 0>) {
+      std::size_t n = 0;
+      for (; begin != end; ++begin) n++;
+      return n;
+    }
+
+    template <typename Iterator>
+    std::size_t distance(Iterator begin, Iterator end, std::integral_constant<int, 1>) {
+      return static_cast<std::size_t>(end - begin);
+    }
+
+    template <typename Iterator>
+    std::size_t distance(Iterator begin, Iterator end, std::integral_constant<int, 2>) {
+      return static_cast<std::size_t>(to_pointer(end) - to_pointer(begin));
+    }
+
+    template <typename Iterator>
+    std::size_t distance(Iterator begin, Iterator end) {
+      return detail::distance(begin, end, walk_tag<Iterator>{});
+    }
+
+    template <typename Iterator>
+    Iterator advance(Iterator it, std::size_t n, std::integral_constant<int, 0>) {
+      for (; n > 0; n--) ++it;
+      return it;
+    }
+
+    template <typename Iterator, int Walk>
+    Iterator advance(Iterator it, std::size_t n, std::integral_constant<int, Walk>) {
+      it += static_cast<std::ptrdiff_t>(n);
+      return it;
+    }
+
+    template <typename Iterator>
+    Iterator advance(Iterator it, std::size_t n) {
+      return detail::advance(it, n, walk_tag<Iterator>{});
+    }
+
+    template <typename Iterator>
+    using referenced_t = typename std::remove_reference<decltype(*std::declval<Iterator>())>::type;
+
+    // Elements can be copied as bytes between the two ranges
+    template <typename InputIterator, typename OutputIterator>
+    struct is_memmovable : std::integral_constant<bool, is_contiguous<InputIterator>::value &&
+        is_contiguous<OutputIterator>::value && std::is_trivially_copyable<referenced_t<OutputIterator>>::value &&
+        std::is_same<typename std::remove_cv<referenced_t<InputIterator>>::type,
+                     referenced_t<OutputIterator>>::value> {};
+
+    template <typename InputIterator, typename OutputIterator>
+    OutputIterator copy(InputIterator begin, InputIterator end, OutputIterator out, std::false_type) {
+      for (; begin != end; ++begin, ++out) *out = *begin;
+      return out;
+    }
+
+    template <typename InputIterator, typename OutputIterator>
+    OutputIterator copy(InputIterator begin, InputIterator end, OutputIterator out, std::true_type) {
+      std::size_t n = detail::distance(begin, end);
+      if (n > 0) std::memmove(to_pointer(out), to_pointer(begin), n * sizeof(*to_pointer(begin)));
+      return detail::advance(out, n);
+    }
+
+    // Assigns the elements to the ones starting at out, ranges may overlap when out is before begin
+    template <typename InputIterator, typename OutputIterator>
+    OutputIterator copy(InputIterator begin, InputIterator end, OutputIterator out) {
+      return detail::copy(begin, end, out, is_memmovable<InputIterator, OutputIterator>{});
+    }
+  }
 }
 
 #endif //PHOSTDLIB_ITERATOR_HPP
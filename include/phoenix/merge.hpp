@@ -0,0 +1,386 @@
+#ifndef PHOSTDLIB_MERGE_HPP
+#define PHOSTDLIB_MERGE_HPP
+#include <phoenix/cpu.hpp>
+#include <phoenix/sort.hpp>
+#include <phoenix/utility.hpp>
+#include <phoenix/vector.hpp>
+#include <phoenix/detail/loser_tree.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace phoenix {
+  namespace detail {
+    // Sides more than this many times longer than the other one are searched by galloping
+    constexpr std::size_t gallop_ratio = 8;
+
+    inline std::size_t default_threads() {
+      unsigned threads = std::thread::hardware_concurrency();
+      return threads > 0 ? threads : 1;
+    }
+
+    // First index in [low, high) whose element is not less than value
+    template <typename RandomAccessIterator, typename T, typename Compare>
+    std::size_t lower_bound_index(RandomAccessIterator begin, std::size_t low, std::size_t high,
+                                  const T& value, Compare compare) {
+      while (low < high) {
+        std::size_t middle = low + (high - low) / 2;
+        if (compare(value, *(begin + middle))) low = middle + 1;
+        else high = middle;
+      }
+      return low;
+    }
+
+    // Same as lower_bound_index, but probes 1, 2, 4... elements ahead first,
+    // so it costs O(log d) for an answer d elements away
+    template <typename RandomAccessIterator, typename T, typename Compare>
+    std::size_t gallop_lower_bound(RandomAccessIterator begin, std::size_t low, std::size_t high,
+                                   const T& value, Compare compare) {
+      std::size_t offset = 1, less_end = low;
+      while (low + offset - 1 < high && compare(value, *(begin + (low + offset - 1)))) {
+        less_end = low + offset;
+        offset *= 2;
+      }
+      std::size_t bound = low + offset - 1 < high ? low + offset - 1 : high;
+      return lower_bound_index(begin, less_end, bound, value, compare);
+    }
+
+    template <typename RandomAccessIterator, typename T, typename Compare>
+    std::size_t skip_less(RandomAccessIterator begin, std::size_t low, std::size_t high,
+                          const T& value, Compare compare, bool gallop) {
+      return gallop ? gallop_lower_bound(begin, low, high, value, compare) : low + 1;
+    }
+
+    template <typename InputIterator, typename OutputIterator>
+    OutputIterator copy_n(InputIterator begin, std::size_t length, OutputIterator output) {
+      for (std::size_t i = 0; i < length; i++, ++begin) *output++ = *begin;
+      return output;
+    }
+  }
+
+  // Stable merge of two sorted ranges, equal elements are taken from the first range first
+  template <typename InputIterator1, typename InputIterator2, typename OutputIterator,
+            typename Compare = greater_fn>
+  OutputIterator merge(InputIterator1 begin1, InputIterator1 end1, InputIterator2 begin2, InputIterator2 end2,
+                       OutputIterator output, Compare compare = Compare{}) {
+    while (begin1 != end1 && begin2 != end2) {
+      if (compare(*begin1, *begin2)) {
+        *output++ = *begin2;
+        ++begin2;
+      } else {
+        *output++ = *begin1;
+        ++begin1;
+      }
+    }
+    for (; begin1 != end1; ++begin1) *output++ = *begin1;
+    for (; begin2 != end2; ++begin2) *output++ = *begin2;
+    return output;
+  }
+
+  // Merge of two sorted ranges split between threads along the merge path - every thread finds
+  // where its equal share of the output starts in both inputs with a binary search, then merges
+  // its part independently
+  template <typename RandomAccessIterator1, typename RandomAccessIterator2, typename RandomAccessIterator3,
+            typename Compare = greater_fn>
+  RandomAccessIterator3 parallel_merge(RandomAccessIterator1 begin1, RandomAccessIterator1 end1,
+                                       RandomAccessIterator2 begin2, RandomAccessIterator2 end2,
+                                       RandomAccessIterator3 output, Compare compare = Compare{},
+                                       std::size_t threads = detail::default_threads()) {
+    std::size_t length1 = detail::distance(begin1, end1), length2 = detail::distance(begin2, end2);
+    std::size_t total = length1 + length2;
+    // Below that, starting threads costs more than merging
+    constexpr std::size_t minimal_share = 1 << 14;
+    if (threads > total / minimal_share) threads = total / minimal_share;
+    if (threads < 2) return phoenix::merge(begin1, end1, begin2, end2, output, compare);
+
+    // Number of elements taken from the first range among the first `diagonal` merged ones
+    auto split = [&](std::size_t diagonal) {
+      std::size_t low = diagonal > length2 ? diagonal - length2 : 0;
+      std::size_t high = diagonal < length1 ? diagonal : length1;
+      while (low < high) {
+        std::size_t middle = low + (high - low) / 2;
+        if (!compare(*(begin1 + middle), *(begin2 + (diagonal - middle - 1)))) low = middle + 1;
+        else high = middle;
+      }
+      return low;
+    };
+
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t < threads; t++) {
+      std::size_t first = total * t / threads, last = total * (t + 1) / threads;
+      std::size_t i = split(first), j = first - i;
+      std::size_t i_end = split(last), j_end = last - i_end;
+      auto work = [=]() mutable {
+        phoenix::merge(begin1 + i, begin1 + i_end, begin2 + j, begin2 + j_end, output + first, compare);
+      };
+      if (t + 1 == threads) work();
+      else workers.emplace_back(work);
+    }
+    for (auto& worker : workers) worker.join();
+    return output + total;
+  }
+
+  namespace detail {
+    template <typename Container, typename OutputIterator, typename Compare>
+    OutputIterator merge_k(const vector<Container>& sources, const vector<std::size_t>& from,
+                           const vector<std::size_t>& to, OutputIterator output, Compare compare) {
+      if (sources.size() == 0) return output;
+      vector<std::size_t> position(from);
+      auto tree = make_loser_tree(sources.size(), [&](std::size_t a, std::size_t b) {
+        if (position[a] == to[a]) return false;
+        if (position[b] == to[b]) return true;
+        return compare(sources[b][position[b]], sources[a][position[a]]);
+      });
+
+      for (;;) {
+        std::size_t source = tree.top();
+        if (position[source] == to[source]) break;
+        *output++ = sources[source][position[source]++];
+        tree.replay();
+      }
+      return output;
+    }
+  }
+
+  // Stable k-way merge of sorted containers through a tournament (loser) tree, which takes
+  // log2(k) comparisons per element
+  template <typename Container, typename OutputIterator,
+            typename Compare = greater_fn>
+  OutputIterator merge(const vector<Container>& sources, OutputIterator output, Compare compare = Compare{}) {
+    vector<std::size_t> from(sources.size(), 0), to(sources.size(), 0);
+    for (std::size_t i = 0; i < sources.size(); i++) to[i] = sources[i].size();
+    return detail::merge_k(sources, from, to, output, compare);
+  }
+
+  // k-way merge split between threads by splitter keys sampled from the sources. Every thread
+  // merges elements between two consecutive splitters (found in each source by binary search).
+  template <typename Container, typename RandomAccessIterator,
+            typename Compare = greater_fn>
+  RandomAccessIterator parallel_merge(const vector<Container>& sources, RandomAccessIterator output,
+                                      Compare compare = Compare{},
+                                      std::size_t threads = detail::default_threads()) {
+    using value_type = typename std::decay<decltype(sources[0][0])>::type;
+    std::size_t k = sources.size(), total = 0;
+    for (std::size_t i = 0; i < k; i++) total += sources[i].size();
+
+    constexpr std::size_t minimal_share = 1 << 14;
+    if (threads > total / minimal_share) threads = total / minimal_share;
+    if (threads < 2) return phoenix::merge(sources, output, compare);
+
+    constexpr std::size_t samples_per_thread = 16;
+    vector<value_type> samples;
+    for (std::size_t i = 0; i < k; i++) {
+      std::size_t n = sources[i].size();
+      std::size_t count = samples_per_thread * threads * n / total;
+      for (std::size_t s = 1; s <= count; s++) samples.push(sources[i][n * s / (count + 1)]);
+    }
+    phoenix::sort(samples.begin(), samples.end(), compare);
+
+    // Boundaries of thread t in source i are bounds[t * k + i] and bounds[(t + 1) * k + i]
+    vector<std::size_t> bounds((threads + 1) * k, 0);
+    vector<std::size_t> offsets(threads + 1, 0);
+    for (std::size_t t = 1; t <= threads; t++) {
+      for (std::size_t i = 0; i < k; i++) {
+        std::size_t bound = sources[i].size();
+        if (t < threads && samples.size() > 0) {
+          const auto& splitter = samples[samples.size() * t / threads];
+          bound = detail::lower_bound_index(sources[i].cbegin(), bounds[(t - 1) * k + i], bound, splitter, compare);
+        }
+        bounds[t * k + i] = bound;
+        offsets[t] += bound;
+      }
+    }
+
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t < threads; t++) {
+      auto work = [&, t]() {
+        vector<std::size_t> from(k, 0), to(k, 0);
+        for (std::size_t i = 0; i < k; i++) {
+          from[i] = bounds[t * k + i];
+          to[i] = bounds[(t + 1) * k + i];
+        }
+        detail::merge_k(sources, from, to, output + offsets[t], compare);
+      };
+      if (t + 1 == threads) work();
+      else workers.emplace_back(work);
+    }
+    for (auto& worker : workers) worker.join();
+    return output + total;
+  }
+
+  // Set operations on sorted ranges, with multiset semantics: an element present m times in the
+  // first range and n times in the second one appears max(m, n), min(m, n) or max(m - n, 0) times
+  // in the union, intersection and difference. When one range is much longer, it is searched by
+  // galloping instead of being walked element by element.
+
+  template <typename RandomAccessIterator1, typename RandomAccessIterator2, typename OutputIterator,
+            typename Compare = greater_fn>
+  OutputIterator set_union(RandomAccessIterator1 begin1, RandomAccessIterator1 end1,
+                           RandomAccessIterator2 begin2, RandomAccessIterator2 end2,
+                           OutputIterator output, Compare compare = Compare{}) {
+    std::size_t n1 = detail::distance(begin1, end1), n2 = detail::distance(begin2, end2);
+    bool gallop1 = n1 >= detail::gallop_ratio * n2, gallop2 = n2 >= detail::gallop_ratio * n1;
+    std::size_t i = 0, j = 0;
+    while (i < n1 && j < n2) {
+      if (compare(*(begin2 + j), *(begin1 + i))) {
+        std::size_t run = detail::skip_less(begin1, i, n1, *(begin2 + j), compare, gallop1);
+        output = detail::copy_n(begin1 + i, run - i, output);
+        i = run;
+      } else if (compare(*(begin1 + i), *(begin2 + j))) {
+        std::size_t run = detail::skip_less(begin2, j, n2, *(begin1 + i), compare, gallop2);
+        output = detail::copy_n(begin2 + j, run - j, output);
+        j = run;
+      } else {
+        *output++ = *(begin1 + i);
+        i++;
+        j++;
+      }
+    }
+    output = detail::copy_n(begin1 + i, n1 - i, output);
+    return detail::copy_n(begin2 + j, n2 - j, output);
+  }
+
+  template <typename RandomAccessIterator1, typename RandomAccessIterator2, typename OutputIterator,
+            typename Compare = greater_fn>
+  OutputIterator set_difference(RandomAccessIterator1 begin1, RandomAccessIterator1 end1,
+                                RandomAccessIterator2 begin2, RandomAccessIterator2 end2,
+                                OutputIterator output, Compare compare = Compare{}) {
+    std::size_t n1 = detail::distance(begin1, end1), n2 = detail::distance(begin2, end2);
+    bool gallop1 = n1 >= detail::gallop_ratio * n2, gallop2 = n2 >= detail::gallop_ratio * n1;
+    std::size_t i = 0, j = 0;
+    while (i < n1 && j < n2) {
+      if (compare(*(begin2 + j), *(begin1 + i))) {
+        std::size_t run = detail::skip_less(begin1, i, n1, *(begin2 + j), compare, gallop1);
+        output = detail::copy_n(begin1 + i, run - i, output);
+        i = run;
+      } else if (compare(*(begin1 + i), *(begin2 + j))) {
+        j = detail::skip_less(begin2, j, n2, *(begin1 + i), compare, gallop2);
+      } else {
+        i++;
+        j++;
+      }
+    }
+    return detail::copy_n(begin1 + i, n1 - i, output);
+  }
+
+  namespace detail {
+    template <typename RandomAccessIterator1, typename RandomAccessIterator2, typename OutputIterator,
+              typename Compare>
+    OutputIterator set_intersection(RandomAccessIterator1 begin1, std::size_t n1, std::size_t i,
+                                    RandomAccessIterator2 begin2, std::size_t n2, std::size_t j,
+                                    OutputIterator output, Compare compare) {
+      bool gallop1 = n1 - i >= gallop_ratio * (n2 - j), gallop2 = n2 - j >= gallop_ratio * (n1 - i);
+      while (i < n1 && j < n2) {
+        if (compare(*(begin2 + j), *(begin1 + i))) {
+          i = skip_less(begin1, i, n1, *(begin2 + j), compare, gallop1);
+        } else if (compare(*(begin1 + i), *(begin2 + j))) {
+          j = skip_less(begin2, j, n2, *(begin1 + i), compare, gallop2);
+        } else {
+          *output++ = *(begin1 + i);
+          i++;
+          j++;
+        }
+      }
+      return output;
+    }
+
+  #if defined(PHOSTDLIB_X86_SIMD) && defined(__SSE2__)
+    template <typename T>
+    bool strictly_increasing(const T* data, std::size_t begin, std::size_t end) {
+      for (std::size_t k = begin > 0 ? begin : 1; k < end; k++) {
+        if (!(data[k - 1] < data[k])) return false;
+      }
+      return true;
+    }
+
+    // Compares blocks of 4 keys all-against-all with SSE2. That only matches the multiset
+    // semantics for strictly increasing ranges - once duplicates show up, scalar code takes over.
+    // Everything before i and j is settled: when one block is exhausted, the other one only
+    // advances past its keys not greater than the exhausted block's maximum, which were either
+    // matched or can't match anymore.
+    template <typename T, typename OutputIterator>
+    OutputIterator simd_set_intersection(const T* a, std::size_t n1, const T* b, std::size_t n2,
+                                         OutputIterator output) {
+      std::size_t i = 0, j = 0;
+      while (i + 4 <= n1 && j + 4 <= n2 && strictly_increasing(a, i, i + 4) && strictly_increasing(b, j, j + 4)) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+        __m128i match = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi32(va, vb), _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x39))),
+            _mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x4E)),
+                         _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x93))));
+        for (int mask = _mm_movemask_ps(_mm_castsi128_ps(match)); mask != 0; mask &= mask - 1) {
+          *output++ = a[i + static_cast<std::size_t>(__builtin_ctz(static_cast<unsigned>(mask)))];
+        }
+
+        T a_max = a[i + 3], b_max = b[j + 3];
+        if (a_max < b_max) {
+          i += 4;
+          while (!(a_max < b[j])) j++;
+        } else if (b_max < a_max) {
+          j += 4;
+          while (!(b_max < a[i])) i++;
+        } else {
+          i += 4;
+          j += 4;
+        }
+      }
+      return set_intersection(a, n1, i, b, n2, j, output, greater_fn{});
+    }
+  #endif
+
+    template <typename RandomAccessIterator1, typename RandomAccessIterator2, typename OutputIterator,
+              typename Compare>
+    OutputIterator set_intersection(RandomAccessIterator1 begin1, std::size_t n1,
+                                    RandomAccessIterator2 begin2, std::size_t n2,
+                                    OutputIterator output, Compare compare, std::false_type) {
+      return set_intersection(begin1, n1, 0, begin2, n2, 0, output, compare);
+    }
+
+    template <typename RandomAccessIterator1, typename RandomAccessIterator2, typename OutputIterator,
+              typename Compare>
+    OutputIterator set_intersection(RandomAccessIterator1 begin1, std::size_t n1,
+                                    RandomAccessIterator2 begin2, std::size_t n2,
+                                    OutputIterator output, Compare compare, std::true_type) {
+    #if defined(PHOSTDLIB_X86_SIMD) && defined(__SSE2__)
+      // Skewed sizes are handled better by galloping
+      bool skewed = n1 >= gallop_ratio * n2 || n2 >= gallop_ratio * n1;
+      if (!skewed && cpu::active_level() != simd_level::scalar) {
+        return simd_set_intersection(to_pointer(begin1), n1, to_pointer(begin2), n2, output);
+      }
+    #endif
+      return set_intersection(begin1, n1, 0, begin2, n2, 0, output, compare);
+    }
+
+    template <typename RandomAccessIterator1, typename RandomAccessIterator2, typename Compare>
+    struct use_simd_intersection {
+      using value_type = typename std::remove_cv<
+          typename std::remove_reference<decltype(*std::declval<RandomAccessIterator1&>())>::type>::type;
+      using value_type2 = typename std::remove_cv<
+          typename std::remove_reference<decltype(*std::declval<RandomAccessIterator2&>())>::type>::type;
+      static constexpr bool value =
+          is_contiguous<RandomAccessIterator1>::value && is_contiguous<RandomAccessIterator2>::value &&
+          std::is_same<value_type, value_type2>::value &&
+          (std::is_same<value_type, std::int32_t>::value || std::is_same<value_type, std::uint32_t>::value) &&
+          std::is_same<typename std::decay<Compare>::type, greater_fn>::value;
+    };
+  }
+
+  // Sorted 32-bit integer ranges in contiguous memory with the default comparator are intersected
+  // with SSE2 block comparisons
+  template <typename RandomAccessIterator1, typename RandomAccessIterator2, typename OutputIterator,
+            typename Compare = greater_fn>
+  OutputIterator set_intersection(RandomAccessIterator1 begin1, RandomAccessIterator1 end1,
+                                  RandomAccessIterator2 begin2, RandomAccessIterator2 end2,
+                                  OutputIterator output, Compare compare = Compare{}) {
+    return detail::set_intersection(
+        begin1, detail::distance(begin1, end1), begin2, detail::distance(begin2, end2), output, compare,
+        std::integral_constant<bool,
+                               detail::use_simd_intersection<RandomAccessIterator1, RandomAccessIterator2,
+                                                             Compare>::value>{});
+  }
+}
+
+#endif //PHOSTDLIB_MERGE_HPP
@@ -0,0 +1,185 @@
+#ifndef PHOSTDLIB_MPMC_QUEUE_HPP
+#define PHOSTDLIB_MPMC_QUEUE_HPP
+#include <phoenix/cpu.hpp>
+#include <phoenix/detail/wait.hpp>
+#include <phoenix/vector.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+// Bounded lock-free queue for any number of producers and consumers (Vyukov's algorithm).
+// Every cell carries a sequence number telling whose turn it is: a cell at position p can be
+// written when its sequence is p, and read when it is p + 1. Reading sets it to p + capacity,
+// handing it to the producer of the next lap. Producers and consumers only compete for their own
+// position counter, and an operation is a single compare-and-swap when uncontended.
+// The counters are aligned to cache lines, which operator new doesn't respect before C++17, so
+// the queue should be a static or automatic variable (or a member of one).
+namespace phoenix {
+  template <typename T>
+  class mpmc_queue {
+   public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    // Capacity is rounded up to a power of two
+    explicit mpmc_queue(size_type capacity) : _cells(round_capacity(capacity)), _mask(_cells.size() - 1) {
+      for (std::size_t i = 0; i < _cells.size(); i++) _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    mpmc_queue(const mpmc_queue&) = delete;
+    mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+    size_type capacity() const { return _mask + 1; }
+
+    // Exact only while no operation is in progress
+    size_type size() const {
+      std::size_t head = _head.load(std::memory_order_acquire);
+      std::size_t tail = _tail.load(std::memory_order_acquire);
+      return tail > head ? tail - head : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    // Returns false if the queue is full
+    bool try_push(const T& value) { return notify_pushed(push_one(value)); }
+    bool try_push(T&& value) { return notify_pushed(push_one(std::move(value))); }
+
+    // Returns false if the queue is empty
+    bool try_pop(T& value) { return notify_popped(pop_one(value)); }
+
+    // Blocking variants wait for free space (or a value) spinning, then yielding, then sleeping
+    void push(const T& value) {
+      _not_full.wait_until([&]() { return push_one(value); });
+      _not_empty.notify_one();
+    }
+
+    void push(T&& value) {
+      _not_full.wait_until([&]() { return push_one(std::move(value)); });
+      _not_empty.notify_one();
+    }
+
+    T pop() {
+      T value;
+      _not_empty.wait_until([&]() { return pop_one(value); });
+      _not_full.notify_one();
+      return value;
+    }
+
+    // Claims a run of consecutive cells with one compare-and-swap and copies up to count values
+    // into it. Returns the number of values pushed, 0 only if the queue is full.
+    size_type push_n(const T* values, size_type count) {
+      std::size_t first;
+      std::size_t claimed = claim(_tail, 0, count, first);
+      for (std::size_t i = 0; i < claimed; i++) {
+        cell& c = _cells[(first + i) & _mask];
+        c.value = values[i];
+        c.sequence.store(first + i + 1, std::memory_order_release);
+      }
+      if (claimed > 0) _not_empty.notify_all();
+      return claimed;
+    }
+
+    // Moves up to count values to out, returns the number of values popped
+    size_type pop_n(T* out, size_type count) {
+      std::size_t first;
+      std::size_t claimed = claim(_head, 1, count, first);
+      for (std::size_t i = 0; i < claimed; i++) {
+        cell& c = _cells[(first + i) & _mask];
+        out[i] = std::move(c.value);
+        c.sequence.store(first + i + capacity(), std::memory_order_release);
+      }
+      if (claimed > 0) _not_full.notify_all();
+      return claimed;
+    }
+
+   private:
+    struct cell {
+      cell() : sequence{0}, value{} {}
+
+      // Only needed to construct the vector of cells
+      cell& operator=(const cell& other) {
+        sequence.store(other.sequence.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        value = other.value;
+        return *this;
+      }
+
+      std::atomic<std::size_t> sequence;
+      T value;
+    };
+
+    static size_type round_capacity(size_type capacity) {
+      if (capacity > (~size_type{0} >> 1) + 1) throw std::length_error("Capacity of mpmc_queue is too big!");
+      size_type rounded = 2;
+      while (rounded < capacity) rounded *= 2;
+      return rounded;
+    }
+
+    // Claims up to count consecutive cells from position, whose sequences have to be
+    // position + offset. Returns the number of cells claimed and their first position.
+    std::size_t claim(std::atomic<std::size_t>& position, std::size_t offset, std::size_t count,
+                      std::size_t& first) {
+      if (count == 0) return 0;
+      std::size_t current = position.load(std::memory_order_relaxed);
+      for (;;) {
+        std::size_t ready = 0;
+        std::size_t sequence = 0;
+        for (; ready < count; ready++) {
+          sequence = _cells[(current + ready) & _mask].sequence.load(std::memory_order_acquire);
+          if (sequence != current + ready + offset) break;
+        }
+        if (ready > 0) {
+          if (position.compare_exchange_weak(current, current + ready, std::memory_order_relaxed)) {
+            first = current;
+            return ready;
+          }
+        } else if (static_cast<std::intptr_t>(sequence - (current + offset)) < 0) {
+          // The cell still belongs to the previous lap: full when pushing, empty when popping
+          return 0;
+        } else {
+          current = position.load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    template <typename Value>
+    bool push_one(Value&& value) {
+      std::size_t position;
+      if (claim(_tail, 0, 1, position) == 0) return false;
+      cell& c = _cells[position & _mask];
+      c.value = std::forward<Value>(value);
+      c.sequence.store(position + 1, std::memory_order_release);
+      return true;
+    }
+
+    bool pop_one(T& value) {
+      std::size_t position;
+      if (claim(_head, 1, 1, position) == 0) return false;
+      cell& c = _cells[position & _mask];
+      value = std::move(c.value);
+      c.sequence.store(position + capacity(), std::memory_order_release);
+      return true;
+    }
+
+    bool notify_pushed(bool pushed) {
+      if (pushed) _not_empty.notify_one();
+      return pushed;
+    }
+
+    bool notify_popped(bool popped) {
+      if (popped) _not_full.notify_one();
+      return popped;
+    }
+
+    vector<cell> _cells;
+    std::size_t _mask;
+
+    alignas(cpu::cache_line_size) std::atomic<std::size_t> _tail{0};
+    alignas(cpu::cache_line_size) std::atomic<std::size_t> _head{0};
+    alignas(cpu::cache_line_size) detail::event _not_empty;
+    alignas(cpu::cache_line_size) detail::event _not_full;
+  };
+}
+
+#endif //PHOSTDLIB_MPMC_QUEUE_HPP
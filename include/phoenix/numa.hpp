@@ -0,0 +1,198 @@
+#ifndef PHOSTDLIB_NUMA_HPP
+#define PHOSTDLIB_NUMA_HPP
+#include <phoenix/execution.hpp>
+#include <phoenix/iterator_flag.hpp>
+#include <phoenix/vector.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Page placement on NUMA machines. Linux puts a page on the node of the thread that writes it
+// first, so a buffer filled by one thread ends up on one node and the other sockets read it over
+// the interconnect. make_vector, fill and resize write every chunk of the policy's fixed chunking
+// from the pool's workers (create the pool with pinned threads so that they stay on their nodes),
+// and can set an explicit policy for the pages before they are first touched.
+// Placement only applies to pages that weren't touched yet, which is the case for fresh large
+// allocations of trivial types. Without the system calls everything falls back to first touch.
+namespace phoenix {
+  namespace numa {
+    // Set of nodes, in the bitmask format of the kernel
+    struct node_mask {
+      static constexpr std::size_t max_nodes = 1024;
+      static constexpr std::size_t word_bits = 8 * sizeof(unsigned long);
+      unsigned long bits[max_nodes / word_bits] = {};
+
+      void set(unsigned node) {
+        if (node < max_nodes) bits[node / word_bits] |= 1ul << (node % word_bits);
+      }
+
+      bool test(unsigned node) const {
+        return node < max_nodes && (bits[node / word_bits] >> (node % word_bits) & 1ul) != 0;
+      }
+
+      unsigned count() const {
+        unsigned result = 0;
+        for (auto word : bits) result += static_cast<unsigned>(__builtin_popcountl(word));
+        return result;
+      }
+    };
+
+    // Nodes with memory and CPUs, read once from sysfs ("0-1,3" format)
+    inline const node_mask& online_nodes() {
+      static const node_mask nodes = []() {
+        node_mask mask;
+        std::ifstream file("/sys/devices/system/node/online");
+        std::string list;
+        if (file >> list) {
+          const char* it = list.c_str();
+          while (*it != '\0') {
+            char* end;
+            unsigned long first = std::strtoul(it, &end, 10), last = first;
+            if (end == it) break;
+            if (*end == '-') {
+              it = end + 1;
+              last = std::strtoul(it, &end, 10);
+            }
+            for (unsigned long node = first; node <= last && node < node_mask::max_nodes; node++) {
+              mask.set(static_cast<unsigned>(node));
+            }
+            it = *end == ',' ? end + 1 : end;
+          }
+        }
+        if (mask.count() == 0) mask.set(0);
+        return mask;
+      }();
+      return nodes;
+    }
+
+    inline unsigned node_count() { return online_nodes().count(); }
+
+    // first_touch is the default policy of the kernel, interleave spreads pages round-robin over
+    // all online nodes, bind(node) puts them on one node
+    struct placement {
+      enum kind_type { first_touch, interleave, bind } kind;
+      unsigned node;
+    };
+
+    constexpr placement first_touch{placement::first_touch, 0};
+    constexpr placement interleave{placement::interleave, 0};
+
+    constexpr placement bind(unsigned node) { return placement{placement::bind, node}; }
+
+  #ifdef __linux__
+    namespace detail {
+      // Arguments of mbind and set_mempolicy, false for a node that isn't online
+      inline bool memory_policy(placement where, int& mode, node_mask& nodes) {
+        switch (where.kind) {
+          case placement::interleave:
+            mode = MPOL_INTERLEAVE;
+            nodes = online_nodes();
+            return true;
+          case placement::bind:
+            if (!online_nodes().test(where.node)) return false;
+            mode = MPOL_BIND;
+            nodes.set(where.node);
+            return true;
+          default:
+            mode = MPOL_DEFAULT;
+            return true;
+        }
+      }
+    }
+  #endif
+
+    // Sets the policy of the pages inside [data, data + bytes), returns false if that failed.
+    // Pages only partially inside the range are left alone.
+    inline bool place(const void* data, std::size_t bytes, placement where) {
+    #ifdef __linux__
+      int mode;
+      node_mask nodes;
+      if (!detail::memory_policy(where, mode, nodes)) return false;
+      auto page = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+      auto first = (reinterpret_cast<std::uintptr_t>(data) + page - 1) & ~(page - 1);
+      auto last = (reinterpret_cast<std::uintptr_t>(data) + bytes) & ~(page - 1);
+      if (last <= first) return true;
+      bool empty = mode == MPOL_DEFAULT;
+      return syscall(SYS_mbind, first, last - first, mode, empty ? nullptr : nodes.bits,
+                     empty ? 0ul : node_mask::max_nodes + 1, 0u) == 0;
+    #else
+      (void)data, (void)bytes;
+      return where.kind == placement::first_touch;
+    #endif
+    }
+
+    // Policy of the pages that the calling thread allocates and touches from now on
+    inline bool set_thread_placement(placement where) {
+    #ifdef __linux__
+      int mode;
+      node_mask nodes;
+      if (!detail::memory_policy(where, mode, nodes)) return false;
+      bool empty = mode == MPOL_DEFAULT;
+      return syscall(SYS_set_mempolicy, mode, empty ? nullptr : nodes.bits,
+                     empty ? 0ul : node_mask::max_nodes + 1) == 0;
+    #else
+      return where.kind == placement::first_touch;
+    #endif
+    }
+
+    // Vector of size copies of value, every chunk written first by a worker of the policy's pool
+    template <typename T, std::size_t AllocSize = 16>
+    vector<T, AllocSize> make_vector(std::size_t size, const T& value,
+                                     const execution::parallel_policy& policy = execution::par,
+                                     placement where = first_touch) {
+      vector<T, AllocSize> result(size, uninitialized);
+      T* data = phoenix::detail::to_pointer(result.begin());
+      place(data, size * sizeof(T), where);
+      phoenix::detail::for_each_chunk(policy, size, [data, &value](std::size_t offset, std::size_t length) {
+        for (T* it = data + offset; it != data + offset + length; ++it) *it = value;
+      });
+      return result;
+    }
+
+    // Assigns value to all elements in parallel
+    template <typename T, std::size_t AllocSize>
+    void fill(vector<T, AllocSize>& values, const T& value,
+              const execution::parallel_policy& policy = execution::par) {
+      T* data = phoenix::detail::to_pointer(values.begin());
+      phoenix::detail::for_each_chunk(policy, values.size(), [data, &value](std::size_t offset, std::size_t length) {
+        for (T* it = data + offset; it != data + offset + length; ++it) *it = value;
+      });
+    }
+
+    // Resizes to size elements, new ones set to value. When the buffer has to grow, the new one is
+    // placed and both the kept and the new elements are written from the pool.
+    template <typename T, std::size_t AllocSize>
+    void resize(vector<T, AllocSize>& values, std::size_t size, const T& value,
+                const execution::parallel_policy& policy = execution::par, placement where = first_touch) {
+      std::size_t kept = values.size() < size ? values.size() : size;
+      if (size <= values.capacity()) {
+        values.resize(size);
+        T* data = phoenix::detail::to_pointer(values.begin());
+        phoenix::detail::for_each_chunk(policy, size - kept, [data, kept, &value](std::size_t offset,
+                                                                                  std::size_t length) {
+          for (T* it = data + kept + offset; it != data + kept + offset + length; ++it) *it = value;
+        });
+        return;
+      }
+
+      vector<T, AllocSize> grown(size, uninitialized);
+      T* data = phoenix::detail::to_pointer(grown.begin());
+      const T* old = values.data();
+      place(data, size * sizeof(T), where);
+      phoenix::detail::for_each_chunk(policy, size, [data, old, kept, &value](std::size_t offset,
+                                                                              std::size_t length) {
+        for (std::size_t i = offset; i < offset + length; i++) data[i] = i < kept ? old[i] : value;
+      });
+      values.swap(grown);
+    }
+  }
+}
+
+#endif //PHOSTDLIB_NUMA_HPP
@@ -0,0 +1,349 @@
+#ifndef PHOSTDLIB_NUMERIC_HPP
+#define PHOSTDLIB_NUMERIC_HPP
+#include <phoenix/algorithm.hpp>
+#include <phoenix/execution.hpp>
+#include <phoenix/iterator_flag.hpp>
+#include <phoenix/thread_pool.hpp>
+#include <phoenix/utility.hpp>
+#include <phoenix/vector.hpp>
+#include <phoenix/detail/simd_scan.hpp>
+#include <phoenix/detail/simd_search.hpp>
+#include <cstddef>
+#include <type_traits>
+
+// transform, reduce, transform_reduce and scans taking an execution policy (see execution.hpp).
+// unseq and par need random-access iterators, seq works with input iterators. Reductions and
+// scans with unseq and par regroup the operations, so the operation should be associative (and
+// for reductions commutative too), and floating-point results can differ from seq by rounding.
+// Integer sums wrap around in the element type.
+namespace phoenix {
+  namespace detail {
+    struct identity_fn {
+      template <typename T>
+      constexpr const T& operator()(const T& value) const {
+        return value;
+      }
+    };
+
+    // Values to reduce: transform(*it), or combine(*it1, *it2)
+    template <typename Iterator, typename Transform>
+    struct unary_source {
+      Iterator first;
+      Transform transform;
+
+      auto values(std::size_t offset) const {
+        Iterator it = detail::advance(first, offset);
+        const Transform& function = transform;
+        return [it, &function]() mutable {
+          auto value = function(*it);
+          ++it;
+          return value;
+        };
+      }
+    };
+
+    template <typename Iterator1, typename Iterator2, typename Combine>
+    struct binary_source {
+      Iterator1 first1;
+      Iterator2 first2;
+      Combine combine;
+
+      auto values(std::size_t offset) const {
+        Iterator1 it1 = detail::advance(first1, offset);
+        Iterator2 it2 = detail::advance(first2, offset);
+        const Combine& function = combine;
+        return [it1, it2, &function]() mutable {
+          auto value = function(*it1, *it2);
+          ++it1;
+          ++it2;
+          return value;
+        };
+      }
+    };
+
+    // Plain sums of contiguous arithmetic elements go to the SIMD accumulate kernel
+    template <typename Source, typename Reduce, typename T>
+    struct use_simd_sum : std::false_type {};
+
+    template <typename Iterator, typename T>
+    struct use_simd_sum<unary_source<Iterator, identity_fn>, plus_fn, T>
+        : std::integral_constant<bool, is_contiguous<Iterator>::value && simd_search::is_key<T>::value &&
+                                           std::is_same<value_type_of<Iterator>, T>::value> {};
+
+    // Reduces length >= 1 values in Lanes independent partial results, which the compiler can
+    // keep in the lanes of a vector register
+    template <typename T, typename Source, typename Reduce>
+    T fold(const Source& source, std::size_t offset, std::size_t length, const Reduce& reduce, std::false_type) {
+      constexpr std::size_t lanes = 8;
+      auto next = source.values(offset);
+      if (length < 2 * lanes) {
+        T result = next();
+        for (std::size_t i = 1; i < length; i++) result = reduce(result, next());
+        return result;
+      }
+      T partial[lanes];
+      for (std::size_t lane = 0; lane < lanes; lane++) partial[lane] = next();
+      std::size_t i = lanes;
+      for (; i + lanes <= length; i += lanes) {
+        for (std::size_t lane = 0; lane < lanes; lane++) partial[lane] = reduce(partial[lane], next());
+      }
+      T result = partial[0];
+      for (std::size_t lane = 1; lane < lanes; lane++) result = reduce(result, partial[lane]);
+      for (; i < length; i++) result = reduce(result, next());
+      return result;
+    }
+
+    template <typename T, typename Source, typename Reduce>
+    T fold(const Source& source, std::size_t offset, std::size_t length, const Reduce& reduce, std::true_type) {
+      T sum;
+      if (simd_search::accumulate(to_pointer(source.first) + offset, length, T{}, sum)) return sum;
+      return fold<T>(source, offset, length, reduce, std::false_type{});
+    }
+
+    template <typename T, typename Source, typename Reduce>
+    T fold(const Source& source, std::size_t offset, std::size_t length, const Reduce& reduce) {
+      return fold<T>(source, offset, length, reduce,
+                     std::integral_constant<bool, use_simd_sum<Source, Reduce, T>::value>{});
+    }
+
+    template <typename T, typename Source, typename Reduce>
+    T reduce_source(execution::sequenced_policy, const Source& source, std::size_t length, T init,
+                    const Reduce& reduce) {
+      auto next = source.values(0);
+      for (std::size_t i = 0; i < length; i++) init = reduce(init, next());
+      return init;
+    }
+
+    template <typename T, typename Source, typename Reduce>
+    T reduce_source(execution::unsequenced_policy, const Source& source, std::size_t length, T init,
+                    const Reduce& reduce) {
+      if (length == 0) return init;
+      return reduce(init, fold<T>(source, 0, length, reduce));
+    }
+
+    // Scans only need an associative operation, so values are folded strictly in order - except
+    // plain sums, which may go to the vector kernels
+    template <typename T, typename Source, typename Operation>
+    T fold_in_order(const Source& source, std::size_t offset, std::size_t length, const Operation& operation) {
+      if (use_simd_sum<Source, Operation, T>::value) return fold<T>(source, offset, length, operation);
+      auto next = source.values(offset);
+      T result = next();
+      for (std::size_t i = 1; i < length; i++) result = operation(result, next());
+      return result;
+    }
+
+    // Partial results of the chunks are combined in chunk order
+    template <typename T, typename Source, typename Reduce>
+    T reduce_source(const execution::parallel_policy& policy, const Source& source, std::size_t length, T init,
+                    const Reduce& reduce) {
+      std::size_t size = policy.chunk_size > 0 ? policy.chunk_size : 1;
+      vector<T> partial(chunk_count(policy, length));
+      for_each_chunk(policy, length, [&](std::size_t offset, std::size_t chunk) {
+        partial[offset / size] = fold<T>(source, offset, chunk, reduce);
+      });
+      for (std::size_t i = 0; i < partial.size(); i++) init = reduce(init, partial[i]);
+      return init;
+    }
+
+    // Length of the range, constant time for random access iterators
+    template <typename Policy, typename Iterator>
+    std::size_t length_of(const Policy&, Iterator first, Iterator last) {
+      return detail::distance(first, last);
+    }
+
+    // Loops over raw pointers vectorize
+    template <typename InputIterator, typename OutputIterator, typename Operation>
+    OutputIterator transform_block(InputIterator first, std::size_t length, OutputIterator out,
+                                   Operation& operation, std::true_type) {
+      auto* in = to_pointer(first);
+      auto* result = to_pointer(out);
+      for (std::size_t i = 0; i < length; i++) result[i] = operation(in[i]);
+      return detail::advance(out, length);
+    }
+
+    template <typename InputIterator, typename OutputIterator, typename Operation>
+    OutputIterator transform_block(InputIterator first, std::size_t length, OutputIterator out,
+                                   Operation& operation, std::false_type) {
+      for (std::size_t i = 0; i < length; i++, ++first, ++out) *out = operation(*first);
+      return out;
+    }
+
+    template <typename InputIterator, typename OutputIterator, typename Operation>
+    OutputIterator transform(execution::sequenced_policy, InputIterator first, InputIterator last,
+                             OutputIterator out, Operation operation) {
+      for (; first != last; ++first, ++out) *out = operation(*first);
+      return out;
+    }
+
+    template <typename InputIterator, typename OutputIterator, typename Operation>
+    OutputIterator transform(execution::unsequenced_policy, InputIterator first, InputIterator last,
+                             OutputIterator out, Operation operation) {
+      return transform_block(first, detail::distance(first, last), out, operation,
+                             std::integral_constant<bool, is_contiguous<InputIterator>::value &&
+                                                              is_contiguous<OutputIterator>::value>{});
+    }
+
+    template <typename InputIterator, typename OutputIterator, typename Operation>
+    OutputIterator transform(const execution::parallel_policy& policy, InputIterator first, InputIterator last,
+                             OutputIterator out, Operation operation) {
+      std::size_t length = detail::distance(first, last);
+      for_each_chunk(policy, length, [&](std::size_t offset, std::size_t chunk) {
+        detail::transform(execution::unseq, detail::advance(first, offset), detail::advance(first, offset + chunk),
+                          detail::advance(out, offset), operation);
+      });
+      return detail::advance(out, length);
+    }
+
+    // Scans length elements starting from carry (only when has_carry, otherwise from the first
+    // element), returns the carry for the elements that follow
+    template <typename T, typename InputIterator, typename OutputIterator, typename Operation>
+    T scan_block(InputIterator first, std::size_t length, OutputIterator out, const Operation& operation, T carry,
+                 bool has_carry, bool exclusive, std::false_type) {
+      for (std::size_t i = 0; i < length; i++, ++first, ++out) {
+        T value = *first;
+        if (exclusive) {
+          *out = carry;
+          carry = operation(carry, value);
+        } else {
+          carry = has_carry || i > 0 ? operation(carry, value) : value;
+          *out = carry;
+        }
+      }
+      return carry;
+    }
+
+    template <typename T, typename InputIterator, typename OutputIterator, typename Operation>
+    T scan_block(InputIterator first, std::size_t length, OutputIterator out, const Operation& operation, T carry,
+                 bool has_carry, bool exclusive, std::true_type) {
+      T total;
+      if (simd_scan::prefix_sum(to_pointer(first), length, to_pointer(out), has_carry ? carry : T{}, exclusive,
+                                total))
+        return total;
+      return scan_block(first, length, out, operation, carry, has_carry, exclusive, std::false_type{});
+    }
+
+    template <typename InputIterator, typename OutputIterator, typename Operation, typename T>
+    struct use_simd_scan : std::integral_constant<bool, is_contiguous<InputIterator>::value &&
+        is_contiguous<OutputIterator>::value && std::is_same<Operation, plus_fn>::value &&
+        simd_scan::is_key<T>::value && std::is_same<value_type_of<InputIterator>, T>::value &&
+        std::is_same<value_type_of<OutputIterator>, T>::value> {};
+
+    template <typename T, typename InputIterator, typename OutputIterator, typename Operation>
+    OutputIterator scan(execution::sequenced_policy, InputIterator first, InputIterator last, OutputIterator out,
+                        const Operation& operation, T carry, bool has_carry, bool exclusive) {
+      for (bool started = false; first != last; ++first, ++out, started = true) {
+        T value = *first;
+        if (exclusive) {
+          *out = carry;
+          carry = operation(carry, value);
+        } else {
+          carry = has_carry || started ? operation(carry, value) : value;
+          *out = carry;
+        }
+      }
+      return out;
+    }
+
+    template <typename T, typename InputIterator, typename OutputIterator, typename Operation>
+    OutputIterator scan(execution::unsequenced_policy, InputIterator first, InputIterator last, OutputIterator out,
+                        const Operation& operation, T carry, bool has_carry, bool exclusive) {
+      std::size_t length = detail::distance(first, last);
+      scan_block(first, length, out, operation, carry, has_carry, exclusive,
+                 std::integral_constant<bool, use_simd_scan<InputIterator, OutputIterator, Operation, T>::value>{});
+      return detail::advance(out, length);
+    }
+
+    // Two passes: chunk totals are reduced in parallel, turned into the carry of every chunk
+    // sequentially, then all chunks are scanned in parallel starting from their carries.
+    // Input and output may be the same range.
+    template <typename T, typename InputIterator, typename OutputIterator, typename Operation>
+    OutputIterator scan(const execution::parallel_policy& policy, InputIterator first, InputIterator last,
+                        OutputIterator out, const Operation& operation, T carry, bool has_carry, bool exclusive) {
+      std::size_t length = detail::distance(first, last);
+      std::size_t size = policy.chunk_size > 0 ? policy.chunk_size : 1;
+      std::size_t chunks = chunk_count(policy, length);
+      if (chunks <= 1) return scan(execution::unseq, first, last, out, operation, carry, has_carry, exclusive);
+
+      unary_source<InputIterator, identity_fn> source{first, identity_fn{}};
+      vector<T> carries(chunks);
+      for_each_chunk(policy, (chunks - 1) * size, [&](std::size_t offset, std::size_t chunk) {
+        carries[offset / size + 1] = fold_in_order<T>(source, offset, chunk, operation);
+      });
+      vector<bool> started(chunks);
+      carries[0] = carry;
+      started[0] = has_carry;
+      for (std::size_t i = 1; i < chunks; i++) {
+        carries[i] = started[i - 1] ? operation(carries[i - 1], carries[i]) : carries[i];
+        started[i] = true;
+      }
+
+      constexpr bool simd = use_simd_scan<InputIterator, OutputIterator, Operation, T>::value;
+      for_each_chunk(policy, length, [&](std::size_t offset, std::size_t chunk) {
+        std::size_t index = offset / size;
+        scan_block(detail::advance(first, offset), chunk, detail::advance(out, offset), operation, carries[index],
+                   started[index], exclusive, std::integral_constant<bool, simd>{});
+      });
+      return detail::advance(out, length);
+    }
+  }
+
+  // out[i] = operation(first[i]), returns the end of the output
+  template <typename Policy, typename InputIterator, typename OutputIterator, typename Operation>
+  OutputIterator transform(const Policy& policy, InputIterator first, InputIterator last, OutputIterator out,
+                           Operation operation) {
+    return detail::transform(policy, first, last, out, operation);
+  }
+
+  template <typename Policy, typename InputIterator, typename T, typename Reduce = plus_fn>
+  T reduce(const Policy& policy, InputIterator first, InputIterator last, T init, Reduce reduce = Reduce{}) {
+    detail::unary_source<InputIterator, detail::identity_fn> source{first, detail::identity_fn{}};
+    return detail::reduce_source(policy, source, detail::length_of(policy, first, last), init, reduce);
+  }
+
+  // Reduces transform(x) of every element
+  template <typename Policy, typename InputIterator, typename T, typename Reduce, typename Transform>
+  T transform_reduce(const Policy& policy, InputIterator first, InputIterator last, T init, Reduce reduce,
+                     Transform transform) {
+    detail::unary_source<InputIterator, Transform> source{first, transform};
+    return detail::reduce_source(policy, source, detail::length_of(policy, first, last), init, reduce);
+  }
+
+  // Reduces combine(first1[i], first2[i]), by default the inner product
+  template <typename Policy, typename InputIterator1, typename InputIterator2, typename T, typename Reduce,
+            typename Combine>
+  T transform_reduce(const Policy& policy, InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, T init,
+                     Reduce reduce, Combine combine) {
+    detail::binary_source<InputIterator1, InputIterator2, Combine> source{first1, first2, combine};
+    return detail::reduce_source(policy, source, detail::length_of(policy, first1, last1), init, reduce);
+  }
+
+  template <typename Policy, typename InputIterator1, typename InputIterator2, typename T>
+  T transform_reduce(const Policy& policy, InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
+                     T init) {
+    return transform_reduce(policy, first1, last1, first2, init, plus_fn{}, multiplies_fn{});
+  }
+
+  // out[i] = first[0] op ... op first[i]. Output may be the input range.
+  template <typename Policy, typename InputIterator, typename OutputIterator, typename Operation = plus_fn>
+  OutputIterator inclusive_scan(const Policy& policy, InputIterator first, InputIterator last, OutputIterator out,
+                                Operation operation = Operation{}) {
+    using T = detail::value_type_of<InputIterator>;
+    return detail::scan<T>(policy, first, last, out, operation, T{}, false, false);
+  }
+
+  // out[i] = init op first[0] op ... op first[i]
+  template <typename Policy, typename InputIterator, typename OutputIterator, typename Operation, typename T>
+  OutputIterator inclusive_scan(const Policy& policy, InputIterator first, InputIterator last, OutputIterator out,
+                                Operation operation, T init) {
+    return detail::scan<T>(policy, first, last, out, operation, init, true, false);
+  }
+
+  // out[i] = init op first[0] op ... op first[i - 1], out[0] = init
+  template <typename Policy, typename InputIterator, typename OutputIterator, typename T, typename Operation = plus_fn>
+  OutputIterator exclusive_scan(const Policy& policy, InputIterator first, InputIterator last, OutputIterator out,
+                                T init, Operation operation = Operation{}) {
+    return detail::scan<T>(policy, first, last, out, operation, init, true, true);
+  }
+}
+
+#endif //PHOSTDLIB_NUMERIC_HPP
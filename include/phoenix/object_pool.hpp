@@ -0,0 +1,376 @@
+#ifndef PHOSTDLIB_OBJECT_POOL_HPP
+#define PHOSTDLIB_OBJECT_POOL_HPP
+#include <phoenix/vector.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+
+// Allocator of same-sized objects. Memory comes in slabs of many objects, and free objects are kept
+// in intrusive lists (the first bytes of a free object point to the next one). Every thread caches
+// up to two batches of free objects per pool, the magazines, so allocation and deallocation only
+// touch thread-local lists. Whole batches move between threads and the pool's depot, under the
+// lock of that pool's depot, at most once per BatchSize operations.
+// Objects may be freed by another thread than the one that allocated them. Cached objects of a
+// thread go back to the depot when it exits, later calls on that thread (from destructors of
+// objects with static storage duration) go straight to the depot. Destroying the pool releases
+// all of its slabs, objects still in use included.
+namespace phoenix {
+  struct object_pool_stats {
+    std::size_t slabs;     // Slabs allocated from the system
+    std::size_t capacity;  // Objects that fit into them
+    std::size_t in_use;    // Allocated and not freed yet
+    std::size_t cached;    // Free, in the magazines of threads
+    std::size_t free;      // Free, in the depot or not handed out yet
+
+    double occupancy() const { return capacity > 0 ? static_cast<double>(in_use) / capacity : 0.0; }
+  };
+
+  namespace detail {
+    struct free_node {
+      free_node* next;
+    };
+
+    // Free objects linked through their first bytes
+    struct free_list {
+      free_node* head = nullptr;
+      std::size_t size = 0;
+
+      void push(void* object) {
+        auto* node = static_cast<free_node*>(object);
+        node->next = head;
+        head = node;
+        size++;
+      }
+
+      void* pop() {
+        free_node* node = head;
+        head = node->next;
+        size--;
+        return node;
+      }
+    };
+
+    // Pools are told apart by ids that are never reused, unlike addresses
+    inline std::uint64_t next_pool_id() {
+      static std::atomic<std::uint64_t> counter{0};
+      return ++counter;
+    }
+
+    constexpr std::size_t max_of(std::size_t first, std::size_t second) { return first > second ? first : second; }
+  }
+
+  template <typename T, std::size_t BatchSize = 64>
+  class object_pool {
+    static_assert(BatchSize > 0, "batches can't be empty");
+    static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types are not supported");
+
+  public:
+    using value_type = T;
+
+    static constexpr std::size_t slot_alignment = detail::max_of(alignof(T), alignof(detail::free_node));
+    static constexpr std::size_t slot_size =
+        (detail::max_of(sizeof(T), sizeof(detail::free_node)) + slot_alignment - 1) / slot_alignment * slot_alignment;
+    // At least 64 KiB, and a whole number of batches
+    static constexpr std::size_t slab_objects =
+        detail::max_of(1, (std::size_t{1} << 16) / slot_size / BatchSize) * BatchSize;
+
+    object_pool() : _id{detail::next_pool_id()}, _depot{std::make_shared<depot>()} {}
+
+    object_pool(const object_pool&) = delete;
+    object_pool& operator=(const object_pool&) = delete;
+
+    // Storage for one object, not constructed
+    T* allocate() {
+      cache* local = thread_cache();
+      if (local == nullptr) return static_cast<T*>(_depot->take_one());
+      if (local->current.size == 0) refill(*local);
+      T* object = static_cast<T*>(local->current.pop());
+      local->count.store(local->current.size + local->previous.size, std::memory_order_relaxed);
+      return object;
+    }
+
+    void deallocate(T* object) {
+      if (object == nullptr) return;
+      cache* local = thread_cache();
+      if (local == nullptr) {
+        _depot->put_one(object);
+        return;
+      }
+      if (local->current.size == BatchSize) spill(*local);
+      local->current.push(object);
+      local->count.store(local->current.size + local->previous.size, std::memory_order_relaxed);
+    }
+
+    template <typename... Args>
+    T* create(Args&&... args) {
+      T* object = allocate();
+      try {
+        return new (object) T(std::forward<Args>(args)...);
+      } catch (...) {
+        deallocate(object);
+        throw;
+      }
+    }
+
+    void destroy(T* object) {
+      if (object == nullptr) return;
+      object->~T();
+      deallocate(object);
+    }
+
+    // Counters of threads are read without stopping them, so a pool in use gives approximate numbers
+    object_pool_stats stats() const {
+      std::lock_guard<std::mutex> guard(_depot->lock);
+      object_pool_stats result{};
+      result.slabs = _depot->slabs.size();
+      result.capacity = result.slabs * slab_objects;
+      result.free = _depot->unused;
+      for (std::size_t i = 0; i < _depot->batches.size(); i++) result.free += _depot->batches[i].size;
+      for (std::size_t i = 0; i < _depot->caches.size(); i++) {
+        result.cached += _depot->caches[i]->count.load(std::memory_order_relaxed);
+      }
+      std::size_t available = result.free + result.cached;
+      result.in_use = result.capacity > available ? result.capacity - available : 0;
+      return result;
+    }
+
+  private:
+    // Magazines of one thread: current is used first, previous is either full or empty
+    struct cache {
+      detail::free_list current, previous;
+      std::atomic<std::size_t> count{0};
+    };
+
+    struct depot {
+      std::mutex lock;
+      vector<detail::free_list> batches;
+      vector<char*> slabs;
+      // Part of the newest slab that was never handed out
+      char* next = nullptr;
+      std::size_t unused = 0;
+      vector<cache*> caches;
+
+      ~depot() {
+        for (std::size_t i = 0; i < slabs.size(); i++) ::operator delete(slabs[i]);
+      }
+
+      // Fills an empty magazine with a batch, from a new slab if there are no free ones
+      void take(cache& local) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (batches.size() > 0) {
+          local.current = batches.pop();
+        } else {
+          if (unused == 0) add_slab();
+          for (std::size_t i = 0; i < BatchSize; i++, next += slot_size) local.current.push(next);
+          unused -= BatchSize;
+        }
+        local.count.store(local.current.size + local.previous.size, std::memory_order_relaxed);
+      }
+
+      void add_slab() {
+        detail::grow(slabs, slabs.size() + 1);
+        slabs.push(static_cast<char*>(::operator new(slab_objects * slot_size)));
+        next = slabs[slabs.size() - 1];
+        unused = slab_objects;
+      }
+
+      // Single objects for threads whose magazines are already gone
+      void* take_one() {
+        std::lock_guard<std::mutex> guard(lock);
+        if (batches.size() > 0) {
+          void* object = batches[batches.size() - 1].pop();
+          if (batches[batches.size() - 1].size == 0) batches.pop();
+          return object;
+        }
+        if (unused == 0) add_slab();
+        void* object = next;
+        next += slot_size;
+        unused--;
+        return object;
+      }
+
+      void put_one(void* object) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (batches.size() == 0 || batches[batches.size() - 1].size == BatchSize) {
+          detail::grow(batches, batches.size() + 1);
+          batches.push(detail::free_list{});
+        }
+        batches[batches.size() - 1].push(object);
+      }
+
+      void give(cache& local, detail::free_list& batch) {
+        std::lock_guard<std::mutex> guard(lock);
+        put(batch);
+        local.count.store(local.current.size, std::memory_order_relaxed);
+      }
+
+      void put(detail::free_list& batch) {
+        if (batch.size == 0) return;
+        detail::grow(batches, batches.size() + 1);
+        batches.push(batch);
+        batch = detail::free_list{};
+      }
+
+      void add(cache* local) {
+        std::lock_guard<std::mutex> guard(lock);
+        detail::grow(caches, caches.size() + 1);
+        caches.push(local);
+      }
+
+      // Takes back the magazines of an exiting thread
+      void remove(cache* local) {
+        std::lock_guard<std::mutex> guard(lock);
+        put(local->current);
+        put(local->previous);
+        for (std::size_t i = 0; i < caches.size(); i++) {
+          if (caches[i] == local) {
+            caches[i] = caches[caches.size() - 1];
+            caches.pop();
+            break;
+          }
+        }
+      }
+    };
+
+    void refill(cache& local) {
+      if (local.previous.size > 0) {
+        std::swap(local.current, local.previous);
+        return;
+      }
+      _depot->take(local);
+    }
+
+    // current is full: it becomes previous, a full previous goes to the depot
+    void spill(cache& local) {
+      if (local.previous.size > 0) _depot->give(local, local.previous);
+      local.previous = local.current;
+      local.current = detail::free_list{};
+    }
+
+    struct registered_cache {
+      std::uint64_t id = 0;
+      cache* local = nullptr;
+      std::weak_ptr<depot> owner;
+    };
+
+    // Magazines of the calling thread for every pool of this type it used
+    struct registry {
+      vector<registered_cache> caches;
+
+      ~registry() {
+        for (std::size_t i = 0; i < caches.size(); i++) release(caches[i]);
+        _last = last_used{};
+        _torn_down = true;
+      }
+
+      static void release(registered_cache& entry) {
+        if (auto owner = entry.owner.lock()) owner->remove(entry.local);
+        delete entry.local;
+      }
+    };
+
+    // Trivial, so reading it is a plain thread-local load
+    struct last_used {
+      std::uint64_t id;
+      cache* local;
+    };
+
+    static thread_local last_used _last;
+    static thread_local registry _registry;
+    // Set once the registry of the thread is destroyed, trivial so it can still be read afterwards
+    static thread_local bool _torn_down;
+
+    // nullptr when the thread is exiting and its magazines were already released
+    cache* thread_cache() {
+      if (_last.id == _id) return _last.local;
+      if (_torn_down) return nullptr;
+      return register_thread();
+    }
+
+    cache* register_thread() {
+      auto& caches = _registry.caches;
+      cache* local = nullptr;
+      for (std::size_t i = 0; i < caches.size() && local == nullptr; i++) {
+        if (caches[i].id == _id) local = caches[i].local;
+      }
+      if (local == nullptr) {
+        // Entries of destroyed pools are dropped on the way
+        for (std::size_t i = 0; i < caches.size();) {
+          if (caches[i].owner.expired()) {
+            registry::release(caches[i]);
+            caches[i] = caches[caches.size() - 1];
+            caches.pop();
+          } else {
+            i++;
+          }
+        }
+        local = new cache();
+        _depot->add(local);
+        registered_cache entry;
+        entry.id = _id;
+        entry.local = local;
+        entry.owner = _depot;
+        detail::grow(caches, caches.size() + 1);
+        caches.push(entry);
+      }
+      _last = last_used{_id, local};
+      return local;
+    }
+
+    std::uint64_t _id;
+    std::shared_ptr<depot> _depot;
+  };
+
+  template <typename T, std::size_t BatchSize>
+  thread_local typename object_pool<T, BatchSize>::last_used object_pool<T, BatchSize>::_last{0, nullptr};
+
+  template <typename T, std::size_t BatchSize>
+  thread_local typename object_pool<T, BatchSize>::registry object_pool<T, BatchSize>::_registry;
+
+  template <typename T, std::size_t BatchSize>
+  thread_local bool object_pool<T, BatchSize>::_torn_down{false};
+
+  // Standard allocator taking single objects from a pool shared by all allocators of T, so that
+  // node-based containers can use it. Arrays go to operator new. The pools are never destroyed,
+  // so containers with static storage duration can still free their nodes at exit.
+  template <typename T>
+  class pool_allocator {
+  public:
+    using value_type = T;
+
+    pool_allocator() noexcept = default;
+
+    template <typename U>
+    pool_allocator(const pool_allocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+      if (n == 1) return pool().allocate();
+      return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* object, std::size_t n) noexcept {
+      if (n == 1) {
+        pool().deallocate(object);
+      } else {
+        ::operator delete(object);
+      }
+    }
+
+    static object_pool<T>& pool() {
+      static auto* shared = new object_pool<T>();
+      return *shared;
+    }
+
+    template <typename U>
+    bool operator==(const pool_allocator<U>&) const noexcept { return true; }
+
+    template <typename U>
+    bool operator!=(const pool_allocator<U>&) const noexcept { return false; }
+  };
+}
+
+#endif //PHOSTDLIB_OBJECT_POOL_HPP
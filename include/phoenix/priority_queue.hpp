@@ -0,0 +1,297 @@
+#ifndef PHOSTDLIB_PRIORITY_QUEUE_HPP
+#define PHOSTDLIB_PRIORITY_QUEUE_HPP
+#include <phoenix/utility.hpp>
+#include <phoenix/vector.hpp>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+// Heaps with Arity children per node, stored in phoenix::vector. Wider nodes make the heap
+// shallower and put all children of a node next to each other, so sifting down touches fewer
+// cache lines than in a binary heap. The top element is the one which goes last in the order
+// of Compare - the biggest for greater_fn (the default) and the smallest for less_fn.
+namespace phoenix {
+  namespace detail {
+    namespace dary_heap {
+      // Elements are moved through a hole, placed(i) is called whenever heap[i] gets a new element
+      template <std::size_t Arity, typename T, std::size_t AllocSize, typename Above, typename Placed>
+      void sift_up(vector<T, AllocSize>& heap, std::size_t hole, Above above, Placed placed) {
+        T value = std::move(heap[hole]);
+        while (hole > 0) {
+          std::size_t parent = (hole - 1) / Arity;
+          if (!above(value, heap[parent])) break;
+          heap[hole] = std::move(heap[parent]);
+          placed(hole);
+          hole = parent;
+        }
+        heap[hole] = std::move(value);
+        placed(hole);
+      }
+
+      template <std::size_t Arity, typename T, std::size_t AllocSize, typename Above, typename Placed>
+      void sift_down(vector<T, AllocSize>& heap, std::size_t length, std::size_t hole, Above above, Placed placed) {
+        T value = std::move(heap[hole]);
+        for (std::size_t first = hole * Arity + 1; first < length; first = hole * Arity + 1) {
+          std::size_t last = length - first > Arity ? first + Arity : length;
+          std::size_t best = first;
+          for (std::size_t child = first + 1; child < last; child++) {
+            if (above(heap[child], heap[best])) best = child;
+          }
+          if (!above(heap[best], value)) break;
+          heap[hole] = std::move(heap[best]);
+          placed(hole);
+          hole = best;
+        }
+        heap[hole] = std::move(value);
+        placed(hole);
+      }
+
+      // Fills the hole with value after a removal: the hole first moves down to a leaf along the
+      // best children, then value rises from there. Value usually belongs near the bottom, so this
+      // takes fewer comparisons than sifting it down from the hole.
+      template <std::size_t Arity, typename T, std::size_t AllocSize, typename Above, typename Placed>
+      void refill(vector<T, AllocSize>& heap, std::size_t length, std::size_t hole, T value, Above above,
+                  Placed placed) {
+        std::size_t top = hole;
+        for (std::size_t first = hole * Arity + 1; first < length; first = hole * Arity + 1) {
+          std::size_t last = length - first > Arity ? first + Arity : length;
+          std::size_t best = first;
+          for (std::size_t child = first + 1; child < last; child++) {
+            if (above(heap[child], heap[best])) best = child;
+          }
+          heap[hole] = std::move(heap[best]);
+          placed(hole);
+          hole = best;
+        }
+        while (hole > top) {
+          std::size_t parent = (hole - 1) / Arity;
+          if (!above(value, heap[parent])) break;
+          heap[hole] = std::move(heap[parent]);
+          placed(hole);
+          hole = parent;
+        }
+        heap[hole] = std::move(value);
+        placed(hole);
+      }
+
+      // Floyd's construction, O(N)
+      template <std::size_t Arity, typename T, std::size_t AllocSize, typename Above, typename Placed>
+      void heapify(vector<T, AllocSize>& heap, Above above, Placed placed) {
+        std::size_t length = heap.size();
+        if (length < 2) {
+          if (length == 1) placed(0);
+          return;
+        }
+        // Leaves are only placed, they never move during construction
+        for (std::size_t i = (length - 2) / Arity + 1; i < length; i++) placed(i);
+        for (std::size_t i = (length - 2) / Arity + 1; i-- > 0;) sift_down<Arity>(heap, length, i, above, placed);
+      }
+
+      struct ignore_placement {
+        void operator()(std::size_t) const {}
+      };
+    }
+  }
+
+  template <typename T, typename Compare = greater_fn, std::size_t Arity = 4>
+  class priority_queue {
+    static_assert(Arity >= 2, "Heap nodes need at least two children");
+
+   public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    explicit priority_queue(Compare compare = Compare{}) : _heap(), _compare(compare) {}
+
+    // Builds the heap in O(N)
+    explicit priority_queue(vector<T> elements, Compare compare = Compare{})
+        : _heap(std::move(elements)), _compare(compare) {
+      detail::dary_heap::heapify<Arity>(_heap, _compare, detail::dary_heap::ignore_placement{});
+    }
+
+    template <typename InputIterator>
+    priority_queue(InputIterator begin, InputIterator end, Compare compare = Compare{}) : _heap(), _compare(compare) {
+      for (; begin != end; ++begin) {
+        detail::grow(_heap, _heap.size() + 1);
+        _heap.push(*begin);
+      }
+      detail::dary_heap::heapify<Arity>(_heap, _compare, detail::dary_heap::ignore_placement{});
+    }
+
+    size_type size() const { return _heap.size(); }
+    bool empty() const { return _heap.size() == 0; }
+    void reserve(size_type capacity) { detail::grow(_heap, capacity); }
+    void clear() { _heap.resize(0); }
+
+    const T& top() const {
+      if (empty()) throw std::out_of_range("Cannot get the top of an empty priority queue!");
+      return _heap[0];
+    }
+
+    void push(T value) {
+      detail::grow(_heap, _heap.size() + 1);
+      _heap.resize(_heap.size() + 1);
+      _heap[_heap.size() - 1] = std::move(value);
+      detail::dary_heap::sift_up<Arity>(_heap, _heap.size() - 1, _compare, detail::dary_heap::ignore_placement{});
+    }
+
+    // Removes and returns the top element
+    T pop() {
+      if (empty()) throw std::out_of_range("Cannot pop from an empty priority queue!");
+      T result = std::move(_heap[0]);
+      std::size_t last = _heap.size() - 1;
+      if (last > 0) {
+        detail::dary_heap::refill<Arity>(_heap, last, 0, std::move(_heap[last]), _compare,
+                                         detail::dary_heap::ignore_placement{});
+      }
+      _heap.resize(last);
+      return result;
+    }
+
+    // Elements in heap order
+    const vector<T>& elements() const { return _heap; }
+
+   private:
+    vector<T> _heap;
+    Compare _compare;
+  };
+
+  // Priority queue whose elements can be changed or removed through handles returned by push.
+  // Handles of popped or erased elements are reused by later pushes.
+  template <typename T, typename Compare = greater_fn, std::size_t Arity = 4>
+  class indexed_priority_queue {
+    static_assert(Arity >= 2, "Heap nodes need at least two children");
+
+   public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using handle = std::size_t;
+
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    explicit indexed_priority_queue(Compare compare = Compare{}) : _compare(compare) {}
+
+    size_type size() const { return _heap.size(); }
+    bool empty() const { return _heap.size() == 0; }
+
+    void reserve(size_type capacity) {
+      detail::grow(_heap, capacity);
+      detail::grow(_positions, capacity);
+    }
+
+    void clear() {
+      _heap.resize(0);
+      _positions.resize(0);
+      _free.resize(0);
+    }
+
+    bool contains(handle h) const { return h < _positions.size() && _positions[h] != npos; }
+
+    const T& value(handle h) const { return _heap[position(h)].value; }
+
+    const T& top() const {
+      if (empty()) throw std::out_of_range("Cannot get the top of an empty priority queue!");
+      return _heap[0].value;
+    }
+
+    handle top_handle() const {
+      if (empty()) throw std::out_of_range("Cannot get the top of an empty priority queue!");
+      return _heap[0].id;
+    }
+
+    handle push(T value) {
+      handle h;
+      if (_free.size() > 0) {
+        h = _free.pop();
+      } else {
+        h = _positions.size();
+        detail::grow(_positions, h + 1);
+        _positions.push(npos);
+      }
+      detail::grow(_heap, _heap.size() + 1);
+      _heap.resize(_heap.size() + 1);
+      _heap[_heap.size() - 1] = entry{std::move(value), h};
+      detail::dary_heap::sift_up<Arity>(_heap, _heap.size() - 1, above(), placement());
+      return h;
+    }
+
+    T pop() {
+      if (empty()) throw std::out_of_range("Cannot pop from an empty priority queue!");
+      T result = std::move(_heap[0].value);
+      remove_at(0);
+      return result;
+    }
+
+    // Moves the element of h towards the top. Throws std::invalid_argument if value would have
+    // a lower priority than the current one, use update for changes in both directions.
+    void decrease_key(handle h, T value) {
+      std::size_t index = position(h);
+      if (_compare(_heap[index].value, value))
+        throw std::invalid_argument("decrease_key can't lower the priority of an element!");
+      _heap[index].value = std::move(value);
+      detail::dary_heap::sift_up<Arity>(_heap, index, above(), placement());
+    }
+
+    void update(handle h, T value) {
+      std::size_t index = position(h);
+      bool up = _compare(value, _heap[index].value);
+      _heap[index].value = std::move(value);
+      if (up) detail::dary_heap::sift_up<Arity>(_heap, index, above(), placement());
+      else detail::dary_heap::sift_down<Arity>(_heap, _heap.size(), index, above(), placement());
+    }
+
+    void erase(handle h) { remove_at(position(h)); }
+
+   private:
+    struct entry {
+      T value;
+      handle id;
+    };
+
+    auto above() const {
+      const Compare& compare = _compare;
+      return [&compare](const entry& a, const entry& b) { return compare(a.value, b.value); };
+    }
+
+    auto placement() {
+      return [this](std::size_t index) { _positions[_heap[index].id] = index; };
+    }
+
+    std::size_t position(handle h) const {
+      if (!contains(h)) throw std::out_of_range("Handle doesn't refer to an element of the priority queue!");
+      return _positions[h];
+    }
+
+    // Fills the hole with the last element, which can belong either above or below it. Nothing is
+    // above the root, and pop has already moved its value out, so the root is always refilled.
+    void remove_at(std::size_t index) {
+      handle removed = _heap[index].id;
+      std::size_t last = _heap.size() - 1;
+      if (index != last) {
+        if (index > 0 && _compare(_heap[last].value, _heap[index].value)) {
+          _heap[index] = std::move(_heap[last]);
+          detail::dary_heap::sift_up<Arity>(_heap, index, above(), placement());
+        } else {
+          detail::dary_heap::refill<Arity>(_heap, last, index, std::move(_heap[last]), above(), placement());
+        }
+        _heap.resize(last);
+      } else {
+        _heap.resize(last);
+      }
+      _positions[removed] = npos;
+      detail::grow(_free, _free.size() + 1);
+      _free.push(removed);
+    }
+
+    vector<entry> _heap;
+    vector<std::size_t> _positions;
+    vector<handle> _free;
+    Compare _compare;
+  };
+
+  template <typename T, typename Compare, std::size_t Arity>
+  constexpr std::size_t indexed_priority_queue<T, Compare, Arity>::npos;
+}
+
+#endif //PHOSTDLIB_PRIORITY_QUEUE_HPP
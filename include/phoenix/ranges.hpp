@@ -0,0 +1,726 @@
+#ifndef PHOSTDLIB_RANGES_HPP
+#define PHOSTDLIB_RANGES_HPP
+#include <phoenix/iterator_flag.hpp>
+#include <phoenix/utility.hpp>
+#include <phoenix/vector.hpp>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+// Lazy views chained with |, for example
+//   auto squares = values | views::filter(is_odd) | views::map(square) | views::take(10) | to_vector();
+// No view stores elements: iterating the last one walks the container once, running every stage
+// on each element in turn, and to_vector allocates the result once when its length is known.
+// Views refer to the containers they were made from, which have to outlive them; views of
+// temporary containers don't compile. Functions are stored in the views.
+namespace phoenix {
+  // Base of the views, which are cheap to copy and are used by value
+  struct view_base {};
+
+  namespace detail {
+    template <typename Range>
+    using range_iterator = decltype(std::declval<const Range&>().begin());
+
+    template <typename Range>
+    using range_reference = decltype(*std::declval<range_iterator<Range>&>());
+
+    template <typename Range>
+    struct is_view : std::is_base_of<view_base, typename std::decay<Range>::type> {};
+
+    template <typename Range, typename = void>
+    struct has_size : std::false_type {};
+
+    template <typename Range>
+    struct has_size<Range, void_t<decltype(std::declval<const Range&>().size())>> : std::true_type {};
+
+    // Element type of the vectors made from a range
+    template <typename Range, typename = void>
+    struct range_value {
+      using type = typename std::decay<range_reference<Range>>::type;
+    };
+
+    template <typename Range>
+    struct range_value<Range, void_t<typename Range::value_type>> {
+      using type = typename Range::value_type;
+    };
+
+    // Iterators of views over Iterator have at most the Limit flag, and are never contiguous
+    template <typename Iterator, iterator_flag Limit>
+    struct view_flag : std::integral_constant<iterator_flag,
+        has_flag(iterator_flag_of<Iterator>::value, Limit) ? Limit : iterator_flag_of<Iterator>::value> {};
+
+    // Iterator n steps further, but not past end
+    template <typename Iterator>
+    Iterator bounded_advance(Iterator it, Iterator end, std::size_t n, std::false_type) {
+      for (; n > 0 && it != end; n--) ++it;
+      return it;
+    }
+
+    template <typename Iterator>
+    Iterator bounded_advance(Iterator it, Iterator end, std::size_t n, std::true_type) {
+      std::size_t left = static_cast<std::size_t>(end - it);
+      return detail::advance(it, n < left ? n : left);
+    }
+
+    template <typename Iterator>
+    Iterator bounded_advance(Iterator it, Iterator end, std::size_t n) {
+      return bounded_advance(it, end, n, is_random_access<Iterator>{});
+    }
+
+    template <typename T>
+    struct range_convert {
+      template <typename Reference>
+      static T from(Reference&& reference) { return T(std::forward<Reference>(reference)); }
+    };
+
+    // Pairs of references (zip, enumerate) become pairs of values
+    template <typename T1, typename T2>
+    struct range_convert<pair<T1, T2>> {
+      template <typename U1, typename U2>
+      static pair<T1, T2> from(const pair<U1, U2>& reference) {
+        return pair<T1, T2>{range_convert<T1>::from(reference.first), range_convert<T2>::from(reference.second)};
+      }
+    };
+  }
+
+  // Pair of iterators
+  template <typename Iterator>
+  class subrange : public view_base {
+  public:
+    using iterator = Iterator;
+
+    subrange() : _begin{}, _end{} {}
+    subrange(Iterator begin, Iterator end) : _begin{begin}, _end{end} {}
+
+    Iterator begin() const { return _begin; }
+    Iterator end() const { return _end; }
+    bool empty() const { return _begin == _end; }
+
+    template <typename I = Iterator, typename std::enable_if<detail::is_random_access<I>::value, int>::type = 0>
+    std::size_t size() const { return detail::distance(_begin, _end); }
+
+  private:
+    Iterator _begin, _end;
+  };
+
+  namespace views {
+    // Views are used as they are, containers through a subrange of their iterators
+    template <typename View, typename std::enable_if<detail::is_view<View>::value, int>::type = 0>
+    typename std::decay<View>::type all(View&& view) { return std::forward<View>(view); }
+
+    template <typename Container, typename std::enable_if<!detail::is_view<Container>::value, int>::type = 0>
+    subrange<decltype(std::declval<Container&>().begin())> all(Container& container) {
+      return subrange<decltype(std::declval<Container&>().begin())>(container.begin(), container.end());
+    }
+  }
+
+  namespace detail {
+    template <typename Range>
+    using all_t = decltype(views::all(std::declval<Range>()));
+
+    // Adaptor waiting for its range: closure(range) or range | closure
+    template <typename Function>
+    struct range_closure {
+      Function function;
+
+      template <typename Range>
+      auto operator()(Range&& range) const -> decltype(function(views::all(std::forward<Range>(range)))) {
+        return function(views::all(std::forward<Range>(range)));
+      }
+    };
+
+    template <typename Function>
+    range_closure<Function> make_closure(Function function) { return range_closure<Function>{function}; }
+
+    template <typename Range, typename Function>
+    auto operator|(Range&& range, const range_closure<Function>& closure)
+        -> decltype(closure(std::forward<Range>(range))) {
+      return closure(std::forward<Range>(range));
+    }
+  }
+
+  // function(element) of every element
+  template <typename Base, typename Function>
+  class map_view : public view_base {
+    using base_iterator = detail::range_iterator<Base>;
+
+  public:
+    using value_type = typename std::decay<decltype(std::declval<const Function&>()(
+        std::declval<detail::range_reference<Base>>()))>::type;
+
+    class iterator {
+    public:
+      using self = iterator;
+      static constexpr auto iterator_type = detail::view_flag<base_iterator, iterator_flag::random_access>::value;
+
+      using iterator_category = detail::std_category<iterator_type>;
+      using value_type = map_view::value_type;
+      using reference = decltype(std::declval<const Function&>()(*std::declval<base_iterator&>()));
+      using pointer = void;
+      using difference_type = std::ptrdiff_t;
+
+      iterator() : _it{}, _function{nullptr} {}
+      iterator(base_iterator it, const Function* function) : _it{it}, _function{function} {}
+
+      reference operator*() const { return (*_function)(*_it); }
+      reference operator[](difference_type x) const { return *(*this + x); }
+
+      self& operator++() {
+        ++_it;
+        return *this;
+      }
+
+      self operator++(int) {
+        auto t = *this;
+        ++_it;
+        return t;
+      }
+
+      self& operator--() {
+        --_it;
+        return *this;
+      }
+
+      self operator--(int) {
+        auto t = *this;
+        --_it;
+        return t;
+      }
+
+      self& operator+=(difference_type x) {
+        _it += x;
+        return *this;
+      }
+
+      self& operator-=(difference_type x) {
+        _it -= x;
+        return *this;
+      }
+
+      self operator+(difference_type x) const { return self(_it + x, _function); }
+      self operator-(difference_type x) const { return self(_it - x, _function); }
+      difference_type operator-(const self& other) const { return _it - other._it; }
+      friend self operator+(difference_type x, const self& it) { return it + x; }
+
+      bool operator==(const self& other) const { return _it == other._it; }
+      bool operator!=(const self& other) const { return _it != other._it; }
+      bool operator<(const self& other) const { return _it < other._it; }
+      bool operator>(const self& other) const { return _it > other._it; }
+      bool operator<=(const self& other) const { return _it <= other._it; }
+      bool operator>=(const self& other) const { return _it >= other._it; }
+
+    private:
+      base_iterator _it;
+      const Function* _function;
+    };
+
+    map_view(Base base, Function function) : _base(std::move(base)), _function(std::move(function)) {}
+
+    iterator begin() const { return iterator(_base.begin(), &_function); }
+    iterator end() const { return iterator(_base.end(), &_function); }
+
+    const Base& base() const { return _base; }
+    const Function& function() const { return _function; }
+
+    template <typename B = Base, typename std::enable_if<detail::has_size<B>::value, int>::type = 0>
+    std::size_t size() const { return _base.size(); }
+
+  private:
+    Base _base;
+    Function _function;
+  };
+
+  // Elements for which predicate(element) is true
+  template <typename Base, typename Predicate>
+  class filter_view : public view_base {
+    using base_iterator = detail::range_iterator<Base>;
+
+  public:
+    using value_type = typename detail::range_value<Base>::type;
+
+    class iterator {
+    public:
+      using self = iterator;
+      static constexpr auto iterator_type = detail::view_flag<base_iterator, iterator_flag::forward>::value;
+
+      using iterator_category = detail::std_category<iterator_type>;
+      using value_type = filter_view::value_type;
+      using reference = detail::range_reference<Base>;
+      using pointer = void;
+      using difference_type = std::ptrdiff_t;
+
+      iterator() : _it{}, _end{}, _predicate{nullptr} {}
+      iterator(base_iterator it, base_iterator end, const Predicate* predicate)
+          : _it{it}, _end{end}, _predicate{predicate} {
+        skip();
+      }
+
+      reference operator*() const { return *_it; }
+
+      self& operator++() {
+        ++_it;
+        skip();
+        return *this;
+      }
+
+      self operator++(int) {
+        auto t = *this;
+        this->operator++();
+        return t;
+      }
+
+      bool operator==(const self& other) const { return _it == other._it; }
+      bool operator!=(const self& other) const { return _it != other._it; }
+
+    private:
+      void skip() {
+        while (_it != _end && !(*_predicate)(*_it)) ++_it;
+      }
+
+      base_iterator _it, _end;
+      const Predicate* _predicate;
+    };
+
+    filter_view(Base base, Predicate predicate) : _base(std::move(base)), _predicate(std::move(predicate)) {}
+
+    iterator begin() const { return iterator(_base.begin(), _base.end(), &_predicate); }
+    iterator end() const { return iterator(_base.end(), _base.end(), &_predicate); }
+
+    const Base& base() const { return _base; }
+    const Predicate& predicate() const { return _predicate; }
+
+  private:
+    Base _base;
+    Predicate _predicate;
+  };
+
+  // At most count first elements of ranges without random access
+  template <typename Base>
+  class take_view : public view_base {
+    using base_iterator = detail::range_iterator<Base>;
+
+  public:
+    using value_type = typename detail::range_value<Base>::type;
+
+    class iterator {
+    public:
+      using self = iterator;
+      static constexpr auto iterator_type = detail::view_flag<base_iterator, iterator_flag::forward>::value;
+
+      using iterator_category = detail::std_category<iterator_type>;
+      using value_type = take_view::value_type;
+      using reference = detail::range_reference<Base>;
+      using pointer = void;
+      using difference_type = std::ptrdiff_t;
+
+      iterator() : _it{}, _left{0} {}
+      iterator(base_iterator it, std::size_t left) : _it{it}, _left{left} {}
+
+      reference operator*() const { return *_it; }
+
+      // The base isn't advanced past the last element, so filters don't search for one more
+      self& operator++() {
+        if (--_left > 0) ++_it;
+        return *this;
+      }
+
+      self operator++(int) {
+        auto t = *this;
+        this->operator++();
+        return t;
+      }
+
+      // Ends after count elements or with the base range, whichever comes first
+      bool operator==(const self& other) const { return _left == other._left || _it == other._it; }
+      bool operator!=(const self& other) const { return !(*this == other); }
+
+    private:
+      base_iterator _it;
+      std::size_t _left;
+    };
+
+    take_view(Base base, std::size_t count) : _base(std::move(base)), _count{count} {}
+
+    iterator begin() const { return iterator(_base.begin(), _count); }
+    iterator end() const { return iterator(_base.end(), 0); }
+
+    template <typename B = Base, typename std::enable_if<detail::has_size<B>::value, int>::type = 0>
+    std::size_t size() const {
+      std::size_t size = _base.size();
+      return size < _count ? size : _count;
+    }
+
+  private:
+    Base _base;
+    std::size_t _count;
+  };
+
+  // Elements after the first count ones of ranges without random access, skipped on every begin()
+  template <typename Base>
+  class drop_view : public view_base {
+    using base_iterator = detail::range_iterator<Base>;
+
+  public:
+    using value_type = typename detail::range_value<Base>::type;
+    using iterator = base_iterator;
+
+    drop_view(Base base, std::size_t count) : _base(std::move(base)), _count{count} {}
+
+    iterator begin() const { return detail::bounded_advance(_base.begin(), _base.end(), _count); }
+    iterator end() const { return _base.end(); }
+
+    template <typename B = Base, typename std::enable_if<detail::has_size<B>::value, int>::type = 0>
+    std::size_t size() const {
+      std::size_t size = _base.size();
+      return size > _count ? size - _count : 0;
+    }
+
+  private:
+    Base _base;
+    std::size_t _count;
+  };
+
+  // Consecutive subranges of size elements, the last one may be shorter
+  template <typename Base>
+  class chunk_view : public view_base {
+    using base_iterator = detail::range_iterator<Base>;
+
+  public:
+    using value_type = subrange<base_iterator>;
+
+    class iterator {
+    public:
+      using self = iterator;
+      static constexpr auto iterator_type = detail::view_flag<base_iterator, iterator_flag::forward>::value;
+
+      using iterator_category = detail::std_category<iterator_type>;
+      using value_type = chunk_view::value_type;
+      using reference = value_type;
+      using pointer = void;
+      using difference_type = std::ptrdiff_t;
+
+      iterator() : _it{}, _next{}, _end{}, _size{0} {}
+      iterator(base_iterator it, base_iterator end, std::size_t size)
+          : _it{it}, _next{detail::bounded_advance(it, end, size)}, _end{end}, _size{size} {}
+
+      reference operator*() const { return reference(_it, _next); }
+
+      self& operator++() {
+        _it = _next;
+        _next = detail::bounded_advance(_it, _end, _size);
+        return *this;
+      }
+
+      self operator++(int) {
+        auto t = *this;
+        this->operator++();
+        return t;
+      }
+
+      bool operator==(const self& other) const { return _it == other._it; }
+      bool operator!=(const self& other) const { return _it != other._it; }
+
+    private:
+      base_iterator _it, _next, _end;
+      std::size_t _size;
+    };
+
+    chunk_view(Base base, std::size_t size) : _base(std::move(base)), _size{size > 0 ? size : 1} {}
+
+    iterator begin() const { return iterator(_base.begin(), _base.end(), _size); }
+    iterator end() const { return iterator(_base.end(), _base.end(), _size); }
+
+    template <typename B = Base, typename std::enable_if<detail::has_size<B>::value, int>::type = 0>
+    std::size_t size() const { return (_base.size() + _size - 1) / _size; }
+
+  private:
+    Base _base;
+    std::size_t _size;
+  };
+
+  // Pairs of elements at the same positions, as long as the shorter range
+  template <typename First, typename Second>
+  class zip_view : public view_base {
+    using first_iterator = detail::range_iterator<First>;
+    using second_iterator = detail::range_iterator<Second>;
+
+  public:
+    using value_type = pair<typename detail::range_value<First>::type, typename detail::range_value<Second>::type>;
+
+    class iterator {
+    public:
+      using self = iterator;
+      static constexpr auto iterator_type = detail::view_flag<first_iterator,
+          detail::view_flag<second_iterator, iterator_flag::forward>::value>::value;
+
+      using iterator_category = detail::std_category<iterator_type>;
+      using value_type = zip_view::value_type;
+      using reference = pair<detail::range_reference<First>, detail::range_reference<Second>>;
+      using pointer = void;
+      using difference_type = std::ptrdiff_t;
+
+      iterator() : _first{}, _second{} {}
+      iterator(first_iterator first, second_iterator second) : _first{first}, _second{second} {}
+
+      reference operator*() const { return reference{*_first, *_second}; }
+
+      self& operator++() {
+        ++_first;
+        ++_second;
+        return *this;
+      }
+
+      self operator++(int) {
+        auto t = *this;
+        this->operator++();
+        return t;
+      }
+
+      bool operator==(const self& other) const { return _first == other._first || _second == other._second; }
+      bool operator!=(const self& other) const { return !(*this == other); }
+
+    private:
+      first_iterator _first;
+      second_iterator _second;
+    };
+
+    zip_view(First first, Second second) : _first(std::move(first)), _second(std::move(second)) {}
+
+    iterator begin() const { return iterator(_first.begin(), _second.begin()); }
+    iterator end() const { return iterator(_first.end(), _second.end()); }
+
+    template <typename F = First, typename S = Second,
+              typename std::enable_if<detail::has_size<F>::value && detail::has_size<S>::value, int>::type = 0>
+    std::size_t size() const {
+      std::size_t first = _first.size(), second = _second.size();
+      return first < second ? first : second;
+    }
+
+  private:
+    First _first;
+    Second _second;
+  };
+
+  // Pairs of position and element
+  template <typename Base>
+  class enumerate_view : public view_base {
+    using base_iterator = detail::range_iterator<Base>;
+
+  public:
+    using value_type = pair<std::size_t, typename detail::range_value<Base>::type>;
+
+    class iterator {
+    public:
+      using self = iterator;
+      static constexpr auto iterator_type = detail::view_flag<base_iterator, iterator_flag::forward>::value;
+
+      using iterator_category = detail::std_category<iterator_type>;
+      using value_type = enumerate_view::value_type;
+      using reference = pair<std::size_t, detail::range_reference<Base>>;
+      using pointer = void;
+      using difference_type = std::ptrdiff_t;
+
+      iterator() : _it{}, _index{0} {}
+      iterator(base_iterator it, std::size_t index) : _it{it}, _index{index} {}
+
+      reference operator*() const { return reference{_index, *_it}; }
+
+      self& operator++() {
+        ++_it;
+        ++_index;
+        return *this;
+      }
+
+      self operator++(int) {
+        auto t = *this;
+        this->operator++();
+        return t;
+      }
+
+      bool operator==(const self& other) const { return _it == other._it; }
+      bool operator!=(const self& other) const { return _it != other._it; }
+
+    private:
+      base_iterator _it;
+      std::size_t _index;
+    };
+
+    explicit enumerate_view(Base base) : _base(std::move(base)) {}
+
+    iterator begin() const { return iterator(_base.begin(), 0); }
+    iterator end() const { return iterator(_base.end(), 0); }
+
+    template <typename B = Base, typename std::enable_if<detail::has_size<B>::value, int>::type = 0>
+    std::size_t size() const { return _base.size(); }
+
+  private:
+    Base _base;
+  };
+
+  namespace detail {
+    template <typename View>
+    struct is_subrange : std::false_type {};
+
+    template <typename Iterator>
+    struct is_subrange<subrange<Iterator>> : std::true_type {};
+
+    // Subranges with random access are cut in constant time, keeping their iterators (and contiguity).
+    // Iterators of other views refer to the view, so they are wrapped by a view that owns it.
+    template <typename View>
+    subrange<range_iterator<View>> take(const View& view, std::size_t count, std::true_type) {
+      return subrange<range_iterator<View>>(view.begin(), bounded_advance(view.begin(), view.end(), count));
+    }
+
+    template <typename View>
+    take_view<View> take(const View& view, std::size_t count, std::false_type) {
+      return take_view<View>(view, count);
+    }
+
+    template <typename View>
+    subrange<range_iterator<View>> drop(const View& view, std::size_t count, std::true_type) {
+      return subrange<range_iterator<View>>(bounded_advance(view.begin(), view.end(), count), view.end());
+    }
+
+    template <typename View>
+    drop_view<View> drop(const View& view, std::size_t count, std::false_type) {
+      return drop_view<View>(view, count);
+    }
+
+    template <typename View>
+    using can_slice = std::integral_constant<bool, is_subrange<View>::value &&
+                                                   is_random_access<range_iterator<View>>::value>;
+  }
+
+  namespace views {
+    template <typename Function>
+    auto map(Function function) {
+      return detail::make_closure([function](auto base) { return map_view<decltype(base), Function>(base, function); });
+    }
+
+    template <typename Predicate>
+    auto filter(Predicate predicate) {
+      return detail::make_closure([predicate](auto base) {
+        return filter_view<decltype(base), Predicate>(base, predicate);
+      });
+    }
+
+    inline auto take(std::size_t count) {
+      return detail::make_closure([count](auto base) {
+        return detail::take(base, count, detail::can_slice<decltype(base)>{});
+      });
+    }
+
+    inline auto drop(std::size_t count) {
+      return detail::make_closure([count](auto base) {
+        return detail::drop(base, count, detail::can_slice<decltype(base)>{});
+      });
+    }
+
+    inline auto chunk(std::size_t size) {
+      return detail::make_closure([size](auto base) { return chunk_view<decltype(base)>(base, size); });
+    }
+
+    template <typename Range>
+    auto zip(Range&& other) {
+      auto second = all(std::forward<Range>(other));
+      return detail::make_closure([second](auto first) {
+        return zip_view<decltype(first), decltype(second)>(first, second);
+      });
+    }
+
+    inline auto enumerate() {
+      return detail::make_closure([](auto base) { return enumerate_view<decltype(base)>(base); });
+    }
+  }
+
+  namespace detail {
+    // Passes every element of the view to sink. Map and filter stages are applied inside a single
+    // loop over their base, which compilers vectorize, unlike the nested loops of filter iterators.
+    template <typename View, typename Sink>
+    void push_elements(const View& view, Sink& sink);
+
+    template <typename Base, typename Function, typename Sink>
+    void push_elements(const map_view<Base, Function>& view, Sink& sink);
+
+    template <typename Base, typename Predicate, typename Sink>
+    void push_elements(const filter_view<Base, Predicate>& view, Sink& sink);
+
+    template <typename View, typename Sink>
+    void push_elements(const View& view, Sink& sink) {
+      for (auto it = view.begin(), end = view.end(); it != end; ++it) sink(*it);
+    }
+
+    template <typename Base, typename Function, typename Sink>
+    void push_elements(const map_view<Base, Function>& view, Sink& sink) {
+      auto mapped = [&view, &sink](auto&& element) {
+        sink(view.function()(std::forward<decltype(element)>(element)));
+      };
+      push_elements(view.base(), mapped);
+    }
+
+    template <typename Base, typename Predicate, typename Sink>
+    void push_elements(const filter_view<Base, Predicate>& view, Sink& sink) {
+      auto filtered = [&view, &sink](auto&& element) {
+        if (view.predicate()(element)) sink(std::forward<decltype(element)>(element));
+      };
+      push_elements(view.base(), filtered);
+    }
+
+    template <typename T, typename Range>
+    void assign_range(T* out, const Range& range, std::true_type) {
+      detail::copy(range.begin(), range.end(), out);
+    }
+
+    template <typename T, typename Range>
+    void assign_range(T* out, const Range& range, std::false_type) {
+      auto assign = [&out](auto&& element) {
+        *(out++) = range_convert<T>::from(std::forward<decltype(element)>(element));
+      };
+      push_elements(range, assign);
+    }
+
+    // Length known up front: a single allocation, and memmove for contiguous ranges of the same type
+    template <typename T, typename Range>
+    vector<T> to_vector(const Range& range, std::true_type) {
+      vector<T> result(range.size(), uninitialized);
+      assign_range(to_pointer(result.begin()), range, is_memmovable<range_iterator<Range>, T*>{});
+      return result;
+    }
+
+    template <typename T, typename Range>
+    vector<T> to_vector(const Range& range, std::false_type) {
+      vector<T> result;
+      auto append = [&result](auto&& element) {
+        grow(result, result.size() + 1);
+        result.push(range_convert<T>::from(std::forward<decltype(element)>(element)));
+      };
+      push_elements(range, append);
+      return result;
+    }
+
+    struct to_vector_fn {
+      template <typename View>
+      vector<typename range_value<View>::type> operator()(const View& view) const {
+        return to_vector<typename range_value<View>::type>(view, has_size<View>{});
+      }
+    };
+  }
+
+  // Elements of the range in a new vector
+  template <typename Range>
+  vector<typename detail::range_value<detail::all_t<Range>>::type> to_vector(Range&& range) {
+    return detail::to_vector_fn{}(views::all(std::forward<Range>(range)));
+  }
+
+  // Calls function(element) for every element of the range, faster than a loop over the iterators
+  // of filter views
+  template <typename Range, typename Function>
+  void for_each(Range&& range, Function function) {
+    detail::push_elements(views::all(std::forward<Range>(range)), function);
+  }
+
+  // Sink of a pipeline: range | to_vector()
+  inline detail::range_closure<detail::to_vector_fn> to_vector() { return {detail::to_vector_fn{}}; }
+}
+
+#endif //PHOSTDLIB_RANGES_HPP
@@ -0,0 +1,274 @@
+#ifndef PHOSTDLIB_SEARCH_HPP
+#define PHOSTDLIB_SEARCH_HPP
+#include <phoenix/iterator_flag.hpp>
+#include <phoenix/utility.hpp>
+#include <phoenix/vector.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+namespace phoenix {
+  namespace detail {
+    inline void prefetch(const void* address) {
+    #if defined(__GNUC__) || defined(__clang__)
+      __builtin_prefetch(address);
+    #else
+      (void)address;
+    #endif
+    }
+
+    // Branchless binary search: the range is halved on every step without a data-dependent jump,
+    // so the loop runs exactly log2(length) times. Before(element) tells whether the element goes
+    // before the searched position.
+    template <typename RandomAccessIterator, typename Before>
+    std::size_t partition_point(RandomAccessIterator begin, std::size_t length, Before before) {
+      if (length == 0) return 0;
+      std::size_t base = 0;
+      while (length > 1) {
+        std::size_t half = length / 2;
+        base = before(*(begin + (base + half - 1))) ? base + half : base;
+        length -= half;
+      }
+      return base + (before(*(begin + base)) ? 1 : 0);
+    }
+  }
+
+  // First element which doesn't go before value
+  template <typename RandomAccessIterator, typename T, typename Compare = greater_fn>
+  RandomAccessIterator lower_bound(RandomAccessIterator begin, RandomAccessIterator end, const T& value,
+                                   Compare compare = Compare{}) {
+    return begin + detail::partition_point(begin, detail::distance(begin, end),
+                                           [&](const auto& element) { return compare(value, element); });
+  }
+
+  // First element which goes after value
+  template <typename RandomAccessIterator, typename T, typename Compare = greater_fn>
+  RandomAccessIterator upper_bound(RandomAccessIterator begin, RandomAccessIterator end, const T& value,
+                                   Compare compare = Compare{}) {
+    return begin + detail::partition_point(begin, detail::distance(begin, end),
+                                           [&](const auto& element) { return !compare(element, value); });
+  }
+
+  template <typename RandomAccessIterator, typename T, typename Compare = greater_fn>
+  bool binary_search(RandomAccessIterator begin, RandomAccessIterator end, const T& value,
+                     Compare compare = Compare{}) {
+    auto it = phoenix::lower_bound(begin, end, value, compare);
+    return it != end && !compare(*it, value);
+  }
+
+  // Static search index over sorted keys, laid out as an implicit B+ tree: nodes of node_keys keys
+  // fill one cache line, the bottom layer holds all keys in sorted order and every upper layer
+  // holds, for each child but the first, the smallest key of that child's subtree. A lookup reads
+  // one cache line per layer and never branches on the keys. Results are ranks - positions in
+  // the sorted order of keys.
+  template <typename T, typename Compare = greater_fn>
+  class sorted_index {
+   public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using const_iterator = const T*;
+
+    static constexpr std::size_t cache_line = 64;
+    static constexpr std::size_t node_keys = cache_line / sizeof(T) > 2 ? cache_line / sizeof(T) : 2;
+    // Lookups of a batch advance layer by layer, so that the loads of the whole batch overlap
+    static constexpr std::size_t batch_size = 16;
+
+    explicit sorted_index(Compare compare = Compare{})
+        : _storage(), _keys{nullptr}, _size{0}, _total{0}, _compare(compare) {}
+
+    // Keys must be sorted by compare, std::invalid_argument is thrown otherwise
+    template <typename InputIterator>
+    sorted_index(InputIterator begin, InputIterator end, Compare compare = Compare{})
+        : _storage(), _keys{nullptr}, _size{detail::distance(begin, end)}, _total{0}, _compare(compare) {
+      build(begin);
+    }
+
+    explicit sorted_index(const vector<T>& keys, Compare compare = Compare{})
+        : sorted_index(keys.cbegin(), keys.cend(), compare) {}
+
+    sorted_index(const sorted_index& other)
+        : _storage(), _keys{nullptr}, _size{other._size}, _total{0}, _compare(other._compare) {
+      _layer_offsets = other._layer_offsets;
+      _layer_nodes = other._layer_nodes;
+      allocate(other._total);
+      for (std::size_t i = 0; i < _total; i++) _keys[i] = other._keys[i];
+    }
+
+    sorted_index(sorted_index&&) = default;
+
+    sorted_index& operator=(const sorted_index& other) {
+      if (this != &other) *this = sorted_index(other);
+      return *this;
+    }
+
+    sorted_index& operator=(sorted_index&&) = default;
+
+    size_type size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+    // Keys in sorted order
+    const T& operator[](size_type rank) const { return _keys[_layer_offsets[0] + rank]; }
+    const_iterator begin() const { return _keys + (_size > 0 ? _layer_offsets[0] : 0); }
+    const_iterator end() const { return begin() + _size; }
+
+    // Rank of the first key which doesn't go before key, size() if there is none
+    template <typename Key>
+    size_type lower_bound(const Key& key) const {
+      return search([&](const T& element) { return _compare(key, element); });
+    }
+
+    // Rank of the first key which goes after key, size() if there is none
+    template <typename Key>
+    size_type upper_bound(const Key& key) const {
+      return search([&](const T& element) { return !_compare(element, key); });
+    }
+
+    template <typename Key>
+    bool contains(const Key& key) const {
+      size_type rank = lower_bound(key);
+      return rank < _size && !_compare((*this)[rank], key);
+    }
+
+    // Batched lookups: writes lower_bound of every key from [begin, end) to output
+    template <typename InputIterator, typename OutputIterator>
+    OutputIterator lower_bounds(InputIterator begin, InputIterator end, OutputIterator output) const {
+      return search_batch(begin, end, output, [this](const T& element, const auto& key) {
+        return _compare(key, element);
+      });
+    }
+
+    template <typename InputIterator, typename OutputIterator>
+    OutputIterator upper_bounds(InputIterator begin, InputIterator end, OutputIterator output) const {
+      return search_batch(begin, end, output, [this](const T& element, const auto& key) {
+        return !_compare(element, key);
+      });
+    }
+
+   private:
+    void allocate(std::size_t total) {
+      // Spare keys let the first node start on a cache line boundary
+      constexpr std::size_t spare = (cache_line + sizeof(T) - 1) / sizeof(T);
+      _total = total;
+      _storage = vector<T>(total + spare);
+      auto address = reinterpret_cast<std::uintptr_t>(&_storage[0]);
+      std::size_t skip = ((cache_line - address % cache_line) % cache_line + sizeof(T) - 1) / sizeof(T);
+      _keys = &_storage[0] + (skip < spare ? skip : 0);
+    }
+
+    template <typename InputIterator>
+    void build(InputIterator begin) {
+      if (_size == 0) return;
+
+      // Layer 0 holds the leaves, every next one has node_keys + 1 times fewer nodes
+      std::size_t nodes = (_size + node_keys - 1) / node_keys;
+      _layer_nodes.push(nodes);
+      while (nodes > 1) {
+        nodes = (nodes + node_keys) / (node_keys + 1);
+        _layer_nodes.push(nodes);
+      }
+      // The top layer is stored first, leaves last
+      std::size_t offset = 0;
+      _layer_offsets = vector<std::size_t>(_layer_nodes.size(), 0);
+      for (std::size_t layer = _layer_nodes.size(); layer-- > 0;) {
+        _layer_offsets[layer] = offset;
+        offset += _layer_nodes[layer] * node_keys;
+      }
+      allocate(offset);
+
+      T* leaves = _keys + _layer_offsets[0];
+      for (std::size_t i = 0; i < _size; i++, ++begin) {
+        leaves[i] = *begin;
+        if (i > 0 && _compare(leaves[i - 1], leaves[i]))
+          throw std::invalid_argument("Keys of sorted_index must be sorted!");
+      }
+      // Padding repeats the biggest key, which never goes before any searched key that exists
+      for (std::size_t i = _size; i < _layer_nodes[0] * node_keys; i++) leaves[i] = leaves[_size - 1];
+
+      std::size_t leaves_per_child = 1;
+      for (std::size_t layer = 1; layer < _layer_nodes.size(); layer++) {
+        T* keys = _keys + _layer_offsets[layer];
+        for (std::size_t node = 0; node < _layer_nodes[layer]; node++) {
+          for (std::size_t i = 0; i < node_keys; i++) {
+            std::size_t leaf = (node * (node_keys + 1) + i + 1) * leaves_per_child;
+            keys[node * node_keys + i] = leaf < _layer_nodes[0] ? leaves[leaf * node_keys] : leaves[_size - 1];
+          }
+        }
+        leaves_per_child *= node_keys + 1;
+      }
+    }
+
+    template <typename Before>
+    std::size_t rank_in_node(const T* node, Before before) const {
+      std::size_t rank = 0;
+      for (std::size_t i = 0; i < node_keys; i++) rank += before(node[i]) ? 1 : 0;
+      return rank;
+    }
+
+    // Child of node in the next layer down. Children past the end of the layer are only reached
+    // through padding, when all keys go before the searched one, and are clamped to the last node.
+    std::size_t child(std::size_t node, std::size_t rank, std::size_t layer) const {
+      std::size_t next = node * (node_keys + 1) + rank;
+      return next < _layer_nodes[layer - 1] ? next : _layer_nodes[layer - 1] - 1;
+    }
+
+    std::size_t rank_of(std::size_t leaf, std::size_t rank) const {
+      std::size_t result = leaf * node_keys + rank;
+      return result < _size ? result : _size;
+    }
+
+    template <typename Before>
+    size_type search(Before before) const {
+      if (_size == 0) return 0;
+      std::size_t node = 0;
+      for (std::size_t layer = _layer_nodes.size() - 1; layer > 0; layer--) {
+        node = child(node, rank_in_node(_keys + _layer_offsets[layer] + node * node_keys, before), layer);
+      }
+      return rank_of(node, rank_in_node(_keys + _layer_offsets[0] + node * node_keys, before));
+    }
+
+    template <typename InputIterator, typename OutputIterator, typename Before>
+    OutputIterator search_batch(InputIterator begin, InputIterator end, OutputIterator output,
+                                Before before) const {
+      // Keys keep their own type, comparisons with elements may be heterogeneous
+      detail::iterator_value<InputIterator> keys[batch_size];
+      std::size_t nodes[batch_size];
+      while (begin != end) {
+        std::size_t count = 0;
+        for (; count < batch_size && begin != end; count++, ++begin) keys[count] = *begin;
+
+        if (_size == 0) {
+          for (std::size_t i = 0; i < count; i++) *output++ = 0;
+          continue;
+        }
+
+        for (std::size_t i = 0; i < count; i++) nodes[i] = 0;
+        for (std::size_t layer = _layer_nodes.size() - 1; layer > 0; layer--) {
+          const T* layer_keys = _keys + _layer_offsets[layer];
+          for (std::size_t i = 0; i < count; i++) {
+            const auto& key = keys[i];
+            std::size_t rank = rank_in_node(layer_keys + nodes[i] * node_keys,
+                                            [&](const T& element) { return before(element, key); });
+            nodes[i] = child(nodes[i], rank, layer);
+            detail::prefetch(_keys + _layer_offsets[layer - 1] + nodes[i] * node_keys);
+          }
+        }
+        const T* leaves = _keys + _layer_offsets[0];
+        for (std::size_t i = 0; i < count; i++) {
+          const auto& key = keys[i];
+          std::size_t rank = rank_in_node(leaves + nodes[i] * node_keys,
+                                          [&](const T& element) { return before(element, key); });
+          *output++ = rank_of(nodes[i], rank);
+        }
+      }
+      return output;
+    }
+
+    vector<T> _storage;
+    T* _keys;
+    std::size_t _size, _total;
+    vector<std::size_t> _layer_offsets, _layer_nodes;
+    Compare _compare;
+  };
+}
+
+#endif //PHOSTDLIB_SEARCH_HPP
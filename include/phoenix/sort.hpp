@@ -1,38 +1,67 @@
 #ifndef PHOSTDLIB_SORT_HPP
 #define PHOSTDLIB_SORT_HPP
 #include "utility.hpp"
+#include "cpu.hpp"
+#include "iterator_flag.hpp"
+#include "vector.hpp"
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 namespace phoenix {
 
   template<typename BidirectionalIterator,
-           typename Compare = decltype(is_greater<typename BidirectionalIterator::const_reference>)>
+           typename Compare = greater_fn>
   void insertion_sort(BidirectionalIterator begin, BidirectionalIterator end,
-                      Compare compare = is_greater) {
+                      Compare compare = Compare{}) {
+    if (begin == end) return;
     for(auto i = begin + 1; i != end; i++) {
-      for(auto j = i; j != begin && compare(*(j - 1), *j); j--) {
-        swap(*j, *(j - 1));
-      }
+      if (!compare(*(i - 1), *i)) continue;
+
+      // Move the hole left instead of swapping the element along
+      auto value = std::move(*i);
+      auto j = i;
+      do {
+        *j = std::move(*(j - 1));
+        j--;
+      } while (j != begin && compare(*(j - 1), value));
+      *j = std::move(value);
     }
   }
 
+  template<typename BidirectionalIterator>
+  void insertion_sort(BidirectionalIterator begin, BidirectionalIterator end,
+                      detail::compare_pointer<BidirectionalIterator> compare) {
+    detail::dispatch_compare(compare, [&](auto function) { phoenix::insertion_sort(begin, end, function); });
+  }
+
   template<typename BidirectionalIterator,
-           typename Compare = decltype(is_greater<typename BidirectionalIterator::const_reference>)>
+           typename Compare = greater_fn>
   void bubble_sort(BidirectionalIterator begin, BidirectionalIterator end,
-                   Compare compare = is_greater) {
+                   Compare compare = Compare{}) {
     for(auto i = begin + 1; i != end; i++) {
       for(auto j = end - 1; j != i - 1; j--) {
         if(compare(*(j - 1), *j))
-          swap(*j, *(j - 1));
+          phoenix::swap(*j, *(j - 1));
       }
     }
   }
 
+  template<typename BidirectionalIterator>
+  void bubble_sort(BidirectionalIterator begin, BidirectionalIterator end,
+                   detail::compare_pointer<BidirectionalIterator> compare) {
+    detail::dispatch_compare(compare, [&](auto function) { phoenix::bubble_sort(begin, end, function); });
+  }
+
   template<typename BidirectionalIterator,
-           typename Compare = decltype(is_greater<typename BidirectionalIterator::const_reference>)>
+           typename Compare = greater_fn>
   void selection_sort(BidirectionalIterator begin, BidirectionalIterator end,
-                      Compare compare = is_greater) {
+                      Compare compare = Compare{}) {
     for(auto i = begin; i != end; i++) {
       auto minimal = i;
       for(auto j = i + 1; j != end; j++) {
@@ -42,32 +71,817 @@ namespace phoenix {
       }
 
       if (minimal != i) {
-        swap(*i, *minimal);
+        phoenix::swap(*i, *minimal);
       }
     }
   }
 
+  template<typename BidirectionalIterator>
+  void selection_sort(BidirectionalIterator begin, BidirectionalIterator end,
+                      detail::compare_pointer<BidirectionalIterator> compare) {
+    detail::dispatch_compare(compare, [&](auto function) { phoenix::selection_sort(begin, end, function); });
+  }
+
   template<typename RandomAccessIterator,
-      typename Compare = decltype(is_greater<typename RandomAccessIterator::const_reference>)>
+      typename Compare = greater_fn>
   void bogo_sort(RandomAccessIterator begin,
                  typename RandomAccessIterator::size_type length,
-                 Compare compare = is_greater) {
+                 Compare compare = Compare{}) {
     std::mt19937 gen(
         static_cast<std::mt19937::result_type>(std::chrono::system_clock::now().time_since_epoch().count()));
     std::uniform_int_distribution<typename RandomAccessIterator::size_type> dist(0, length - 1);
 
     auto bogo = [&]() {
       for (typename RandomAccessIterator::size_type i{}; i < length; i++) {
-        swap(*(begin + dist(gen)), *(begin + dist(gen)));
+        phoenix::swap(*(begin + dist(gen)), *(begin + dist(gen)));
       }
     };
 
     // ¯\_(ツ)_/¯
-    while (!is_sorted(begin, RandomAccessIterator(begin + length), compare)) {
+    while (!phoenix::is_sorted(begin, RandomAccessIterator(begin + length), compare)) {
       bogo();
     }
   }
 
+  template<typename RandomAccessIterator>
+  void bogo_sort(RandomAccessIterator begin,
+                 typename RandomAccessIterator::size_type length,
+                 detail::compare_pointer<RandomAccessIterator> compare) {
+    detail::dispatch_compare(compare, [&](auto function) { phoenix::bogo_sort(begin, length, function); });
+  }
+
+  namespace detail {
+    template <typename RandomAccessIterator, typename Compare>
+    void sift_down(RandomAccessIterator begin, std::size_t length, std::size_t root, Compare compare) {
+      std::size_t child = 2 * root + 1;
+      if (child >= length) return;
+      if (child + 1 < length && compare(*(begin + (child + 1)), *(begin + child))) child++;
+      if (!compare(*(begin + child), *(begin + root))) return;
+
+      // The root element is held aside while bigger children move up into the hole
+      auto value = std::move(*(begin + root));
+      for (;;) {
+        *(begin + root) = std::move(*(begin + child));
+        root = child;
+        child = 2 * root + 1;
+        if (child >= length) break;
+        if (child + 1 < length && compare(*(begin + (child + 1)), *(begin + child))) child++;
+        if (!compare(*(begin + child), value)) break;
+      }
+      *(begin + root) = std::move(value);
+    }
+
+    template <typename RandomAccessIterator, typename Compare>
+    void heap_sort_n(RandomAccessIterator begin, std::size_t length, Compare compare) {
+      if (length < 2) return;
+      for (std::size_t i = length / 2; i-- > 0;) sift_down(begin, length, i, compare);
+      for (std::size_t last = length - 1; last > 0; last--) {
+        phoenix::swap(*begin, *(begin + last));
+        sift_down(begin, last, 0, compare);
+      }
+    }
+
+    template <typename RandomAccessIterator, typename Compare>
+    void sort3(RandomAccessIterator a, RandomAccessIterator b, RandomAccessIterator c, Compare compare) {
+      if (compare(*a, *b)) phoenix::swap(*a, *b);
+      if (compare(*b, *c)) phoenix::swap(*b, *c);
+      if (compare(*a, *b)) phoenix::swap(*a, *b);
+    }
+
+    // Introsort - quicksort with median-of-three pivot, heap sort when recursion gets too deep
+    // and insertion sort for short ranges
+    template <typename RandomAccessIterator, typename Compare>
+    void introsort_loop(RandomAccessIterator begin, std::size_t length, std::size_t depth, Compare compare) {
+      while (length > 16) {
+        if (depth == 0) {
+          heap_sort_n(begin, length, compare);
+          return;
+        }
+        depth--;
+
+        sort3(begin + 1, begin + length / 2, begin + (length - 1), compare);
+        phoenix::swap(*begin, *(begin + length / 2));
+        const auto& pivot = *begin;
+
+        std::size_t i = 1, j = length - 1;
+        for (;;) {
+          while (i < length && compare(pivot, *(begin + i))) i++;
+          while (compare(*(begin + j), pivot)) j--;
+          if (i >= j) break;
+          phoenix::swap(*(begin + i), *(begin + j));
+          i++;
+          j--;
+        }
+        phoenix::swap(*begin, *(begin + j));
+
+        // Recurse into the smaller part, loop on the bigger one
+        std::size_t right_length = length - j - 1;
+        if (j < right_length) {
+          introsort_loop(begin, j, depth, compare);
+          begin = begin + (j + 1);
+          length = right_length;
+        } else {
+          introsort_loop(begin + (j + 1), right_length, depth, compare);
+          length = j;
+        }
+      }
+
+      if (length > 1) insertion_sort(begin, begin + length, compare);
+    }
+
+    inline std::size_t introsort_depth(std::size_t length) {
+      std::size_t depth = 0;
+      for (; length > 1; length >>= 1) depth += 2;
+      return depth;
+    }
+
+    template <typename RandomAccessIterator, typename Compare>
+    void introsort(RandomAccessIterator begin, std::size_t length, Compare compare) {
+      introsort_loop(begin, length, introsort_depth(length), compare);
+    }
+  }
+
+  template<typename RandomAccessIterator,
+           typename Compare = greater_fn>
+  void heap_sort(RandomAccessIterator begin, RandomAccessIterator end, Compare compare = Compare{}) {
+    detail::heap_sort_n(begin, detail::distance(begin, end), compare);
+  }
+
+  template<typename RandomAccessIterator>
+  void heap_sort(RandomAccessIterator begin, RandomAccessIterator end,
+                 detail::compare_pointer<RandomAccessIterator> compare) {
+    detail::dispatch_compare(compare, [&](auto function) { phoenix::heap_sort(begin, end, function); });
+  }
+}
+
+#ifdef PHOSTDLIB_X86_SIMD
+// Vectorized quicksort for int32_t, float, uint64_t and double keys.
+// Partitioning is done a register at a time (AVX2 permute tables or AVX-512 compress-store),
+// partitions smaller than 8 registers are sorted with in-register bitonic networks.
+namespace phoenix {
+  namespace detail {
+    namespace simd_sort {
+      // Bitonic networks as permutation tables, indices are in 32-bit units so one table
+      // format fits every register width and key size
+      template <std::size_t Lanes, std::size_t Lanes32>
+      struct bitonic_network {
+        static constexpr std::size_t log_lanes = Lanes == 4 ? 2 : (Lanes == 8 ? 3 : 4);
+        static constexpr std::size_t sort_steps = log_lanes * (log_lanes + 1) / 2;
+        static constexpr std::size_t ratio = Lanes32 / Lanes;
+
+        std::int32_t sort_index[sort_steps][Lanes32];
+        unsigned sort_min_bits[sort_steps];
+        std::int32_t merge_index[log_lanes][Lanes32];
+        unsigned merge_min_bits[log_lanes];
+        std::int32_t reverse_index[Lanes32];
+
+        bitonic_network() {
+          std::size_t step = 0;
+          for (std::size_t k = 2; k <= Lanes; k *= 2) {
+            for (std::size_t j = k / 2; j > 0; j /= 2) {
+              fill_step(sort_index[step], sort_min_bits[step], k, j);
+              step++;
+            }
+          }
+          step = 0;
+          for (std::size_t j = Lanes / 2; j > 0; j /= 2) {
+            fill_step(merge_index[step], merge_min_bits[step], Lanes, j);
+            step++;
+          }
+          for (std::size_t q = 0; q < Lanes32; q++) {
+            reverse_index[q] = static_cast<std::int32_t>((Lanes - 1 - q / ratio) * ratio + q % ratio);
+          }
+        }
+
+        static const bitonic_network& get() {
+          static const bitonic_network network;
+          return network;
+        }
+
+       private:
+        void fill_step(std::int32_t* index, unsigned& min_bits, std::size_t k, std::size_t j) {
+          min_bits = 0;
+          for (std::size_t lane = 0; lane < Lanes; lane++) {
+            std::size_t partner = lane ^ j;
+            bool ascending = (lane & k) == 0;
+            if ((lane < partner) == ascending) min_bits |= 1u << lane;
+            for (std::size_t r = 0; r < ratio; r++) {
+              index[lane * ratio + r] = static_cast<std::int32_t>(partner * ratio + r);
+            }
+          }
+        }
+      };
+
+      // Permutations moving lanes with cleared bits to the front, and lanes with set bits to the back
+      template <std::size_t Lanes, std::size_t Lanes32>
+      struct partition_table {
+        static constexpr std::size_t ratio = Lanes32 / Lanes;
+        std::int32_t index[1u << Lanes][Lanes32];
+
+        partition_table() {
+          for (unsigned mask = 0; mask < (1u << Lanes); mask++) {
+            std::size_t out = 0;
+            for (int side = 0; side < 2; side++) {
+              for (std::size_t lane = 0; lane < Lanes; lane++) {
+                if (((mask >> lane) & 1u) != static_cast<unsigned>(side)) continue;
+                for (std::size_t r = 0; r < ratio; r++) {
+                  index[mask][out * ratio + r] = static_cast<std::int32_t>(lane * ratio + r);
+                }
+                out++;
+              }
+            }
+          }
+        }
+
+        static const partition_table& get() {
+          static const partition_table table;
+          return table;
+        }
+      };
+
+      template <typename T>
+      T* pick_pivot(T* a, std::size_t n) {
+        T* x = a + n / 4;
+        T* y = a + n / 2;
+        T* z = a + (3 * n) / 4;
+        if (*y < *x) { T* t = x; x = y; y = t; }
+        if (*z < *y) { T* t = y; y = z; z = t; }
+        if (*y < *x) { T* t = x; x = y; y = t; }
+        return y;
+      }
+
+      template <typename T>
+      void reverse(T* a, std::size_t n) {
+        for (std::size_t i = 0; i < n / 2; i++) phoenix::swap(a[i], a[n - 1 - i]);
+      }
+
+      PHOSTDLIB_TARGET_AVX2_BEGIN
+      namespace avx2 {
+        template <typename T>
+        struct vec;
+
+        template <>
+        struct vec<std::int32_t> {
+          using value_type = std::int32_t;
+          using reg = __m256i;
+          static constexpr std::size_t lanes = 8;
+          static constexpr std::size_t lanes32 = 8;
+
+          static reg loadu(const value_type* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+          static void storeu(value_type* p, reg v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+          static reg set1(value_type x) { return _mm256_set1_epi32(x); }
+          static reg min(reg a, reg b) { return _mm256_min_epi32(a, b); }
+          static reg max(reg a, reg b) { return _mm256_max_epi32(a, b); }
+          static unsigned gt(reg a, reg b) {
+            return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(a, b))));
+          }
+          static unsigned ge(reg a, reg b) { return ~gt(b, a) & 0xFFu; }
+          static reg permute(reg v, const std::int32_t* index) { return _mm256_permutevar8x32_epi32(v, loadu(index)); }
+          static reg blend(reg a, reg b, unsigned bits) {
+            const __m256i lane_bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+            __m256i mask = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(static_cast<int>(bits)), lane_bits),
+                                              lane_bits);
+            return _mm256_blendv_epi8(a, b, mask);
+          }
+          static value_type max_value() { return std::numeric_limits<value_type>::max(); }
+        };
+
+        template <>
+        struct vec<float> {
+          using value_type = float;
+          using reg = __m256;
+          static constexpr std::size_t lanes = 8;
+          static constexpr std::size_t lanes32 = 8;
+
+          static reg loadu(const value_type* p) { return _mm256_loadu_ps(p); }
+          static void storeu(value_type* p, reg v) { _mm256_storeu_ps(p, v); }
+          static reg set1(value_type x) { return _mm256_set1_ps(x); }
+          static reg min(reg a, reg b) { return _mm256_min_ps(a, b); }
+          static reg max(reg a, reg b) { return _mm256_max_ps(a, b); }
+          static unsigned gt(reg a, reg b) {
+            return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GT_OQ)));
+          }
+          static unsigned ge(reg a, reg b) {
+            return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GE_OQ)));
+          }
+          static reg permute(reg v, const std::int32_t* index) {
+            return _mm256_permutevar8x32_ps(v, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index)));
+          }
+          static reg blend(reg a, reg b, unsigned bits) {
+            return _mm256_castsi256_ps(vec<std::int32_t>::blend(_mm256_castps_si256(a), _mm256_castps_si256(b), bits));
+          }
+          static value_type max_value() { return std::numeric_limits<value_type>::infinity(); }
+        };
+
+        template <>
+        struct vec<std::uint64_t> {
+          using value_type = std::uint64_t;
+          using reg = __m256i;
+          static constexpr std::size_t lanes = 4;
+          static constexpr std::size_t lanes32 = 8;
+
+          static reg loadu(const value_type* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+          static void storeu(value_type* p, reg v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+          static reg set1(value_type x) { return _mm256_set1_epi64x(static_cast<long long>(x)); }
+          // AVX2 has only signed 64-bit comparison, flipping the sign bit makes it unsigned
+          static reg gt_mask(reg a, reg b) {
+            const __m256i sign = _mm256_set1_epi64x(static_cast<long long>(0x8000000000000000ull));
+            return _mm256_cmpgt_epi64(_mm256_xor_si256(a, sign), _mm256_xor_si256(b, sign));
+          }
+          static reg min(reg a, reg b) { return _mm256_blendv_epi8(a, b, gt_mask(a, b)); }
+          static reg max(reg a, reg b) { return _mm256_blendv_epi8(b, a, gt_mask(a, b)); }
+          static unsigned gt(reg a, reg b) {
+            return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(gt_mask(a, b))));
+          }
+          static unsigned ge(reg a, reg b) { return ~gt(b, a) & 0xFu; }
+          static reg permute(reg v, const std::int32_t* index) {
+            return _mm256_permutevar8x32_epi32(v, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index)));
+          }
+          static reg blend(reg a, reg b, unsigned bits) {
+            const __m256i lane_bits = _mm256_setr_epi64x(1, 2, 4, 8);
+            __m256i mask = _mm256_cmpeq_epi64(
+                _mm256_and_si256(_mm256_set1_epi64x(static_cast<long long>(bits)), lane_bits), lane_bits);
+            return _mm256_blendv_epi8(a, b, mask);
+          }
+          static value_type max_value() { return std::numeric_limits<value_type>::max(); }
+        };
+
+        template <>
+        struct vec<double> {
+          using value_type = double;
+          using reg = __m256d;
+          static constexpr std::size_t lanes = 4;
+          static constexpr std::size_t lanes32 = 8;
+
+          static reg loadu(const value_type* p) { return _mm256_loadu_pd(p); }
+          static void storeu(value_type* p, reg v) { _mm256_storeu_pd(p, v); }
+          static reg set1(value_type x) { return _mm256_set1_pd(x); }
+          static reg min(reg a, reg b) { return _mm256_min_pd(a, b); }
+          static reg max(reg a, reg b) { return _mm256_max_pd(a, b); }
+          static unsigned gt(reg a, reg b) {
+            return static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GT_OQ)));
+          }
+          static unsigned ge(reg a, reg b) {
+            return static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GE_OQ)));
+          }
+          static reg permute(reg v, const std::int32_t* index) {
+            return _mm256_castps_pd(_mm256_permutevar8x32_ps(
+                _mm256_castpd_ps(v), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index))));
+          }
+          static reg blend(reg a, reg b, unsigned bits) {
+            return _mm256_castsi256_pd(vec<std::uint64_t>::blend(_mm256_castpd_si256(a), _mm256_castpd_si256(b), bits));
+          }
+          static value_type max_value() { return std::numeric_limits<value_type>::infinity(); }
+        };
+
+        // Permute-table partition: one permuted register is stored at both write heads,
+        // the lower lanes belong to the left side and the upper lanes to the right side
+        template <typename V>
+        void partition_store(typename V::value_type* left, typename V::value_type* right_end,
+                             typename V::reg v, unsigned right_bits, std::size_t) {
+          const auto& table = partition_table<V::lanes, V::lanes32>::get();
+          auto permuted = V::permute(v, table.index[right_bits]);
+          V::storeu(left, permuted);
+          V::storeu(right_end - V::lanes, permuted);
+        }
+
+        #include "detail/simd_sort_kernels.hpp"
+      }
+      PHOSTDLIB_TARGET_END
+
+      PHOSTDLIB_TARGET_AVX512_BEGIN
+      namespace avx512 {
+        template <typename T>
+        struct vec;
+
+        template <>
+        struct vec<std::int32_t> {
+          using value_type = std::int32_t;
+          using reg = __m512i;
+          static constexpr std::size_t lanes = 16;
+          static constexpr std::size_t lanes32 = 16;
+
+          static reg loadu(const value_type* p) { return _mm512_loadu_si512(p); }
+          static void storeu(value_type* p, reg v) { _mm512_storeu_si512(p, v); }
+          static reg set1(value_type x) { return _mm512_set1_epi32(x); }
+          static reg min(reg a, reg b) { return _mm512_min_epi32(a, b); }
+          static reg max(reg a, reg b) { return _mm512_max_epi32(a, b); }
+          static unsigned gt(reg a, reg b) { return _mm512_cmpgt_epi32_mask(a, b); }
+          static unsigned ge(reg a, reg b) { return _mm512_cmpge_epi32_mask(a, b); }
+          static reg permute(reg v, const std::int32_t* index) {
+            return _mm512_permutexvar_epi32(_mm512_loadu_si512(index), v);
+          }
+          static reg blend(reg a, reg b, unsigned bits) {
+            return _mm512_mask_mov_epi32(a, static_cast<__mmask16>(bits), b);
+          }
+          static void compress_store(value_type* p, unsigned bits, reg v) {
+            _mm512_mask_compressstoreu_epi32(p, static_cast<__mmask16>(bits), v);
+          }
+          static value_type max_value() { return std::numeric_limits<value_type>::max(); }
+        };
+
+        template <>
+        struct vec<float> {
+          using value_type = float;
+          using reg = __m512;
+          static constexpr std::size_t lanes = 16;
+          static constexpr std::size_t lanes32 = 16;
+
+          static reg loadu(const value_type* p) { return _mm512_loadu_ps(p); }
+          static void storeu(value_type* p, reg v) { _mm512_storeu_ps(p, v); }
+          static reg set1(value_type x) { return _mm512_set1_ps(x); }
+          static reg min(reg a, reg b) { return _mm512_min_ps(a, b); }
+          static reg max(reg a, reg b) { return _mm512_max_ps(a, b); }
+          static unsigned gt(reg a, reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+          static unsigned ge(reg a, reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ); }
+          static reg permute(reg v, const std::int32_t* index) {
+            return _mm512_permutexvar_ps(_mm512_loadu_si512(index), v);
+          }
+          static reg blend(reg a, reg b, unsigned bits) {
+            return _mm512_mask_mov_ps(a, static_cast<__mmask16>(bits), b);
+          }
+          static void compress_store(value_type* p, unsigned bits, reg v) {
+            _mm512_mask_compressstoreu_ps(p, static_cast<__mmask16>(bits), v);
+          }
+          static value_type max_value() { return std::numeric_limits<value_type>::infinity(); }
+        };
+
+        template <>
+        struct vec<std::uint64_t> {
+          using value_type = std::uint64_t;
+          using reg = __m512i;
+          static constexpr std::size_t lanes = 8;
+          static constexpr std::size_t lanes32 = 16;
+
+          static reg loadu(const value_type* p) { return _mm512_loadu_si512(p); }
+          static void storeu(value_type* p, reg v) { _mm512_storeu_si512(p, v); }
+          static reg set1(value_type x) { return _mm512_set1_epi64(static_cast<long long>(x)); }
+          static reg min(reg a, reg b) { return _mm512_min_epu64(a, b); }
+          static reg max(reg a, reg b) { return _mm512_max_epu64(a, b); }
+          static unsigned gt(reg a, reg b) { return _mm512_cmpgt_epu64_mask(a, b); }
+          static unsigned ge(reg a, reg b) { return _mm512_cmpge_epu64_mask(a, b); }
+          static reg permute(reg v, const std::int32_t* index) {
+            return _mm512_permutexvar_epi32(_mm512_loadu_si512(index), v);
+          }
+          static reg blend(reg a, reg b, unsigned bits) {
+            return _mm512_mask_mov_epi64(a, static_cast<__mmask8>(bits), b);
+          }
+          static void compress_store(value_type* p, unsigned bits, reg v) {
+            _mm512_mask_compressstoreu_epi64(p, static_cast<__mmask8>(bits), v);
+          }
+          static value_type max_value() { return std::numeric_limits<value_type>::max(); }
+        };
+
+        template <>
+        struct vec<double> {
+          using value_type = double;
+          using reg = __m512d;
+          static constexpr std::size_t lanes = 8;
+          static constexpr std::size_t lanes32 = 16;
+
+          static reg loadu(const value_type* p) { return _mm512_loadu_pd(p); }
+          static void storeu(value_type* p, reg v) { _mm512_storeu_pd(p, v); }
+          static reg set1(value_type x) { return _mm512_set1_pd(x); }
+          static reg min(reg a, reg b) { return _mm512_min_pd(a, b); }
+          static reg max(reg a, reg b) { return _mm512_max_pd(a, b); }
+          static unsigned gt(reg a, reg b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+          static unsigned ge(reg a, reg b) { return _mm512_cmp_pd_mask(a, b, _CMP_GE_OQ); }
+          static reg permute(reg v, const std::int32_t* index) {
+            return _mm512_castsi512_pd(_mm512_permutexvar_epi32(_mm512_loadu_si512(index), _mm512_castpd_si512(v)));
+          }
+          static reg blend(reg a, reg b, unsigned bits) {
+            return _mm512_mask_mov_pd(a, static_cast<__mmask8>(bits), b);
+          }
+          static void compress_store(value_type* p, unsigned bits, reg v) {
+            _mm512_mask_compressstoreu_pd(p, static_cast<__mmask8>(bits), v);
+          }
+          static value_type max_value() { return std::numeric_limits<value_type>::infinity(); }
+        };
+
+        // Compress-store partition, writes exactly the lanes belonging to each side
+        template <typename V>
+        void partition_store(typename V::value_type* left, typename V::value_type* right_end,
+                             typename V::reg v, unsigned right_bits, std::size_t right_count) {
+          const unsigned all = (1u << V::lanes) - 1;
+          V::compress_store(left, ~right_bits & all, v);
+          V::compress_store(right_end - right_count, right_bits, v);
+        }
+
+        #include "detail/simd_sort_kernels.hpp"
+      }
+      PHOSTDLIB_TARGET_END
+
+      template <typename T>
+      struct is_key : std::integral_constant<bool,
+          std::is_same<T, std::int32_t>::value || std::is_same<T, float>::value ||
+          std::is_same<T, std::uint64_t>::value || std::is_same<T, double>::value> {};
+
+      // NaN is unordered, so the kernels would mix it up with the padding of partial registers.
+      // NaNs are moved to the end first, only the rest is sorted.
+      template <typename T>
+      std::size_t partition_nan(T* data, std::size_t length, std::true_type) {
+        std::size_t end = length;
+        for (std::size_t i = 0; i < end;) {
+          if (data[i] != data[i]) phoenix::swap(data[i], data[--end]);
+          else i++;
+        }
+        return end;
+      }
+
+      template <typename T>
+      std::size_t partition_nan(T*, std::size_t length, std::false_type) {
+        return length;
+      }
+
+      // Returns false when no vector unit is available, so the caller can take the generic path
+      template <typename T>
+      bool sort(T* data, std::size_t length) {
+        if (cpu::active_level() < simd_level::avx2) return false;
+        length = partition_nan(data, length, std::is_floating_point<T>{});
+        switch (cpu::active_level()) {
+          case simd_level::avx512:
+            avx512::sort(data, length);
+            return true;
+          case simd_level::avx2:
+            avx2::sort(data, length);
+            return true;
+          default:
+            return false;
+        }
+      }
+    }
+  }
+}
+#endif
+
+namespace phoenix {
+  namespace detail {
+    template <typename RandomAccessIterator, typename Compare>
+    void sort(RandomAccessIterator begin, std::size_t length, Compare compare, std::false_type) {
+      introsort(begin, length, compare);
+    }
+
+    // Default comparators on primitive keys in contiguous memory can be sorted with SIMD
+    template <typename RandomAccessIterator, typename Compare>
+    void sort(RandomAccessIterator begin, std::size_t length, Compare compare, std::true_type) {
+    #ifdef PHOSTDLIB_X86_SIMD
+      auto* data = to_pointer(begin);
+      if (simd_sort::sort(data, length)) {
+        if (natural_order<Compare>::value < 0) simd_sort::reverse(data, length);
+        return;
+      }
+    #endif
+      introsort(begin, length, compare);
+    }
+
+    template <typename RandomAccessIterator, typename Compare>
+    struct use_simd_sort {
+    #ifdef PHOSTDLIB_X86_SIMD
+      using value_type = typename std::remove_cv<
+          typename std::remove_reference<decltype(*std::declval<RandomAccessIterator&>())>::type>::type;
+      static constexpr bool value = is_contiguous<RandomAccessIterator>::value &&
+                                    simd_sort::is_key<value_type>::value &&
+                                    natural_order<typename std::decay<Compare>::type>::value != 0;
+    #else
+      static constexpr bool value = false;
+    #endif
+    };
+  }
+
+  // Introsort. Ranges of int32_t, float, uint64_t and double in contiguous memory sorted with
+  // greater_fn or less_fn use vectorized quicksort when the CPU supports AVX2 or AVX-512
+  template<typename RandomAccessIterator,
+           typename Compare = greater_fn>
+  void sort(RandomAccessIterator begin, RandomAccessIterator end, Compare compare = Compare{}) {
+    auto length = detail::distance(begin, end);
+    if (length < 2) return;
+    detail::sort(begin, length, compare,
+                 std::integral_constant<bool, detail::use_simd_sort<RandomAccessIterator, Compare>::value>{});
+  }
+
+  // is_greater and is_lesser are passed on as greater_fn and less_fn, so they are vectorized too
+  template<typename RandomAccessIterator>
+  void sort(RandomAccessIterator begin, RandomAccessIterator end, detail::compare_pointer<RandomAccessIterator> compare) {
+    detail::dispatch_compare(compare, [&](auto function) { phoenix::sort(begin, end, function); });
+  }
+
+  namespace detail {
+    template <typename RandomAccessIterator, typename Projection>
+    using projected_key = typename std::decay<
+        decltype(std::declval<Projection&>()(*std::declval<RandomAccessIterator&>()))>::type;
+
+    // Moves elements so that position i receives the element from position index(i), following
+    // every cycle of the permutation once. Visited indices are overwritten with their own position.
+    template <typename RandomAccessIterator, typename IndexAt>
+    void apply_permutation_n(RandomAccessIterator begin, std::size_t length, IndexAt index) {
+      for (std::size_t start = 0; start < length; start++) {
+        if (static_cast<std::size_t>(index(start)) == start) continue;
+
+        auto temporary = std::move(*(begin + start));
+        std::size_t hole = start;
+        for (;;) {
+          std::size_t source = static_cast<std::size_t>(index(hole));
+          index(hole) = hole;
+          if (source == start) break;
+          *(begin + hole) = std::move(*(begin + source));
+          hole = source;
+        }
+        *(begin + hole) = std::move(temporary);
+      }
+    }
+
+    template <typename Key>
+    using radix_key = typename std::make_unsigned<Key>::type;
+
+    // Maps a key to unsigned integer with the same (or, when descending, reversed) order
+    template <typename Key>
+    radix_key<Key> to_radix_key(Key key, bool descending) {
+      auto bits = static_cast<radix_key<Key>>(key);
+      if (std::is_signed<Key>::value) bits ^= static_cast<radix_key<Key>>(radix_key<Key>(1) << (sizeof(Key) * 8 - 1));
+      return descending ? static_cast<radix_key<Key>>(~bits) : bits;
+    }
+
+    // LSD radix sort on 8-bit digits, stable. Digits shared by all keys are skipped.
+    template <typename Key, typename Index>
+    void radix_sort(vector<pair<Key, Index>>& keys) {
+      constexpr std::size_t digits = sizeof(Key);
+      std::size_t length = keys.size();
+      vector<std::size_t> counts(digits * 256, 0);
+      for (std::size_t i = 0; i < length; i++) {
+        for (std::size_t d = 0; d < digits; d++) counts[d * 256 + ((keys[i].first >> (d * 8)) & 0xFF)]++;
+      }
+
+      vector<pair<Key, Index>> scratch(length);
+      auto* from = &keys;
+      auto* to = &scratch;
+      for (std::size_t d = 0; d < digits; d++) {
+        std::size_t* count = &counts[d * 256];
+        bool trivial = false;
+        std::size_t offset = 0;
+        for (std::size_t b = 0; b < 256; b++) {
+          if (count[b] == length) trivial = true;
+          std::size_t c = count[b];
+          count[b] = offset;
+          offset += c;
+        }
+        if (trivial) continue;
+
+        for (std::size_t i = 0; i < length; i++) {
+          const auto& entry = (*from)[i];
+          (*to)[count[(entry.first >> (d * 8)) & 0xFF]++] = entry;
+        }
+        auto* t = from;
+        from = to;
+        to = t;
+      }
+      if (from != &keys) {
+        for (std::size_t i = 0; i < length; i++) keys[i] = scratch[i];
+      }
+    }
+
+    template <typename Index, typename RandomAccessIterator, typename Projection, typename Compare>
+    void sort_by_key(RandomAccessIterator begin, std::size_t length, Projection& projection,
+                     Compare compare, bool stable, std::false_type) {
+      using key_type = projected_key<RandomAccessIterator, Projection>;
+      vector<pair<key_type, Index>> keys(length);
+      auto it = begin;
+      for (std::size_t i = 0; i < length; i++, ++it) {
+        keys[i].first = projection(*it);
+        keys[i].second = static_cast<Index>(i);
+      }
+
+      if (stable) {
+        // Index breaks ties, which makes the order of equal keys deterministic
+        introsort(keys.begin(), length, [&](const pair<key_type, Index>& a, const pair<key_type, Index>& b) {
+          return compare(a.first, b.first) || (!compare(b.first, a.first) && a.second > b.second);
+        });
+      } else {
+        introsort(keys.begin(), length, [&](const pair<key_type, Index>& a, const pair<key_type, Index>& b) {
+          return compare(a.first, b.first);
+        });
+      }
+
+      apply_permutation_n(begin, length, [&](std::size_t i) -> Index& { return keys[i].second; });
+    }
+
+    template <typename Index, typename RandomAccessIterator, typename Projection, typename Compare>
+    void sort_by_key(RandomAccessIterator begin, std::size_t length, Projection& projection,
+                     Compare, bool, std::true_type) {
+      using key_type = projected_key<RandomAccessIterator, Projection>;
+      bool descending = natural_order<Compare>::value < 0;
+      vector<pair<radix_key<key_type>, Index>> keys(length);
+      auto it = begin;
+      for (std::size_t i = 0; i < length; i++, ++it) {
+        keys[i].first = to_radix_key(static_cast<key_type>(projection(*it)), descending);
+        keys[i].second = static_cast<Index>(i);
+      }
+      radix_sort(keys);
+      apply_permutation_n(begin, length, [&](std::size_t i) -> Index& { return keys[i].second; });
+    }
+
+    template <typename RandomAccessIterator, typename Projection, typename Compare>
+    void sort_by_key(RandomAccessIterator begin, RandomAccessIterator end, Projection& projection,
+                     Compare compare, bool stable) {
+      using key_type = projected_key<RandomAccessIterator, Projection>;
+      using radix = std::integral_constant<bool, std::is_integral<key_type>::value &&
+          !std::is_same<key_type, bool>::value &&
+          natural_order<typename std::decay<Compare>::type>::value != 0>;
+
+      auto length = detail::distance(begin, end);
+      if (length < 2) return;
+      // 32-bit indices keep the (key, index) buffer smaller whenever they are sufficient
+      if (length <= std::numeric_limits<std::uint32_t>::max()) {
+        sort_by_key<std::uint32_t>(begin, length, projection, compare, stable, radix{});
+      } else {
+        sort_by_key<std::size_t>(begin, length, projection, compare, stable, radix{});
+      }
+    }
+  }
+
+  // Sorts by projection(element), computing every key once. Integer keys with greater_fn/less_fn
+  // are sorted with radix sort, then elements are moved into place following permutation cycles
+  template<typename RandomAccessIterator, typename Projection,
+           typename Compare = greater_fn>
+  void sort_by_key(RandomAccessIterator begin, RandomAccessIterator end, Projection projection,
+                   Compare compare = Compare{}) {
+    detail::sort_by_key(begin, end, projection, compare, false);
+  }
+
+  // Like sort_by_key, but elements with equal keys keep their relative order
+  template<typename RandomAccessIterator, typename Projection,
+           typename Compare = greater_fn>
+  void stable_sort_by_key(RandomAccessIterator begin, RandomAccessIterator end, Projection projection,
+                          Compare compare = Compare{}) {
+    detail::sort_by_key(begin, end, projection, compare, true);
+  }
+
+  // Returns indices of elements in sorted order, elements themselves are not moved.
+  // Index can be narrowed (e.g. to std::uint32_t) to halve the memory traffic on smaller ranges.
+  template<typename Index = std::size_t, typename RandomAccessIterator,
+           typename Compare = greater_fn>
+  vector<Index> argsort(RandomAccessIterator begin, RandomAccessIterator end, Compare compare = Compare{}) {
+    auto length = detail::distance(begin, end);
+    if (length > 0 && length - 1 > static_cast<std::size_t>(std::numeric_limits<Index>::max()))
+      throw std::length_error("Range too long for argsort index type!");
+
+    vector<Index> indices(length);
+    for (std::size_t i = 0; i < length; i++) indices[i] = static_cast<Index>(i);
+    detail::introsort(indices.begin(), length, [&](Index a, Index b) {
+      return compare(*(begin + a), *(begin + b));
+    });
+    return indices;
+  }
+
+  namespace detail {
+    template <typename Container, typename Index>
+    void move_cycle(Container& container, const vector<Index>& permutation, std::size_t start) {
+      auto temporary = std::move(container[start]);
+      std::size_t hole = start;
+      for (std::size_t source = permutation[hole]; source != start; source = permutation[hole]) {
+        container[hole] = std::move(container[source]);
+        hole = source;
+      }
+      container[hole] = std::move(temporary);
+    }
+
+    template <typename Index>
+    void check_permutation_size(const vector<Index>&) {}
+
+    template <typename Index, typename Container, typename... Containers>
+    void check_permutation_size(const vector<Index>& permutation, const Container& container,
+                                const Containers&... containers) {
+      if (container.size() != permutation.size())
+        throw std::invalid_argument("Permutation and container sizes differ!");
+      check_permutation_size(permutation, containers...);
+    }
+  }
+
+  // Reorders every container so that element i becomes the one previously at permutation[i]
+  // (so the result of argsort sorts the containers). Every cycle of the permutation is followed
+  // once for all containers, which takes one move per element plus one per cycle.
+  // Throws std::invalid_argument when an index is out of range or repeated.
+  template <typename Index, typename... Containers>
+  void apply_permutation(const vector<Index>& permutation, Containers&... containers) {
+    detail::check_permutation_size(permutation, containers...);
+
+    std::size_t length = permutation.size();
+    vector<bool> visited(length, false);
+    for (std::size_t i = 0; i < length; i++) {
+      auto index = static_cast<std::size_t>(permutation[i]);
+      if (index >= length || visited[index]) throw std::invalid_argument("Not a permutation!");
+      visited[index] = true;
+    }
+    for (std::size_t i = 0; i < length; i++) visited[i] = false;
+
+    for (std::size_t start = 0; start < length; start++) {
+      if (visited[start]) continue;
+      for (std::size_t i = start; !visited[i]; i = permutation[i]) visited[i] = true;
+      if (static_cast<std::size_t>(permutation[start]) == start) continue;
+
+      int expand[] = {0, (detail::move_cycle(containers, permutation, start), 0)...};
+      (void)expand;
+    }
+  }
 }
 
 #endif //PHOSTDLIB_SORT_HPP
@@ -0,0 +1,326 @@
+#ifndef PHOSTDLIB_SPAN_HPP
+#define PHOSTDLIB_SPAN_HPP
+#include <phoenix/array.hpp>
+#include <phoenix/iterator_flag.hpp>
+#include <phoenix/vector.hpp>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#ifndef PHOSTDLIB_DONT_SUPPORT_PRINT
+#include <iostream>
+#endif
+
+// Non-owning views of elements stored elsewhere, valid as long as the storage. Copying a view
+// never copies elements, and writes through a view of non-const T change the viewed container.
+namespace phoenix {
+  constexpr std::size_t dynamic_extent = static_cast<std::size_t>(-1);
+
+  namespace detail {
+    // Size of a span: stored only when it's not known at compile time
+    template <std::size_t Extent>
+    struct span_size {
+      constexpr explicit span_size(std::size_t) noexcept {}
+      constexpr std::size_t get() const noexcept { return Extent; }
+    };
+
+    template <>
+    struct span_size<dynamic_extent> {
+      constexpr explicit span_size(std::size_t size) noexcept : _size{size} {}
+      constexpr std::size_t get() const noexcept { return _size; }
+
+    private:
+      std::size_t _size;
+    };
+
+    // Elements of From can be viewed as To (same type, possibly adding const)
+    template <typename From, typename To>
+    struct is_span_convertible : std::is_convertible<From (*)[], To (*)[]> {};
+
+    template <std::size_t Extent, std::size_t Offset, std::size_t Count>
+    struct subspan_extent
+        : std::integral_constant<std::size_t, Count != dynamic_extent ? Count
+                                                  : (Extent != dynamic_extent ? Extent - Offset : dynamic_extent)> {};
+  }
+
+  // Contiguous elements, with the count fixed at compile time or stored in the span. Iterators are
+  // raw pointers, so algorithms take their contiguous (and vectorized) paths.
+  template <typename T, std::size_t Extent = dynamic_extent>
+  class span : private detail::span_size<Extent> {
+    using size_base = detail::span_size<Extent>;
+
+  public:
+    using element_type = T;
+    using value_type = typename std::remove_cv<T>::type;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = T*;
+    static constexpr size_type extent = Extent;
+
+    template <std::size_t E = Extent, typename std::enable_if<E == 0 || E == dynamic_extent, int>::type = 0>
+    constexpr span() noexcept : size_base{0}, _data{nullptr} {}
+
+    // The count of a static span has to match Extent
+    constexpr span(pointer data, size_type size) noexcept : size_base{size}, _data{data} {}
+    constexpr span(pointer first, pointer last) noexcept
+        : size_base{static_cast<size_type>(last - first)}, _data{first} {}
+
+    template <std::size_t N, typename std::enable_if<Extent == dynamic_extent || N == Extent, int>::type = 0>
+    constexpr span(element_type (&data)[N]) noexcept : size_base{N}, _data{data} {}
+
+    template <typename U, std::size_t N, typename std::enable_if<
+        (Extent == dynamic_extent || N == Extent) && detail::is_span_convertible<U, T>::value, int>::type = 0>
+    span(array<U, N>& data) noexcept : size_base{N}, _data{detail::to_pointer(data.begin())} {}
+
+    template <typename U, std::size_t N, typename std::enable_if<
+        (Extent == dynamic_extent || N == Extent) && detail::is_span_convertible<const U, T>::value, int>::type = 0>
+    span(const array<U, N>& data) noexcept : size_base{N}, _data{detail::to_pointer(data.begin())} {}
+
+    template <typename U, std::size_t AllocSize, typename std::enable_if<
+        Extent == dynamic_extent && detail::is_span_convertible<U, T>::value, int>::type = 0>
+    span(vector<U, AllocSize>& data) noexcept : size_base{data.size()}, _data{detail::to_pointer(data.begin())} {}
+
+    template <typename U, std::size_t AllocSize, typename std::enable_if<
+        Extent == dynamic_extent && detail::is_span_convertible<const U, T>::value, int>::type = 0>
+    span(const vector<U, AllocSize>& data) noexcept : size_base{data.size()}, _data{data.data()} {}
+
+    // Static to dynamic extent, and T to const T
+    template <typename U, std::size_t N, typename std::enable_if<
+        (Extent == dynamic_extent || N == Extent) && detail::is_span_convertible<U, T>::value, int>::type = 0>
+    constexpr span(const span<U, N>& other) noexcept : size_base{other.size()}, _data{other.data()} {}
+
+    constexpr pointer data() const noexcept { return _data; }
+    constexpr size_type size() const noexcept { return size_base::get(); }
+    constexpr size_type size_bytes() const noexcept { return size() * sizeof(T); }
+    constexpr bool empty() const noexcept { return size() == 0; }
+
+    // Raw access
+    constexpr reference operator[](size_type i) const { return _data[i]; }
+
+    // Guarded access
+    reference at(size_type i) const {
+      if (i >= size()) throw std::out_of_range("Span index out of bounds!");
+      return _data[i];
+    }
+
+    constexpr reference front() const { return _data[0]; }
+    constexpr reference back() const { return _data[size() - 1]; }
+
+    constexpr iterator begin() const noexcept { return _data; }
+    constexpr iterator end() const noexcept { return _data + size(); }
+    constexpr const_pointer cbegin() const noexcept { return _data; }
+    constexpr const_pointer cend() const noexcept { return _data + size(); }
+
+    // Parts of the span, counts are not checked
+    span<T> first(size_type count) const { return span<T>(_data, count); }
+    span<T> last(size_type count) const { return span<T>(_data + size() - count, count); }
+
+    span<T> subspan(size_type offset, size_type count = dynamic_extent) const {
+      return span<T>(_data + offset, count == dynamic_extent ? size() - offset : count);
+    }
+
+    template <std::size_t Count>
+    span<T, Count> first() const {
+      static_assert(Extent == dynamic_extent || Count <= Extent, "subspan longer than the span");
+      return span<T, Count>(_data, Count);
+    }
+
+    template <std::size_t Count>
+    span<T, Count> last() const {
+      static_assert(Extent == dynamic_extent || Count <= Extent, "subspan longer than the span");
+      return span<T, Count>(_data + size() - Count, Count);
+    }
+
+    template <std::size_t Offset, std::size_t Count = dynamic_extent>
+    span<T, detail::subspan_extent<Extent, Offset, Count>::value> subspan() const {
+      static_assert(Extent == dynamic_extent || (Offset <= Extent && (Count == dynamic_extent ||
+                    Count <= Extent - Offset)), "subspan outside of the span");
+      return span<T, detail::subspan_extent<Extent, Offset, Count>::value>(
+          _data + Offset, Count == dynamic_extent ? size() - Offset : Count);
+    }
+
+    #ifndef PHOSTDLIB_DONT_SUPPORT_PRINT
+    std::ostream& print(std::ostream& os, const char* separator = ", ") const {
+      for (auto it = begin(); it != end(); ++it) os << *it << separator;
+      return os;
+    }
+    #endif
+
+  private:
+    pointer _data;
+  };
+
+  template <typename T, std::size_t Extent>
+  constexpr std::size_t span<T, Extent>::extent;
+
+  // Every stride-th element, stride may be negative. Views columns of row-major data.
+  template <typename T>
+  class strided_span {
+  public:
+    using element_type = T;
+    using value_type = typename std::remove_cv<T>::type;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+    class iterator {
+    public:
+      using self = iterator;
+      static constexpr auto iterator_type = iterator_flag::random_access;
+
+      using iterator_category = detail::std_category<iterator_type>;
+      using value_type = typename std::remove_cv<T>::type;
+      using reference = T&;
+      using pointer = T*;
+      using difference_type = std::ptrdiff_t;
+      using size_type = std::size_t;
+
+      // The element pointer is only formed on access, so end() of a view which stops next to
+      // the end of the buffer (like a column) doesn't point stride elements past it
+      iterator() : _data{nullptr}, _index{0}, _stride{1} {}
+      iterator(pointer data, difference_type index, difference_type stride)
+          : _data{data}, _index{index}, _stride{stride} {}
+
+      self& operator++() {
+        _index++;
+        return *this;
+      }
+
+      self operator++(int) {
+        auto t = *this;
+        this->operator++();
+        return t;
+      }
+
+      self& operator--() {
+        _index--;
+        return *this;
+      }
+
+      self operator--(int) {
+        auto t = *this;
+        this->operator--();
+        return t;
+      }
+
+      reference operator*() const { return _data[_index * _stride]; }
+      pointer operator->() const { return &**this; }
+      reference operator[](difference_type x) const { return _data[(_index + x) * _stride]; }
+
+      bool operator==(const self& other) const { return _index == other._index; }
+      bool operator!=(const self& other) const { return _index != other._index; }
+      bool operator<(const self& other) const { return _index < other._index; }
+      bool operator>(const self& other) const { return other < *this; }
+      bool operator<=(const self& other) const { return !(other < *this); }
+      bool operator>=(const self& other) const { return !(*this < other); }
+
+      self operator+(difference_type x) const { return self(_data, _index + x, _stride); }
+      self operator-(difference_type x) const { return self(_data, _index - x, _stride); }
+      difference_type operator-(const self& other) const { return _index - other._index; }
+      friend self operator+(difference_type x, const self& it) { return it + x; }
+
+      self& operator+=(difference_type x) {
+        _index += x;
+        return *this;
+      }
+
+      self& operator-=(difference_type x) {
+        _index -= x;
+        return *this;
+      }
+
+    private:
+      pointer _data;
+      difference_type _index;
+      difference_type _stride;
+    };
+
+    strided_span() noexcept : _data{nullptr}, _size{0}, _stride{1} {}
+    // size elements: data[0], data[stride], ..., data[(size - 1) * stride]
+    strided_span(pointer data, size_type size, difference_type stride) : _data{data}, _size{size}, _stride{stride} {
+      if (stride == 0) throw std::invalid_argument("Strided span stride can't be zero!");
+    }
+
+    // Every element of a span
+    template <typename U, std::size_t Extent,
+              typename std::enable_if<detail::is_span_convertible<U, T>::value, int>::type = 0>
+    strided_span(span<U, Extent> elements) noexcept : _data{elements.data()}, _size{elements.size()}, _stride{1} {}
+
+    pointer data() const noexcept { return _data; }
+    size_type size() const noexcept { return _size; }
+    difference_type stride() const noexcept { return _stride; }
+    bool empty() const noexcept { return _size == 0; }
+
+    reference operator[](size_type i) const { return _data[static_cast<difference_type>(i) * _stride]; }
+
+    reference at(size_type i) const {
+      if (i >= _size) throw std::out_of_range("Strided span index out of bounds!");
+      return (*this)[i];
+    }
+
+    reference front() const { return _data[0]; }
+    reference back() const { return (*this)[_size - 1]; }
+
+    iterator begin() const noexcept { return iterator(_data, 0, _stride); }
+    iterator end() const noexcept { return iterator(_data, static_cast<difference_type>(_size), _stride); }
+
+    // An empty view at the end keeps the data pointer, which would otherwise be past the buffer
+    strided_span subspan(size_type offset, size_type count = dynamic_extent) const {
+      if (offset == _size) return strided_span(_data, 0, _stride);
+      return strided_span(_data + static_cast<difference_type>(offset) * _stride,
+                          count == dynamic_extent ? _size - offset : count, _stride);
+    }
+
+    // Every step-th element of this view
+    strided_span every(size_type step) const {
+      if (step == 0) throw std::invalid_argument("Strided span step can't be zero!");
+      return strided_span(_data, (_size + step - 1) / step, _stride * static_cast<difference_type>(step));
+    }
+
+    #ifndef PHOSTDLIB_DONT_SUPPORT_PRINT
+    std::ostream& print(std::ostream& os, const char* separator = ", ") const {
+      for (auto it = begin(); it != end(); ++it) os << *it << separator;
+      return os;
+    }
+    #endif
+
+  private:
+    pointer _data;
+    size_type _size;
+    difference_type _stride;
+  };
+
+  // Views deduced from containers
+  template <typename T, std::size_t AllocSize>
+  span<T> make_span(vector<T, AllocSize>& data) { return span<T>(data); }
+
+  template <typename T, std::size_t AllocSize>
+  span<const T> make_span(const vector<T, AllocSize>& data) { return span<const T>(data); }
+
+  template <typename T, std::size_t N>
+  span<T, N> make_span(array<T, N>& data) { return span<T, N>(data); }
+
+  template <typename T, std::size_t N>
+  span<const T, N> make_span(const array<T, N>& data) { return span<const T, N>(data); }
+
+  template <typename T>
+  span<T> make_span(T* data, std::size_t size) { return span<T>(data, size); }
+
+  // Row and column of a row-major matrix with given number of columns
+  template <typename T, std::size_t Extent>
+  span<T> row(span<T, Extent> matrix, std::size_t columns, std::size_t index) {
+    return matrix.subspan(index * columns, columns);
+  }
+
+  template <typename T, std::size_t Extent>
+  strided_span<T> column(span<T, Extent> matrix, std::size_t columns, std::size_t index) {
+    if (index >= columns) throw std::out_of_range("Column index out of bounds!");
+    return strided_span<T>(matrix.data() + index, matrix.size() / columns, static_cast<std::ptrdiff_t>(columns));
+  }
+}
+
+#endif //PHOSTDLIB_SPAN_HPP
@@ -0,0 +1,114 @@
+#ifndef PHOSTDLIB_SPSC_QUEUE_HPP
+#define PHOSTDLIB_SPSC_QUEUE_HPP
+#include <phoenix/array.hpp>
+#include <phoenix/cpu.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+// The producer only writes _tail and the consumer only writes _head, each on its own cache line
+// together with the owner's copy of the other index. The other index is reloaded only when the
+// copy says the queue is full (or empty), so in steady state neither side touches the other's
+// line. Indices grow without wrapping, the slot is index & (N - 1).
+// The queue is aligned to a cache line, which operator new doesn't respect before C++17, so
+// it should be a static or automatic variable (or a member of one).
+namespace phoenix {
+  template <typename T, std::size_t N>
+  class spsc_queue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "Capacity of spsc_queue has to be a power of two");
+
+   public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    spsc_queue() = default;
+    spsc_queue(const spsc_queue&) = delete;
+    spsc_queue& operator=(const spsc_queue&) = delete;
+
+    static constexpr size_type capacity() { return N; }
+
+    // Both are exact only when called from one of the two threads while the other one is idle
+    size_type size() const {
+      return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+
+    // Producer side, returns false if the queue is full
+    bool try_push(const T& value) { return emplace(value); }
+    bool try_push(T&& value) { return emplace(std::move(value)); }
+
+    // Consumer side, returns false if the queue is empty
+    bool try_pop(T& value) {
+      std::size_t head = _head.load(std::memory_order_relaxed);
+      if (head == _cached_tail) {
+        _cached_tail = _tail.load(std::memory_order_acquire);
+        if (head == _cached_tail) return false;
+      }
+      value = std::move(_buffer[head & mask]);
+      _head.store(head + 1, std::memory_order_release);
+      return true;
+    }
+
+    // Producer side, copies as many of count values as fit and publishes them at once.
+    // Returns the number of values pushed.
+    size_type push_n(const T* values, size_type count) {
+      std::size_t tail = _tail.load(std::memory_order_relaxed);
+      if (N - (tail - _cached_head) < count) _cached_head = _head.load(std::memory_order_acquire);
+      count = std::min(count, N - (tail - _cached_head));
+      if (count == 0) return 0;
+
+      // The free space may wrap around the end of the buffer, making it two contiguous spans
+      std::size_t first = tail & mask;
+      std::size_t split = std::min(count, N - first);
+      std::copy(values, values + split, &_buffer[0] + first);
+      std::copy(values + split, values + count, &_buffer[0]);
+      _tail.store(tail + count, std::memory_order_release);
+      return count;
+    }
+
+    // Consumer side, moves up to count values to out. Returns the number of values popped.
+    size_type pop_n(T* out, size_type count) {
+      std::size_t head = _head.load(std::memory_order_relaxed);
+      if (_cached_tail - head < count) _cached_tail = _tail.load(std::memory_order_acquire);
+      count = std::min(count, _cached_tail - head);
+      if (count == 0) return 0;
+
+      std::size_t first = head & mask;
+      std::size_t split = std::min(count, N - first);
+      std::move(&_buffer[0] + first, &_buffer[0] + first + split, out);
+      std::move(&_buffer[0], &_buffer[0] + (count - split), out + split);
+      _head.store(head + count, std::memory_order_release);
+      return count;
+    }
+
+   private:
+    static constexpr std::size_t mask = N - 1;
+
+    template <typename Value>
+    bool emplace(Value&& value) {
+      std::size_t tail = _tail.load(std::memory_order_relaxed);
+      if (tail - _cached_head == N) {
+        _cached_head = _head.load(std::memory_order_acquire);
+        if (tail - _cached_head == N) return false;
+      }
+      _buffer[tail & mask] = std::forward<Value>(value);
+      _tail.store(tail + 1, std::memory_order_release);
+      return true;
+    }
+
+    // Written by the consumer
+    alignas(cpu::cache_line_size) std::atomic<std::size_t> _head{0};
+    std::size_t _cached_tail = 0;
+
+    // Written by the producer
+    alignas(cpu::cache_line_size) std::atomic<std::size_t> _tail{0};
+    std::size_t _cached_head = 0;
+
+    alignas(cpu::cache_line_size) array<T, N> _buffer;
+  };
+}
+
+#endif //PHOSTDLIB_SPSC_QUEUE_HPP
@@ -0,0 +1,456 @@
+#ifndef PHOSTDLIB_STRING_HPP
+#define PHOSTDLIB_STRING_HPP
+#include <phoenix/detail/hash_bytes.hpp>
+#include <phoenix/detail/simd_search.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#ifndef PHOSTDLIB_DONT_SUPPORT_PRINT
+#include <iostream>
+#endif
+
+namespace phoenix {
+  // Returned by searches that found nothing
+  constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+  namespace detail {
+    inline std::size_t find_char(const char* data, std::size_t size, char value, std::size_t position) {
+      if (position >= size) return npos;
+      auto* found = static_cast<const char*>(std::memchr(data + position, value, size - position));
+      return found != nullptr ? static_cast<std::size_t>(found - data) : npos;
+    }
+
+    inline std::size_t find_string(const char* data, std::size_t size, const char* needle, std::size_t length,
+                                   std::size_t position) {
+      if (position > size || length > size - position) return npos;
+      if (length == 0) return position;
+      if (length == 1) return find_char(data, size, needle[0], position);
+      std::size_t found;
+      if (!simd_search::find_substring(data + position, size - position, needle, length, found)) {
+        found = size - position;
+        for (std::size_t i = 0; i + length <= size - position; i++) {
+          if (std::memcmp(data + position + i, needle, length) == 0) {
+            found = i;
+            break;
+          }
+        }
+      }
+      return found == size - position ? npos : position + found;
+    }
+
+    inline int compare_strings(const char* first, std::size_t first_size, const char* second,
+                               std::size_t second_size) {
+      std::size_t common = first_size < second_size ? first_size : second_size;
+      int result = common > 0 ? std::memcmp(first, second, common) : 0;
+      if (result != 0) return result;
+      return first_size == second_size ? 0 : (first_size < second_size ? -1 : 1);
+    }
+  }
+
+  // Non-owning view of characters, valid as long as the viewed string
+  class string_view {
+  public:
+    using value_type = char;
+    using size_type = std::size_t;
+    using const_iterator = const char*;
+    using iterator = const_iterator;
+    static constexpr size_type npos = phoenix::npos;
+
+    constexpr string_view() noexcept : _data{nullptr}, _size{0} {}
+    constexpr string_view(const char* data, size_type size) noexcept : _data{data}, _size{size} {}
+    string_view(const char* string) : _data{string}, _size{std::strlen(string)} {}
+    string_view(const std::string& string) noexcept : _data{string.data()}, _size{string.size()} {}
+
+    constexpr const char* data() const noexcept { return _data; }
+    constexpr size_type size() const noexcept { return _size; }
+    constexpr size_type length() const noexcept { return _size; }
+    constexpr bool empty() const noexcept { return _size == 0; }
+
+    constexpr const char& operator[](size_type i) const { return _data[i]; }
+
+    const char& at(size_type i) const {
+      if (i >= _size) throw std::out_of_range("String view index out of bounds!");
+      return _data[i];
+    }
+
+    const char& front() const { return _data[0]; }
+    const char& back() const { return _data[_size - 1]; }
+
+    constexpr const_iterator begin() const noexcept { return _data; }
+    constexpr const_iterator end() const noexcept { return _data + _size; }
+    constexpr const_iterator cbegin() const noexcept { return _data; }
+    constexpr const_iterator cend() const noexcept { return _data + _size; }
+
+    void remove_prefix(size_type count) {
+      _data += count;
+      _size -= count;
+    }
+
+    void remove_suffix(size_type count) { _size -= count; }
+
+    // At most count characters starting at position
+    string_view substr(size_type position, size_type count = npos) const {
+      if (position > _size) throw std::out_of_range("String view position out of bounds!");
+      return string_view(_data + position, count < _size - position ? count : _size - position);
+    }
+
+    size_type find(char value, size_type position = 0) const {
+      return detail::find_char(_data, _size, value, position);
+    }
+
+    size_type find(string_view needle, size_type position = 0) const {
+      return detail::find_string(_data, _size, needle._data, needle._size, position);
+    }
+
+    size_type rfind(char value) const {
+      for (size_type i = _size; i > 0; i--) {
+        if (_data[i - 1] == value) return i - 1;
+      }
+      return npos;
+    }
+
+    bool contains(string_view needle) const { return find(needle) != npos; }
+
+    bool starts_with(string_view prefix) const {
+      return prefix._size <= _size && (prefix._size == 0 || std::memcmp(_data, prefix._data, prefix._size) == 0);
+    }
+
+    bool ends_with(string_view suffix) const {
+      return suffix._size <= _size &&
+             (suffix._size == 0 || std::memcmp(_data + _size - suffix._size, suffix._data, suffix._size) == 0);
+    }
+
+    // Negative, zero or positive like memcmp, shorter strings first when one is a prefix of the other
+    int compare(string_view other) const { return detail::compare_strings(_data, _size, other._data, other._size); }
+
+    explicit operator std::string() const { return std::string(_data, _size); }
+
+  private:
+    const char* _data;
+    size_type _size;
+  };
+
+  // Comparisons of any mix of phoenix strings, std::string and C strings go through string_view
+  inline bool operator==(string_view first, string_view second) noexcept {
+    return first.size() == second.size() &&
+           (first.size() == 0 || std::memcmp(first.data(), second.data(), first.size()) == 0);
+  }
+
+  inline bool operator!=(string_view first, string_view second) noexcept { return !(first == second); }
+  inline bool operator<(string_view first, string_view second) noexcept { return first.compare(second) < 0; }
+  inline bool operator>(string_view first, string_view second) noexcept { return first.compare(second) > 0; }
+  inline bool operator<=(string_view first, string_view second) noexcept { return first.compare(second) <= 0; }
+  inline bool operator>=(string_view first, string_view second) noexcept { return first.compare(second) >= 0; }
+
+  #ifndef PHOSTDLIB_DONT_SUPPORT_PRINT
+  inline std::ostream& operator<<(std::ostream& os, string_view string) {
+    return os.write(string.data(), static_cast<std::streamsize>(string.size()));
+  }
+  #endif
+
+  // Owning, null-terminated string. Up to 22 characters are stored inside the object (24 bytes),
+  // longer strings on the heap with capacity doubling on growth.
+  class string {
+  public:
+    using value_type = char;
+    using size_type = std::size_t;
+    using iterator = char*;
+    using const_iterator = const char*;
+    static constexpr size_type npos = phoenix::npos;
+    static constexpr size_type small_capacity = 22;
+
+    string() noexcept { set_small_size(0); }
+    string(const char* data, size_type size) { init(data, size); }
+    string(const char* string) { init(string, std::strlen(string)); }
+    explicit string(string_view view) { init(view.data(), view.size()); }
+    explicit string(const std::string& other) { init(other.data(), other.size()); }
+
+    string(size_type count, char value) {
+      init(nullptr, count);
+      std::memset(data(), value, count);
+    }
+
+    // Rule of five
+    string(const string& other) { init(other.data(), other.size()); }
+
+    string(string&& other) noexcept {
+      std::memcpy(static_cast<void*>(this), static_cast<const void*>(&other), sizeof(string));
+      other.set_small_size(0);
+    }
+
+    string& operator=(const string& other) {
+      if (this != &other) assign(other.data(), other.size());
+      return *this;
+    }
+
+    string& operator=(string&& other) noexcept {
+      if (this != &other) {
+        release();
+        std::memcpy(static_cast<void*>(this), static_cast<const void*>(&other), sizeof(string));
+        other.set_small_size(0);
+      }
+      return *this;
+    }
+
+    string& operator=(string_view view) { return assign(view.data(), view.size()); }
+    string& operator=(const char* string) { return assign(string, std::strlen(string)); }
+
+    ~string() { release(); }
+
+    // Works when the characters are a part of this string too
+    string& assign(const char* data, size_type size) {
+      if (size > capacity()) {
+        string copy(data, size);
+        swap(copy);
+        return *this;
+      }
+      std::memmove(this->data(), data, size);
+      set_size(size);
+      return *this;
+    }
+
+    // Raw access
+    char* data() noexcept { return is_small() ? _small : _large.data; }
+    const char* data() const noexcept { return is_small() ? _small : _large.data; }
+    const char* c_str() const noexcept { return data(); }
+
+    size_type size() const noexcept { return is_small() ? small_size() : _large.size; }
+    size_type length() const noexcept { return size(); }
+    size_type capacity() const noexcept { return is_small() ? small_capacity : decode(_large.capacity); }
+    bool empty() const noexcept { return size() == 0; }
+
+    char& operator[](size_type i) { return data()[i]; }
+    const char& operator[](size_type i) const { return data()[i]; }
+
+    // Guarded access
+    char& at(size_type i) {
+      if (i >= size()) throw std::out_of_range("String index out of bounds!");
+      return data()[i];
+    }
+
+    const char& at(size_type i) const {
+      if (i >= size()) throw std::out_of_range("String index out of bounds!");
+      return data()[i];
+    }
+
+    char& front() { return data()[0]; }
+    const char& front() const { return data()[0]; }
+    char& back() { return data()[size() - 1]; }
+    const char& back() const { return data()[size() - 1]; }
+
+    iterator begin() noexcept { return data(); }
+    iterator end() noexcept { return data() + size(); }
+    const_iterator begin() const noexcept { return data(); }
+    const_iterator end() const noexcept { return data() + size(); }
+    const_iterator cbegin() const noexcept { return data(); }
+    const_iterator cend() const noexcept { return data() + size(); }
+
+    operator string_view() const noexcept { return string_view(data(), size()); }
+    explicit operator std::string() const { return std::string(data(), size()); }
+
+    // Capacity
+    void reserve(size_type new_capacity) {
+      if (new_capacity <= capacity()) return;
+      if (new_capacity > max_size()) throw std::length_error("String too long!");
+      size_type old_size = size();
+      char* buffer = new char[new_capacity + 1];
+      std::memcpy(buffer, data(), old_size + 1);
+      release();
+      _large.data = buffer;
+      _large.size = old_size;
+      _large.capacity = encode(new_capacity);
+    }
+
+    void resize(size_type new_size, char value = '\0') {
+      size_type old_size = size();
+      if (new_size > old_size) {
+        grow(new_size);
+        std::memset(data() + old_size, value, new_size - old_size);
+      }
+      set_size(new_size);
+    }
+
+    void clear() noexcept { set_size(0); }
+
+    static constexpr size_type max_size() noexcept { return (npos >> 1) - 1; }
+
+    // Adding and removing characters
+    void push_back(char value) {
+      size_type old_size = size();
+      grow(old_size + 1);
+      data()[old_size] = value;
+      set_size(old_size + 1);
+    }
+
+    void pop_back() {
+      if (empty()) throw std::out_of_range("Cannot pop from an empty string!");
+      set_size(size() - 1);
+    }
+
+    string& append(const char* characters, size_type count) {
+      size_type old_size = size();
+      if (count > max_size() - old_size) throw std::length_error("String too long!");
+      if (old_size + count > capacity()) {
+        // The characters may belong to this string
+        string grown;
+        grown.reserve(next_capacity(old_size + count));
+        std::memcpy(grown.data(), data(), old_size);
+        std::memcpy(grown.data() + old_size, characters, count);
+        grown.set_size(old_size + count);
+        swap(grown);
+        return *this;
+      }
+      std::memmove(data() + old_size, characters, count);
+      set_size(old_size + count);
+      return *this;
+    }
+
+    string& append(string_view view) { return append(view.data(), view.size()); }
+
+    string& append(size_type count, char value) {
+      size_type old_size = size();
+      grow(old_size + count);
+      std::memset(data() + old_size, value, count);
+      set_size(old_size + count);
+      return *this;
+    }
+
+    string& operator+=(string_view view) { return append(view); }
+    string& operator+=(const char* string) { return append(string, std::strlen(string)); }
+    string& operator+=(char value) {
+      push_back(value);
+      return *this;
+    }
+
+    // Searching, see string_view
+    size_type find(char value, size_type position = 0) const {
+      return detail::find_char(data(), size(), value, position);
+    }
+
+    size_type find(string_view needle, size_type position = 0) const {
+      return detail::find_string(data(), size(), needle.data(), needle.size(), position);
+    }
+
+    size_type rfind(char value) const { return string_view(*this).rfind(value); }
+    bool contains(string_view needle) const { return find(needle) != npos; }
+    bool starts_with(string_view prefix) const { return string_view(*this).starts_with(prefix); }
+    bool ends_with(string_view suffix) const { return string_view(*this).ends_with(suffix); }
+    int compare(string_view other) const { return string_view(*this).compare(other); }
+
+    string substr(size_type position, size_type count = npos) const {
+      return string(string_view(*this).substr(position, count));
+    }
+
+    // Exchanges the representations, nothing is allocated
+    void swap(string& other) noexcept {
+      char temporary[sizeof(string)];
+      std::memcpy(temporary, static_cast<const void*>(this), sizeof(string));
+      std::memcpy(static_cast<void*>(this), static_cast<const void*>(&other), sizeof(string));
+      std::memcpy(static_cast<void*>(&other), temporary, sizeof(string));
+    }
+
+  private:
+    struct large {
+      char* data;
+      size_type size;
+      // Encoded, so that the flag lands in the last byte of the object
+      size_type capacity;
+    };
+
+    // The last byte holds the size of a small string, or has the high bit set for a large one
+  #if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    static size_type encode(size_type capacity) noexcept { return capacity << 8 | 0x80u; }
+    static size_type decode(size_type field) noexcept { return field >> 8; }
+  #else
+    static constexpr size_type large_flag = ~(npos >> 1);
+    static size_type encode(size_type capacity) noexcept { return capacity | large_flag; }
+    static size_type decode(size_type field) noexcept { return field & ~large_flag; }
+  #endif
+
+    unsigned char control() const noexcept {
+      return reinterpret_cast<const unsigned char*>(this)[sizeof(large) - 1];
+    }
+
+    bool is_small() const noexcept { return (control() & 0x80u) == 0; }
+    size_type small_size() const noexcept { return control(); }
+
+    void set_small_size(size_type size) noexcept {
+      _small[size] = '\0';
+      _small[sizeof(large) - 1] = static_cast<char>(size);
+    }
+
+    void set_size(size_type size) noexcept {
+      if (is_small()) {
+        set_small_size(size);
+      } else {
+        _large.size = size;
+        _large.data[size] = '\0';
+      }
+    }
+
+    // Storage for size characters without initializing them, copied from data when it's given
+    void init(const char* data, size_type size) {
+      if (size <= small_capacity) {
+        if (size > 0 && data != nullptr) std::memcpy(_small, data, size);
+        set_small_size(size);
+        return;
+      }
+      if (size > max_size()) throw std::length_error("String too long!");
+      _large.data = new char[size + 1];
+      if (data != nullptr) std::memcpy(_large.data, data, size);
+      _large.data[size] = '\0';
+      _large.size = size;
+      _large.capacity = encode(size);
+    }
+
+    void release() noexcept {
+      if (!is_small()) delete[] _large.data;
+    }
+
+    size_type next_capacity(size_type needed) const noexcept {
+      size_type doubled = capacity() * 2;
+      return doubled > needed && doubled <= max_size() ? doubled : needed;
+    }
+
+    void grow(size_type needed) {
+      if (needed > capacity()) reserve(next_capacity(needed));
+    }
+
+    union {
+      large _large;
+      char _small[sizeof(large)];
+    };
+  };
+
+  inline string operator+(string_view first, string_view second) {
+    string result;
+    result.reserve(first.size() + second.size());
+    result.append(first);
+    result.append(second);
+    return result;
+  }
+
+  inline void swap(string& first, string& second) noexcept { first.swap(second); }
+}
+
+namespace std {
+  template <>
+  struct hash<phoenix::string_view> {
+    std::size_t operator()(phoenix::string_view string) const noexcept {
+      return static_cast<std::size_t>(phoenix::detail::hash_bytes(string.data(), string.size()));
+    }
+  };
+
+  template <>
+  struct hash<phoenix::string> {
+    std::size_t operator()(const phoenix::string& string) const noexcept {
+      return static_cast<std::size_t>(phoenix::detail::hash_bytes(string.data(), string.size()));
+    }
+  };
+}
+
+#endif //PHOSTDLIB_STRING_HPP
@@ -0,0 +1,376 @@
+#ifndef PHOSTDLIB_THREAD_POOL_HPP
+#define PHOSTDLIB_THREAD_POOL_HPP
+#include <phoenix/cpu.hpp>
+#include <phoenix/detail/wait.hpp>
+#include <phoenix/iterator_flag.hpp>
+#include <phoenix/mpmc_queue.hpp>
+#include <phoenix/vector.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace phoenix {
+  namespace detail {
+    // Chase-Lev deque, following Le et al. "Correct and Efficient Work-Stealing for Weak Memory
+    // Models". The owner pushes and pops at the bottom, other threads steal from the
+    // top. When the ring fills up it's replaced by a twice bigger one, old rings are kept until
+    // destruction, because thieves may still read them.
+    template <typename T>
+    class work_deque {
+     public:
+      work_deque() : _ring(nullptr) {
+        _ring.store(add_ring(64), std::memory_order_relaxed);
+      }
+
+      work_deque(const work_deque&) = delete;
+      work_deque& operator=(const work_deque&) = delete;
+
+      ~work_deque() {
+        for (std::size_t i = 0; i < _rings.size(); i++) delete _rings[i];
+      }
+
+      // Owner only
+      void push(T* item) {
+        std::int64_t bottom = _bottom.load(std::memory_order_relaxed);
+        std::int64_t top = _top.load(std::memory_order_acquire);
+        ring* current = _ring.load(std::memory_order_relaxed);
+        if (bottom - top > static_cast<std::int64_t>(current->mask)) current = grow(current, top, bottom);
+        current->put(bottom, item);
+        _bottom.store(bottom + 1, std::memory_order_release);
+      }
+
+      // Owner only, returns the most recently pushed item or nullptr if the deque is empty
+      T* pop() {
+        std::int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+        ring* current = _ring.load(std::memory_order_relaxed);
+        _bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t top = _top.load(std::memory_order_relaxed);
+        if (top > bottom) {
+          _bottom.store(bottom + 1, std::memory_order_relaxed);
+          return nullptr;
+        }
+        T* item = current->get(bottom);
+        if (top == bottom) {
+          // Last item, thieves may be after it too
+          if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            item = nullptr;
+          _bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return item;
+      }
+
+      // Any thread, returns the oldest item or nullptr if the deque is empty or another thread won
+      T* steal() {
+        std::int64_t top = _top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t bottom = _bottom.load(std::memory_order_acquire);
+        if (top >= bottom) return nullptr;
+        T* item = _ring.load(std::memory_order_acquire)->get(top);
+        if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+          return nullptr;
+        return item;
+      }
+
+      bool empty() const {
+        return _bottom.load(std::memory_order_relaxed) <= _top.load(std::memory_order_relaxed);
+      }
+
+     private:
+      struct ring {
+        explicit ring(std::size_t capacity) : mask(capacity - 1), slots(new std::atomic<T*>[capacity]) {}
+
+        T* get(std::int64_t i) const {
+          return slots[static_cast<std::size_t>(i) & mask].load(std::memory_order_relaxed);
+        }
+
+        void put(std::int64_t i, T* item) {
+          slots[static_cast<std::size_t>(i) & mask].store(item, std::memory_order_relaxed);
+        }
+
+        std::size_t mask;
+        std::unique_ptr<std::atomic<T*>[]> slots;
+      };
+
+      ring* add_ring(std::size_t capacity) {
+        detail::grow(_rings, _rings.size() + 1);
+        _rings.push(new ring(capacity));
+        return _rings[_rings.size() - 1];
+      }
+
+      ring* grow(ring* current, std::int64_t top, std::int64_t bottom) {
+        ring* bigger = add_ring(2 * (current->mask + 1));
+        for (std::int64_t i = top; i < bottom; i++) bigger->put(i, current->get(i));
+        _ring.store(bigger, std::memory_order_release);
+        return bigger;
+      }
+
+      // Thieves write _top, the owner writes _bottom
+      std::atomic<std::int64_t> _top{0};
+      char _padding[cpu::cache_line_size];
+      std::atomic<std::int64_t> _bottom{0};
+      std::atomic<ring*> _ring;
+      vector<ring*> _rings;
+    };
+
+    // Index of threads which aren't workers of a pool
+    constexpr std::size_t no_worker = ~std::size_t{0};
+  }
+
+  class task_group;
+
+  // Every worker has its own deque of tasks. Tasks spawned by a worker go to its deque and are
+  // taken back newest first, idle workers steal the oldest tasks of others. Tasks submitted from
+  // outside of the pool go through a shared queue. Workers that found nothing to do spin for a
+  // while and then sleep until new tasks arrive.
+  // The pool is aligned to a cache line, which operator new doesn't respect before C++17, so it
+  // should be a static or automatic variable (or a member of one).
+  class thread_pool {
+   public:
+    // Optionally binds worker i to core i (modulo the number of available cores)
+    explicit thread_pool(unsigned threads = cpu::available_cores(), bool pin_threads = false)
+        : _workers(threads > 0 ? threads : 1), _injected(1024) {
+      for (std::size_t i = 0; i < _workers.size(); i++) _workers[i] = new worker;
+      for (std::size_t i = 0; i < _workers.size(); i++) {
+        _workers[i]->thread = std::thread([this, i, pin_threads]() {
+          if (pin_threads) cpu::pin_current_thread(static_cast<unsigned>(i) % cpu::available_cores());
+          context() = {this, i, static_cast<std::uint32_t>(i) * 2654435761u + 1};
+          run_until([this]() { return _stopping.load(std::memory_order_acquire); });
+        });
+      }
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    // Waits for running tasks, tasks which haven't started yet are run by the calling thread
+    ~thread_pool() {
+      _stopping.store(true, std::memory_order_release);
+      _signal.notify_all();
+      for (std::size_t i = 0; i < _workers.size(); i++) _workers[i]->thread.join();
+      while (task* t = find_task(detail::no_worker)) execute(t);
+      for (std::size_t i = 0; i < _workers.size(); i++) delete _workers[i];
+    }
+
+    std::size_t size() const { return _workers.size(); }
+
+    // Runs function() on some worker. It must not throw, use a task_group to get exceptions back.
+    template <typename Function>
+    void submit(Function&& function) {
+      schedule(new function_task<typename std::decay<Function>::type>(std::forward<Function>(function)));
+    }
+
+   private:
+    friend class task_group;
+
+    struct task {
+      virtual ~task() = default;
+      virtual void run() = 0;
+    };
+
+    template <typename Function>
+    struct function_task : task {
+      template <typename F>
+      explicit function_task(F&& f) : function(std::forward<F>(f)) {}
+      void run() override { function(); }
+      Function function;
+    };
+
+    struct worker {
+      detail::work_deque<task> deque;
+      std::thread thread;
+    };
+
+    struct thread_context {
+      thread_pool* pool;
+      std::size_t index;
+      std::uint32_t seed;
+    };
+
+    static thread_context& context() {
+      static thread_local thread_context current{nullptr, detail::no_worker, 0x9e3779b9u};
+      return current;
+    }
+
+    // Index of the calling thread's worker in this pool
+    std::size_t current_index() const {
+      const thread_context& current = context();
+      return current.pool == this ? current.index : detail::no_worker;
+    }
+
+    void schedule(task* t) {
+      std::size_t index = current_index();
+      if (index != detail::no_worker) _workers[index]->deque.push(t);
+      else _injected.push(t);
+      _signal.notify_one();
+    }
+
+    static void execute(task* t) {
+      t->run();
+      delete t;
+    }
+
+    // Own deque first, then the shared queue, then other workers starting from a random one
+    task* find_task(std::size_t index) {
+      task* t = nullptr;
+      if (index != detail::no_worker && (t = _workers[index]->deque.pop()) != nullptr) return t;
+      if (_injected.try_pop(t)) return t;
+
+      std::uint32_t& seed = context().seed;
+      seed ^= seed << 13;
+      seed ^= seed >> 17;
+      seed ^= seed << 5;
+      std::size_t count = _workers.size();
+      for (std::size_t i = 0, victim = seed % count; i < count; i++, victim = victim + 1 == count ? 0 : victim + 1) {
+        if (victim == index) continue;
+        if ((t = _workers[victim]->deque.steal()) != nullptr) return t;
+      }
+      return nullptr;
+    }
+
+    // Runs tasks until done() returns true, sleeping when there is nothing to do. Threads
+    // waiting for a task group help this way too, so that waiting inside a task can't deadlock.
+    template <typename Done>
+    void run_until(Done done) {
+      std::size_t index = current_index();
+      detail::backoff delay;
+      while (!done()) {
+        if (task* t = find_task(index)) {
+          execute(t);
+          delay.reset();
+          continue;
+        }
+        if (!delay.exhausted()) {
+          delay.pause();
+          continue;
+        }
+        std::uint32_t key = _signal.prepare_wait();
+        if (done()) {
+          _signal.cancel_wait();
+          return;
+        }
+        if (task* t = find_task(index)) {
+          _signal.cancel_wait();
+          execute(t);
+          delay.reset();
+          continue;
+        }
+        _signal.wait(key);
+      }
+    }
+
+    vector<worker*> _workers;
+    mpmc_queue<task*> _injected;
+    std::atomic<bool> _stopping{false};
+    // Notified about new tasks, finished task groups and stopping
+    alignas(cpu::cache_line_size) detail::event _signal;
+  };
+
+  // Pool used by parallel algorithms when none is given, with one worker per available core
+  inline thread_pool& default_thread_pool() {
+    static thread_pool pool;
+    return pool;
+  }
+
+  // Fork/join: run spawns tasks, wait returns once all of them have finished, running tasks of
+  // the pool in the meantime. The first exception thrown by a task is rethrown by wait.
+  class task_group {
+   public:
+    explicit task_group(thread_pool& pool = default_thread_pool()) : _pool(pool) {}
+
+    task_group(const task_group&) = delete;
+    task_group& operator=(const task_group&) = delete;
+
+    ~task_group() {
+      try {
+        wait();
+      } catch (...) {
+      }
+    }
+
+    template <typename Function>
+    void run(Function&& function) {
+      _pending.fetch_add(1, std::memory_order_relaxed);
+      _pool.schedule(new group_task<typename std::decay<Function>::type>(std::forward<Function>(function), this));
+    }
+
+    void wait() {
+      _pool.run_until([this]() { return _pending.load(std::memory_order_acquire) == 0; });
+      if (_failed.load(std::memory_order_acquire)) {
+        std::exception_ptr error = std::move(_error);
+        _error = nullptr;
+        _failed.store(false, std::memory_order_relaxed);
+        std::rethrow_exception(error);
+      }
+    }
+
+   private:
+    template <typename Function>
+    struct group_task : thread_pool::task {
+      template <typename F>
+      group_task(F&& f, task_group* g) : function(std::forward<F>(f)), group(g) {}
+
+      void run() override {
+        try {
+          function();
+        } catch (...) {
+          if (!group->_failed.exchange(true, std::memory_order_acq_rel)) group->_error = std::current_exception();
+        }
+        // The group may be gone as soon as the counter drops to zero, the pool outlives it
+        thread_pool& pool = group->_pool;
+        if (group->_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) pool._signal.notify_all();
+      }
+
+      Function function;
+      task_group* group;
+    };
+
+    thread_pool& _pool;
+    std::atomic<std::size_t> _pending{0};
+    std::atomic<bool> _failed{false};
+    std::exception_ptr _error;
+  };
+
+  namespace detail {
+    // Keeps the first part of the range and hands the second half to the group until the rest
+    // is at most grain long. Thieves take the oldest, biggest halves and split them further.
+    template <typename Iterator, typename Function>
+    void split_range(task_group& group, Iterator first, std::size_t length, std::size_t grain,
+                     const Function& function) {
+      while (length > grain) {
+        std::size_t half = length / 2;
+        Iterator middle = first;
+        middle += static_cast<std::ptrdiff_t>(half);
+        std::size_t rest = length - half;
+        group.run([&group, middle, rest, grain, &function]() { split_range(group, middle, rest, grain, function); });
+        length = half;
+      }
+      Iterator last = first;
+      last += static_cast<std::ptrdiff_t>(length);
+      function(first, last);
+    }
+  }
+
+  // Calls function(block_first, block_last) for blocks of at most grain elements covering
+  // [first, last), in parallel. Returns when all blocks are done.
+  template <typename Iterator, typename Function>
+  void parallel_for(thread_pool& pool, Iterator first, Iterator last, std::size_t grain, Function function) {
+    std::size_t length = detail::distance(first, last);
+    if (length == 0) return;
+    task_group group(pool);
+    detail::split_range(group, first, length, grain > 0 ? grain : 1, function);
+    group.wait();
+  }
+
+  template <typename Iterator, typename Function>
+  void parallel_for(Iterator first, Iterator last, std::size_t grain, Function function) {
+    parallel_for(default_thread_pool(), first, last, grain, std::move(function));
+  }
+}
+
+#endif //PHOSTDLIB_THREAD_POOL_HPP
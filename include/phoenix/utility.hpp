@@ -3,6 +3,11 @@
 #ifndef PHOSTDLIB_DONT_SUPPORT_PRINT
 #include <iostream>
 #endif
+#include <phoenix/iterator_flag.hpp>
+#include <phoenix/detail/simd_search.hpp>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
 
 namespace phoenix {
   template <typename T1, typename T2>
@@ -27,52 +32,230 @@ namespace phoenix {
     return first < second ? first : second;
   }
 
+  // Stateless comparators. Unlike pointers to the functions below, they are inlined into
+  // algorithms they are passed to. Both sides can be of different types (heterogeneous lookup).
+  struct greater_fn {
+    using is_transparent = void;
+
+    template <typename T, typename U>
+    constexpr bool operator()(const T& first, const U& second) const {
+      return first > second;
+    }
+  };
+
+  struct greater_or_equal_fn {
+    using is_transparent = void;
+
+    template <typename T, typename U>
+    constexpr bool operator()(const T& first, const U& second) const {
+      return first >= second;
+    }
+  };
+
+  struct less_fn {
+    using is_transparent = void;
+
+    template <typename T, typename U>
+    constexpr bool operator()(const T& first, const U& second) const {
+      return first < second;
+    }
+  };
+
+  struct less_or_equal_fn {
+    using is_transparent = void;
+
+    template <typename T, typename U>
+    constexpr bool operator()(const T& first, const U& second) const {
+      return first <= second;
+    }
+  };
+
+  struct equal_fn {
+    using is_transparent = void;
+
+    template <typename T, typename U>
+    constexpr bool operator()(const T& first, const U& second) const {
+      return first == second;
+    }
+  };
+
+  struct not_equal_fn {
+    using is_transparent = void;
+
+    template <typename T, typename U>
+    constexpr bool operator()(const T& first, const U& second) const {
+      return first != second;
+    }
+  };
+
+  // Arithmetic operations for reductions and scans
+  struct plus_fn {
+    template <typename T, typename U>
+    constexpr auto operator()(const T& first, const U& second) const -> decltype(first + second) {
+      return first + second;
+    }
+  };
+
+  struct multiplies_fn {
+    template <typename T, typename U>
+    constexpr auto operator()(const T& first, const U& second) const -> decltype(first * second) {
+      return first * second;
+    }
+  };
+
+  namespace detail {
+    // Direction of the comparators that specialized algorithms know how to emulate:
+    // 1 for ascending (greater_fn), -1 for descending (less_fn), 0 for everything else
+    template <typename Compare>
+    struct natural_order : std::integral_constant<int, 0> {};
+
+    template <>
+    struct natural_order<greater_fn> : std::integral_constant<int, 1> {};
+
+    template <>
+    struct natural_order<less_fn> : std::integral_constant<int, -1> {};
+  }
+
   template <typename T>
   bool is_greater(const T& first, const T& second) {
-    return first > second;
+    return greater_fn{}(first, second);
   }
 
   template <typename T>
   bool is_greater_or_equal(const T& first, const T& second) {
-    return first >= second;
+    return greater_or_equal_fn{}(first, second);
   }
 
   template <typename T>
   bool is_lesser(const T& first, const T& second) {
-    return first < second;
+    return less_fn{}(first, second);
   }
 
   template <typename T>
   bool is_lesser_or_equal(const T& first, const T& second) {
-    return first <= second;
+    return less_or_equal_fn{}(first, second);
   }
 
   template <typename T>
   bool is_equal(const T& first, const T& second) {
-    return first == second;
+    return equal_fn{}(first, second);
   }
 
   template <typename T>
   bool is_not_equal(const T& first, const T& second) {
-    return first != second;
+    return not_equal_fn{}(first, second);
+  }
+
+  namespace detail {
+    template <typename Iterator>
+    using iterator_value = typename std::remove_cv<
+        typename std::remove_reference<decltype(*std::declval<Iterator&>())>::type>::type;
+
+    template <typename Iterator>
+    using compare_pointer = bool (*)(const iterator_value<Iterator>&, const iterator_value<Iterator>&);
+
+    // Wraps a function pointer, so overloads taking one don't end up calling themselves
+    template <typename T>
+    struct function_compare {
+      bool (*compare)(const T&, const T&);
+
+      bool operator()(const T& first, const T& second) const {
+        return compare(first, second);
+      }
+    };
+
+    // Algorithms take comparators by deduced type, which a function template like is_greater
+    // can't be passed as, so they also have overloads taking a function pointer. Pointers to
+    // is_greater and is_lesser are turned into greater_fn and less_fn, which keeps the
+    // specialized (vectorized) paths selected by comparator type.
+    template <typename T, typename Algorithm>
+    auto dispatch_compare(bool (*compare)(const T&, const T&), Algorithm algorithm)
+        -> decltype(algorithm(greater_fn{})) {
+      if (compare == &is_greater<T>) return algorithm(greater_fn{});
+      if (compare == &is_lesser<T>) return algorithm(less_fn{});
+      return algorithm(function_compare<T>{compare});
+    }
+  }
+
+  namespace detail {
+    namespace swap_lookup {
+      // Generic swap templates (this one, std::swap and phoenix::swap) are ambiguous with each
+      // other, so argument-dependent lookup below only succeeds for swaps written for a given type
+      template <typename T>
+      void swap(T&, T&) = delete;
+
+      template <unsigned N>
+      struct priority : priority<N - 1> {};
+
+      template <>
+      struct priority<0> {};
+
+      template <typename T>
+      auto dispatch(T& first, T& second, priority<2>) -> decltype(void(swap(first, second))) {
+        swap(first, second);
+      }
+
+      template <typename T>
+      auto dispatch(T& first, T& second, priority<1>) -> decltype(void(first.swap(second))) {
+        first.swap(second);
+      }
+
+      template <typename T>
+      void dispatch(T& first, T& second, priority<0>) {
+        T temporary = std::move(first);
+        first = std::move(second);
+        second = std::move(temporary);
+      }
+    }
   }
 
+  // Uses swap(T&, T&) found by argument-dependent lookup when T has its own, then T::swap member
+  // function, and moves through a temporary otherwise
   template <typename T>
   void swap(T& first, T& second) {
-    T temporary = first;
-    first = second;
-    second = temporary;
+    detail::swap_lookup::dispatch(first, second, detail::swap_lookup::priority<2>{});
   }
 
-  //TODO: Maybe use std::enable_if? Or some metaprogramming?
-  template <typename ConstIterator, typename Compare = decltype(is_greater<typename ConstIterator::const_reference>)>
-  bool is_sorted(ConstIterator begin, ConstIterator end, Compare compare = is_greater) {
-    for(auto it = begin; it + 1 != end; ++it) {
-      if (compare(*(it), *(it + 1))) {
-        return false;
+  namespace detail {
+    template <typename ConstIterator, typename Compare>
+    bool is_sorted(ConstIterator begin, ConstIterator end, Compare compare, std::false_type) {
+      if (begin == end) return true;
+      for(auto it = begin; it + 1 != end; ++it) {
+        if (compare(*(it), *(it + 1))) {
+          return false;
+        }
       }
+      return true;
     }
-    return true;
+
+    template <typename ConstIterator, typename Compare>
+    bool is_sorted(ConstIterator begin, ConstIterator end, Compare compare, std::true_type) {
+      auto* data = to_pointer(begin);
+      auto length = static_cast<std::size_t>(to_pointer(end) - data);
+      std::size_t until;
+      if (simd_search::is_sorted_until(data, length, natural_order<Compare>::value < 0, until)) return until == length;
+      return is_sorted(begin, end, compare, std::false_type{});
+    }
+
+    // Contiguous ranges of arithmetic types compared by greater_fn or less_fn use SIMD kernels
+    template <typename Iterator, typename Compare>
+    struct use_simd_search {
+      using value_type = typename std::remove_cv<
+          typename std::remove_reference<decltype(*std::declval<Iterator&>())>::type>::type;
+      static constexpr bool value = is_contiguous<Iterator>::value && simd_search::is_key<value_type>::value &&
+                                    natural_order<typename std::decay<Compare>::type>::value != 0;
+    };
+  }
+
+  template <typename ConstIterator, typename Compare = greater_fn>
+  bool is_sorted(ConstIterator begin, ConstIterator end, Compare compare = Compare{}) {
+    return detail::is_sorted(begin, end, compare,
+                             std::integral_constant<bool, detail::use_simd_search<ConstIterator, Compare>::value>{});
+  }
+
+  template <typename ConstIterator>
+  bool is_sorted(ConstIterator begin, ConstIterator end, detail::compare_pointer<ConstIterator> compare) {
+    return detail::dispatch_compare(compare, [&](auto function) { return phoenix::is_sorted(begin, end, function); });
   }
 }
 
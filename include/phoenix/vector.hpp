@@ -9,6 +9,10 @@
 #endif
 
 namespace phoenix {
+// Tag of the constructors that leave elements default-initialized
+struct uninitialized_t {};
+constexpr uninitialized_t uninitialized{};
+
 // AllocSize is capacity added to vector when reallocating at push()
 template <typename T, std::size_t AllocSize = 16>
 class vector {
@@ -25,16 +29,18 @@ public:
   class iterator {
   public:
     using self = iterator;
-    static constexpr auto iterator_type = iterator_flag::random_access;
+    static constexpr auto iterator_type = iterator_flag::contiguous;
 
-    using value_type = value_type;
-    using reference = reference;
+    using iterator_category = detail::std_category<iterator_type>;
+    using value_type = T;
+    using reference = T&;
     using const_reference = const T&;
-    using pointer = pointer;
+    using pointer = T*;
     using const_pointer = const T*;
     using difference_type = std::ptrdiff_t;
     using size_type = std::size_t;
 
+    iterator() : _ptr{nullptr} {}
     explicit iterator(pointer e) : _ptr{e} {}
 
     self& operator++() {
@@ -59,14 +65,18 @@ public:
       return t;
     }
 
-    reference operator*() {
+    reference operator*() const {
       return *_ptr;
     }
 
-    pointer operator->() {
+    pointer operator->() const {
       return _ptr;
     }
 
+    reference operator[](difference_type x) const {
+      return _ptr[x];
+    }
+
     bool operator==(const self& other) const {
       return _ptr == other._ptr;
     }
@@ -75,14 +85,27 @@ public:
       return _ptr != other._ptr;
     }
 
-    self operator+(difference_type x) {
+    bool operator<(const self& other) const { return _ptr < other._ptr; }
+    bool operator>(const self& other) const { return _ptr > other._ptr; }
+    bool operator<=(const self& other) const { return _ptr <= other._ptr; }
+    bool operator>=(const self& other) const { return _ptr >= other._ptr; }
+
+    self operator+(difference_type x) const {
       return self(_ptr + x);
     }
 
-    self operator-(difference_type x) {
+    self operator-(difference_type x) const {
       return self(_ptr - x);
     }
 
+    difference_type operator-(const self& other) const {
+      return _ptr - other._ptr;
+    }
+
+    friend self operator+(difference_type x, const self& it) {
+      return it + x;
+    }
+
     self& operator+=(difference_type x) {
       _ptr += x;
       return *this;
@@ -104,15 +127,22 @@ public:
   class const_iterator {
   public:
     using self = const_iterator;
-    static constexpr auto iterator_type = iterator_flag::random_access;
+    static constexpr auto iterator_type = iterator_flag::contiguous;
 
-    using value_type = value_type;
-    using const_reference = const_reference;
-    using const_pointer = const_pointer;
+    using iterator_category = detail::std_category<iterator_type>;
+    using value_type = T;
+    using reference = const T&;
+    using const_reference = const T&;
+    using pointer = const T*;
+    using const_pointer = const T*;
     using difference_type = std::ptrdiff_t;
     using size_type = std::size_t;
 
-    explicit const_iterator(const_pointer e) : _ptr{e} {}
+    const_iterator() : _ptr{nullptr} {}
+    explicit const_iterator(pointer e) : _ptr{e} {}
+
+    // Iterators can be used where const iterators are expected
+    const_iterator(const iterator& it) : _ptr{detail::to_pointer(it)} {}
 
     self& operator++() {
       _ptr++;
@@ -136,14 +166,18 @@ public:
       return t;
     }
 
-    const_reference operator*() const {
+    reference operator*() const {
       return *_ptr;
     }
 
-    const_pointer operator->() const {
+    pointer operator->() const {
       return _ptr;
     }
 
+    reference operator[](difference_type x) const {
+      return _ptr[x];
+    }
+
     bool operator==(const self& other) const {
       return _ptr == other._ptr;
     }
@@ -152,14 +186,27 @@ public:
       return _ptr != other._ptr;
     }
 
-    self operator+(difference_type x) {
+    bool operator<(const self& other) const { return _ptr < other._ptr; }
+    bool operator>(const self& other) const { return _ptr > other._ptr; }
+    bool operator<=(const self& other) const { return _ptr <= other._ptr; }
+    bool operator>=(const self& other) const { return _ptr >= other._ptr; }
+
+    self operator+(difference_type x) const {
       return self(_ptr + x);
     }
 
-    self operator-(difference_type x) {
+    self operator-(difference_type x) const {
       return self(_ptr - x);
     }
 
+    difference_type operator-(const self& other) const {
+      return _ptr - other._ptr;
+    }
+
+    friend self operator+(difference_type x, const self& it) {
+      return it + x;
+    }
+
     self& operator+=(difference_type x) {
       _ptr += x;
       return *this;
@@ -195,29 +242,25 @@ public:
     }
   }
 
+  // Elements of trivial types keep indeterminate values and the memory isn't touched, so that
+  // pages of a large buffer get placed by the threads that write them first (see numa.hpp)
+  vector(size_type size, uninitialized_t)
+      : _data{new T[size]}, _size{size}, _capacity{size} {}
+
   vector(const std::initializer_list<value_type>& data)
       : _data{new T[data.size()]}, _size{data.size()}, _capacity{data.size()} {
-    auto* i = _data;
-    for (const auto &e : data) {
-      *(i++) = e;
-    }
+    detail::copy(data.begin(), data.end(), _data);
   }
 
   explicit vector(const std::vector<value_type>& data)
       : _data{new T[data.size()]}, _size{data.size()}, _capacity{data.size()} {
-    auto* i = _data;
-    for (const auto &e : data) {
-      *(i++) = e;
-    }
+    detail::copy(data.data(), data.data() + data.size(), _data);
   }
 
   // Rule of five
   vector(const vector<value_type, AllocSize>& other)
       : _data{new T[other._size]}, _size{other._size}, _capacity{other._size} {
-    auto* i = _data;
-    for (auto* j = other._data; j != other._data + other._size; j++) {
-      *(i++) = *j;
-    }
+    detail::copy(other._data, other._data + other._size, _data);
   }
 
   vector(vector<value_type, AllocSize>&& other) noexcept
@@ -228,15 +271,20 @@ public:
   }
 
   vector<value_type, AllocSize>& operator=(const vector<value_type, AllocSize>& other) {
-    reserve(other._size);
-    auto* i = begin();
-    for (const auto &x : other) {
-      *(i++) = x;
+    if (this == &other) return *this;
+    if (_capacity < other._size) {
+      delete[] _data;
+      _data = new T[other._size];
+      _capacity = other._size;
     }
+    detail::copy(other._data, other._data + other._size, _data);
+    _size = other._size;
     return *this;
   }
 
   vector<value_type, AllocSize>& operator=(vector<value_type, AllocSize>&& other) noexcept {
+    if (this == &other) return *this;
+    delete[] _data;
     _data = other._data;
     _size = other._size;
     _capacity = other._capacity;
@@ -301,17 +349,14 @@ public:
 
   void reserve(size_type new_size) {
     // In case when actual capacity is greater or equal
-    if (_size >= new_size)
+    if (_capacity >= new_size)
       return;
 
     // Allocate new block
     auto* new_data = new T[new_size];
 
     // Copy the data to new block
-    auto* new_data_it = new_data;
-    for (auto* x = _data; x != (_data + _size); ++x) {
-      *(new_data_it++) = *x;
-    }
+    detail::copy(_data, _data + _size, new_data);
 
     // Deallocate old block, set new as default one, increase capacity
     delete[] _data;
@@ -324,6 +369,21 @@ public:
     _size = new_size;
   }
 
+  // Exchanges buffers, elements are neither copied nor moved
+  void swap(vector<value_type, AllocSize>& other) noexcept {
+    auto* data = _data;
+    _data = other._data;
+    other._data = data;
+
+    auto size = _size;
+    _size = other._size;
+    other._size = size;
+
+    auto capacity = _capacity;
+    _capacity = other._capacity;
+    other._capacity = capacity;
+  }
+
   #ifndef PHOSTDLIB_DONT_SUPPORT_PRINT
   std::ostream& print(std::ostream& os, const char* separator = ", ") const {
     for (auto i = cbegin(); i != cend(); i++)
@@ -344,6 +404,16 @@ private:
   pointer _data;
   size_type _size, _capacity;
 };
+
+namespace detail {
+  // Capacity doubles, so that repeated insertions don't reallocate every AllocSize elements
+  template <typename T, std::size_t AllocSize>
+  void grow(vector<T, AllocSize>& v, std::size_t needed) {
+    if (needed <= v.capacity()) return;
+    std::size_t capacity = v.capacity() * 2;
+    v.reserve(capacity > needed ? capacity : needed);
+  }
+}
 } // namespace phoenix
 
 #endif
@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+#include <phoenix/algorithm.hpp>
+#include <phoenix/array.hpp>
+#include <phoenix/cpu.hpp>
+#include <phoenix/test.hpp>
+#include <phoenix/vector.hpp>
+
+const phoenix::simd_level levels[] = {phoenix::simd_level::scalar, phoenix::simd_level::sse2,
+                                      phoenix::simd_level::avx2};
+const std::size_t sizes[] = {0, 1, 3, 7, 16, 33, 100, 1001};
+
+template <typename T>
+phoenix::vector<T> random_values(std::size_t length, unsigned seed) {
+  std::mt19937_64 gen(seed);
+  phoenix::vector<T> v(length);
+  // Small range, so that values repeat
+  for (std::size_t i = 0; i < length; i++) v[i] = static_cast<T>(gen() % 50) - static_cast<T>(std::is_signed<T>::value ? 25 : 0);
+  return v;
+}
+
+template <typename T>
+std::vector<T> to_std(const phoenix::vector<T>& v) {
+  return std::vector<T>(v.data(), v.data() + v.size());
+}
+
+template <typename T>
+void check_searches(const char* type) {
+  for (auto level : levels) {
+    phoenix::cpu::set_level_limit(level);
+    for (auto size : sizes) {
+      std::string name = std::string(type) + ", " + std::to_string(size) + " elements, level " +
+                         std::to_string(static_cast<unsigned>(level));
+      auto v = random_values<T>(size, static_cast<unsigned>(size));
+      auto s = to_std(v);
+
+      for (T value : {T(0), T(7), T(49), T(100)}) {
+        auto found = phoenix::find(v.begin(), v.end(), value);
+        auto expected = std::find(s.begin(), s.end(), value);
+        phoenix::test::eq(static_cast<std::size_t>(found.operator->() - v.data()),
+                          static_cast<std::size_t>(expected - s.begin()), "find: " + name);
+        phoenix::test::eq(phoenix::count(v.begin(), v.end(), value),
+                          static_cast<std::size_t>(std::count(s.begin(), s.end(), value)), "count: " + name);
+      }
+
+      if (size > 0) {
+        auto min = phoenix::min_element(v.begin(), v.end());
+        auto max = phoenix::max_element(v.begin(), v.end());
+        auto minmax = phoenix::minmax_element(v.cbegin(), v.cend());
+        auto expected_min = static_cast<std::size_t>(std::min_element(s.begin(), s.end()) - s.begin());
+        // phoenix returns the first biggest element
+        auto expected_max = static_cast<std::size_t>(
+            std::min_element(s.begin(), s.end(), [](T a, T b) { return a > b; }) - s.begin());
+        phoenix::test::eq(static_cast<std::size_t>(min.operator->() - v.data()), expected_min, "min_element: " + name);
+        phoenix::test::eq(static_cast<std::size_t>(max.operator->() - v.data()), expected_max, "max_element: " + name);
+        phoenix::test::eq(static_cast<std::size_t>(minmax.first.operator->() - v.data()), expected_min,
+                          "minmax_element: " + name);
+        phoenix::test::eq(static_cast<std::size_t>(minmax.second.operator->() - v.data()), expected_max,
+                          "minmax_element: " + name);
+        // Descending order swaps the meaning
+        auto descending_min = phoenix::min_element(v.begin(), v.end(), phoenix::less_fn{});
+        phoenix::test::eq(static_cast<std::size_t>(descending_min.operator->() - v.data()), expected_max,
+                          "min_element descending: " + name);
+      } else {
+        phoenix::test::eq(phoenix::min_element(v.begin(), v.end()), v.end());
+      }
+
+      auto copy = v;
+      phoenix::test::eq(phoenix::equal(v.begin(), v.end(), copy.begin()), true, "equal: " + name);
+      if (size > 0) {
+        copy[size - 1] = static_cast<T>(copy[size - 1] + 1);
+        phoenix::test::eq(phoenix::equal(v.begin(), v.end(), copy.begin()), false, "equal: " + name);
+      }
+
+      phoenix::test::eq(phoenix::is_sorted(v.begin(), v.end()), std::is_sorted(s.begin(), s.end()),
+                        "is_sorted: " + name);
+      std::sort(s.begin(), s.end());
+      phoenix::vector<T> sorted(s);
+      phoenix::test::eq(phoenix::is_sorted(sorted.begin(), sorted.end()), true, "is_sorted: " + name);
+      phoenix::test::eq(phoenix::is_sorted(sorted.begin(), sorted.end(), phoenix::less_fn{}),
+                        size < 2 || s.front() == s.back(), "is_sorted descending: " + name);
+      if (size > 10) {
+        sorted[size / 2] = static_cast<T>(sorted[size - 1] + 1);
+        phoenix::test::eq(phoenix::is_sorted(sorted.begin(), sorted.end()), false, "is_sorted: " + name);
+      }
+    }
+  }
+  phoenix::cpu::set_level_limit(phoenix::simd_level::avx512);
+}
+
+template <typename T>
+void check_integer_sum(const char* type) {
+  for (auto level : levels) {
+    phoenix::cpu::set_level_limit(level);
+    for (auto size : sizes) {
+      auto v = random_values<T>(size * 10, static_cast<unsigned>(size));
+      auto s = to_std(v);
+      phoenix::test::eq(phoenix::accumulate(v.begin(), v.end(), T(3)), std::accumulate(s.begin(), s.end(), T(3)),
+                        std::string("accumulate: ") + type);
+    }
+  }
+  phoenix::cpu::set_level_limit(phoenix::simd_level::avx512);
+}
+
+void integers() {
+  check_searches<std::int8_t>("int8_t");
+  check_searches<std::uint8_t>("uint8_t");
+  check_searches<std::int16_t>("int16_t");
+  check_searches<std::uint16_t>("uint16_t");
+  check_searches<std::int32_t>("int32_t");
+  check_searches<std::uint32_t>("uint32_t");
+  check_searches<std::int64_t>("int64_t");
+  check_searches<std::uint64_t>("uint64_t");
+  check_searches<char>("char");
+
+  check_integer_sum<std::int8_t>("int8_t");
+  check_integer_sum<std::uint16_t>("uint16_t");
+  check_integer_sum<std::int32_t>("int32_t");
+  check_integer_sum<std::uint64_t>("uint64_t");
+
+  // Values which differ only in the sign bit or in one half of a 64-bit lane
+  phoenix::vector<std::uint64_t> wide{1ull << 63, 1, 1ull << 32, 0xFFFFFFFFull, 5, 0, 1ull << 63 | 1};
+  phoenix::test::eq(*phoenix::max_element(wide.begin(), wide.end()), 1ull << 63 | 1);
+  phoenix::test::eq(*phoenix::min_element(wide.begin(), wide.end()), 0ull);
+  phoenix::test::eq(phoenix::find(wide.begin(), wide.end(), std::uint64_t(1ull << 32)), wide.begin() + 2);
+}
+
+void floating_point() {
+  check_searches<float>("float");
+  check_searches<double>("double");
+
+  for (auto level : levels) {
+    phoenix::cpu::set_level_limit(level);
+    auto v = random_values<double>(1000, 1);
+    auto s = to_std(v);
+    double sum = phoenix::accumulate(v.begin(), v.end(), 0.5);
+    phoenix::test::eq(std::fabs(sum - std::accumulate(s.begin(), s.end(), 0.5)) < 1e-9, true, "accumulate: double");
+
+    // NaN makes vector min/max disagree with comparisons, the generic loop has to decide
+    phoenix::vector<float> nan(40, 1.f);
+    nan[0] = std::numeric_limits<float>::quiet_NaN();
+    nan[20] = -1.f;
+    auto n = to_std(nan);
+    auto expected = std::min_element(n.begin(), n.end(), [](float a, float b) { return b > a; });
+    phoenix::test::eq(phoenix::min_element(nan.begin(), nan.end()).operator->() - nan.data(), expected - n.begin(),
+                      "min_element with NaN");
+    phoenix::test::eq(phoenix::find(nan.begin(), nan.end(), nan[0]), nan.end(), "NaN was found");
+    phoenix::test::eq(phoenix::equal(nan.begin(), nan.end(), nan.begin()), false, "NaN is equal to itself");
+  }
+  phoenix::cpu::set_level_limit(phoenix::simd_level::avx512);
+}
+
+// Floating-point sums keep the same partial sums on every level, so they have to match exactly
+template <typename T>
+void reproducible_sum(const char* type) {
+  for (std::size_t length : {0u, 7u, 31u, 64u, 129u, 1000u, 4099u}) {
+    // Fractions of different magnitudes, so that the order of additions changes the rounding
+    std::mt19937_64 gen(length);
+    phoenix::vector<T> v(length);
+    for (std::size_t i = 0; i < length; i++) v[i] = static_cast<T>((gen() % 1000000) / 7.0 * (i % 3 == 0 ? 1e-4 : 1.0));
+    T expected{};
+    for (auto level : levels) {
+      phoenix::cpu::set_level_limit(level);
+      T sum = phoenix::accumulate(v.begin(), v.end(), T(0.25));
+      if (level == levels[0]) expected = sum;
+      phoenix::test::eq(sum, expected, std::string("accumulate differs between levels: ") + type);
+    }
+  }
+  phoenix::cpu::set_level_limit(phoenix::simd_level::avx512);
+}
+
+void reproducible() {
+  reproducible_sum<float>("float");
+  reproducible_sum<double>("double");
+}
+
+struct point {
+  int x, y;
+  bool operator==(const point& other) const { return x == other.x && y == other.y; }
+  bool operator>(const point& other) const { return x > other.x; }
+  point operator+(const point& other) const { return point{x + other.x, y + other.y}; }
+};
+
+void generic() {
+  phoenix::array<point, 4> points{point{3, 0}, point{1, 1}, point{4, 2}, point{1, 3}};
+  phoenix::test::eq(phoenix::find(points.begin(), points.end(), point{4, 2}) == points.begin() + 2, true);
+  phoenix::test::eq(phoenix::count(points.begin(), points.end(), point{1, 1}), 1u);
+  phoenix::test::eq(phoenix::min_element(points.begin(), points.end())->y, 1, "min_element should be the first");
+  phoenix::test::eq(phoenix::max_element(points.begin(), points.end())->y, 2);
+  phoenix::test::eq(phoenix::accumulate(points.begin(), points.end(), point{0, 0}).x, 9);
+  phoenix::test::eq(phoenix::accumulate(points.begin(), points.end(), 1,
+                                        [](int product, const point& p) { return product * p.x; }), 12);
+  phoenix::test::eq(phoenix::equal(points.begin(), points.end(), points.begin()), true);
+  phoenix::test::eq(phoenix::equal(points.begin(), points.end(), points.begin(),
+                                   [](const point& a, const point& b) { return a.x == b.x + 1; }), false);
+
+  // Different value type than the elements - generic path
+  phoenix::vector<int> v{1, 2, 3};
+  phoenix::test::eq(phoenix::find(v.begin(), v.end(), 2L) == v.begin() + 1, true);
+  phoenix::test::eq(phoenix::accumulate(v.begin(), v.end(), 0.5), 6.5);
+}
+
+int main() {
+  phoenix::run_test(integers, "Integers");
+  phoenix::run_test(floating_point, "Floating point");
+  phoenix::run_test(reproducible, "Reproducible sums");
+  phoenix::run_test(generic, "Generic");
+}
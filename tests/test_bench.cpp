@@ -0,0 +1,134 @@
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <phoenix/bench.hpp>
+#include <phoenix/test.hpp>
+
+phoenix::bench_options quick(std::ostream& output) {
+  phoenix::bench_options options;
+  options.samples = 5;
+  options.sample_seconds = 0.001;
+  options.warmup_seconds = 0.001;
+  options.output = &output;
+  return options;
+}
+
+void statistics() {
+  std::stringstream output;
+  std::size_t calls = 0;
+  auto result = phoenix::bench("count", quick(output)).items(10).bytes(40).run([&calls]() { calls++; });
+
+  phoenix::test::eq(result.name, std::string("count"), "name");
+  phoenix::test::eq(result.samples, std::size_t{5}, "samples");
+  phoenix::test::gt(result.iterations, std::size_t{1000}, "short functions are repeated");
+  phoenix::test::geq(calls, result.iterations * result.samples, "every iteration calls the function");
+  phoenix::test::leq(result.min, result.median, "min below median");
+  phoenix::test::leq(result.median, result.p99, "median below p99");
+  phoenix::test::geq(result.stddev, 0.0, "stddev");
+  phoenix::test::eq(std::abs(result.bytes_per_second - 4 * result.items_per_second) < 1e-6 * result.bytes_per_second,
+                    true, "throughput from the median");
+
+  std::string line = output.str();
+  phoenix::test::eq(line.find("count: ") == 0 && line.find("items/s") != std::string::npos &&
+                    line.find("B/s") != std::string::npos, true, "printed result");
+}
+
+void setup() {
+  std::stringstream output;
+  int value = 0, sum = 0, calls = 0;
+  // Only the function is timed
+  auto result = phoenix::bench("setup", quick(output)).run(
+      [&value]() {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        value = 1;
+      },
+      [&value, &sum, &calls]() {
+        sum += value;
+        value = 0;
+        calls++;
+      });
+  phoenix::test::lt(result.median, 100e-6, "setup isn't timed");
+  phoenix::test::eq(sum, calls, "setup runs before each call");
+
+  auto slow = phoenix::bench("sleep", quick(output)).run([]() {
+    std::this_thread::sleep_for(std::chrono::microseconds(500));
+  });
+  phoenix::test::geq(slow.min, 500e-6, "timed");
+}
+
+void sizes() {
+  std::stringstream output;
+  auto results = phoenix::run_bench("sum", {16, 1024}, [](phoenix::bench& b, std::size_t size) {
+    std::vector<int> values(size, 1);
+    return b.items(size).run([&values]() {
+      int total = 0;
+      for (int value : values) total += value;
+      phoenix::do_not_optimize(total);
+    });
+  }, quick(output));
+  phoenix::test::eq(results.size(), std::size_t{2}, "a result per size");
+  phoenix::test::eq(results[1].name, std::string("sum/1024"), "sized name");
+  phoenix::test::gt(results[1].median, results[0].median, "larger input takes longer");
+}
+
+void counters() {
+  // Counters may be unavailable (other systems, containers, perf_event_paranoid), which must not fail benchmarks
+  phoenix::perf_counters events;
+  phoenix::test::eq(events.available() || !events.error().empty(), true, "unavailable counters are explained");
+
+  std::stringstream output;
+  auto options = quick(output);
+  options.counters = true;
+  std::vector<int> values(4096, 1);
+  auto result = phoenix::bench("counted", options).run([&values]() {
+    int total = 0;
+    for (int value : values) total += value;
+    phoenix::do_not_optimize(total);
+  });
+  phoenix::test::gt(result.median, 0.0, "timed with counters");
+  for (std::size_t e = 0; e < phoenix::perf_counters::event_count; e++) {
+    auto event = static_cast<phoenix::perf_counters::event>(e);
+    if (!events.available(event)) phoenix::test::lt(result.counter(event), 0.0, phoenix::perf_counters::name(event));
+  }
+  if (events.available(phoenix::perf_counters::instructions)) {
+    phoenix::test::gt(result.counter(phoenix::perf_counters::instructions), 4096.0, "an instruction per element");
+    phoenix::test::neq(output.str().find("instructions"), std::string::npos, "printed counters");
+  }
+
+  auto uncounted = phoenix::bench("uncounted", quick(output)).run([]() {});
+  phoenix::test::eq(uncounted.counter(phoenix::perf_counters::cycles) < 0 && uncounted.ipc() < 0, true,
+                    "off by default");
+}
+
+// Values passed through do_not_optimize keep what the measured function stored in them
+void barriers() {
+  std::stringstream output;
+  std::vector<double> reals(100, 1.0);
+  std::vector<float> singles(100, 1.0f);
+  double real = 0;
+  float single = 0;
+  long integer = 0;
+  phoenix::bench("barriers", quick(output)).run([&]() {
+    real = std::accumulate(reals.begin(), reals.end(), 0.5);
+    single = std::accumulate(singles.begin(), singles.end(), 0.5f);
+    integer = static_cast<long>(reals.size());
+    phoenix::do_not_optimize(real);
+    phoenix::do_not_optimize(single);
+    phoenix::do_not_optimize(integer);
+  });
+  phoenix::test::eq(real, 100.5, "double");
+  phoenix::test::eq(single, 100.5f, "float");
+  phoenix::test::eq(integer, 100l, "integer");
+}
+
+int main() {
+  phoenix::run_test(statistics, "Statistics");
+  phoenix::run_test(setup, "Setup");
+  phoenix::run_test(sizes, "Sizes");
+  phoenix::run_test(counters, "Counters");
+  phoenix::run_test(barriers, "Barriers");
+}
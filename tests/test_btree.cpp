@@ -0,0 +1,206 @@
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <phoenix/btree.hpp>
+#include <phoenix/test.hpp>
+#include <phoenix/utility.hpp>
+
+// Counts live allocations, so that tests can check nodes go through the allocator and are freed
+std::size_t live_nodes = 0;
+
+template <typename T>
+struct counting_allocator {
+  using value_type = T;
+
+  counting_allocator() = default;
+  template <typename U>
+  counting_allocator(const counting_allocator<U>&) {}
+
+  T* allocate(std::size_t count) {
+    live_nodes += count;
+    return std::allocator<T>().allocate(count);
+  }
+
+  void deallocate(T* pointer, std::size_t count) {
+    live_nodes -= count;
+    std::allocator<T>().deallocate(pointer, count);
+  }
+
+  template <typename U>
+  bool operator==(const counting_allocator<U>&) const { return true; }
+  template <typename U>
+  bool operator!=(const counting_allocator<U>&) const { return false; }
+};
+
+// 64-byte nodes hold few keys, so that small tests build deep trees
+using small_map = phoenix::btree_map<int, int, phoenix::greater_fn, counting_allocator<int>, 64>;
+
+void check_same(const small_map& map, const std::map<int, int>& expected, const std::string& message) {
+  phoenix::test::eq(map.size(), expected.size(), message + ": size");
+  auto it = map.begin();
+  for (const auto& element : expected) {
+    phoenix::test::eq(it.key(), element.first, message + ": key");
+    phoenix::test::eq(it.value(), element.second, message + ": value");
+    ++it;
+  }
+  phoenix::test::eq(it == map.end(), true, message + ": end");
+
+  // Walking back from the end goes over the same elements in reverse
+  auto back = map.end();
+  for (auto element = expected.rbegin(); element != expected.rend(); ++element) {
+    --back;
+    phoenix::test::eq(back.key(), element->first, message + ": reverse key");
+  }
+}
+
+void random_operations() {
+  {
+    std::mt19937 gen(4);
+    small_map map;
+    std::map<int, int> expected;
+    for (int i = 0; i < 30000; i++) {
+      int key = static_cast<int>(gen() % 4000);
+      switch (gen() % 4) {
+        case 0:
+          phoenix::test::eq(map.erase(key), expected.erase(key), "Erase " + std::to_string(key));
+          break;
+        case 1:
+          map.insert_or_assign(key, i);
+          expected[key] = i;
+          break;
+        default: {
+          auto result = map.insert(key, i);
+          bool inserted = expected.insert({key, i}).second;
+          phoenix::test::eq(result.second, inserted, "Insertion result");
+          phoenix::test::eq(result.first.key(), key, "Insertion position");
+        }
+      }
+      if (i % 5000 == 0) check_same(map, expected, "Step " + std::to_string(i));
+    }
+    check_same(map, expected, "Random operations");
+    phoenix::test::neq(map.height(), 0u, "Tree has inner levels");
+
+    for (int key = -1; key <= 4001; key++) {
+      phoenix::test::eq(map.contains(key), expected.count(key) == 1, "contains " + std::to_string(key));
+      auto lower = map.lower_bound(key);
+      auto expected_lower = expected.lower_bound(key);
+      phoenix::test::eq(lower == map.end(), expected_lower == expected.end(), "lower_bound end");
+      if (expected_lower != expected.end()) phoenix::test::eq(lower.key(), expected_lower->first, "lower_bound");
+      auto upper = map.upper_bound(key);
+      auto expected_upper = expected.upper_bound(key);
+      phoenix::test::eq(upper == map.end(), expected_upper == expected.end(), "upper_bound end");
+      if (expected_upper != expected.end()) phoenix::test::eq(upper.key(), expected_upper->first, "upper_bound");
+    }
+
+    for (int key = 0; key < 4000; key++) map.erase(key);
+    phoenix::test::eq(map.empty(), true, "Map is empty after erasing everything");
+    phoenix::test::eq(map.begin() == map.end(), true, "Empty map has no elements");
+    phoenix::test::eq(live_nodes, 0u, "Erasing everything frees all nodes");
+    map[7] = 1;
+    phoenix::test::eq(map.at(7), 1, "Map is usable after being emptied");
+  }
+  phoenix::test::eq(live_nodes, 0u, "Destructor frees all nodes");
+}
+
+void bulk_load() {
+  {
+    std::vector<std::pair<int, int>> sorted;
+    std::map<int, int> expected;
+    for (int i = 0; i < 10000; i++) {
+      sorted.push_back({i * 3, i});
+      // Repeated keys keep the first value
+      if (i % 10 == 0) sorted.push_back({i * 3, -1});
+      expected.insert({i * 3, i});
+    }
+    small_map map;
+    map[5] = 5;
+    map.assign_sorted(sorted.begin(), sorted.end());
+    check_same(map, expected, "Bulk load");
+
+    for (int i = 0; i < 3000; i++) {
+      map.insert(i * 10 + 1, i);
+      expected.insert({i * 10 + 1, i});
+    }
+    check_same(map, expected, "Insertions after bulk load");
+
+    small_map copy(map), assigned;
+    assigned = copy;
+    small_map moved(std::move(map));
+    check_same(copy, expected, "Copy");
+    check_same(assigned, expected, "Assignment");
+    check_same(moved, expected, "Move");
+    phoenix::test::eq(map.size(), 0u, "Moved-from map is empty");
+
+    std::vector<std::pair<int, int>> unsorted = {{1, 1}, {3, 3}, {2, 2}};
+    bool thrown = false;
+    try {
+      assigned.assign_sorted(unsorted.begin(), unsorted.end());
+    } catch (const std::invalid_argument&) {
+      thrown = true;
+    }
+    phoenix::test::eq(thrown, true, "Unsorted bulk load is rejected");
+    phoenix::test::eq(assigned.empty(), true, "Rejected bulk load leaves an empty map");
+  }
+  phoenix::test::eq(live_nodes, 0u, "All nodes are freed");
+}
+
+void sets() {
+  std::mt19937 gen(5);
+  phoenix::btree_set<long> set;
+  std::set<long> expected;
+  for (int i = 0; i < 20000; i++) {
+    long key = static_cast<long>(gen() % 10000);
+    if (gen() % 3 == 0) {
+      phoenix::test::eq(set.erase(key), expected.erase(key), "Erase");
+    } else {
+      phoenix::test::eq(set.insert(key).second, expected.insert(key).second, "Insert");
+    }
+  }
+  phoenix::test::eq(set.size(), expected.size(), "Size");
+  std::vector<long> keys;
+  for (auto key : set) keys.push_back(key);
+  phoenix::test::eq(keys == std::vector<long>(expected.begin(), expected.end()), true, "Keys in order");
+
+  // Range scan over linked leaves
+  long sum = 0, expected_sum = 0;
+  for (auto it = set.lower_bound(2500L); it != set.end() && *it < 7500; ++it) sum += *it;
+  for (auto it = expected.lower_bound(2500L); it != expected.end() && *it < 7500; ++it) expected_sum += *it;
+  phoenix::test::eq(sum, expected_sum, "Range scan");
+
+  phoenix::btree_set<long> loaded;
+  loaded.assign_sorted(expected.begin(), expected.end());
+  std::vector<long> loaded_keys;
+  for (auto key : loaded) loaded_keys.push_back(key);
+  phoenix::test::eq(loaded_keys == keys, true, "Bulk loaded set");
+
+  phoenix::btree_set<int, phoenix::less_fn> descending = {1, 5, 3};
+  phoenix::test::eq(*descending.begin(), 5, "Descending order");
+}
+
+void heterogeneous_lookup() {
+  phoenix::btree_map<std::string, int> map = {{"one", 1}, {"two", 2}, {"three", 3}};
+  phoenix::test::eq(map.at("two"), 2, "Lookup with a literal");
+  phoenix::test::eq(map.contains("four"), false, "Missing literal");
+  phoenix::test::eq(map.lower_bound("p").key(), std::string("three"), "lower_bound with a literal");
+  phoenix::test::eq(map.erase("one"), 1u, "Erase with a literal");
+  bool thrown = false;
+  try {
+    map.at("one");
+  } catch (const std::out_of_range&) {
+    thrown = true;
+  }
+  phoenix::test::eq(thrown, true, "at throws for missing keys");
+}
+
+int main() {
+  phoenix::run_test(random_operations, "btree_map random operations");
+  phoenix::run_test(bulk_load, "btree_map bulk load");
+  phoenix::run_test(sets, "btree_set");
+  phoenix::run_test(heterogeneous_lookup, "btree_map heterogeneous lookup");
+}
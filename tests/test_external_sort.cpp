@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+#include <phoenix/external_sort.hpp>
+#include <phoenix/test.hpp>
+
+// Live and peak bytes allocated with operator new, every block starts with its size
+std::atomic<std::size_t> live_bytes{0}, peak_bytes{0};
+
+void* operator new(std::size_t size) {
+  auto* block = static_cast<std::size_t*>(std::malloc(size + sizeof(std::max_align_t)));
+  if (block == nullptr) throw std::bad_alloc();
+  *block = size;
+  std::size_t live = live_bytes += size;
+  for (std::size_t peak = peak_bytes; live > peak && !peak_bytes.compare_exchange_weak(peak, live);) {
+  }
+  return reinterpret_cast<char*>(block) + sizeof(std::max_align_t);
+}
+
+void operator delete(void* pointer) noexcept {
+  if (pointer == nullptr) return;
+  auto* block = reinterpret_cast<std::size_t*>(static_cast<char*>(pointer) - sizeof(std::max_align_t));
+  live_bytes -= *block;
+  std::free(block);
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete[](void* pointer) noexcept { operator delete(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { operator delete(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { operator delete(pointer); }
+
+struct record {
+  std::uint32_t key;
+  std::uint32_t id;
+
+  bool operator>(const record& other) const { return key > other.key; }
+};
+
+const std::string input_path = "test_external_sort_input.bin";
+const std::string output_path = "test_external_sort_output.bin";
+
+std::vector<record> write_input(std::size_t count) {
+  std::mt19937 gen(static_cast<std::mt19937::result_type>(count));
+  std::vector<record> records(count);
+  for (std::size_t i = 0; i < count; i++) records[i] = record{static_cast<std::uint32_t>(gen() % 1000), static_cast<std::uint32_t>(i)};
+
+  std::FILE* file = std::fopen(input_path.c_str(), "wb");
+  std::fwrite(records.data(), sizeof(record), count, file);
+  std::fclose(file);
+  return records;
+}
+
+std::vector<record> read_output() {
+  std::vector<record> records(1 << 20);
+  std::FILE* file = std::fopen(output_path.c_str(), "rb");
+  std::size_t count = std::fread(records.data(), sizeof(record), records.size(), file);
+  std::fclose(file);
+  records.resize(count);
+  return records;
+}
+
+std::vector<std::uint32_t> read_output_keys() {
+  std::vector<std::uint32_t> keys;
+  for (const auto& r : read_output()) keys.push_back(r.key);
+  return keys;
+}
+
+phoenix::external_sort_config make_config(std::size_t budget_records, std::size_t fan_in) {
+  phoenix::external_sort_config config;
+  config.memory_budget = budget_records * sizeof(record);
+  config.fan_in = fan_in;
+  config.io_buffer_size = 4096;
+  config.temp_directory = ".";
+  return config;
+}
+
+void check_sort(std::size_t count, std::size_t budget_records, std::size_t fan_in) {
+  auto records = write_input(count);
+  phoenix::external_sort<record>(input_path, output_path, make_config(budget_records, fan_in));
+
+  std::string description = std::to_string(count) + " records, budget " + std::to_string(budget_records) +
+                            ", fan-in " + std::to_string(fan_in);
+  auto output = read_output();
+  phoenix::test::eq(output.size(), count, "External sort lost records, " + description);
+
+  // Every id has to come out exactly once, still carrying its own key
+  std::vector<bool> seen(count, false);
+  for (std::size_t i = 0; i < output.size(); i++) {
+    if (i > 0) phoenix::test::leq(output[i - 1].key, output[i].key, "Output isn't sorted, " + description);
+    phoenix::test::lt(output[i].id, static_cast<std::uint32_t>(count), "Corrupted payload, " + description);
+    phoenix::test::eq(static_cast<bool>(seen[output[i].id]), false, "Duplicated record, " + description);
+    seen[output[i].id] = true;
+    phoenix::test::eq(output[i].key, records[output[i].id].key, "Payload separated from its key, " + description);
+  }
+}
+
+void check_stable(std::size_t count, std::size_t budget_records, std::size_t fan_in) {
+  auto records = write_input(count);
+  auto config = make_config(budget_records, fan_in);
+  config.stable = true;
+  phoenix::external_sort<record>(input_path, output_path, config);
+
+  std::stable_sort(records.begin(), records.end(), [](const record& a, const record& b) { return a.key < b.key; });
+  auto output = read_output();
+  phoenix::test::eq(output.size(), count);
+  for (std::size_t i = 0; i < count; i++) {
+    phoenix::test::eq(output[i].key, records[i].key, "Stable external sort key differs");
+    phoenix::test::eq(output[i].id, records[i].id, "Stable external sort reordered equal keys");
+  }
+}
+
+// Index buffers of stable runs are a part of the budget, not added to it
+void stable_budget() {
+  const std::size_t budget_records = 20000;
+  for (std::size_t count : {10000u, 19999u, 60000u}) {
+    write_input(count);
+    auto config = make_config(budget_records, 64);
+    config.io_buffer_size = 1 << 20;
+    config.stable = true;
+    std::size_t before = live_bytes;
+    peak_bytes = before;
+    phoenix::external_sort<record>(input_path, output_path, config);
+    // Paths of temporary files and states of background reads come on top of the buffers
+    phoenix::test::leq(peak_bytes - before, config.memory_budget + 4096,
+                       "Stable sort of " + std::to_string(count) + " records exceeded the memory budget");
+  }
+}
+
+void single_run() {
+  check_sort(0, 1000, 4);
+  check_sort(1, 1000, 4);
+  check_sort(999, 1000, 4);
+}
+
+void single_merge() {
+  check_sort(10000, 1000, 64);
+}
+
+void multi_pass_merge() {
+  check_sort(10000, 100, 2);
+  check_sort(12345, 100, 3);
+}
+
+void stable() {
+  check_stable(999, 1000, 4);
+  check_stable(10000, 1000, 64);
+  check_stable(12345, 100, 3);
+}
+
+void descending() {
+  write_input(5000);
+  phoenix::external_sort_config config;
+  config.memory_budget = 300 * sizeof(record);
+  config.temp_directory = ".";
+  phoenix::external_sort<record>(input_path, output_path, config,
+                                 [](const record& a, const record& b) { return a.key < b.key; });
+
+  auto keys = read_output_keys();
+  phoenix::test::eq(keys.size(), 5000u);
+  phoenix::test::eq(std::is_sorted(keys.rbegin(), keys.rend()), true, "Output isn't sorted descending");
+}
+
+void invalid_config() {
+  phoenix::external_sort_config config;
+  config.fan_in = 1;
+  try {
+    phoenix::external_sorter<record> sorter(config);
+    throw phoenix::test_exception("Sorter accepted fan-in of 1");
+  } catch (const std::invalid_argument&) {
+  }
+}
+
+int main() {
+  phoenix::run_test(single_run, "Single run");
+  phoenix::run_test(single_merge, "Single merge");
+  phoenix::run_test(multi_pass_merge, "Multi-pass merge");
+  phoenix::run_test(stable, "Stable");
+  phoenix::run_test(stable_budget, "Stable within budget");
+  phoenix::run_test(descending, "Descending");
+  phoenix::run_test(invalid_config, "Invalid config");
+  std::remove(input_path.c_str());
+  std::remove(output_path.c_str());
+}
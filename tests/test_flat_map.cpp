@@ -0,0 +1,134 @@
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <phoenix/flat_map.hpp>
+#include <phoenix/test.hpp>
+#include <phoenix/utility.hpp>
+#include <phoenix/vector.hpp>
+
+void check_same(const phoenix::flat_map<int, int>& map, const std::map<int, int>& expected,
+                const std::string& message) {
+  phoenix::test::eq(map.size(), expected.size(), message + ": size");
+  auto it = map.begin();
+  for (const auto& element : expected) {
+    phoenix::test::eq(it.key(), element.first, message + ": key");
+    phoenix::test::eq((*it).second, element.second, message + ": value of " + std::to_string(element.first));
+    ++it;
+  }
+  phoenix::test::eq(it == map.end(), true, message + ": end");
+}
+
+void bulk_construction() {
+  phoenix::flat_map<int, int> map = {{5, 50}, {3, 30}, {5, 51}, {1, 10}, {3, 31}};
+  check_same(map, {{1, 10}, {3, 30}, {5, 50}}, "Initializer list keeps first values");
+
+  std::mt19937 gen(1);
+  phoenix::vector<int> keys(3000), values(3000);
+  std::map<int, int> expected;
+  for (std::size_t i = 0; i < keys.size(); i++) {
+    keys[i] = static_cast<int>(gen() % 1000);
+    values[i] = static_cast<int>(i);
+    expected.insert({keys[i], values[i]});
+  }
+  phoenix::flat_map<int, int> columns(keys, values);
+  check_same(columns, expected, "Columns");
+
+  std::vector<std::pair<int, int>> pairs(expected.begin(), expected.end());
+  phoenix::flat_map<int, int> from_range(pairs.rbegin(), pairs.rend());
+  check_same(from_range, expected, "Range");
+
+  bool thrown = false;
+  try {
+    phoenix::flat_map<int, int> invalid(phoenix::vector<int>{1, 2}, phoenix::vector<int>{1});
+  } catch (const std::invalid_argument&) {
+    thrown = true;
+  }
+  phoenix::test::eq(thrown, true, "Columns of different sizes are rejected");
+}
+
+void lookups() {
+  phoenix::flat_map<std::string, int> map = {{"one", 1}, {"two", 2}, {"three", 3}};
+  phoenix::test::eq(map.at("two"), 2, "at");
+  phoenix::test::eq(map.contains("four"), false, "contains missing key");
+  phoenix::test::eq(map.find("three").value(), 3, "find");
+  phoenix::test::eq(map.find("zero") == map.end(), true, "find missing key");
+  phoenix::test::eq(map.lower_bound("p").key(), std::string("three"), "lower_bound");
+  phoenix::test::eq(map.upper_bound("three").key(), std::string("two"), "upper_bound");
+
+  bool thrown = false;
+  try {
+    map.at("four");
+  } catch (const std::out_of_range&) {
+    thrown = true;
+  }
+  phoenix::test::eq(thrown, true, "at throws for missing keys");
+
+  const auto& constant = map;
+  phoenix::test::eq(constant.at("one"), 1, "const at");
+  phoenix::flat_map<std::string, int>::const_iterator it = map.begin();
+  phoenix::test::eq((*it).first, std::string("one"), "Conversion to const_iterator");
+
+  map["two"] = 22;
+  map["four"] = 4;
+  phoenix::test::eq(map.at("two"), 22, "operator[] of an existing key");
+  phoenix::test::eq(map.at("four"), 4, "operator[] of a new key");
+  phoenix::test::container_equal(map.keys(), phoenix::vector<std::string>{"four", "one", "three", "two"}, "Key column");
+  phoenix::test::container_equal(map.values(), phoenix::vector<int>{4, 1, 3, 22}, "Value column");
+}
+
+// Counts default constructions, which operator[] should only do for missing keys
+struct counted {
+  static int built;
+  int value = 0;
+  counted() { built++; }
+  explicit counted(int v) : value{v} {}
+};
+int counted::built = 0;
+
+void subscript_construction() {
+  phoenix::flat_map<int, counted> map;
+  map.insert(1, counted(10));
+  map.insert(2, counted(20));
+  counted::built = 0;
+  phoenix::test::eq(map[1].value, 10, "Existing value");
+  phoenix::test::eq(counted::built, 0, "No value built for an existing key");
+  map[3].value = 30;
+  phoenix::test::eq(map.at(3).value, 30, "Inserted value");
+}
+
+void insertions() {
+  std::mt19937 gen(2);
+  phoenix::flat_map<int, int> map;
+  std::map<int, int> expected;
+  for (int i = 0; i < 500; i++) {
+    int key = static_cast<int>(gen() % 300);
+    auto result = i % 2 ? map.insert(key, i) : map.insert_or_assign(key, i);
+    bool inserted = expected.insert({key, i}).second;
+    if (i % 2 == 0) expected[key] = i;
+    phoenix::test::eq(result.second, inserted, "Single insertion result");
+    phoenix::test::eq(result.first.key(), key, "Single insertion position");
+  }
+  check_same(map, expected, "Single insertions");
+
+  for (int round = 0; round < 20; round++) {
+    std::vector<std::pair<int, int>> batch;
+    for (int i = 0; i < round * 13; i++) batch.push_back({static_cast<int>(gen() % 1000) - 300, i});
+    map.insert(batch.begin(), batch.end());
+    expected.insert(batch.begin(), batch.end());
+    check_same(map, expected, "Batch " + std::to_string(round));
+  }
+
+  for (int key = -300; key < 700; key += 7) {
+    phoenix::test::eq(map.erase(key), expected.erase(key), "Erase " + std::to_string(key));
+  }
+  check_same(map, expected, "Erase");
+}
+
+int main() {
+  phoenix::run_test(bulk_construction, "flat_map bulk construction");
+  phoenix::run_test(lookups, "flat_map lookups");
+  phoenix::run_test(subscript_construction, "flat_map operator[] construction");
+  phoenix::run_test(insertions, "flat_map insertions");
+}
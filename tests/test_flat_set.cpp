@@ -0,0 +1,89 @@
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include <phoenix/flat_set.hpp>
+#include <phoenix/test.hpp>
+#include <phoenix/utility.hpp>
+#include <phoenix/vector.hpp>
+
+template <typename Set>
+void check_same(const phoenix::flat_set<int>& set, const Set& expected, const std::string& message) {
+  phoenix::test::eq(set.size(), expected.size(), message + ": size");
+  std::vector<int> keys(expected.begin(), expected.end());
+  phoenix::test::container_equal(set, keys, message + ": keys");
+}
+
+void bulk_construction() {
+  phoenix::flat_set<int> set = {5, 3, 9, 3, 1, 5, 5, 7};
+  check_same(set, std::set<int>{1, 3, 5, 7, 9}, "Initializer list");
+
+  std::mt19937 gen(1);
+  phoenix::vector<int> keys(5000);
+  for (std::size_t i = 0; i < keys.size(); i++) keys[i] = static_cast<int>(gen() % 2000);
+  std::set<int> expected(keys.cbegin().operator->(), keys.cend().operator->());
+  phoenix::flat_set<int> from_vector(keys);
+  check_same(from_vector, expected, "Vector");
+  phoenix::flat_set<int> from_range(keys.cbegin(), keys.cend());
+  check_same(from_range, expected, "Range");
+
+  phoenix::flat_set<int> empty;
+  phoenix::test::eq(empty.empty(), true, "Default set is empty");
+  phoenix::test::eq(empty.contains(1), false, "Empty set contains nothing");
+}
+
+void lookups() {
+  phoenix::flat_set<int> set = {10, 20, 30, 40};
+  for (int key = 0; key <= 50; key++) {
+    std::string name = "Key " + std::to_string(key);
+    bool present = key % 10 == 0 && key >= 10 && key <= 40;
+    phoenix::test::eq(set.contains(key), present, name + ": contains");
+    phoenix::test::eq(set.count(key), present ? 1u : 0u, name + ": count");
+    phoenix::test::eq(set.find(key) != set.end(), present, name + ": find");
+    int lower = set.lower_bound(key) == set.end() ? -1 : *set.lower_bound(key);
+    int expected = key > 40 ? -1 : (key + 9) / 10 * 10 < 10 ? 10 : (key + 9) / 10 * 10;
+    phoenix::test::eq(lower, expected, name + ": lower_bound");
+  }
+  phoenix::test::eq(*set.upper_bound(20), 30, "upper_bound");
+
+  phoenix::flat_set<std::string, phoenix::less_fn> words = {"b", "a", "c"};
+  phoenix::test::eq(words[0], std::string("c"), "Descending order");
+  phoenix::test::eq(words.contains("a"), true, "Heterogeneous lookup");
+}
+
+void insertions() {
+  std::mt19937 gen(2);
+  phoenix::flat_set<int> set;
+  std::set<int> expected;
+  for (int i = 0; i < 500; i++) {
+    int key = static_cast<int>(gen() % 300);
+    auto result = set.insert(key);
+    bool inserted = expected.insert(key).second;
+    phoenix::test::eq(result.second, inserted, "Single insertion result");
+    phoenix::test::eq(*result.first, key, "Single insertion position");
+  }
+  check_same(set, expected, "Single insertions");
+
+  for (int round = 0; round < 20; round++) {
+    std::vector<int> batch;
+    for (int i = 0; i < round * 13; i++) batch.push_back(static_cast<int>(gen() % 1000) - 300);
+    set.insert(batch.begin(), batch.end());
+    expected.insert(batch.begin(), batch.end());
+    check_same(set, expected, "Batch " + std::to_string(round));
+  }
+
+  set.insert({-1000, 5000});
+  expected.insert({-1000, 5000});
+  check_same(set, expected, "Initializer list batch");
+
+  for (int key = -1000; key < 1000; key += 7) {
+    phoenix::test::eq(set.erase(key), expected.erase(key), "Erase " + std::to_string(key));
+  }
+  check_same(set, expected, "Erase");
+}
+
+int main() {
+  phoenix::run_test(bulk_construction, "flat_set bulk construction");
+  phoenix::run_test(lookups, "flat_set lookups");
+  phoenix::run_test(insertions, "flat_set insertions");
+}
@@ -0,0 +1,33 @@
+#include <cstdint>
+#include <set>
+#include <string>
+#include <phoenix/hash.hpp>
+#include <phoenix/test.hpp>
+
+void strings() {
+  phoenix::hash_fn hash;
+  std::string text = "phoenix standard library";
+  const char* literal = "phoenix standard library";
+  phoenix::test::eq(hash(text), hash(literal), "std::string and C string hash the same");
+  phoenix::test::eq(hash(text), hash("phoenix standard library"), "std::string and char array hash the same");
+  phoenix::test::neq(hash(text), hash(std::string("phoenix standard librarY")), "Last byte changes the hash");
+  phoenix::test::neq(hash(std::string("")), hash(std::string(1, '\0')), "Length changes the hash");
+}
+
+void integers() {
+  phoenix::hash_fn hash;
+  // Sequential keys must spread over both the low and the high bits
+  std::set<std::size_t> low, high;
+  for (std::uint64_t i = 0; i < 4096; i++) {
+    low.insert(hash(i) & 0xff);
+    high.insert(hash(i) >> (8 * sizeof(std::size_t) - 8));
+  }
+  phoenix::test::eq(low.size(), 256u, "Low byte takes every value");
+  phoenix::test::eq(high.size(), 256u, "High byte takes every value");
+  phoenix::test::eq(hash(42), hash(42ull), "Integer types of the same value hash the same");
+}
+
+int main() {
+  phoenix::run_test(strings, "Hash of strings");
+  phoenix::run_test(integers, "Hash of integers");
+}
@@ -0,0 +1,147 @@
+#include <cstdint>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <phoenix/cpu.hpp>
+#include <phoenix/hash_map.hpp>
+#include <phoenix/test.hpp>
+
+void check_same(const phoenix::hash_map<int, int>& map, const std::map<int, int>& expected,
+                const std::string& message) {
+  phoenix::test::eq(map.size(), expected.size(), message + ": size");
+  std::map<int, int> contents;
+  for (auto it = map.begin(); it != map.end(); ++it) contents[it.key()] = it.value();
+  phoenix::test::eq(contents == expected, true, message + ": contents");
+  for (const auto& element : expected) phoenix::test::eq(map.at(element.first), element.second, message + ": at");
+}
+
+void insert_and_find() {
+  phoenix::hash_map<int, int> map;
+  phoenix::test::eq(map.contains(1), false, "Empty map contains nothing");
+  phoenix::test::eq(map.find(1) == map.end(), true, "Empty map finds nothing");
+
+  std::map<int, int> expected;
+  for (int i = 0; i < 10000; i++) {
+    auto result = map.insert(i * 7, i);
+    phoenix::test::eq(result.second, true, "Insertion of a new key");
+    phoenix::test::eq(result.first.key(), i * 7, "Inserted key");
+    expected[i * 7] = i;
+  }
+  check_same(map, expected, "Inserted");
+  phoenix::test::leq(map.load_factor(), 0.875, "Load factor");
+
+  for (int i = 0; i < 70000; i++) {
+    phoenix::test::eq(map.contains(i), i % 7 == 0, "contains " + std::to_string(i));
+  }
+  auto result = map.insert(14, 100);
+  phoenix::test::eq(result.second, false, "Insertion of an existing key");
+  phoenix::test::eq(result.first.value(), 2, "Existing value is kept");
+  map.insert_or_assign(14, 100);
+  phoenix::test::eq(map.at(14), 100, "insert_or_assign");
+  map[15] += 5;
+  phoenix::test::eq(map.at(15), 5, "operator[] inserts a default value");
+
+  bool thrown = false;
+  try {
+    map.at(16);
+  } catch (const std::out_of_range&) {
+    thrown = true;
+  }
+  phoenix::test::eq(thrown, true, "at throws for missing keys");
+}
+
+void subscript() {
+  // The slots don't exist before the first insertion and move on every rehash, operator[]
+  // has to insert before it takes the reference
+  phoenix::hash_map<int, std::string> map;
+  map[1] = "one";
+  phoenix::test::eq(map.size(), 1u, "operator[] on an empty map");
+  phoenix::test::eq(map.at(1), std::string("one"));
+
+  std::map<int, std::string> expected{{1, "one"}};
+  for (int i = 2; i < 5000; i++) {
+    auto capacity = map.capacity();
+    map[i] = std::to_string(i);
+    expected[i] = std::to_string(i);
+    if (map.capacity() != capacity) phoenix::test::eq(map.at(i), expected[i], "operator[] across a rehash");
+  }
+  phoenix::test::eq(map.size(), expected.size());
+  for (const auto& element : expected) phoenix::test::eq(map[element.first], element.second, "operator[] lookup");
+  phoenix::test::eq(map.size(), expected.size(), "operator[] inserted an existing key");
+}
+
+void erase_and_tombstones() {
+  std::mt19937 gen(3);
+  phoenix::hash_map<int, int> map;
+  std::map<int, int> expected;
+  // Keys churn in a small range, so that tombstones pile up and get reused or rehashed away
+  for (int i = 0; i < 200000; i++) {
+    int key = static_cast<int>(gen() % 5000);
+    if (gen() % 2) {
+      phoenix::test::eq(map.erase(key), expected.erase(key), "Erase " + std::to_string(key));
+    } else {
+      map.insert_or_assign(key, i);
+      expected[key] = i;
+    }
+  }
+  check_same(map, expected, "After churn");
+  phoenix::test::leq(map.capacity(), 16384u, "Tombstones don't grow the table");
+
+  map.clear();
+  phoenix::test::eq(map.empty(), true, "Cleared map is empty");
+  phoenix::test::eq(map.begin() == map.end(), true, "Cleared map has no elements");
+}
+
+void reserve_and_copies() {
+  phoenix::hash_map<int, int> map;
+  map.reserve(1000);
+  auto capacity = map.capacity();
+  for (int i = 0; i < 1000; i++) map[i] = -i;
+  phoenix::test::eq(map.capacity(), capacity, "Reserved map doesn't rehash");
+
+  phoenix::hash_map<int, int> copy(map), assigned;
+  assigned = copy;
+  phoenix::hash_map<int, int> moved(std::move(map));
+  phoenix::test::eq(map.size(), 0u, "Moved-from map is empty");
+  for (int i = 0; i < 1000; i++) {
+    phoenix::test::eq(copy.at(i), -i, "Copy");
+    phoenix::test::eq(assigned.at(i), -i, "Assignment");
+    phoenix::test::eq(moved.at(i), -i, "Move");
+  }
+  moved.rehash(0);
+  phoenix::test::eq(moved.size(), 1000u, "Rehash keeps elements");
+  phoenix::test::eq(moved.at(999), -999, "Rehash keeps values");
+}
+
+void heterogeneous_lookup() {
+  phoenix::hash_map<std::string, int> map = {{"one", 1}, {"two", 2}, {"three", 3}};
+  phoenix::test::eq(map.at("two"), 2, "Lookup with a literal");
+  const char* key = "three";
+  phoenix::test::eq(map.contains(key), true, "Lookup with a C string");
+  phoenix::test::eq(map.contains("four"), false, "Missing literal");
+  phoenix::test::eq(map.erase("one"), 1u, "Erase with a literal");
+  phoenix::test::eq(map.size(), 2u, "Size after erase");
+}
+
+void control_groups() {
+  // Control bytes are matched with SSE2 or, without it, byte by byte - both have to agree
+  std::int8_t group[16];
+  for (int i = 0; i < 16; i++) group[i] = static_cast<std::int8_t>(i % 3 == 0 ? -128 : i % 5 == 0 ? -2 : i);
+  unsigned free = 0, seven = 0;
+  for (unsigned i = 0; i < 16; i++) {
+    free |= (group[i] < 0 ? 1u : 0u) << i;
+    seven |= (group[i] == 7 ? 1u : 0u) << i;
+  }
+  phoenix::test::eq(phoenix::detail::swiss::match_free(group), free, "Free slots");
+  phoenix::test::eq(phoenix::detail::swiss::match(group, 7), seven, "Matching slots");
+}
+
+int main() {
+  phoenix::run_test(insert_and_find, "hash_map insert and find");
+  phoenix::run_test(subscript, "hash_map operator[]");
+  phoenix::run_test(erase_and_tombstones, "hash_map erase and tombstones");
+  phoenix::run_test(reserve_and_copies, "hash_map reserve and copies");
+  phoenix::run_test(heterogeneous_lookup, "hash_map heterogeneous lookup");
+  phoenix::run_test(control_groups, "hash_map control groups");
+}
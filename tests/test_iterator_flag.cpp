@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <list>
+#include <numeric>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <phoenix/array.hpp>
+#include <phoenix/btree.hpp>
+#include <phoenix/execution.hpp>
+#include <phoenix/flat_map.hpp>
+#include <phoenix/hash_map.hpp>
+#include <phoenix/iterator_flag.hpp>
+#include <phoenix/numeric.hpp>
+#include <phoenix/ranges.hpp>
+#include <phoenix/search.hpp>
+#include <phoenix/sort.hpp>
+#include <phoenix/test.hpp>
+#include <phoenix/vector.hpp>
+
+template <typename Iterator>
+using category = typename std::iterator_traits<Iterator>::iterator_category;
+
+void flags() {
+  using phoenix::iterator_flag;
+  static_assert(phoenix::has_flag(iterator_flag::contiguous, iterator_flag::random_access), "contiguous");
+  static_assert(phoenix::has_flag(iterator_flag::random_access, iterator_flag::bidirectional), "random access");
+  static_assert(!phoenix::has_flag(iterator_flag::bidirectional, iterator_flag::random_access), "bidirectional");
+  static_assert(!phoenix::has_flag(iterator_flag::random_access, iterator_flag::output), "not output");
+  phoenix::test::eq(static_cast<unsigned>(iterator_flag::random_access), 0x1Du, "random access bits");
+  phoenix::test::eq(static_cast<unsigned>(iterator_flag::contiguous), 0x3Du, "contiguous bits");
+
+  // Standard categories of phoenix iterators
+  static_assert(std::is_same<category<phoenix::vector<int>::iterator>, std::random_access_iterator_tag>::value,
+                "vector iterator");
+  static_assert(std::is_same<category<phoenix::array<int, 4>::const_iterator>,
+                             std::random_access_iterator_tag>::value, "array iterator");
+  static_assert(std::is_same<category<phoenix::flat_map<int, int>::iterator>, std::input_iterator_tag>::value,
+                "flat_map iterator");
+  static_assert(phoenix::detail::is_random_access<phoenix::flat_map<int, int>::iterator>::value,
+                "flat_map iterator flag");
+  static_assert(std::is_same<category<phoenix::btree_map<int, int>::iterator>,
+                             std::bidirectional_iterator_tag>::value, "btree iterator");
+  static_assert(std::is_same<category<phoenix::hash_map<int, int>::iterator>, std::forward_iterator_tag>::value,
+                "hash_map iterator");
+
+  // Flags of standard iterators
+  static_assert(phoenix::detail::is_contiguous<const int*>::value, "pointer");
+  static_assert(phoenix::detail::is_contiguous<phoenix::vector<int>::const_iterator>::value, "vector");
+  static_assert(phoenix::detail::is_random_access<std::vector<int>::iterator>::value, "std::vector");
+  static_assert(!phoenix::detail::is_random_access<std::list<int>::iterator>::value, "std::list");
+  static_assert(phoenix::detail::iterator_flag_of<std::list<int>::iterator>::value == iterator_flag::bidirectional,
+                "std::list flag");
+}
+
+void arithmetic() {
+  phoenix::vector<int> vec{0, 1, 2, 3, 4, 5, 6, 7};
+  auto begin = vec.begin(), end = vec.end();
+  phoenix::test::eq(end - begin, std::ptrdiff_t{8}, "difference");
+  phoenix::test::eq(begin[3], 3, "subscript");
+  phoenix::test::eq(*(2 + begin), 2, "offset on the left");
+  phoenix::test::eq(begin < end && end > begin && begin <= begin && end >= begin, true, "ordering");
+
+  phoenix::vector<int>::const_iterator constant = begin + 1;
+  phoenix::test::eq(*constant, 1, "iterator to const iterator");
+
+  phoenix::flat_map<int, int> map{{3, 30}, {1, 10}, {2, 20}};
+  phoenix::test::eq(map.end() - map.begin(), std::ptrdiff_t{3}, "flat_map difference");
+  phoenix::test::eq(map.begin()[1].second, 20, "flat_map subscript");
+  phoenix::test::eq(phoenix::detail::distance(map.begin(), map.end()), std::size_t{3}, "flat_map distance");
+
+  std::list<int> list{1, 2, 3, 4, 5};
+  phoenix::test::eq(phoenix::detail::distance(list.begin(), list.end()), std::size_t{5}, "walked distance");
+  phoenix::test::eq(*phoenix::detail::advance(list.begin(), 3), 4, "walked advance");
+}
+
+void standard_algorithms() {
+  phoenix::vector<int> vec{5, 3, 8, 1, 9, 2};
+  std::sort(vec.begin(), vec.end());
+  phoenix::test::eq(std::is_sorted(vec.cbegin(), vec.cend()), true, "std::sort");
+  phoenix::test::eq(*std::lower_bound(vec.begin(), vec.end(), 4), 5, "std::lower_bound");
+  phoenix::test::eq(std::distance(vec.begin(), vec.end()), std::ptrdiff_t{6}, "std::distance");
+  std::reverse(vec.begin(), vec.end());
+  phoenix::test::eq(vec[0], 9, "std::reverse");
+
+  phoenix::array<int, 4> arr{4, 3, 2, 1};
+  std::vector<int> copied(arr.begin(), arr.end());
+  phoenix::test::eq(copied[3], 1, "std::vector from array iterators");
+  phoenix::test::eq(std::accumulate(arr.cbegin(), arr.cend(), 0), 10, "std::accumulate");
+
+  phoenix::btree_map<int, int> tree;
+  for (int i = 0; i < 100; i++) tree.insert(i, i);
+  phoenix::test::eq(std::distance(tree.begin(), tree.end()), std::ptrdiff_t{100}, "std::distance on btree");
+}
+
+void copies() {
+  // Overlapping ranges of trivial elements
+  phoenix::vector<int> vec{0, 1, 2, 3, 4, 5, 6, 7};
+  auto end = phoenix::detail::copy(vec.begin() + 2, vec.end(), vec.begin());
+  phoenix::test::eq(end - vec.begin(), std::ptrdiff_t{6}, "returned end");
+  phoenix::test::eq(vec[0] == 2 && vec[5] == 7 && vec[7] == 7, true, "overlapping copy");
+  static_assert(phoenix::detail::is_memmovable<phoenix::vector<int>::const_iterator, int*>::value, "memmove path");
+  static_assert(!phoenix::detail::is_memmovable<std::list<int>::iterator, int*>::value, "loop path");
+
+  // Elements with their own copy assignment
+  phoenix::vector<std::string> words{"alpha", "a string too long for the small buffer", "gamma"};
+  phoenix::vector<std::string> copy(words);
+  words[1] = "changed";
+  phoenix::test::eq(copy[1], std::string("a string too long for the small buffer"), "deep copy");
+  copy.reserve(100);
+  phoenix::test::eq(copy[2], std::string("gamma"), "reserve keeps elements");
+
+  phoenix::array<std::string, 2> pair{"left", "right"}, other;
+  other = pair;
+  phoenix::test::eq(other[1], std::string("right"), "array assignment");
+}
+
+// Internal distance, advance and copy must not clash with std ones found through std iterators
+// or std element types
+void standard_types() {
+  phoenix::vector<std::array<int, 2>> points{{{1, 2}}, {{3, 4}}};
+  phoenix::vector<std::array<int, 2>> points_copy(points);
+  phoenix::test::eq(points_copy[1][0], 3, "vector of std::array");
+  auto listed = phoenix::to_vector(points);
+  phoenix::test::eq(listed[0][1], 2, "to_vector of std::array");
+
+  std::vector<int> values{5, 3, 9, 1, 7};
+  phoenix::sort_by_key(values.begin(), values.end(), [](int x) { return -x; });
+  phoenix::test::eq(values[0], 9, "sort_by_key on std::vector");
+  phoenix::sort(values.begin(), values.end());
+  phoenix::test::eq(phoenix::is_sorted(values.begin(), values.end()), true, "sort on std::vector");
+  phoenix::test::eq(phoenix::binary_search(values.begin(), values.end(), 7), true, "binary_search on std::vector");
+
+  phoenix::test::eq(phoenix::reduce(phoenix::execution::par, values.begin(), values.end(), 0), 25,
+                    "parallel reduce on std::vector");
+  phoenix::test::eq(phoenix::reduce(phoenix::execution::unseq, values.begin(), values.end(), 0), 25,
+                    "vectorized reduce on std::vector");
+  std::vector<int> sums(values.size());
+  phoenix::inclusive_scan(phoenix::execution::par, values.begin(), values.end(), sums.begin());
+  phoenix::test::eq(sums[4], 25, "parallel inclusive_scan on std::vector");
+  phoenix::transform(phoenix::execution::par, values.begin(), values.end(), sums.begin(), [](int x) { return 2 * x; });
+  phoenix::test::eq(sums[0], 2, "parallel transform on std::vector");
+}
+
+int main() {
+  phoenix::run_test(flags, "Flags");
+  phoenix::run_test(arithmetic, "Arithmetic");
+  phoenix::run_test(standard_algorithms, "Standard algorithms");
+  phoenix::run_test(copies, "Copies");
+  phoenix::run_test(standard_types, "Standard types");
+}
@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <vector>
+#include <phoenix/merge.hpp>
+#include <phoenix/test.hpp>
+#include <phoenix/vector.hpp>
+
+phoenix::vector<int> sorted_random(std::size_t length, unsigned seed, int range) {
+  std::mt19937 gen(seed);
+  phoenix::vector<int> v(length);
+  for (std::size_t i = 0; i < length; i++) v[i] = static_cast<int>(gen() % static_cast<unsigned>(range));
+  phoenix::sort(v.begin(), v.end());
+  return v;
+}
+
+std::vector<int> to_std(const phoenix::vector<int>& v) {
+  return std::vector<int>(v.cbegin().operator->(), v.cbegin().operator->() + v.size());
+}
+
+void two_way() {
+  auto a = sorted_random(1000, 1, 500), b = sorted_random(700, 2, 500);
+  phoenix::vector<int> out(a.size() + b.size());
+  auto end = phoenix::merge(a.begin(), a.end(), b.begin(), b.end(), out.begin());
+  phoenix::test::eq(end, out.end(), "Merge returned wrong output end");
+
+  std::vector<int> expected;
+  auto sa = to_std(a), sb = to_std(b);
+  std::merge(sa.begin(), sa.end(), sb.begin(), sb.end(), std::back_inserter(expected));
+  phoenix::test::container_equal(out, expected, "Two-way merge differs from std::merge");
+}
+
+void parallel_two_way() {
+  auto a = sorted_random(200000, 3, 1000), b = sorted_random(150000, 4, 1000);
+  std::vector<int> expected;
+  auto sa = to_std(a), sb = to_std(b);
+  std::merge(sa.begin(), sa.end(), sb.begin(), sb.end(), std::back_inserter(expected));
+
+  for (std::size_t threads : {1u, 2u, 3u, 8u}) {
+    phoenix::vector<int> out(a.size() + b.size());
+    phoenix::parallel_merge(a.begin(), a.end(), b.begin(), b.end(), out.begin(), phoenix::greater_fn{}, threads);
+    phoenix::test::container_equal(out, expected, "Parallel merge differs from std::merge");
+  }
+}
+
+void k_way() {
+  phoenix::vector<phoenix::vector<int>> shards;
+  std::vector<int> expected;
+  for (unsigned s = 0; s < 13; s++) {
+    shards.push(sorted_random(s * 997 % 5000, s, 10000));
+    auto part = to_std(shards[s]);
+    expected.insert(expected.end(), part.begin(), part.end());
+  }
+  std::sort(expected.begin(), expected.end());
+
+  phoenix::vector<int> out(expected.size());
+  phoenix::merge(shards, out.begin());
+  phoenix::test::container_equal(out, expected, "k-way merge result is not sorted union of shards");
+
+  for (std::size_t threads : {2u, 5u}) {
+    phoenix::vector<int> parallel_out(expected.size());
+    auto end = phoenix::parallel_merge(shards, parallel_out.begin(), phoenix::greater_fn{}, threads);
+    phoenix::test::eq(end, parallel_out.end());
+    phoenix::test::container_equal(parallel_out, expected, "Parallel k-way merge differs");
+  }
+
+  phoenix::vector<phoenix::vector<int>> no_shards;
+  phoenix::vector<int> no_out;
+  phoenix::test::eq(phoenix::merge(no_shards, no_out.begin()), no_out.begin(), "Merge of no sources wrote output");
+  phoenix::test::eq(phoenix::parallel_merge(no_shards, no_out.begin()), no_out.begin());
+
+  // stability - equal keys come from lower shards first
+  struct tagged {
+    int key;
+    int shard;
+  };
+  phoenix::vector<std::vector<tagged>> tagged_shards;
+  for (int s = 0; s < 4; s++) tagged_shards.push(std::vector<tagged>{{1, s}, {2, s}, {2, s}});
+  std::vector<tagged> tagged_out(12);
+  phoenix::merge(tagged_shards, tagged_out.begin(), [](const tagged& a, const tagged& b) { return a.key > b.key; });
+  for (std::size_t i = 1; i < tagged_out.size(); i++) {
+    if (tagged_out[i].key == tagged_out[i - 1].key)
+      phoenix::test::leq(tagged_out[i - 1].shard, tagged_out[i].shard, "k-way merge is not stable");
+  }
+}
+
+template <typename Operation, typename StdOperation>
+void check_set_operation(Operation operation, StdOperation std_operation, const char* name) {
+  std::size_t sizes[][2] = {{0, 100}, {100, 0}, {1000, 1000}, {5000, 40}, {40, 5000}, {3, 100000}};
+  for (auto& size : sizes) {
+    for (int range : {50, 100000}) {
+      auto a = sorted_random(size[0], static_cast<unsigned>(size[0]), range);
+      auto b = sorted_random(size[1], static_cast<unsigned>(size[1] + 1), range);
+      auto sa = to_std(a), sb = to_std(b);
+
+      std::vector<int> expected;
+      std_operation(sa.begin(), sa.end(), sb.begin(), sb.end(), std::back_inserter(expected));
+      std::vector<int> out;
+      operation(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out));
+      phoenix::test::container_equal(out, expected, name);
+    }
+  }
+}
+
+void set_operations() {
+  check_set_operation([](phoenix::vector<int>::iterator b1, phoenix::vector<int>::iterator e1,
+                         phoenix::vector<int>::iterator b2, phoenix::vector<int>::iterator e2,
+                         std::back_insert_iterator<std::vector<int>> out) { phoenix::set_union(b1, e1, b2, e2, out); },
+                      [](std::vector<int>::iterator b1, std::vector<int>::iterator e1, std::vector<int>::iterator b2,
+                         std::vector<int>::iterator e2, std::back_insert_iterator<std::vector<int>> out) {
+                        std::set_union(b1, e1, b2, e2, out);
+                      },
+                      "set_union differs from std");
+  check_set_operation([](phoenix::vector<int>::iterator b1, phoenix::vector<int>::iterator e1,
+                         phoenix::vector<int>::iterator b2, phoenix::vector<int>::iterator e2,
+                         std::back_insert_iterator<std::vector<int>> out) { phoenix::set_difference(b1, e1, b2, e2, out); },
+                      [](std::vector<int>::iterator b1, std::vector<int>::iterator e1, std::vector<int>::iterator b2,
+                         std::vector<int>::iterator e2, std::back_insert_iterator<std::vector<int>> out) {
+                        std::set_difference(b1, e1, b2, e2, out);
+                      },
+                      "set_difference differs from std");
+  check_set_operation([](phoenix::vector<int>::iterator b1, phoenix::vector<int>::iterator e1,
+                         phoenix::vector<int>::iterator b2, phoenix::vector<int>::iterator e2,
+                         std::back_insert_iterator<std::vector<int>> out) { phoenix::set_intersection(b1, e1, b2, e2, out); },
+                      [](std::vector<int>::iterator b1, std::vector<int>::iterator e1, std::vector<int>::iterator b2,
+                         std::vector<int>::iterator e2, std::back_insert_iterator<std::vector<int>> out) {
+                        std::set_intersection(b1, e1, b2, e2, out);
+                      },
+                      "set_intersection differs from std");
+}
+
+void simd_intersection() {
+  for (auto level : {phoenix::simd_level::scalar, phoenix::simd_level::sse2}) {
+    phoenix::cpu::set_level_limit(level);
+    phoenix::vector<std::uint32_t> a, b;
+    for (std::uint32_t i = 0; i < 10000; i++) {
+      if (i % 3 == 0) a.push(i);
+      if (i % 5 == 0) b.push(i);
+    }
+    // a duplicate in the middle makes the SIMD path hand over to the scalar one
+    b.push(9999);
+    b.push(9999);
+
+    std::vector<std::uint32_t> expected, out;
+    std::vector<std::uint32_t> sa(a.cbegin().operator->(), a.cbegin().operator->() + a.size());
+    std::vector<std::uint32_t> sb(b.cbegin().operator->(), b.cbegin().operator->() + b.size());
+    std::set_intersection(sa.begin(), sa.end(), sb.begin(), sb.end(), std::back_inserter(expected));
+    phoenix::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out));
+    phoenix::test::container_equal(out, expected, "Vectorized intersection differs from std");
+
+    // a duplicate across a block boundary, after its first copy was already matched
+    phoenix::vector<std::uint32_t> c{1, 2, 3, 4, 4, 9, 10, 11}, d{4, 5, 6, 7, 8, 12, 13, 14};
+    out.clear();
+    phoenix::set_intersection(c.begin(), c.end(), d.begin(), d.end(), std::back_inserter(out));
+    phoenix::test::container_equal(out, std::vector<std::uint32_t>{4}, "Duplicate matched twice");
+    out.clear();
+    phoenix::set_intersection(d.begin(), d.end(), c.begin(), c.end(), std::back_inserter(out));
+    phoenix::test::container_equal(out, std::vector<std::uint32_t>{4}, "Duplicate matched twice");
+  }
+  phoenix::cpu::set_level_limit(phoenix::simd_level::avx512);
+}
+
+int main() {
+  phoenix::run_test(two_way, "Two-way merge");
+  phoenix::run_test(parallel_two_way, "Parallel two-way merge");
+  phoenix::run_test(k_way, "k-way merge");
+  phoenix::run_test(set_operations, "Set operations");
+  phoenix::run_test(simd_intersection, "Vectorized intersection");
+}
@@ -0,0 +1,127 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <phoenix/mpmc_queue.hpp>
+#include <phoenix/test.hpp>
+
+void single_thread() {
+  phoenix::mpmc_queue<int> queue(3);
+  int value = 0;
+  phoenix::test::eq(queue.capacity(), std::size_t{4}, "capacity rounded up");
+  phoenix::test::eq(queue.try_pop(value), false, "pop from empty queue");
+  for (int i = 0; i < 4; i++) phoenix::test::eq(queue.try_push(i), true, "push into free space");
+  phoenix::test::eq(queue.try_push(4), false, "push into full queue");
+  phoenix::test::eq(queue.size(), std::size_t{4}, "size of full queue");
+
+  for (int i = 4; i < 100; i++) {
+    phoenix::test::eq(queue.try_pop(value), true, "pop");
+    phoenix::test::eq(value, i - 4, "popped value");
+    queue.push(i);
+  }
+  for (int i = 96; i < 100; i++) phoenix::test::eq(queue.pop(), i, "blocking pop of available value");
+  phoenix::test::eq(queue.empty(), true, "empty after draining");
+
+  phoenix::mpmc_queue<std::string> strings(1);
+  phoenix::test::eq(strings.capacity(), std::size_t{2}, "minimal capacity");
+  strings.push(std::string(100, 'x'));
+  phoenix::test::eq(strings.pop(), std::string(100, 'x'), "moved string");
+}
+
+void batches() {
+  phoenix::mpmc_queue<int> queue(8);
+  int input[10], output[10];
+  for (int i = 0; i < 10; i++) input[i] = i;
+
+  phoenix::test::eq(queue.push_n(input, 10), std::size_t{8}, "push_n stops at capacity");
+  phoenix::test::eq(queue.push_n(input, 10), std::size_t{0}, "push_n into full queue");
+  phoenix::test::eq(queue.pop_n(output, 5), std::size_t{5}, "pop_n part");
+  for (int i = 0; i < 5; i++) phoenix::test::eq(output[i], i, "pop_n values");
+  phoenix::test::eq(queue.push_n(input, 5), std::size_t{5}, "wrapping push_n");
+  phoenix::test::eq(queue.pop_n(output, 10), std::size_t{8}, "wrapping pop_n");
+  int expected[] = {5, 6, 7, 0, 1, 2, 3, 4};
+  for (int i = 0; i < 8; i++) phoenix::test::eq(output[i], expected[i], "wrapping pop_n values");
+  phoenix::test::eq(queue.pop_n(output, 10), std::size_t{0}, "pop_n from empty queue");
+}
+
+// Every value has to arrive exactly once, whichever mix of operations moves it
+void many_threads() {
+  constexpr std::uint32_t producers = 4, consumers = 4, per_producer = 50000;
+  constexpr std::uint32_t total = producers * per_producer;
+  phoenix::mpmc_queue<std::uint32_t> queue(64);
+  std::vector<std::atomic<int>> received(total);
+  for (auto& r : received) r.store(0);
+  std::atomic<std::uint32_t> consumed{0};
+
+  std::vector<std::thread> threads;
+  for (std::uint32_t p = 0; p < producers; p++) {
+    threads.emplace_back([&, p]() {
+      std::uint32_t batch[5];
+      for (std::uint32_t i = 0; i < per_producer;) {
+        std::uint32_t value = p * per_producer + i;
+        if (p % 2 == 0) {
+          queue.push(value);
+          i++;
+          continue;
+        }
+        std::size_t length = 0;
+        for (; length < 5 && i + length < per_producer; length++)
+          batch[length] = value + static_cast<std::uint32_t>(length);
+        std::size_t pushed = queue.push_n(batch, length);
+        if (pushed == 0) std::this_thread::yield();
+        i += static_cast<std::uint32_t>(pushed);
+      }
+    });
+  }
+  for (std::uint32_t c = 0; c < consumers; c++) {
+    threads.emplace_back([&, c]() {
+      std::uint32_t batch[3];
+      for (;;) {
+        std::size_t popped = c % 2 == 0 ? queue.pop_n(batch, 3) : queue.try_pop(batch[0]);
+        if (popped == 0) {
+          if (consumed.load() == total) return;
+          std::this_thread::yield();
+        }
+        for (std::size_t i = 0; i < popped; i++) received[batch[i]]++;
+        consumed += static_cast<std::uint32_t>(popped);
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+
+  bool once = true;
+  for (auto& r : received) once &= r.load() == 1;
+  phoenix::test::eq(once, true, "every value received exactly once");
+  phoenix::test::eq(queue.empty(), true, "empty after transfer");
+}
+
+// Consumers have to sleep on an empty queue and wake up for every value
+void blocking() {
+  phoenix::mpmc_queue<int> queue(2);
+  std::atomic<long> sum{0};
+  std::vector<std::thread> consumers;
+  for (int c = 0; c < 3; c++) {
+    consumers.emplace_back([&]() {
+      for (;;) {
+        int value = queue.pop();
+        if (value < 0) return;
+        sum += value;
+      }
+    });
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  for (int i = 1; i <= 1000; i++) queue.push(i);
+  for (int c = 0; c < 3; c++) queue.push(-1);
+  for (auto& t : consumers) t.join();
+  phoenix::test::eq(sum.load(), 500500l, "sum of values popped by sleeping consumers");
+}
+
+int main() {
+  phoenix::run_test(single_thread, "Single thread");
+  phoenix::run_test(batches, "Batches");
+  phoenix::run_test(many_threads, "Many threads");
+  phoenix::run_test(blocking, "Blocking");
+}
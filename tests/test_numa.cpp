@@ -0,0 +1,79 @@
+#include <cstdint>
+#include <phoenix/execution.hpp>
+#include <phoenix/numa.hpp>
+#include <phoenix/test.hpp>
+#include <phoenix/thread_pool.hpp>
+#include <phoenix/vector.hpp>
+
+template <typename T, std::size_t AllocSize>
+bool all_equal(const phoenix::vector<T, AllocSize>& values, std::size_t first, std::size_t last, const T& value) {
+  bool result = true;
+  for (std::size_t i = first; i < last; i++) result &= values[i] == value;
+  return result;
+}
+
+void nodes() {
+  unsigned count = phoenix::numa::node_count();
+  phoenix::test::leq(1u, count, "at least one node");
+  phoenix::test::eq(phoenix::numa::online_nodes().test(0), true, "node 0 is online");
+
+  phoenix::numa::node_mask mask;
+  mask.set(3);
+  mask.set(64);
+  mask.set(5000);
+  phoenix::test::eq(mask.count(), 2u, "nodes outside of the mask are ignored");
+  phoenix::test::eq(mask.test(64) && !mask.test(4), true, "mask bits");
+
+  // Nodes that don't exist can't be used
+  phoenix::vector<int> values(10, phoenix::uninitialized);
+  phoenix::test::eq(phoenix::numa::place(values.data(), 10 * sizeof(int), phoenix::numa::bind(1000)), false,
+                    "bind to a missing node");
+  phoenix::test::eq(phoenix::numa::set_thread_placement(phoenix::numa::bind(1000)), false,
+                    "thread bound to a missing node");
+  phoenix::numa::set_thread_placement(phoenix::numa::first_touch);
+}
+
+void construction() {
+  phoenix::thread_pool pool(4, true);
+  auto policy = phoenix::execution::par.on(pool).chunk(1000);
+  for (auto where : {phoenix::numa::first_touch, phoenix::numa::interleave, phoenix::numa::bind(0)}) {
+    auto values = phoenix::numa::make_vector<std::uint64_t>(100003, 7, policy, where);
+    phoenix::test::eq(values.size(), std::size_t{100003}, "size");
+    phoenix::test::eq(all_equal(values, 0, values.size(), std::uint64_t{7}), true, "all elements set");
+  }
+  auto empty = phoenix::numa::make_vector<int>(0, 1, policy);
+  phoenix::test::eq(empty.size(), std::size_t{0}, "empty vector");
+
+  auto small = phoenix::numa::make_vector(5, 2.5);
+  phoenix::test::eq(small[4], 2.5, "default pool and policy");
+}
+
+void fill_and_resize() {
+  phoenix::thread_pool pool(3);
+  auto policy = phoenix::execution::par.on(pool).chunk(512);
+  phoenix::vector<int> values(10000, 1);
+  phoenix::numa::fill(values, 2, policy);
+  phoenix::test::eq(all_equal(values, 0, values.size(), 2), true, "fill");
+
+  // Growing reallocates and copies the kept elements
+  for (std::size_t i = 0; i < values.size(); i++) values[i] = static_cast<int>(i);
+  phoenix::numa::resize(values, 50000, -1, policy, phoenix::numa::interleave);
+  bool kept = true;
+  for (std::size_t i = 0; i < 10000; i++) kept &= values[i] == static_cast<int>(i);
+  phoenix::test::eq(kept, true, "kept elements copied");
+  phoenix::test::eq(all_equal(values, 10000, 50000, -1), true, "new elements set");
+
+  // Shrinking and growing within the capacity
+  phoenix::numa::resize(values, 100, 0, policy);
+  phoenix::test::eq(values.size(), std::size_t{100}, "shrunk");
+  phoenix::test::eq(values.capacity(), std::size_t{50000}, "capacity kept");
+  phoenix::numa::resize(values, 20000, 5, policy);
+  phoenix::test::eq(values[99], 99, "kept after shrinking");
+  phoenix::test::eq(all_equal(values, 100, 20000, 5), true, "grown within capacity");
+}
+
+int main() {
+  phoenix::run_test(nodes, "Nodes");
+  phoenix::run_test(construction, "Construction");
+  phoenix::run_test(fill_and_resize, "Fill and resize");
+}
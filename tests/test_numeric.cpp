@@ -0,0 +1,168 @@
+#include <cstdint>
+#include <string>
+#include <phoenix/array.hpp>
+#include <phoenix/execution.hpp>
+#include <phoenix/numeric.hpp>
+#include <phoenix/test.hpp>
+#include <phoenix/thread_pool.hpp>
+#include <phoenix/vector.hpp>
+
+namespace execution = phoenix::execution;
+
+void transform() {
+  phoenix::vector<int> values(1000);
+  for (std::size_t i = 0; i < values.size(); i++) values[i] = static_cast<int>(i);
+  auto square = [](int x) { return x * x; };
+
+  phoenix::vector<long> seq(1000), unseq(1000), par(1000);
+  auto end = phoenix::transform(execution::seq, values.begin(), values.end(), seq.begin(), square);
+  phoenix::test::eq(end == seq.end(), true, "seq returns the end of the output");
+  phoenix::transform(execution::unseq, values.begin(), values.end(), unseq.begin(), square);
+  phoenix::transform(execution::par.chunk(64), values.begin(), values.end(), par.begin(), square);
+  phoenix::test::eq(seq[999], 998001l, "seq");
+  phoenix::test::eq(phoenix::equal(unseq.begin(), unseq.end(), seq.begin()), true, "unseq matches seq");
+  phoenix::test::eq(phoenix::equal(par.begin(), par.end(), seq.begin()), true, "par matches seq");
+
+  int raw[5] = {1, 2, 3, 4, 5};
+  phoenix::transform(execution::par.chunk(2), raw, raw + 5, raw, [](int x) { return -x; });
+  phoenix::test::eq(raw[0] + raw[4], -6, "in place on pointers");
+}
+
+void reduce() {
+  phoenix::vector<std::int64_t> values(100003);
+  for (std::size_t i = 0; i < values.size(); i++) values[i] = static_cast<std::int64_t>(i % 1000) - 300;
+  std::int64_t expected = 0;
+  for (auto v : values) expected += v;
+
+  phoenix::test::eq(phoenix::reduce(execution::seq, values.begin(), values.end(), std::int64_t{5}), expected + 5,
+                    "seq");
+  phoenix::test::eq(phoenix::reduce(execution::unseq, values.begin(), values.end(), std::int64_t{5}), expected + 5,
+                    "unseq");
+  phoenix::test::eq(phoenix::reduce(execution::par.chunk(1000), values.begin(), values.end(), std::int64_t{5}),
+                    expected + 5, "par");
+  phoenix::test::eq(phoenix::reduce(execution::par, values.begin(), values.begin(), 7), 7, "empty range");
+
+  // Not a plain sum, and a result type different from the elements
+  auto maximum = [](std::int64_t a, std::int64_t b) { return a < b ? b : a; };
+  phoenix::test::eq(phoenix::reduce(execution::unseq, values.begin(), values.end(), std::int64_t{-1000}, maximum),
+                    std::int64_t{699}, "unseq maximum");
+  phoenix::test::eq(phoenix::reduce(execution::par.chunk(77), values.begin(), values.end(), 0.0), double(expected),
+                    "par into double");
+
+  phoenix::array<int, 12> numbers;
+  for (std::size_t i = 0; i < numbers.size(); i++) numbers[i] = static_cast<int>(i + 1);
+  auto product = phoenix::reduce(execution::par.chunk(3), numbers.begin(), numbers.end(), 1, phoenix::multiplies_fn{});
+  phoenix::test::eq(product, 479001600, "par product over array");
+}
+
+// Same chunks give the same floating-point result, whatever the number of threads
+void deterministic() {
+  phoenix::vector<float> values(200000);
+  for (std::size_t i = 0; i < values.size(); i++) values[i] = 1.0f / static_cast<float>(i + 1);
+  phoenix::thread_pool one(1), four(4);
+  auto policy = execution::par.chunk(4096);
+  float first = phoenix::reduce(policy.on(one), values.begin(), values.end(), 0.0f);
+  float second = phoenix::reduce(policy.on(four), values.begin(), values.end(), 0.0f);
+  phoenix::test::eq(first, second, "reduce with 1 and 4 threads");
+
+  phoenix::vector<float> scanned_one(values.size()), scanned_four(values.size());
+  phoenix::inclusive_scan(policy.on(one), values.begin(), values.end(), scanned_one.begin());
+  phoenix::inclusive_scan(policy.on(four), values.begin(), values.end(), scanned_four.begin());
+  bool same = phoenix::equal(scanned_one.begin(), scanned_one.end(), scanned_four.begin());
+  phoenix::test::eq(same, true, "scan with 1 and 4 threads");
+}
+
+void transform_reduce() {
+  phoenix::vector<double> x(1001), y(1001);
+  for (std::size_t i = 0; i < x.size(); i++) {
+    x[i] = static_cast<double>(i);
+    y[i] = 2.0;
+  }
+  phoenix::test::eq(phoenix::transform_reduce(execution::seq, x.begin(), x.end(), y.begin(), 1.0), 1001001.0,
+                    "seq inner product");
+  phoenix::test::eq(phoenix::transform_reduce(execution::unseq, x.begin(), x.end(), y.begin(), 1.0), 1001001.0,
+                    "unseq inner product");
+  phoenix::test::eq(phoenix::transform_reduce(execution::par.chunk(100), x.begin(), x.end(), y.begin(), 1.0),
+                    1001001.0, "par inner product");
+
+  auto count_even = [](double v) { return static_cast<long>(v) % 2 == 0 ? 1l : 0l; };
+  phoenix::test::eq(phoenix::transform_reduce(execution::par.chunk(10), x.begin(), x.end(), 0l, phoenix::plus_fn{},
+                                              count_even), 501l, "par unary transform");
+  phoenix::test::eq(phoenix::transform_reduce(execution::seq, x.begin(), x.end(), y.begin(), 0.0, phoenix::plus_fn{},
+                                              [](double a, double b) { return a - b; }), 498498.0,
+                    "custom combine");
+}
+
+template <typename Policy>
+void check_scans(const Policy& policy, const char* name) {
+  std::string prefix(name);
+  for (std::size_t length : {0, 1, 3, 17, 1000, 4099}) {
+    phoenix::vector<int> values(length), inclusive(length), exclusive(length), expected(length);
+    int sum = 0;
+    for (std::size_t i = 0; i < length; i++) {
+      values[i] = static_cast<int>(i % 7) - 2;
+      expected[i] = sum;
+      sum += values[i];
+    }
+    phoenix::exclusive_scan(policy, values.begin(), values.end(), exclusive.begin(), 10);
+    phoenix::inclusive_scan(policy, values.begin(), values.end(), inclusive.begin());
+    bool valid = true;
+    for (std::size_t i = 0; i < length; i++) {
+      valid &= exclusive[i] == expected[i] + 10;
+      valid &= inclusive[i] == expected[i] + values[i];
+    }
+    phoenix::test::eq(valid, true, prefix + " scans of " + std::to_string(length) + " elements");
+  }
+
+  // In place, with an operation that is not a sum, and with init for the inclusive scan
+  phoenix::vector<std::uint64_t> values(300, 3);
+  phoenix::inclusive_scan(policy, values.begin(), values.end(), values.begin(), phoenix::multiplies_fn{},
+                          std::uint64_t{2});
+  phoenix::test::eq(values[0], std::uint64_t{6}, prefix + " in place product");
+  phoenix::test::eq(values[4], std::uint64_t{486}, prefix + " in place product");
+
+  phoenix::array<double, 10> halves;
+  for (auto& v : halves) v = 0.5;
+  phoenix::exclusive_scan(policy, halves.begin(), halves.end(), halves.begin(), 1.0);
+  phoenix::test::eq(halves[0], 1.0, prefix + " in place exclusive over array");
+  phoenix::test::eq(halves[9], 5.5, prefix + " in place exclusive over array");
+
+  short raw[6] = {1, 2, 3, 4, 5, 6};
+  long scanned[6];
+  phoenix::inclusive_scan(policy, raw, raw + 6, scanned, phoenix::plus_fn{}, 100l);
+  phoenix::test::eq(scanned[5], 121l, prefix + " pointers with a different output type");
+}
+
+void scans() {
+  check_scans(execution::seq, "seq");
+  check_scans(execution::unseq, "unseq");
+  check_scans(execution::par.chunk(4), "par");
+  check_scans(execution::par.chunk(256), "par");
+}
+
+// Associative, but not commutative - scans may regroup it, never reorder it
+struct first_nonzero {
+  int operator()(int a, int b) const { return a != 0 ? a : b; }
+};
+
+void non_commutative_scans() {
+  phoenix::vector<int> values(1000), seq(1000), par(1000);
+  for (std::size_t i = 0; i < values.size(); i++) values[i] = i % 97 < 90 ? 0 : static_cast<int>(i);
+
+  phoenix::inclusive_scan(execution::seq, values.begin(), values.end(), seq.begin(), first_nonzero{});
+  phoenix::inclusive_scan(execution::par.chunk(64), values.begin(), values.end(), par.begin(), first_nonzero{});
+  phoenix::test::eq(phoenix::equal(par.begin(), par.end(), seq.begin()), true, "par inclusive scan reordered");
+
+  phoenix::exclusive_scan(execution::seq, values.begin(), values.end(), seq.begin(), 0, first_nonzero{});
+  phoenix::exclusive_scan(execution::par.chunk(64), values.begin(), values.end(), par.begin(), 0, first_nonzero{});
+  phoenix::test::eq(phoenix::equal(par.begin(), par.end(), seq.begin()), true, "par exclusive scan reordered");
+}
+
+int main() {
+  phoenix::run_test(transform, "Transform");
+  phoenix::run_test(reduce, "Reduce");
+  phoenix::run_test(deterministic, "Deterministic");
+  phoenix::run_test(transform_reduce, "Transform reduce");
+  phoenix::run_test(scans, "Scans");
+  phoenix::run_test(non_commutative_scans, "Non-commutative scans");
+}
@@ -0,0 +1,156 @@
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <phoenix/object_pool.hpp>
+#include <phoenix/test.hpp>
+#include <phoenix/vector.hpp>
+
+struct node {
+  std::uint64_t key;
+  std::string name;
+  node* next;
+
+  node(std::uint64_t k, const std::string& n) : key{k}, name{n}, next{nullptr} {
+    if (n == "throw") throw std::invalid_argument("bad name");
+  }
+};
+
+void single_thread() {
+  phoenix::object_pool<node> pool;
+  phoenix::test::eq(pool.stats().slabs, std::size_t{0}, "no slabs before the first allocation");
+
+  phoenix::vector<node*> nodes;
+  for (std::uint64_t i = 0; i < 5000; i++) nodes.push(pool.create(i, std::to_string(i)));
+  bool valid = true;
+  for (std::size_t i = 0; i < nodes.size(); i++) valid &= nodes[i]->key == i && nodes[i]->name == std::to_string(i);
+  phoenix::test::eq(valid, true, "objects keep their values");
+
+  auto stats = pool.stats();
+  phoenix::test::eq(stats.in_use, std::size_t{5000}, "objects in use");
+  phoenix::test::eq(stats.capacity, stats.slabs * phoenix::object_pool<node>::slab_objects, "capacity of slabs");
+  phoenix::test::eq(stats.in_use + stats.cached + stats.free, stats.capacity, "every object counted once");
+
+  // Freed objects are reused before new slabs are made
+  for (std::size_t i = 0; i < nodes.size(); i++) pool.destroy(nodes[i]);
+  phoenix::test::eq(pool.stats().in_use, std::size_t{0}, "nothing in use after freeing");
+  std::size_t slabs = pool.stats().slabs;
+  for (std::size_t i = 0; i < nodes.size(); i++) nodes[i] = pool.create(i, "again");
+  phoenix::test::eq(pool.stats().slabs, slabs, "slabs reused");
+  phoenix::test::leq(pool.stats().occupancy(), 1.0, "occupancy");
+  for (std::size_t i = 0; i < nodes.size(); i++) pool.destroy(nodes[i]);
+
+  // A throwing constructor gives the storage back
+  bool thrown = false;
+  try {
+    pool.create(1, "throw");
+  } catch (const std::invalid_argument&) {
+    thrown = true;
+  }
+  phoenix::test::eq(thrown, true, "constructor exception passed on");
+  phoenix::test::eq(pool.stats().in_use, std::size_t{0}, "storage returned after an exception");
+  pool.destroy(nullptr);
+}
+
+// Objects allocated by producers are freed by consumers, caches of exited threads return to the depot
+void many_threads() {
+  phoenix::object_pool<std::uint64_t, 16> pool;
+  constexpr int threads = 4;
+  constexpr std::uint64_t count = 20000;
+  std::atomic<std::uint64_t*> slots[threads];
+  for (auto& slot : slots) slot.store(nullptr);
+  std::atomic<std::uint64_t> sum{0};
+
+  std::thread workers[2 * threads];
+  for (int t = 0; t < threads; t++) {
+    workers[2 * t] = std::thread([&, t]() {
+      for (std::uint64_t i = 1; i <= count; i++) {
+        std::uint64_t* object = pool.allocate();
+        *object = i;
+        while (slots[t].load() != nullptr) std::this_thread::yield();
+        slots[t].store(object);
+      }
+    });
+    workers[2 * t + 1] = std::thread([&, t]() {
+      for (std::uint64_t i = 1; i <= count; i++) {
+        std::uint64_t* object;
+        while ((object = slots[t].exchange(nullptr)) == nullptr) std::this_thread::yield();
+        sum += *object;
+        pool.deallocate(object);
+      }
+    });
+  }
+  for (auto& worker : workers) worker.join();
+
+  phoenix::test::eq(sum.load(), threads * count * (count + 1) / 2, "every object passed once");
+  auto stats = pool.stats();
+  phoenix::test::eq(stats.in_use, std::size_t{0}, "nothing in use");
+  phoenix::test::eq(stats.cached, std::size_t{0}, "caches of exited threads returned");
+  phoenix::test::eq(stats.free, stats.capacity, "all objects free");
+}
+
+void allocator() {
+  std::list<int, phoenix::pool_allocator<int>> list;
+  for (int i = 0; i < 1000; i++) list.push_back(i);
+  long sum = 0;
+  for (int v : list) sum += v;
+  phoenix::test::eq(sum, 499500l, "list with pool allocator");
+
+  std::map<int, std::string, std::less<int>, phoenix::pool_allocator<std::pair<const int, std::string>>> map;
+  for (int i = 0; i < 1000; i++) map[i] = std::to_string(i);
+  map.erase(500);
+  phoenix::test::eq(map.size(), std::size_t{999}, "map with pool allocator");
+  phoenix::test::eq(map[999], std::string("999"), "map values");
+
+  phoenix::pool_allocator<int> ints;
+  phoenix::pool_allocator<double> doubles(ints);
+  phoenix::test::eq(ints == doubles, true, "allocators are interchangeable");
+  double* array = doubles.allocate(10);
+  array[9] = 1.0;
+  doubles.deallocate(array, 10);
+}
+
+// Destroyed after the thread-local magazines of the main thread, so nodes go straight to the depot
+struct static_containers {
+  std::list<long, phoenix::pool_allocator<long>> list;
+  std::vector<long*> objects;
+
+  ~static_containers() {
+    list.clear();
+    list.push_back(1);
+
+    auto& pool = phoenix::pool_allocator<long>::pool();
+    std::size_t in_use = pool.stats().in_use;
+    phoenix::pool_allocator<long> allocator;
+    for (long* object : objects) allocator.deallocate(object, 1);
+    allocator.deallocate(allocator.allocate(1), 1);
+    if (pool.stats().in_use + objects.size() != in_use) {
+      std::cerr << "Objects freed at exit weren't returned to the pool" << std::endl;
+      std::_Exit(1);
+    }
+  }
+};
+
+static_containers statics;
+
+void static_storage() {
+  phoenix::pool_allocator<long> allocator;
+  for (long i = 0; i < 1000; i++) {
+    statics.list.push_back(i);
+    statics.objects.push_back(allocator.allocate(1));
+  }
+  phoenix::test::eq(statics.list.size(), std::size_t{1000});
+}
+
+int main() {
+  phoenix::run_test(single_thread, "Single thread");
+  phoenix::run_test(many_threads, "Many threads");
+  phoenix::run_test(allocator, "Allocator");
+  phoenix::run_test(static_storage, "Container with static storage duration");
+}
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <queue>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <phoenix/priority_queue.hpp>
+#include <phoenix/test.hpp>
+#include <phoenix/utility.hpp>
+#include <phoenix/vector.hpp>
+
+template <std::size_t Arity>
+void check_against_std() {
+  std::string name = "Arity " + std::to_string(Arity);
+  std::mt19937 gen(static_cast<unsigned>(Arity));
+  phoenix::priority_queue<int, phoenix::greater_fn, Arity> queue;
+  std::priority_queue<int> expected;
+  for (int i = 0; i < 20000; i++) {
+    if (gen() % 3 == 0 && !expected.empty()) {
+      phoenix::test::eq(queue.pop(), expected.top(), name + ": pop");
+      expected.pop();
+    } else {
+      int value = static_cast<int>(gen() % 1000);
+      queue.push(value);
+      expected.push(value);
+    }
+    phoenix::test::eq(queue.size(), expected.size(), name + ": size");
+    if (!expected.empty()) phoenix::test::eq(queue.top(), expected.top(), name + ": top");
+  }
+  while (!expected.empty()) {
+    phoenix::test::eq(queue.pop(), expected.top(), name + ": draining pop");
+    expected.pop();
+  }
+  phoenix::test::eq(queue.empty(), true, name + ": empty");
+}
+
+void push_and_pop() {
+  check_against_std<2>();
+  check_against_std<3>();
+  check_against_std<4>();
+  check_against_std<8>();
+}
+
+void heapify() {
+  for (std::size_t length : {0u, 1u, 2u, 5u, 9u, 100u, 1001u}) {
+    std::mt19937 gen(static_cast<unsigned>(length));
+    phoenix::vector<int> values(length);
+    std::vector<int> sorted(length);
+    for (std::size_t i = 0; i < length; i++) sorted[i] = values[i] = static_cast<int>(gen() % 500);
+    std::sort(sorted.begin(), sorted.end());
+
+    // Smallest on top
+    phoenix::priority_queue<int, phoenix::less_fn, 8> queue(values);
+    for (std::size_t i = 0; i < length; i++) {
+      phoenix::test::eq(queue.pop(), sorted[i], std::to_string(length) + " elements: pop after heapify");
+    }
+    phoenix::priority_queue<int> from_range(sorted.begin(), sorted.end());
+    if (length > 0) phoenix::test::eq(from_range.top(), sorted.back(), "Biggest on top");
+  }
+
+  phoenix::priority_queue<int> empty;
+  bool thrown = false;
+  try {
+    empty.pop();
+  } catch (const std::out_of_range&) {
+    thrown = true;
+  }
+  phoenix::test::eq(thrown, true, "Popping an empty queue throws");
+}
+
+void indexed() {
+  std::mt19937 gen(9);
+  phoenix::indexed_priority_queue<int, phoenix::less_fn, 4> queue;
+  // Reference: handle -> value, plus ordered (value, handle) pairs
+  std::map<std::size_t, int> values;
+  std::set<std::pair<int, std::size_t>> ordered;
+  for (int i = 0; i < 30000; i++) {
+    unsigned operation = gen() % 6;
+    if (values.empty() || operation < 2) {
+      int value = static_cast<int>(gen() % 100000);
+      auto h = queue.push(value);
+      phoenix::test::eq(values.count(h), 0u, "Handle of a live element isn't reused");
+      values[h] = value;
+      ordered.insert({value, h});
+    } else {
+      auto chosen = values.begin();
+      std::advance(chosen, gen() % values.size());
+      auto h = chosen->first;
+      int old = chosen->second;
+      ordered.erase({old, h});
+      if (operation == 2) {
+        int value = old - static_cast<int>(gen() % 1000);
+        queue.decrease_key(h, value);
+        chosen->second = value;
+        ordered.insert({value, h});
+      } else if (operation == 3) {
+        int value = static_cast<int>(gen() % 100000);
+        queue.update(h, value);
+        chosen->second = value;
+        ordered.insert({value, h});
+      } else if (operation == 4) {
+        queue.erase(h);
+        values.erase(chosen);
+        phoenix::test::eq(queue.contains(h), false, "Erased handle");
+      } else {
+        ordered.insert({old, h});
+        phoenix::test::eq(queue.top(), ordered.begin()->first, "top before pop");
+        auto top = queue.top_handle();
+        phoenix::test::eq(queue.value(top), ordered.begin()->first, "Value of the top handle");
+        queue.pop();
+        ordered.erase({values[top], top});
+        values.erase(top);
+      }
+    }
+    phoenix::test::eq(queue.size(), values.size(), "Size");
+    if (!values.empty()) phoenix::test::eq(queue.top(), ordered.begin()->first, "top");
+  }
+  for (const auto& element : values) phoenix::test::eq(queue.value(element.first), element.second, "Values by handle");
+}
+
+void indexed_errors() {
+  phoenix::indexed_priority_queue<int> queue;
+  auto h = queue.push(5);
+  bool thrown = false;
+  try {
+    queue.decrease_key(h, 3);
+  } catch (const std::invalid_argument&) {
+    thrown = true;
+  }
+  phoenix::test::eq(thrown, true, "decrease_key towards the bottom throws");
+  queue.decrease_key(h, 7);
+  phoenix::test::eq(queue.top(), 7, "decrease_key towards the top");
+
+  thrown = false;
+  try {
+    queue.update(h + 1, 1);
+  } catch (const std::out_of_range&) {
+    thrown = true;
+  }
+  phoenix::test::eq(thrown, true, "Unknown handle throws");
+}
+
+// Popped values are moved out before the hole is refilled, moved-from strings are empty
+void indexed_strings() {
+  std::vector<std::string> words{"m", "c", "x", "a", "q", "b", "z", "d", "k"};
+  phoenix::indexed_priority_queue<std::string> queue;
+  for (const auto& word : words) queue.push(word);
+  auto erased = queue.push("y");
+  queue.erase(erased);
+
+  std::sort(words.begin(), words.end(), std::greater<std::string>());
+  for (const auto& word : words) phoenix::test::eq(queue.pop(), word, "Strings popped in order");
+  phoenix::test::eq(queue.empty(), true, "Empty after popping");
+}
+
+int main() {
+  phoenix::run_test(push_and_pop, "priority_queue push and pop");
+  phoenix::run_test(heapify, "priority_queue heapify");
+  phoenix::run_test(indexed, "indexed_priority_queue operations");
+  phoenix::run_test(indexed_errors, "indexed_priority_queue errors");
+  phoenix::run_test(indexed_strings, "indexed_priority_queue of strings");
+}
@@ -0,0 +1,118 @@
+#include <list>
+#include <string>
+#include <phoenix/algorithm.hpp>
+#include <phoenix/array.hpp>
+#include <phoenix/ranges.hpp>
+#include <phoenix/test.hpp>
+#include <phoenix/vector.hpp>
+
+phoenix::vector<int> iota(int n) {
+  phoenix::vector<int> values(static_cast<std::size_t>(n));
+  for (int i = 0; i < n; i++) values[static_cast<std::size_t>(i)] = i;
+  return values;
+}
+
+template <typename Range>
+bool same(const Range& range, const phoenix::vector<int>& expected) {
+  auto values = phoenix::to_vector(range);
+  return values.size() == expected.size() && phoenix::equal(values.begin(), values.end(), expected.begin());
+}
+
+void adaptors() {
+  auto values = iota(10);
+  auto square = [](int x) { return x * x; };
+  auto odd = [](int x) { return x % 2 == 1; };
+
+  phoenix::test::eq(same(values | phoenix::views::map(square), {0, 1, 4, 9, 16, 25, 36, 49, 64, 81}), true, "map");
+  phoenix::test::eq(same(values | phoenix::views::filter(odd), {1, 3, 5, 7, 9}), true, "filter");
+  phoenix::test::eq(same(values | phoenix::views::take(3), {0, 1, 2}), true, "take");
+  phoenix::test::eq(same(values | phoenix::views::take(20), iota(10)), true, "take more than there is");
+  phoenix::test::eq(same(values | phoenix::views::drop(7), {7, 8, 9}), true, "drop");
+  phoenix::test::eq((values | phoenix::views::drop(20)).empty(), true, "drop everything");
+
+  auto pipeline = values | phoenix::views::filter(odd) | phoenix::views::map(square) | phoenix::views::drop(1) |
+                  phoenix::views::take(3);
+  phoenix::test::eq(same(pipeline, {9, 25, 49}), true, "pipeline");
+  phoenix::test::eq(same(phoenix::views::map(square)(values | phoenix::views::take(2)), {0, 1}), true,
+                    "adaptor called on a range");
+
+  // Input without random access
+  std::list<int> list{5, 6, 7, 8};
+  phoenix::test::eq(same(list | phoenix::views::drop(1) | phoenix::views::take(2), {6, 7}), true, "list");
+}
+
+void grouping() {
+  auto values = iota(7);
+  auto chunks = phoenix::to_vector(values | phoenix::views::chunk(3));
+  phoenix::test::eq(chunks.size(), std::size_t{3}, "chunk count");
+  phoenix::test::eq(chunks[1].size() + chunks[2].size(), std::size_t{4}, "chunk sizes");
+  phoenix::test::eq(*chunks[2].begin(), 6, "last chunk");
+
+  phoenix::array<std::string, 3> names{"a", "b", "c"};
+  auto zipped = phoenix::to_vector(values | phoenix::views::zip(names));
+  phoenix::test::eq(zipped.size(), std::size_t{3}, "zip stops at the shorter range");
+  phoenix::test::eq(zipped[2].first == 2 && zipped[2].second == "c", true, "zip pairs");
+
+  auto numbered = phoenix::to_vector(names | phoenix::views::enumerate());
+  phoenix::test::eq(numbered[1].first == 1 && numbered[1].second == "b", true, "enumerate");
+
+  int total = 0;
+  for (auto chunk : values | phoenix::views::chunk(2)) {
+    for (int x : chunk) total += x;
+  }
+  phoenix::test::eq(total, 21, "nested iteration");
+}
+
+void laziness() {
+  auto values = iota(1000);
+  int calls = 0;
+  auto counted = [&calls](int x) {
+    calls++;
+    return x + 1;
+  };
+  auto view = values | phoenix::views::map(counted) | phoenix::views::filter([](int x) { return x % 10 == 0; });
+  phoenix::test::eq(calls, 0, "nothing runs before iteration");
+  auto first = phoenix::to_vector(view | phoenix::views::take(2));
+  phoenix::test::eq(first[0] + first[1], 30, "first results");
+  // 20 elements tested by the filter, and the two results evaluated again when read
+  phoenix::test::eq(calls, 22, "elements after the last needed one are not visited");
+
+  // Writes through views go to the container
+  for (auto& x : values | phoenix::views::drop(998)) x = -1;
+  phoenix::test::eq(values[998] + values[999], -2, "writes through a view");
+  for (auto element : values | phoenix::views::enumerate() | phoenix::views::take(3)) element.second *= 10;
+  phoenix::test::eq(values[2], 20, "writes through enumerate");
+}
+
+void sinks() {
+  auto values = iota(100);
+  auto copy = phoenix::to_vector(values);
+  phoenix::test::eq(copy.capacity(), std::size_t{100}, "single allocation for a sized range");
+  phoenix::test::eq(phoenix::equal(copy.begin(), copy.end(), values.begin()), true, "copy");
+
+  auto mapped = values | phoenix::views::map([](int x) { return x * 0.5; }) | phoenix::to_vector();
+  phoenix::test::eq(mapped.capacity(), std::size_t{100}, "mapped range keeps its size");
+  phoenix::test::eq(mapped[99], 49.5, "mapped values");
+
+  auto filtered = values | phoenix::views::filter([](int x) { return x < 70; }) | phoenix::to_vector();
+  phoenix::test::eq(filtered.size(), std::size_t{70}, "unsized range");
+  phoenix::test::leq(filtered.capacity(), std::size_t{140}, "unsized range grows geometrically");
+
+  int sum = 0;
+  phoenix::for_each(values | phoenix::views::map([](int x) { return x * 2; }) |
+                        phoenix::views::filter([](int x) { return x % 3 == 0; }),
+                    [&sum](int x) { sum += x; });
+  phoenix::test::eq(sum, 3366, "for_each");
+
+  // Slices of contiguous ranges keep their iterators
+  auto slice = values | phoenix::views::drop(10) | phoenix::views::take(5);
+  phoenix::test::eq(phoenix::detail::is_contiguous<decltype(slice.begin())>::value, true, "contiguous slice");
+  phoenix::test::eq(slice.size(), std::size_t{5}, "slice size");
+}
+
+int main() {
+  phoenix::run_test(adaptors, "Adaptors");
+  phoenix::run_test(grouping, "Grouping");
+  phoenix::run_test(laziness, "Laziness");
+  phoenix::run_test(sinks, "Sinks");
+}
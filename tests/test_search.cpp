@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <phoenix/search.hpp>
+#include <phoenix/test.hpp>
+#include <phoenix/utility.hpp>
+#include <phoenix/vector.hpp>
+
+const std::size_t sizes[] = {0, 1, 2, 7, 8, 9, 15, 16, 17, 100, 145, 1000, 5000};
+
+// Sorted values with repeats and gaps, so that searched keys hit, miss and fall between runs
+template <typename T>
+std::vector<T> sorted_values(std::size_t length, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::vector<T> values(length);
+  for (auto& value : values) value = static_cast<T>(gen() % (2 * length + 1));
+  std::sort(values.begin(), values.end());
+  return values;
+}
+
+template <typename T>
+void check_index(const char* type) {
+  for (auto size : sizes) {
+    std::string name = std::string(type) + ", " + std::to_string(size) + " keys";
+    auto values = sorted_values<T>(size, static_cast<unsigned>(size));
+    phoenix::sorted_index<T> index(values.begin(), values.end());
+    phoenix::test::eq(index.size(), size, name + ": size");
+    phoenix::test::container_equal(index, values, name + ": keys");
+
+    std::vector<T> queries;
+    for (std::size_t i = 0; i < 2 * size + 3; i++) queries.push_back(static_cast<T>(i));
+    std::vector<std::size_t> lower(queries.size()), upper(queries.size());
+    index.lower_bounds(queries.begin(), queries.end(), lower.begin());
+    index.upper_bounds(queries.begin(), queries.end(), upper.begin());
+
+    for (std::size_t i = 0; i < queries.size(); i++) {
+      T key = queries[i];
+      auto expected_lower = static_cast<std::size_t>(std::lower_bound(values.begin(), values.end(), key) - values.begin());
+      auto expected_upper = static_cast<std::size_t>(std::upper_bound(values.begin(), values.end(), key) - values.begin());
+      std::string query = name + ", key " + std::to_string(key);
+      phoenix::test::eq(index.lower_bound(key), expected_lower, query + ": lower_bound");
+      phoenix::test::eq(index.upper_bound(key), expected_upper, query + ": upper_bound");
+      phoenix::test::eq(lower[i], expected_lower, query + ": lower_bounds");
+      phoenix::test::eq(upper[i], expected_upper, query + ": upper_bounds");
+      phoenix::test::eq(index.contains(key), std::binary_search(values.begin(), values.end(), key),
+                        query + ": contains");
+    }
+  }
+}
+
+void sorted_index_keys() {
+  check_index<std::int8_t>("int8_t");
+  check_index<std::uint16_t>("uint16_t");
+  check_index<std::int32_t>("int32_t");
+  check_index<std::uint64_t>("uint64_t");
+  check_index<double>("double");
+}
+
+void sorted_index_descending() {
+  std::vector<int> values = {9, 7, 7, 5, 3, 3, 3, 1, -2, -4, -4, -8, -9, -9, -9, -10, -11, -20};
+  phoenix::sorted_index<int, phoenix::less_fn> index(values.begin(), values.end());
+  for (int key = -22; key <= 11; key++) {
+    auto expected_lower = static_cast<std::size_t>(
+        std::lower_bound(values.begin(), values.end(), key, std::greater<int>()) - values.begin());
+    auto expected_upper = static_cast<std::size_t>(
+        std::upper_bound(values.begin(), values.end(), key, std::greater<int>()) - values.begin());
+    phoenix::test::eq(index.lower_bound(key), expected_lower, "lower_bound of " + std::to_string(key));
+    phoenix::test::eq(index.upper_bound(key), expected_upper, "upper_bound of " + std::to_string(key));
+  }
+}
+
+void sorted_index_copies() {
+  phoenix::vector<long> values = {1, 4, 9, 16, 25, 36, 49, 64, 81, 100, 121, 144};
+  phoenix::sorted_index<long> index(values);
+  phoenix::sorted_index<long> copy(index);
+  phoenix::sorted_index<long> assigned;
+  phoenix::test::eq(assigned.empty(), true, "Default index is empty");
+  phoenix::test::eq(assigned.lower_bound(5L), std::size_t(0), "Empty index lower_bound");
+  assigned = copy;
+  phoenix::sorted_index<long> moved(std::move(index));
+  for (long key = 0; key < 150; key++) {
+    auto expected = moved.lower_bound(key);
+    phoenix::test::eq(copy.lower_bound(key), expected, "Copy lower_bound of " + std::to_string(key));
+    phoenix::test::eq(assigned.lower_bound(key), expected, "Assigned lower_bound of " + std::to_string(key));
+  }
+  phoenix::test::eq(reinterpret_cast<std::uintptr_t>(copy.begin()) % 64, std::uintptr_t(0), "Aligned to cache line");
+}
+
+void sorted_index_unsorted() {
+  std::vector<int> values = {1, 2, 3, 2};
+  bool thrown = false;
+  try {
+    phoenix::sorted_index<int> index(values.begin(), values.end());
+  } catch (const std::invalid_argument&) {
+    thrown = true;
+  }
+  phoenix::test::eq(thrown, true, "Unsorted keys are rejected");
+}
+
+void branchless_search() {
+  for (auto size : sizes) {
+    auto values = sorted_values<int>(size, static_cast<unsigned>(size) + 1);
+    phoenix::vector<int> v(values);
+    for (int key = -1; key <= static_cast<int>(2 * size + 1); key++) {
+      std::string name = std::to_string(size) + " elements, key " + std::to_string(key);
+      auto lower = phoenix::lower_bound(v.cbegin(), v.cend(), key);
+      auto upper = phoenix::upper_bound(v.cbegin(), v.cend(), key);
+      phoenix::test::eq(lower.operator->() - v.data(),
+                        std::lower_bound(values.begin(), values.end(), key) - values.begin(), name + ": lower_bound");
+      phoenix::test::eq(upper.operator->() - v.data(),
+                        std::upper_bound(values.begin(), values.end(), key) - values.begin(), name + ": upper_bound");
+      phoenix::test::eq(phoenix::binary_search(v.cbegin(), v.cend(), key),
+                        std::binary_search(values.begin(), values.end(), key), name + ": binary_search");
+    }
+  }
+}
+
+// Keys of another type than the elements are compared as they are, not converted
+void mixed_types() {
+  phoenix::vector<int> v{1, 2, 2, 3, 5, 8};
+  phoenix::test::eq(phoenix::lower_bound(v.cbegin(), v.cend(), 2.5) - v.cbegin(), 3, "lower_bound truncated 2.5");
+  phoenix::test::eq(phoenix::upper_bound(v.cbegin(), v.cend(), 1.5) - v.cbegin(), 1, "upper_bound truncated 1.5");
+  phoenix::test::eq(phoenix::binary_search(v.cbegin(), v.cend(), 2.5), false, "2.5 was found among integers");
+  phoenix::test::eq(phoenix::upper_bound(v.cbegin(), v.cend(), 8L) - v.cbegin(), 6);
+
+  // Wider elements than the key
+  phoenix::vector<std::int64_t> wide{1, std::int64_t(1) << 40, std::int64_t(1) << 41};
+  phoenix::test::eq(phoenix::lower_bound(wide.cbegin(), wide.cend(), 2) - wide.cbegin(), 1);
+
+  phoenix::vector<std::string> words{"apple", "banana", "cherry"};
+  phoenix::test::eq(phoenix::lower_bound(words.cbegin(), words.cend(), "banana") - words.cbegin(), 1);
+  phoenix::test::eq(phoenix::binary_search(words.cbegin(), words.cend(), "cherry"), true);
+
+  std::vector<int> values{1, 2, 2, 3, 5, 8};
+  phoenix::sorted_index<int> index(values.begin(), values.end());
+  phoenix::test::eq(index.lower_bound(2.5), 3u, "sorted_index::lower_bound truncated 2.5");
+  phoenix::test::eq(index.contains(2.5), false, "sorted_index found 2.5 among integers");
+  std::vector<double> queries{0.5, 2.0, 2.5, 7.9, 9.0};
+  std::vector<std::size_t> lower(queries.size()), upper(queries.size());
+  index.lower_bounds(queries.begin(), queries.end(), lower.begin());
+  index.upper_bounds(queries.begin(), queries.end(), upper.begin());
+  phoenix::test::container_equal(lower, std::vector<std::size_t>{0, 1, 3, 5, 6}, "Batched lower_bounds converted keys");
+  phoenix::test::container_equal(upper, std::vector<std::size_t>{0, 3, 3, 5, 6}, "Batched upper_bounds converted keys");
+}
+
+int main() {
+  phoenix::run_test(sorted_index_keys, "sorted_index lookups");
+  phoenix::run_test(sorted_index_descending, "sorted_index with descending keys");
+  phoenix::run_test(sorted_index_copies, "sorted_index copies");
+  phoenix::run_test(sorted_index_unsorted, "sorted_index with unsorted keys");
+  phoenix::run_test(branchless_search, "Branchless binary search");
+  phoenix::run_test(mixed_types, "Mixed key types");
+}
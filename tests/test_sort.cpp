@@ -1,3 +1,10 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
 #include <phoenix/test.hpp>
 #include <phoenix/vector.hpp>
 #include <phoenix/sort.hpp>
@@ -33,6 +40,59 @@ void selection() {
   phoenix::test::eq(phoenix::is_sorted(a.begin(), a.end(), phoenix::is_lesser), true);
 }
 
+// Copies are counted, moves are not
+struct counted {
+  std::string value;
+  static int copies;
+
+  counted() = default;
+  counted(const std::string& v) : value{v} {}
+  counted(const counted& other) : value{other.value} { copies++; }
+  counted(counted&&) = default;
+  counted& operator=(const counted& other) {
+    value = other.value;
+    copies++;
+    return *this;
+  }
+  counted& operator=(counted&&) = default;
+
+  bool operator>(const counted& other) const { return value > other.value; }
+};
+int counted::copies = 0;
+
+void no_copies() {
+  auto make = []() {
+    phoenix::vector<counted> a(50);
+    std::mt19937 gen(7);
+    for (std::size_t i = 0; i < a.size(); i++) a[i].value = "long enough to be on the heap " + std::to_string(gen() % 100);
+    counted::copies = 0;
+    return a;
+  };
+
+  auto a = make();
+  phoenix::insertion_sort(a.begin(), a.end());
+  phoenix::test::eq(phoenix::is_sorted(a.begin(), a.end()), true);
+  phoenix::test::eq(counted::copies, 0, "Insertion sort copied elements");
+
+  a = make();
+  phoenix::selection_sort(a.begin(), a.end());
+  phoenix::test::eq(phoenix::is_sorted(a.begin(), a.end()), true);
+  phoenix::test::eq(counted::copies, 0, "Selection sort copied elements");
+
+  a = make();
+  phoenix::heap_sort(a.begin(), a.end());
+  phoenix::test::eq(phoenix::is_sorted(a.begin(), a.end()), true);
+  phoenix::test::eq(counted::copies, 0, "Heap sort copied elements");
+
+  a = make();
+  phoenix::sort(a.begin(), a.end());
+  phoenix::test::eq(phoenix::is_sorted(a.begin(), a.end()), true);
+  phoenix::test::eq(counted::copies, 0, "Sort copied elements");
+
+  phoenix::vector<int> empty;
+  phoenix::insertion_sort(empty.begin(), empty.end());
+}
+
 void bogo() {
   phoenix::vector<int> a{2, 8, 4, 1, 3};
 
@@ -43,9 +103,203 @@ void bogo() {
   phoenix::test::eq(phoenix::is_sorted(a.begin(), a.end(), phoenix::is_lesser), true);
 }
 
+void heap() {
+  phoenix::vector<int> a{2, 8, 4, 1, 3, 6, 2, 3, 2, 5, 23, 67, 32, 643, 756, 4236, 34, 1, 3, 7};
+
+  phoenix::heap_sort(a.begin(), a.end());
+  phoenix::test::eq(phoenix::is_sorted(a.begin(), a.end()), true);
+
+  phoenix::heap_sort(a.begin(), a.end(), phoenix::is_lesser);
+  phoenix::test::eq(phoenix::is_sorted(a.begin(), a.end(), phoenix::is_lesser), true);
+}
+
+void generic_sort() {
+  std::mt19937 gen(42);
+  phoenix::vector<long> a;
+  for (int i = 0; i < 5000; i++) a.push(static_cast<long>(gen() % 100));
+
+  phoenix::sort(a.begin(), a.end());
+  phoenix::test::eq(phoenix::is_sorted(a.begin(), a.end()), true, "Sorting with duplicates failed");
+
+  phoenix::sort(a.begin(), a.end(), phoenix::is_lesser);
+  phoenix::test::eq(phoenix::is_sorted(a.begin(), a.end(), phoenix::is_lesser), true, "Descending sort failed");
+
+  phoenix::vector<long> empty;
+  phoenix::sort(empty.begin(), empty.end());
+  phoenix::test::eq(empty.size(), 0u);
+}
+
+template <typename T>
+void simd_sort_type(phoenix::simd_level level, std::size_t length) {
+  phoenix::cpu::set_level_limit(level);
+  std::mt19937_64 gen(length);
+
+  // random, few unique keys, already sorted
+  for (int pattern = 0; pattern < 3; pattern++) {
+    phoenix::vector<T> a(length);
+    std::vector<T> expected(length);
+    for (std::size_t i = 0; i < length; i++) {
+      T x = pattern == 0 ? static_cast<T>(gen() % 1000000) : (pattern == 1 ? static_cast<T>(gen() % 3) : static_cast<T>(i));
+      a[i] = x;
+      expected[i] = x;
+    }
+    std::sort(expected.begin(), expected.end());
+
+    phoenix::sort(a.begin(), a.end());
+    phoenix::test::container_equal(a, expected, "Vectorized sort result differs from std::sort");
+
+    phoenix::sort(a.begin(), a.end(), phoenix::is_lesser);
+    std::reverse(expected.begin(), expected.end());
+    phoenix::test::container_equal(a, expected, "Vectorized descending sort result differs from std::sort");
+  }
+  phoenix::cpu::set_level_limit(phoenix::simd_level::avx512);
+}
+
+void simd_sort() {
+  for (auto level : {phoenix::simd_level::scalar, phoenix::simd_level::avx2, phoenix::simd_level::avx512}) {
+    for (std::size_t length : {1u, 2u, 15u, 16u, 17u, 64u, 127u, 128u, 129u, 1000u, 65537u}) {
+      simd_sort_type<std::int32_t>(level, length);
+      simd_sort_type<float>(level, length);
+      simd_sort_type<std::uint64_t>(level, length);
+      simd_sort_type<double>(level, length);
+    }
+  }
+}
+
+// Sorts keys mixing -0.0, +0.0 and NaN, which compare equal or unordered - the result has to
+// stay a permutation of the input, so the sorted bit patterns have to match
+template <typename T, typename Bits>
+void signed_zeros_type(phoenix::simd_level level, std::size_t length) {
+  phoenix::cpu::set_level_limit(level);
+  std::mt19937_64 gen(length);
+  const T choices[] = {-0.0, 0.0, std::numeric_limits<T>::quiet_NaN(), 1.0, -1.0};
+
+  for (int run = 0; run < 20; run++) {
+    phoenix::vector<T> a(length);
+    std::vector<Bits> expected(length), result(length);
+    for (std::size_t i = 0; i < length; i++) {
+      a[i] = choices[gen() % (run % 2 == 0 ? 2 : 5)];
+      std::memcpy(&expected[i], &a[i], sizeof(T));
+    }
+
+    phoenix::sort(a.begin(), a.end());
+    for (std::size_t i = 0; i < length; i++) std::memcpy(&result[i], &a[i], sizeof(T));
+    std::sort(expected.begin(), expected.end());
+    std::sort(result.begin(), result.end());
+    phoenix::test::container_equal(result, expected, "Vectorized sort lost or duplicated signed zeros or NaN");
+  }
+  phoenix::cpu::set_level_limit(phoenix::simd_level::avx512);
+}
+
+void simd_sort_signed_zeros() {
+  for (auto level : {phoenix::simd_level::scalar, phoenix::simd_level::avx2, phoenix::simd_level::avx512}) {
+    for (std::size_t length : {2u, 16u, 17u, 64u, 100u, 128u, 1000u}) {
+      signed_zeros_type<float, std::uint32_t>(level, length);
+      signed_zeros_type<double, std::uint64_t>(level, length);
+    }
+  }
+}
+
+struct record {
+  long key;
+  std::size_t id;
+  std::string name;
+};
+
+void by_key() {
+  std::mt19937 gen(7);
+  phoenix::vector<record> a(3000);
+  std::vector<record> expected(3000);
+  for (std::size_t i = 0; i < a.size(); i++) {
+    a[i] = record{static_cast<long>(gen() % 100) - 50, i, std::to_string(gen() % 500)};
+    expected[i] = a[i];
+  }
+
+  // integer keys - radix sort
+  phoenix::stable_sort_by_key(a.begin(), a.end(), [](const record& r) { return r.key; });
+  std::stable_sort(expected.begin(), expected.end(), [](const record& x, const record& y) { return x.key < y.key; });
+  for (std::size_t i = 0; i < a.size(); i++) phoenix::test::eq(a[i].id, expected[i].id, "Stable sort by integer key");
+
+  phoenix::stable_sort_by_key(a.begin(), a.end(), [](const record& r) { return r.key; }, phoenix::less_fn{});
+  std::stable_sort(expected.begin(), expected.end(), [](const record& x, const record& y) { return x.key > y.key; });
+  for (std::size_t i = 0; i < a.size(); i++) phoenix::test::eq(a[i].id, expected[i].id, "Descending stable sort");
+
+  // comparison-sorted keys
+  phoenix::stable_sort_by_key(a.begin(), a.end(), [](const record& r) { return r.name; });
+  std::stable_sort(expected.begin(), expected.end(), [](const record& x, const record& y) { return x.name < y.name; });
+  for (std::size_t i = 0; i < a.size(); i++) phoenix::test::eq(a[i].id, expected[i].id, "Stable sort by string key");
+
+  phoenix::sort_by_key(a.begin(), a.end(), [](const record& r) { return r.key * 0.5; });
+  for (std::size_t i = 1; i < a.size(); i++) phoenix::test::leq(a[i - 1].key, a[i].key, "Sort by floating key");
+  phoenix::sort_by_key(a.begin(), a.end(), [](const record& r) { return r.key; });
+  for (std::size_t i = 1; i < a.size(); i++) phoenix::test::leq(a[i - 1].key, a[i].key, "Sort by integer key");
+}
+
+void argsort() {
+  phoenix::vector<int> a{50, 10, 40, 20, 30};
+  auto order = phoenix::argsort(a.begin(), a.end());
+  phoenix::test::container_equal(order, std::vector<std::size_t>{1, 3, 4, 2, 0}, "Argsort order is wrong");
+  phoenix::test::container_equal(a, std::vector<int>{50, 10, 40, 20, 30}, "Argsort moved the elements");
+
+  auto descending = phoenix::argsort<std::uint32_t>(a.begin(), a.end(), phoenix::less_fn{});
+  phoenix::test::container_equal(descending, std::vector<std::uint32_t>{0, 2, 4, 3, 1},
+                                 "Descending argsort order is wrong");
+
+  phoenix::vector<int> empty;
+  phoenix::test::eq(phoenix::argsort(empty.begin(), empty.end()).size(), 0u);
+}
+
+void apply_permutation() {
+  std::mt19937 gen(3);
+  phoenix::vector<record> records(1000);
+  phoenix::vector<std::size_t> ids(1000);
+  std::vector<std::string> names(1000);
+  for (std::size_t i = 0; i < records.size(); i++) {
+    records[i] = record{static_cast<long>(gen() % 200), i, std::to_string(i)};
+    ids[i] = i;
+    names[i] = std::to_string(i);
+  }
+
+  auto order = phoenix::argsort(records.begin(), records.end(),
+                                [](const record& x, const record& y) { return x.key > y.key; });
+  phoenix::apply_permutation(order, records, ids, names);
+
+  for (std::size_t i = 0; i < records.size(); i++) {
+    if (i > 0) phoenix::test::leq(records[i - 1].key, records[i].key, "Permuted records aren't sorted");
+    phoenix::test::eq(records[i].id, order[i], "Record moved to wrong position");
+    phoenix::test::eq(ids[i], order[i], "Parallel container permuted differently");
+    phoenix::test::eq(names[i], records[i].name, "Parallel std::vector permuted differently");
+  }
+
+  try {
+    phoenix::vector<int> shorter(10);
+    phoenix::apply_permutation(order, shorter);
+    throw phoenix::test_exception("Permutation applied to container of different size");
+  } catch (const std::invalid_argument&) {
+  }
+
+  phoenix::vector<int> values{1, 2, 3};
+  for (auto invalid : {phoenix::vector<std::size_t>{0, 0, 2}, phoenix::vector<std::size_t>{0, 1, 3}}) {
+    try {
+      phoenix::apply_permutation(invalid, values);
+      throw phoenix::test_exception("Invalid permutation accepted");
+    } catch (const std::invalid_argument&) {
+    }
+  }
+  phoenix::test::container_equal(values, std::vector<int>{1, 2, 3}, "Invalid permutation modified the container");
+}
+
 int main() {
   phoenix::run_test(insertion, "Insertion sort");
   phoenix::run_test(bubble, "Bubble sort");
   phoenix::run_test(selection, "Selection sort");
+  phoenix::run_test(no_copies, "No copies");
   phoenix::run_test(bogo, "Bogo sort");
+  phoenix::run_test(heap, "Heap sort");
+  phoenix::run_test(generic_sort, "Sort");
+  phoenix::run_test(simd_sort, "Vectorized sort");
+  phoenix::run_test(simd_sort_signed_zeros, "Vectorized sort of signed zeros and NaN");
+  phoenix::run_test(by_key, "Sort by key");
+  phoenix::run_test(argsort, "Argsort");
+  phoenix::run_test(apply_permutation, "Apply permutation");
 }
\ No newline at end of file
@@ -0,0 +1,152 @@
+#include <stdexcept>
+#include <phoenix/algorithm.hpp>
+#include <phoenix/array.hpp>
+#include <phoenix/sort.hpp>
+#include <phoenix/span.hpp>
+#include <phoenix/test.hpp>
+#include <phoenix/utility.hpp>
+#include <phoenix/vector.hpp>
+
+int sum(phoenix::span<const int> values) {
+  int total = 0;
+  for (int value : values) total += value;
+  return total;
+}
+
+void conversions() {
+  phoenix::vector<int> vec{1, 2, 3, 4, 5};
+  const phoenix::vector<int>& constant = vec;
+  phoenix::array<int, 4> arr{1, 2, 3, 4};
+  int raw[3] = {7, 8, 9};
+
+  phoenix::test::eq(sum(vec), 15, "from vector");
+  phoenix::test::eq(sum(constant), 15, "from const vector");
+  phoenix::test::eq(sum(arr), 10, "from array");
+  phoenix::test::eq(sum(raw), 24, "from C array");
+  phoenix::test::eq(sum({raw, 2}), 15, "from pointer and count");
+
+  // Views share the storage
+  phoenix::span<int> view(vec);
+  view[0] = 10;
+  phoenix::test::eq(vec[0], 10, "writes go to the container");
+  phoenix::test::eq(view.data() == constant.data(), true, "no copy");
+  phoenix::test::eq(view.size_bytes(), 5 * sizeof(int), "size in bytes");
+
+  phoenix::span<int, 4> fixed(arr);
+  phoenix::span<const int> dynamic = fixed;
+  phoenix::test::eq(sizeof(fixed), sizeof(int*), "static extent stores only the pointer");
+  phoenix::test::eq(dynamic.size(), std::size_t{4}, "static to dynamic extent");
+  phoenix::test::eq(phoenix::make_span(arr).extent, std::size_t{4}, "extent deduced from array");
+
+  phoenix::span<int> empty;
+  phoenix::test::eq(empty.empty(), true, "default span is empty");
+  bool thrown = false;
+  try {
+    view.at(5);
+  } catch (const std::out_of_range&) {
+    thrown = true;
+  }
+  phoenix::test::eq(thrown, true, "at out of range");
+}
+
+void subspans() {
+  phoenix::vector<int> vec{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  phoenix::span<int> view(vec);
+
+  phoenix::test::eq(sum(view.first(3)), 3, "first");
+  phoenix::test::eq(sum(view.last(2)), 17, "last");
+  phoenix::test::eq(sum(view.subspan(4, 3)), 15, "subspan");
+  phoenix::test::eq(view.subspan(7).front(), 7, "subspan to the end");
+
+  auto head = view.first<3>();
+  auto tail = view.last<2>();
+  phoenix::test::eq(head.extent + tail.extent, std::size_t{5}, "static first and last");
+  phoenix::test::eq(tail.back(), 9, "static last");
+
+  phoenix::array<int, 6> arr{0, 1, 2, 3, 4, 5};
+  auto middle = phoenix::make_span(arr).subspan<1, 3>();
+  auto rest = phoenix::make_span(arr).subspan<2>();
+  phoenix::test::eq(middle.extent, std::size_t{3}, "static subspan");
+  phoenix::test::eq(rest.extent, std::size_t{4}, "static subspan to the end");
+  phoenix::test::eq(sum(rest), 14, "static subspan contents");
+}
+
+void algorithms() {
+  phoenix::vector<int> vec{9, 3, 7, 1, 8, 2, 6, 4, 5, 0};
+  phoenix::span<int> view(vec);
+
+  // Only the middle is sorted
+  phoenix::sort(view.begin() + 2, view.end() - 2);
+  phoenix::vector<int> expected{9, 3, 1, 2, 4, 6, 7, 8, 5, 0};
+  phoenix::test::eq(phoenix::equal(vec.begin(), vec.end(), expected.begin()), true, "sort a slice");
+
+  auto slice = view.subspan(2, 6);
+  phoenix::test::eq(phoenix::is_sorted(slice.begin(), slice.end()), true, "sorted slice");
+  phoenix::test::eq(phoenix::count(view.begin(), view.end(), 7), std::size_t{1}, "count");
+  auto bounds = phoenix::minmax_element(slice.begin(), slice.end());
+  phoenix::test::eq(*bounds.first + *bounds.second, 9, "minmax element");
+
+  phoenix::sort(view.begin(), view.end(), phoenix::less_fn{});
+  phoenix::test::eq(view.front(), 9, "sort whole view descending");
+}
+
+void strided() {
+  // 4 rows, 3 columns
+  phoenix::vector<int> matrix{5, 10, 0, 2, 11, 1, 8, 12, 2, 1, 13, 3};
+  phoenix::span<int> cells(matrix);
+
+  auto first_column = phoenix::column(cells, 3, 0);
+  phoenix::test::eq(first_column.size(), std::size_t{4}, "column size");
+  phoenix::test::eq(first_column[2], 8, "column access");
+
+  phoenix::sort(first_column.begin(), first_column.end());
+  phoenix::vector<int> expected{1, 10, 0, 2, 11, 1, 5, 12, 2, 8, 13, 3};
+  phoenix::test::eq(phoenix::equal(matrix.begin(), matrix.end(), expected.begin()), true,
+                    "sorting a column keeps the other columns");
+  phoenix::test::eq(phoenix::is_sorted(first_column.begin(), first_column.end()), true, "sorted column");
+
+  auto last_column = phoenix::column(cells, 3, 2);
+  phoenix::sort(last_column.begin(), last_column.end(), phoenix::less_fn{});
+  phoenix::test::eq(last_column.front() == 3 && last_column.back() == 0, true, "column sorted descending");
+  phoenix::test::eq(sum(phoenix::row(cells, 3, 1)), 2 + 11 + 2, "row");
+
+  // Reversed view through a negative stride
+  phoenix::strided_span<int> reversed(&matrix[matrix.size() - 1], matrix.size(), -1);
+  phoenix::test::eq(reversed[0], 0, "negative stride");
+  phoenix::test::eq(reversed.end() - reversed.begin(), std::ptrdiff_t{12}, "negative stride distance");
+  phoenix::test::eq(reversed.every(4).size(), std::size_t{3}, "every n-th element");
+  phoenix::test::eq(phoenix::count(reversed.begin(), reversed.end(), 2), std::size_t{2}, "count in strided view");
+  phoenix::test::eq(reversed.subspan(12).empty(), true, "empty subspan at the end");
+  phoenix::test::eq(last_column.end() - last_column.begin(), std::ptrdiff_t{4}, "column distance");
+  phoenix::test::eq(last_column.begin()[3], last_column.back(), "column subscript");
+}
+
+void invalid_strides() {
+  phoenix::vector<int> matrix{0, 1, 2, 3, 4, 5};
+  phoenix::span<int> cells(matrix);
+  int thrown = 0;
+  try {
+    phoenix::strided_span<int>(&matrix[0], 3, 0);
+  } catch (const std::invalid_argument&) {
+    thrown++;
+  }
+  try {
+    phoenix::column(cells, 3, 0).every(0);
+  } catch (const std::invalid_argument&) {
+    thrown++;
+  }
+  try {
+    phoenix::column(cells, 3, 3);
+  } catch (const std::out_of_range&) {
+    thrown++;
+  }
+  phoenix::test::eq(thrown, 3, "zero stride, zero step and column out of range are rejected");
+}
+
+int main() {
+  phoenix::run_test(conversions, "Conversions");
+  phoenix::run_test(subspans, "Subspans");
+  phoenix::run_test(algorithms, "Algorithms");
+  phoenix::run_test(strided, "Strided");
+  phoenix::run_test(invalid_strides, "Invalid strides");
+}
@@ -0,0 +1,94 @@
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <phoenix/spsc_queue.hpp>
+#include <phoenix/test.hpp>
+
+void single_values() {
+  phoenix::spsc_queue<int, 4> queue;
+  int value = 0;
+  phoenix::test::eq(queue.capacity(), std::size_t{4}, "capacity");
+  phoenix::test::eq(queue.try_pop(value), false, "pop from empty queue");
+  for (int i = 0; i < 4; i++) phoenix::test::eq(queue.try_push(i), true, "push into free space");
+  phoenix::test::eq(queue.try_push(4), false, "push into full queue");
+  phoenix::test::eq(queue.size(), std::size_t{4}, "size of full queue");
+
+  // Indices go around the buffer many times
+  for (int i = 4; i < 100; i++) {
+    phoenix::test::eq(queue.try_pop(value), true, "pop");
+    phoenix::test::eq(value, i - 4, "popped value");
+    phoenix::test::eq(queue.try_push(i), true, "push after pop");
+  }
+  for (int i = 96; i < 100; i++) {
+    queue.try_pop(value);
+    phoenix::test::eq(value, i, "draining pop");
+  }
+  phoenix::test::eq(queue.empty(), true, "empty after draining");
+}
+
+void moved_values() {
+  phoenix::spsc_queue<std::string, 2> queue;
+  std::string text(100, 'x');
+  queue.try_push(std::move(text));
+  std::string result;
+  queue.try_pop(result);
+  phoenix::test::eq(result, std::string(100, 'x'), "moved string");
+}
+
+void batches() {
+  phoenix::spsc_queue<int, 8> queue;
+  int input[10], output[10];
+  for (int i = 0; i < 10; i++) input[i] = i;
+
+  phoenix::test::eq(queue.push_n(input, 10), std::size_t{8}, "push_n stops at capacity");
+  phoenix::test::eq(queue.pop_n(output, 5), std::size_t{5}, "pop_n part");
+  for (int i = 0; i < 5; i++) phoenix::test::eq(output[i], i, "pop_n values");
+
+  // Free space is now split between the end and the beginning of the buffer
+  phoenix::test::eq(queue.push_n(input, 5), std::size_t{5}, "wrapping push_n");
+  phoenix::test::eq(queue.pop_n(output, 10), std::size_t{8}, "wrapping pop_n");
+  int expected[] = {5, 6, 7, 0, 1, 2, 3, 4};
+  for (int i = 0; i < 8; i++) phoenix::test::eq(output[i], expected[i], "wrapping pop_n values");
+  phoenix::test::eq(queue.pop_n(output, 10), std::size_t{0}, "pop_n from empty queue");
+  phoenix::test::eq(queue.push_n(input, 0), std::size_t{0}, "empty push_n");
+}
+
+phoenix::spsc_queue<std::uint64_t, 64> shared_queue;
+
+// Consumer must see every value exactly once and in order, with single and batched operations mixed
+void two_threads() {
+  constexpr std::uint64_t count = 200000;
+  std::thread producer([]() {
+    std::uint64_t batch[7];
+    for (std::uint64_t next = 0; next < count;) {
+      if (next % 3 == 0) {
+        if (shared_queue.try_push(next)) next++;
+        else std::this_thread::yield();
+      } else {
+        std::size_t length = 0;
+        for (; length < 7 && next + length < count; length++) batch[length] = next + length;
+        std::size_t pushed = shared_queue.push_n(batch, length);
+        if (pushed == 0) std::this_thread::yield();
+        next += pushed;
+      }
+    }
+  });
+
+  bool in_order = true;
+  std::uint64_t batch[5];
+  for (std::uint64_t expected = 0; expected < count;) {
+    std::size_t popped = expected % 2 == 0 ? shared_queue.pop_n(batch, 5) : shared_queue.try_pop(batch[0]);
+    if (popped == 0) std::this_thread::yield();
+    for (std::size_t i = 0; i < popped; i++) in_order &= batch[i] == expected++;
+  }
+  producer.join();
+  phoenix::test::eq(in_order, true, "values passed between threads in order");
+  phoenix::test::eq(shared_queue.empty(), true, "empty after transfer");
+}
+
+int main() {
+  phoenix::run_test(single_values, "Single values");
+  phoenix::run_test(moved_values, "Moved values");
+  phoenix::run_test(batches, "Batches");
+  phoenix::run_test(two_threads, "Two threads");
+}
@@ -0,0 +1,146 @@
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <phoenix/hash.hpp>
+#include <phoenix/hash_map.hpp>
+#include <phoenix/sort.hpp>
+#include <phoenix/string.hpp>
+#include <phoenix/test.hpp>
+#include <phoenix/vector.hpp>
+
+void small_and_large() {
+  phoenix::test::eq(sizeof(phoenix::string), std::size_t{24}, "string takes three words");
+
+  phoenix::string empty;
+  phoenix::test::eq(empty.size(), std::size_t{0}, "empty");
+  phoenix::test::eq(empty.c_str()[0], '\0', "empty string is terminated");
+
+  // 22 characters still fit inside the object
+  phoenix::string small("abcdefghijklmnopqrstuv");
+  phoenix::test::eq(small.size(), std::size_t{22}, "small size");
+  phoenix::test::eq(small.capacity(), std::size_t{22}, "small capacity");
+  phoenix::test::eq(std::string(small.c_str()), std::string("abcdefghijklmnopqrstuv"), "small contents");
+
+  phoenix::string large("abcdefghijklmnopqrstuvw");
+  phoenix::test::eq(large.size(), std::size_t{23}, "large size");
+  phoenix::test::eq(large.back(), 'w', "large contents");
+  phoenix::test::eq(large.c_str()[23], '\0', "large string is terminated");
+
+  phoenix::string copy(large), moved(std::move(copy));
+  phoenix::test::eq(moved == large, true, "copy and move");
+  phoenix::test::eq(copy.empty(), true, "moved-from string is empty");
+  copy = small;
+  small = large;
+  large = copy;
+  phoenix::test::eq(large.size() + small.size(), std::size_t{45}, "assignment between representations");
+  small = std::move(large);
+  phoenix::test::eq(small == "abcdefghijklmnopqrstuv", true, "move assignment");
+
+  phoenix::string filled(30, 'x');
+  phoenix::test::eq(filled.find('y'), phoenix::npos, "filled");
+  filled.resize(5);
+  filled.resize(8, 'z');
+  phoenix::test::eq(filled == "xxxxxzzz", true, "resize");
+  filled.pop_back();
+  filled.clear();
+  phoenix::test::eq(filled.empty(), true, "clear");
+  phoenix::test::eq(std::string(phoenix::string(std::string("std"))), std::string("std"), "std::string conversions");
+}
+
+void append() {
+  phoenix::string text;
+  for (int i = 0; i < 100; i++) text += static_cast<char>('a' + i % 26);
+  phoenix::test::eq(text.size(), std::size_t{100}, "push back");
+  phoenix::test::leq(text.capacity(), std::size_t{256}, "capacity grows geometrically");
+
+  // Appending a part of the string itself while it reallocates
+  phoenix::string word("0123456789");
+  for (int i = 0; i < 5; i++) word.append(phoenix::string_view(word).substr(0, 10));
+  phoenix::test::eq(word.size(), std::size_t{60}, "self append size");
+  phoenix::test::eq(word.substr(50) == "0123456789", true, "self append contents");
+  word.assign(word.data() + 5, 3);
+  phoenix::test::eq(word == "567", true, "assign from itself");
+
+  phoenix::string joined = phoenix::string("left") + "-" + std::string("right");
+  joined.append(3, '!');
+  phoenix::test::eq(joined == "left-right!!!", true, "concatenation");
+  phoenix::test::eq(joined.at(4), '-', "at");
+  bool thrown = false;
+  try {
+    joined.at(100);
+  } catch (const std::out_of_range&) {
+    thrown = true;
+  }
+  phoenix::test::eq(thrown, true, "at out of range");
+}
+
+void search() {
+  phoenix::string text("the quick brown fox jumps over the lazy dog, the end");
+  phoenix::test::eq(text.find('q'), std::size_t{4}, "find char");
+  phoenix::test::eq(text.find('t', 1), std::size_t{31}, "find char from position");
+  phoenix::test::eq(text.find("the"), std::size_t{0}, "find string");
+  phoenix::test::eq(text.find("the", 1), std::size_t{31}, "find string from position");
+  phoenix::test::eq(text.find("the end"), std::size_t{45}, "find at the end");
+  phoenix::test::eq(text.find("cat"), phoenix::npos, "not found");
+  phoenix::test::eq(text.find(""), std::size_t{0}, "empty needle");
+  phoenix::test::eq(text.find("dog, the end and more"), phoenix::npos, "needle longer than the rest");
+  phoenix::test::eq(text.rfind('e'), std::size_t{49}, "rfind");
+  phoenix::test::eq(text.starts_with("the quick") && text.ends_with("end"), true, "prefix and suffix");
+  phoenix::test::eq(text.contains("lazy"), true, "contains");
+
+  // Needles around register sizes, with many partial matches
+  std::string haystack(1000, 'a');
+  haystack += "ab";
+  phoenix::string long_text(haystack);
+  for (std::size_t length : {2, 15, 16, 17, 31, 32, 33, 100}) {
+    std::string needle(length - 1, 'a');
+    needle += 'b';
+    phoenix::test::eq(long_text.find(needle), haystack.find(needle), "needle of " + std::to_string(length));
+  }
+
+  phoenix::string_view view(text);
+  view.remove_prefix(4);
+  view.remove_suffix(9);
+  phoenix::test::eq(view == "quick brown fox jumps over the lazy dog", true, "view prefix and suffix removal");
+  phoenix::test::eq(view.substr(6, 5) == "brown", true, "view substr");
+}
+
+void compare() {
+  phoenix::test::eq(phoenix::string("abc") < phoenix::string("abd"), true, "less");
+  phoenix::test::eq(phoenix::string("ab") < "abc", true, "prefix first");
+  phoenix::test::eq(phoenix::string("b") > std::string("abc"), true, "with std::string");
+  phoenix::test::eq(phoenix::string("abc").compare("abc"), 0, "compare equal");
+  phoenix::test::eq(phoenix::string_view("abc") != "abd", true, "view inequality");
+
+  // Sorting and printing
+  phoenix::vector<phoenix::string> words{"pear", "apple", "a fairly long fruit name", "fig", "banana"};
+  phoenix::sort(words.begin(), words.end());
+  std::stringstream printed;
+  words.print(printed, " ");
+  phoenix::test::eq(printed.str(), std::string("a fairly long fruit name apple banana fig pear "),
+                    "sorted and printed");
+  phoenix::sort(words.begin(), words.end(), phoenix::less_fn{});
+  phoenix::test::eq(words[0] == "pear", true, "sorted descending");
+}
+
+void hash() {
+  phoenix::hash_fn hash;
+  phoenix::test::eq(hash(phoenix::string("key")), hash(std::string("key")), "same hash as std::string");
+  phoenix::test::eq(hash(phoenix::string_view("key")), hash("key"), "same hash as a C string");
+
+  phoenix::hash_map<phoenix::string, int> map;
+  for (int i = 0; i < 1000; i++) map[phoenix::string(std::to_string(i))] = i;
+  phoenix::test::eq(map.find("500") != map.end(), true, "lookup with a literal");
+  phoenix::test::eq(map.find(std::string("999")).value(), 999, "lookup with std::string");
+
+  std::unordered_set<phoenix::string> set{"one", "two", "three"};
+  phoenix::test::eq(set.count("two"), std::size_t{1}, "std::hash specialization");
+}
+
+int main() {
+  phoenix::run_test(small_and_large, "Small and large");
+  phoenix::run_test(append, "Append");
+  phoenix::run_test(search, "Search");
+  phoenix::run_test(compare, "Compare");
+  phoenix::run_test(hash, "Hash");
+}
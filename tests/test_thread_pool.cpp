@@ -0,0 +1,143 @@
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <phoenix/array.hpp>
+#include <phoenix/test.hpp>
+#include <phoenix/thread_pool.hpp>
+#include <phoenix/vector.hpp>
+
+// The deque is used by one owner and any number of thieves, every item has to come out once
+void work_deque() {
+  constexpr std::size_t count = 100000;
+  phoenix::detail::work_deque<std::size_t> deque;
+  phoenix::vector<std::size_t> items(count);
+  std::atomic<std::size_t> taken[count];
+  for (std::size_t i = 0; i < count; i++) {
+    items[i] = i;
+    taken[i].store(0);
+  }
+
+  std::atomic<bool> done{false};
+  auto thief = [&]() {
+    while (!done.load() || !deque.empty()) {
+      if (std::size_t* item = deque.steal()) taken[*item]++;
+    }
+  };
+  std::thread first(thief), second(thief);
+  // Pushing more than the initial ring holds makes the deque grow while being stolen from
+  for (std::size_t i = 0; i < count; i++) {
+    deque.push(&items[i]);
+    if (i % 3 == 0) {
+      if (std::size_t* item = deque.pop()) taken[*item]++;
+    }
+  }
+  while (std::size_t* item = deque.pop()) taken[*item]++;
+  done.store(true);
+  first.join();
+  second.join();
+
+  bool once = true;
+  for (std::size_t i = 0; i < count; i++) once &= taken[i].load() == 1;
+  phoenix::test::eq(once, true, "every item taken exactly once");
+}
+
+void submit() {
+  std::atomic<int> counter{0};
+  {
+    phoenix::thread_pool pool(4);
+    phoenix::test::eq(pool.size(), std::size_t{4}, "pool size");
+    for (int i = 0; i < 1000; i++) pool.submit([&counter]() { counter++; });
+  }
+  phoenix::test::eq(counter.load(), 1000, "all submitted tasks done when the pool is destroyed");
+}
+
+long fibonacci(phoenix::thread_pool& pool, int n) {
+  if (n < 2) return n;
+  long a = 0;
+  phoenix::task_group group(pool);
+  group.run([&]() { a = fibonacci(pool, n - 1); });
+  long b = fibonacci(pool, n - 2);
+  group.wait();
+  return a + b;
+}
+
+void fork_join() {
+  phoenix::thread_pool pool(3, true);
+  phoenix::test::eq(fibonacci(pool, 20), 6765l, "recursive task groups");
+
+  phoenix::task_group group(pool);
+  std::atomic<int> counter{0};
+  for (int i = 0; i < 100; i++) group.run([&counter]() { counter++; });
+  group.wait();
+  phoenix::test::eq(counter.load(), 100, "group waits for all tasks");
+
+  // The group can be reused and passes the first exception to wait
+  for (int i = 0; i < 10; i++) {
+    group.run([i]() {
+      if (i == 5) throw std::runtime_error("task failed");
+    });
+  }
+  std::string message;
+  try {
+    group.wait();
+  } catch (const std::runtime_error& e) {
+    message = e.what();
+  }
+  phoenix::test::eq(message, std::string("task failed"), "exception rethrown by wait");
+  group.run([]() {});
+  group.wait();
+}
+
+void parallel_for() {
+  phoenix::thread_pool pool(4);
+  using iterator = phoenix::vector<std::uint64_t>::iterator;
+  phoenix::vector<std::uint64_t> values(100000);
+  phoenix::parallel_for(pool, values.begin(), values.end(), 1000, [](iterator first, iterator last) {
+    for (; first != last; ++first) *first += 1;
+  });
+  bool each_once = true;
+  for (auto v : values) each_once &= v == 1;
+  phoenix::test::eq(each_once, true, "every element of a vector visited once");
+
+  std::atomic<std::size_t> blocks{0}, longest{0};
+  using array = phoenix::array<int, 1000>;
+  array numbers;
+  for (std::size_t i = 0; i < numbers.size(); i++) numbers[i] = static_cast<int>(i);
+  std::atomic<long> sum{0};
+  phoenix::parallel_for(pool, numbers.begin(), numbers.end(), 64, [&](array::iterator first, array::iterator last) {
+    std::size_t length = 0;
+    for (; first != last; ++first, ++length) sum += *first;
+    blocks++;
+    std::size_t previous = longest.load();
+    while (length > previous && !longest.compare_exchange_weak(previous, length)) {}
+  });
+  phoenix::test::eq(sum.load(), 499500l, "sum over array blocks");
+  phoenix::test::leq(longest.load(), std::size_t{64}, "blocks not longer than grain");
+  phoenix::test::eq(blocks.load(), std::size_t{16}, "number of blocks");
+
+  // Pointers, an empty range and the default pool
+  int raw[10] = {};
+  phoenix::parallel_for(raw, raw + 10, 1, [](int* first, int* last) {
+    for (; first != last; ++first) *first = 7;
+  });
+  bool filled = true;
+  for (int v : raw) filled &= v == 7;
+  phoenix::test::eq(filled, true, "pointer range with default pool");
+  phoenix::parallel_for(raw, raw, 1, [](int*, int*) { throw std::logic_error("called for an empty range"); });
+
+  // Nested parallel_for from inside tasks
+  std::atomic<int> inner{0};
+  phoenix::parallel_for(pool, raw, raw + 10, 1, [&](int*, int*) {
+    phoenix::parallel_for(pool, values.begin(), values.begin() + 100, 10, [&](iterator, iterator) { inner++; });
+  });
+  phoenix::test::eq(inner.load(), 160, "nested parallel_for");
+}
+
+int main() {
+  phoenix::run_test(work_deque, "Work deque");
+  phoenix::run_test(submit, "Submit");
+  phoenix::run_test(fork_join, "Fork/join");
+  phoenix::run_test(parallel_for, "Parallel for");
+}
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <string>
 #include <phoenix/utility.hpp>
 #include <phoenix/test.hpp>
 #include <phoenix/array.hpp>
@@ -22,6 +23,67 @@ void swap() {
   phoenix::test::eq(y, 3, "Values has not been swapped!");
 }
 
+namespace custom {
+  struct counted {
+    int value;
+    static int copies;
+
+    counted(int v = 0) : value{v} {}
+    counted(const counted& other) : value{other.value} { copies++; }
+    counted(counted&&) = default;
+    counted& operator=(const counted& other) {
+      value = other.value;
+      copies++;
+      return *this;
+    }
+    counted& operator=(counted&&) = default;
+  };
+  int counted::copies = 0;
+
+  struct with_member_swap {
+    int value;
+    bool swapped;
+
+    void swap(with_member_swap& other) {
+      phoenix::swap(value, other.value);
+      swapped = other.swapped = true;
+    }
+  };
+
+  struct with_adl_swap {
+    int value;
+    bool swapped;
+  };
+
+  void swap(with_adl_swap& first, with_adl_swap& second) {
+    phoenix::swap(first.value, second.value);
+    first.swapped = second.swapped = true;
+  }
+}
+
+void swap_customization() {
+  custom::counted a{1}, b{2};
+  phoenix::swap(a, b);
+  phoenix::test::eq(a.value, 2);
+  phoenix::test::eq(b.value, 1);
+  phoenix::test::eq(custom::counted::copies, 0, "Swap copied instead of moving");
+
+  custom::with_member_swap c{1, false}, d{2, false};
+  phoenix::swap(c, d);
+  phoenix::test::eq(c.value, 2);
+  phoenix::test::eq(c.swapped, true, "Member swap wasn't used");
+
+  custom::with_adl_swap e{1, false}, f{2, false};
+  phoenix::swap(e, f);
+  phoenix::test::eq(e.value, 2);
+  phoenix::test::eq(e.swapped, true, "Swap found by argument-dependent lookup wasn't used");
+
+  std::string g = "first", h = "second";
+  phoenix::swap(g, h);
+  phoenix::test::eq(g, std::string("second"));
+  phoenix::test::eq(h, std::string("first"));
+}
+
 void is_sorted() {
   phoenix::array<int, 10> sorted{2, 4, 6, 8, 10, 23, 45, 89, 2354, 9999};
   phoenix::array<double, 10> not_sorted{3., 6., 3.14, 7.5, 2.3, 9.9, 12.3, 9., 1234., 532.};
@@ -34,11 +96,38 @@ void is_sorted() {
                     "Unsorted container is sorted ascending!");
   phoenix::test::eq(phoenix::is_sorted(not_sorted.cbegin(), not_sorted.cend(), phoenix::is_lesser), false,
                     "Unsorted container is sorted descending!");
+  phoenix::test::eq(phoenix::is_sorted(sorted.cbegin(), sorted.cend(), phoenix::greater_fn{}), true,
+                    "Sorted container is not sorted with greater_fn?");
+  phoenix::test::eq(phoenix::is_sorted(sorted.cbegin(), sorted.cend(), phoenix::less_fn{}), false,
+                    "Sorted container is sorted reverse way with less_fn?");
+  phoenix::test::eq(phoenix::is_sorted(sorted.cbegin(), sorted.cend(), phoenix::is_greater<int>), true,
+                    "Function pointer comparator doesn't work");
+  phoenix::test::eq(phoenix::is_sorted(sorted.cbegin(), sorted.cbegin()), true, "Empty range is not sorted?");
+}
+
+void comparators() {
+  phoenix::test::eq(phoenix::greater_fn{}(3, 2), true);
+  phoenix::test::eq(phoenix::greater_fn{}(2, 2), false);
+  phoenix::test::eq(phoenix::greater_or_equal_fn{}(2, 2), true);
+  phoenix::test::eq(phoenix::less_fn{}(2, 3), true);
+  phoenix::test::eq(phoenix::less_or_equal_fn{}(3, 2), false);
+  phoenix::test::eq(phoenix::equal_fn{}(2, 2), true);
+  phoenix::test::eq(phoenix::not_equal_fn{}(2, 2), false);
+
+  // heterogeneous comparison
+  phoenix::test::eq(phoenix::greater_fn{}(2, 1.5), true, "2 is not greater than 1.5?");
+  phoenix::test::eq(phoenix::less_fn{}(std::string("abc"), "abd"), true, "\"abc\" is not less than \"abd\"?");
+
+  static_assert(phoenix::less_fn{}(1, 2), "Comparators should be usable in constant expressions");
+  phoenix::test::eq(phoenix::is_lesser(1, 2), true);
+  phoenix::test::eq(phoenix::is_not_equal(1, 2), true);
 }
 
 int main() {
   phoenix::run_test(greater, "Greater");
   phoenix::run_test(lesser, "Lesser");
   phoenix::run_test(swap, "Swap");
+  phoenix::run_test(swap_customization, "Swap customization");
   phoenix::run_test(is_sorted, "Is sorted");
+  phoenix::run_test(comparators, "Comparators");
 }
\ No newline at end of file
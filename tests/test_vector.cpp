@@ -1,6 +1,7 @@
 #include <iostream>
 #include <phoenix/test.hpp>
 #include <phoenix/vector.hpp>
+#include <phoenix/utility.hpp>
 #include <utility>
 #include <vector>
 
@@ -220,10 +221,24 @@ void iterator() {
   }
 }
 
+void swap() {
+  phoenix::vector<int> a{1, 2, 3}, b{4, 5};
+  const int* a_data = a.data();
+
+  a.swap(b);
+  phoenix::test::container_equal(a, std::vector<int>{4, 5});
+  phoenix::test::container_equal(b, std::vector<int>{1, 2, 3});
+  phoenix::test::eq(b.data(), a_data, "Swap copied the elements");
+
+  phoenix::swap(a, b);
+  phoenix::test::container_equal(a, std::vector<int>{1, 2, 3});
+}
+
 int main() {
   phoenix::run_test(create_vector, "Create vector");
   phoenix::run_test(iterator, "Iterator");
   phoenix::run_test(rule_of_five, "Rule of five");
   phoenix::run_test(push_pop, "Push/pop");
   phoenix::run_test(access, "Access");
+  phoenix::run_test(swap, "Swap");
 }